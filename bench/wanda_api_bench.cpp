@@ -0,0 +1,387 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <wanda_case_generator.h>
+#include <wanda_engine.h>
+#include <wandamodel.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// Microbenchmarks of the wanda_api paths mgwso depends on. The benchmarks run
+// on synthetic cases of several sizes, grown from a small template case:
+//
+//   wanda_api_bench --wanda_case=template.wdi --wanda_bin=<Wanda bin> --wanda_sizes=100,1000,10000
+//
+// The template must contain at least one pipe, the synthetic case chains copies
+// of it, see wanda_generate_case(). Besides the time per operation every benchmark reports the heap
+// allocations and the bytes requested by read calls per operation, also when the OS serves them
+// from its cache.
+
+// ---- allocation counting, for the whole process ----
+
+namespace {
+std::atomic<std::uint64_t> allocation_count{ 0 };
+std::atomic<std::uint64_t> allocated_bytes{ 0 };
+}// namespace
+
+namespace {
+void *allocate(std::size_t size, std::size_t alignment) noexcept
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (size == 0) { size = 1; }
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) { return std::malloc(size); }
+#ifdef _WIN32
+  return _aligned_malloc(size, alignment);
+#else
+  return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void release(void *memory, std::size_t alignment) noexcept
+{
+#ifdef _WIN32
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    _aligned_free(memory);
+    return;
+  }
+#else
+  (void)alignment;
+#endif
+  std::free(memory);
+}
+}// namespace
+
+// the array and the other delete forms call these by default
+void *operator new(std::size_t size)
+{
+  if (void *memory = allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__)) { return memory; }
+  throw std::bad_alloc();
+}
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (void *memory = allocate(size, static_cast<std::size_t>(alignment))) { return memory; }
+  throw std::bad_alloc();
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *memory) noexcept { release(memory, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void *memory, std::size_t) noexcept { release(memory, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void *memory, std::align_val_t alignment) noexcept
+{
+  release(memory, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *memory, std::size_t, std::align_val_t alignment) noexcept
+{
+  release(memory, static_cast<std::size_t>(alignment));
+}
+
+namespace {
+
+struct settings {
+  std::string wanda_case;
+  std::string wanda_bin;
+  std::vector<int> sizes{ 100, 1000 };
+};
+settings options;
+
+// bytes requested by the read calls of the process so far, cached or not
+std::uint64_t get_bytes_read()
+{
+#ifdef _WIN32
+  IO_COUNTERS counters{};
+  if (GetProcessIoCounters(GetCurrentProcess(), &counters)) { return counters.ReadTransferCount; }
+  return 0;
+#else
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  std::uint64_t value = 0;
+  while (io >> key >> value) {
+    if (key == "rchar:") { return value; }
+  }
+  return 0;
+#endif
+}
+
+// adds the allocations and bytes requested by read calls per operation to the report of a benchmark
+class resource_counter {
+public:
+  explicit resource_counter(benchmark::State &state) : _state(state) {}
+  ~resource_counter()
+  {
+    const auto per_operation = benchmark::Counter::kAvgIterations;
+    _state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocation_count.load() - _allocations), per_operation);
+    _state.counters["alloc_bytes"] = benchmark::Counter(
+      static_cast<double>(allocated_bytes.load() - _allocated), per_operation, benchmark::Counter::OneK::kIs1024);
+    _state.counters["read_call_bytes"] = benchmark::Counter(
+      static_cast<double>(get_bytes_read() - _read), per_operation, benchmark::Counter::OneK::kIs1024);
+  }
+
+private:
+  benchmark::State &_state;
+  std::uint64_t _allocations = allocation_count.load();
+  std::uint64_t _allocated = allocated_bytes.load();
+  std::uint64_t _read = get_bytes_read();
+};
+
+// synthetic case with the given number of pipes, created once per size
+std::string get_synthetic_case(int pipes)
+{
+  static std::map<int, std::string> cases;
+  if (auto found = cases.find(pipes); found != cases.end()) { return found->second; }
+
+  wanda_case_generator_spec spec;
+  spec.template_case = options.wanda_case;
+  spec.output_case = (std::filesystem::temp_directory_path() / ("wanda_api_bench_" + std::to_string(pipes))
+                       / std::filesystem::path(options.wanda_case).filename())
+                       .string();
+  spec.wanda_bin = options.wanda_bin;
+  spec.pipes = pipes;
+  // synthetic output for the output benchmarks, without running the solvers
+  spec.time_steps = 100;
+  wanda_generate_case(spec);
+  cases[pipes] = spec.output_case;
+  return spec.output_case;
+}
+
+// model of the synthetic case, kept open between the benchmarks of the same size
+wanda_model &get_model(int pipes)
+{
+  static std::map<int, std::unique_ptr<wanda_model>> models;
+  auto &model = models[pipes];
+  if (!model) { model = std::make_unique<wanda_model>(get_synthetic_case(pipes), options.wanda_bin); }
+  return *model;
+}
+
+std::string get_last_pipe_name(wanda_model &model)
+{
+  auto pipes = model.get_all_pipes();
+  return pipes.back()->get_complete_name_spec();
+}
+
+void bench_initialize(benchmark::State &state)
+{
+  auto file = get_synthetic_case(static_cast<int>(state.range(0)));
+  resource_counter counter(state);
+  for (auto _ : state) {
+    wanda_model model(file, options.wanda_bin);
+    state.PauseTiming();
+    model.close();
+    state.ResumeTiming();
+  }
+}
+
+void bench_reload_input(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  resource_counter counter(state);
+  for (auto _ : state) { model.reload_input(); }
+}
+
+void bench_reload_output(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  try {
+    model.reload_output();
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+  resource_counter counter(state);
+  for (auto _ : state) { model.reload_output(); }
+}
+
+void bench_read_prop_output(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  auto &property = model.get_component(get_last_pipe_name(model)).get_property("Discharge 1");
+  try {
+    model.read_prop_output(property);
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+  resource_counter counter(state);
+  for (auto _ : state) {
+    model.read_prop_output(property);
+    auto series = property.get_series_view();
+    benchmark::DoNotOptimize(series);
+  }
+}
+
+void bench_get_route(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  std::vector<int> directions;
+  resource_counter counter(state);
+  for (auto _ : state) {
+    auto route = model.get_route(wanda_synthetic_route_keyword, directions);
+    benchmark::DoNotOptimize(route.data());
+  }
+}
+
+void bench_get_component(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  auto name = get_last_pipe_name(model);
+  resource_counter counter(state);
+  for (auto _ : state) { benchmark::DoNotOptimize(&model.get_component(name)); }
+}
+
+void bench_keyword_query(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  resource_counter counter(state);
+  for (auto _ : state) {
+    auto components = model.get_components_with_keyword(wanda_synthetic_tenth_keyword);
+    benchmark::DoNotOptimize(components.data());
+  }
+}
+
+void bench_save_model_input(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  auto &property = model.get_component(get_last_pipe_name(model)).get_property("Inner diameter");
+  const float diameter = property.get_scalar_float();
+  resource_counter counter(state);
+  for (auto _ : state) {
+    // one modified property, the common case when a coupled run changes an input
+    property.set_scalar(diameter);
+    model.save_model_input();
+  }
+}
+
+// reads the Profile tables of all pipes, the tables are loaded with the input
+void bench_load_tables(benchmark::State &state)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  auto pipes = model.get_all_pipes();
+  resource_counter counter(state);
+  for (auto _ : state) {
+    for (auto pipe : pipes) {
+      auto &table = pipe->get_property("Profile").get_table();
+      auto height = table.get_float_column("Height");
+      benchmark::DoNotOptimize(height);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pipes.size()));
+}
+
+void bench_engine(benchmark::State &state, bool by_handle, bool set)
+{
+  auto &model = get_model(static_cast<int>(state.range(0)));
+  auto name = get_last_pipe_name(model);
+  wanda_engine *engine = nullptr;
+  try {
+    engine = wanda_engine::get_instance(options.wanda_bin);
+    engine->initialize_engine(model.get_case_path());
+    engine->run_steady();
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+  auto handle = engine->get_handle(name, "Discharge 1");
+  double value = engine->get_value(name, "Discharge 1");
+  resource_counter counter(state);
+  for (auto _ : state) {
+    if (set) {
+      by_handle ? engine->set_values(handle, &value) : engine->set_value(name, "Discharge 1", value);
+    } else if (by_handle) {
+      engine->get_values(handle, &value);
+    } else {
+      value = engine->get_value(name, "Discharge 1");
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  engine->close_engine();
+}
+
+std::vector<int> parse_sizes(const std::string &list)
+{
+  std::vector<int> sizes;
+  std::stringstream stream(list);
+  std::string size;
+  while (std::getline(stream, size, ',')) { sizes.push_back(std::stoi(size)); }
+  return sizes;
+}
+
+// takes the options of this program out of the arguments, the rest is for Google Benchmark
+void parse_options(int &argc, char **argv)
+{
+  int kept = 1;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    auto value = argument.substr(argument.find('=') + 1);
+    if (argument.starts_with("--wanda_case=")) {
+      options.wanda_case = value;
+    } else if (argument.starts_with("--wanda_bin=")) {
+      options.wanda_bin = value;
+    } else if (argument.starts_with("--wanda_sizes=")) {
+      options.sizes = parse_sizes(value);
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+}
+
+void register_benchmarks()
+{
+  auto add = [](const char *name, auto function) {
+    auto *benchmark = benchmark::RegisterBenchmark(name, function);
+    for (auto size : options.sizes) { benchmark->Arg(size); }
+    benchmark->ArgName("pipes")->Unit(benchmark::kMicrosecond);
+    return benchmark;
+  };
+  add("initialize", bench_initialize)->Iterations(3);
+  add("reload_input", bench_reload_input);
+  add("reload_output", bench_reload_output);
+  add("read_prop_output", bench_read_prop_output);
+  add("get_route", bench_get_route);
+  add("get_component", bench_get_component)->Unit(benchmark::kNanosecond);
+  add("keyword_query", bench_keyword_query);
+  add("save_model_input", bench_save_model_input);
+  add("load_tables", bench_load_tables);
+  add("engine_get_value", [](benchmark::State &state) { bench_engine(state, false, false); })->Unit(benchmark::kNanosecond);
+  add("engine_set_value", [](benchmark::State &state) { bench_engine(state, false, true); })->Unit(benchmark::kNanosecond);
+  add("engine_get_values", [](benchmark::State &state) { bench_engine(state, true, false); })->Unit(benchmark::kNanosecond);
+  add("engine_set_values", [](benchmark::State &state) { bench_engine(state, true, true); })->Unit(benchmark::kNanosecond);
+}
+}// namespace
+
+int main(int argc, char **argv)
+{
+  parse_options(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return EXIT_FAILURE; }
+  if (options.wanda_case.empty() || options.wanda_bin.empty()) {
+    std::fprintf(stderr, "Give a template case with --wanda_case and the Wanda bin directory with --wanda_bin\n");
+    return EXIT_FAILURE;
+  }
+  register_benchmarks();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return EXIT_SUCCESS;
+}
@@ -32,5 +32,24 @@ function(mgwso_setup_dependencies)
     cpmaddpackage("gh:CLIUtils/CLI11@2.4.1")
   endif()
 
+  if(mgwso_BUILD_BENCHMARKS AND NOT TARGET benchmark::benchmark)
+    cpmaddpackage(
+      NAME
+      benchmark
+      VERSION
+      1.8.3
+      GITHUB_REPOSITORY
+      "google/benchmark"
+      OPTIONS
+      "BENCHMARK_ENABLE_TESTING OFF"
+      "BENCHMARK_ENABLE_INSTALL OFF")
+  endif()
+
+  # Arrow is too large to build through CPM, it is taken from the system or vcpkg
+  if(mgwso_BUILD_OUTPUT_EXPORT AND NOT TARGET Parquet::parquet_shared)
+    find_package(Arrow CONFIG REQUIRED)
+    find_package(Parquet CONFIG REQUIRED)
+  endif()
+
 
 endfunction()
\ No newline at end of file
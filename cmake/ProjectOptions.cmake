@@ -21,6 +21,16 @@ endmacro()
 macro(mgwso_setup_options)
   option(mgwso_ENABLE_HARDENING "Enable hardening" ON)
   option(mgwso_ENABLE_COVERAGE "Enable coverage reporting" OFF)
+  option(mgwso_BUILD_BENCHMARKS "Build the wanda_api microbenchmarks" OFF)
+  option(mgwso_BUILD_OUTPUT_EXPORT "Build wanda_output_export, which needs Arrow and Parquet" OFF)
+  # without it a build on Linux, where Component64.dll doesn't exist, computes no HCS at all. On Windows the native
+  # HCS is only used when the dll can't be loaded or a model selects it, and stays off until test/data has results
+  # captured from the dll.
+  if(WIN32)
+    option(mgwso_ENABLE_NATIVE_HCS "Compute the HCS of supported pipes without Component64.dll" OFF)
+  else()
+    option(mgwso_ENABLE_NATIVE_HCS "Compute the HCS of supported pipes without Component64.dll" ON)
+  endif()
   cmake_dependent_option(
     mgwso_ENABLE_GLOBAL_HARDENING
     "Attempt to push hardening options to built dependencies"
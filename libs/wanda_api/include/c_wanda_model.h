@@ -9,6 +9,16 @@ class wanda_component;
 //! @brief C interface functions for the wanda_model objects. This allows access to the
 //! wanda_model functionality for non-Object oriented languages.
 //!
+//! Concurrency: different models can be used from different threads without restrictions.
+//! Functions taking a model handle lock that model, the read only ones (getting handles,
+//! names, keywords, routes and time steps) with a shared lock so they run in parallel,
+//! all others exclusively. Functions taking an item, property or table handle do not lock;
+//! the getters among them, including the series and extremes functions, may run in parallel
+//! with each other and with read only model functions, but not at the same time as any
+//! function changing the same model (setters, adding, deleting, connecting, reloading,
+//! saving and running). Error messages are stored per thread, wnd_get_last_error returns
+//! the last error of the calling thread.
+//!
 extern "C"
 {
     //! Initializes a wanda_model
@@ -460,6 +470,51 @@ extern "C"
     int wnd_get_time_series_pipe(void *property_handle, int element, float *buffer, const size_t buffersize);
     int wnd_get_series_pipe(void *property_handle, float *buffer, const size_t buffersize);
 
+    //! Gets the time series of many properties in one call.
+    /*!
+    * Copies the series of all given properties after each other into buffer. For properties of pipes the
+    * series of all elements (number of elements + 1) are copied after each other. offsets[i] is the start of
+    * property i in buffer and offsets[num_properties] the total number of values. When buffer is NULL only the
+    * offsets are filled, this can be used to allocate the buffer.
+    \param property_handles array with handles of wanda properties
+    \param num_properties number of handles in property_handles
+    \param buffer buffer for the values or NULL
+    \param buffersize size of buffer in bytes, as for wnd_get_series
+    \param offsets array of num_properties + 1 elements, receives the start of each property in buffer, in values
+    \return Error code: 0 = success, -1 indicates an error, a message is written to stderr
+    */
+    int wnd_get_series_bulk(void **property_handles, const size_t num_properties, float *buffer,
+                            const size_t buffersize, size_t *offsets);
+
+    //! Gets the extremes of many properties in one call.
+    /*!
+    * Writes one value per property, or one value per element (number of elements + 1) for properties of pipes.
+    * offsets and a NULL buffer work as in wnd_get_series_bulk.
+    \param property_handles array with handles of wanda properties
+    \param num_properties number of handles in property_handles
+    \param extreme_type 0 = minimum, 1 = maximum, 2 = time of minimum, 3 = time of maximum
+    \param buffer buffer for the values or NULL
+    \param buffersize size of buffer in bytes, as for wnd_get_series
+    \param offsets array of num_properties + 1 elements, receives the start of each property in buffer, in values
+    \return Error code: 0 = success, -1 indicates an error, a message is written to stderr
+    */
+    int wnd_get_extremes_bulk(void **property_handles, const size_t num_properties, int extreme_type,
+                              float *buffer, const size_t buffersize, size_t *offsets);
+
+    //! Gives direct read access to the time series of a property without copying it.
+    /*!
+    * The returned pointer refers to the output loaded in the model. It stays valid until
+    * wnd_reload_model_output is called or the model is closed and must not be written to.
+    * When the output is returned in the units of the case, a unit switch rescales the
+    * values in place, so the pointer stays valid but the values change.
+    \param property_handle Handle of the wanda property
+    \param element element of the pipe, 0 for other components
+    \param data receives the pointer to the first value
+    \param length receives the number of values
+    \return Error code: 0 = success, -1 indicates an error, a message is written to stderr
+    */
+    int wnd_borrow_series(void *property_handle, int element, const float **data, size_t *length);
+
     //! Gets the IsFlipped status of the component in the Igrafix diagram.
     /*!
     * Gets the IsFlipped status of the component in the Igrafix diagram.
@@ -604,6 +659,8 @@ extern "C"
     void *wnd_get_output_component(void *signal_line_handle);
     //! returns the unit factor for the given property
     int wnd_get_unit_factor(void *prop_handle, float *factor);
+    //! Selects whether output is returned in the units of the case (1) or in SI units (0, default)
+    int wnd_set_output_in_case_units(void *model_handle, int convert);
 
     //! returns the size of the column.
     int wnd_get_table_size(void *table, const char *description);
@@ -647,11 +704,30 @@ extern "C"
     int wnd_reset_wdo_pointer(void *model);
     //! resume the current wanda simualtion until the given end time
     int wnd_resume_unsteady_until(void *model, float end_time);
+    //! Returns the last error message of the calling thread
     /*!
-    \return pointer to character buffer that contains the error message
+    \return pointer to character buffer that contains the error message, valid until the next
+    error in the calling thread
     */
     const char *wnd_get_last_error();
     //! upgrade model to latest file format specification
     int wnd_upgrade_model(void *model);
+
+    //! Enables (1) or disables (0) the runtime metrics of the API, see wanda_metrics
+    int wnd_enable_metrics(int enable);
+    //! Returns the value of a counter, 0 when it has not been counted yet
+    /*!
+    \param name name of the metric, e.g. wanda_nefis_calls_total
+    \param labels labels in Prometheus syntax, e.g. group="OUTP_H", NULL or empty for none
+    \param value the value of the counter
+    \return Error code: 0 = success, -1 indicates an error
+    */
+    int wnd_get_metric_counter(const char *name, const char *labels, unsigned long long *value);
+    //! Returns the number and the total duration in seconds of the observations of a histogram
+    int wnd_get_metric_histogram(const char *name, const char *labels, unsigned long long *count, double *sum);
+    //! Writes all metrics in the Prometheus text format to the file, replacing it at once
+    int wnd_write_metrics(const char *file);
+    //! Sets all metrics to 0
+    int wnd_reset_metrics();
 }
 #endif
@@ -1,7 +1,10 @@
 #ifndef WANDA_CALC_HCS
 #define WANDA_CALC_HCS
+#include "wanda_native_hcs.h"
 #include "wandacomponent.h"
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <functional>
 
 
@@ -15,7 +18,30 @@ class wanda_component_dll
 
     static wanda_component_dll *get_instance(const std::string &wanda_bin);
     ~wanda_component_dll();
-    void calc_hydraulic_spec_component(wanda_component &component, std::vector<float> globvars);    
+    void calc_hydraulic_spec_component(wanda_component &component, const std::vector<float> &globvars,
+                                       wanda_hcs_backend backend);
+    // Computes the HCS of all given components in one pass. The dll has no batch entry point, so it is called for
+    // each component. Components whose HIS, table, node height and global inputs are unchanged since their last
+    // computation are skipped unless force is set. The dll keeps its error message in global state, so the calls
+    // are not made in parallel.
+    // Pipes supported by wanda_native_hcs are computed natively, depending on the backend of the model, when the
+    // library is built with WANDA_NATIVE_HCS. Errors, also those of the native pipes, are set as HCS error of the
+    // component.
+    // Returns the number of computed components.
+    int calc_hydraulic_spec_components(const std::vector<wanda_component *> &components,
+                                       const std::vector<float> &globvars, wanda_hcs_backend backend,
+                                       bool force = false);
+    // returns true when the pipe can be computed by the native implementation
+    static bool has_native_hcs(wanda_component &component);
+    bool is_dll_loaded() const
+    {
+        return hGetProcIDDLL != nullptr;
+    }
+    // reason why Component64.dll is not loaded, empty when it is
+    const std::string &get_load_error() const
+    {
+        return _load_error;
+    }
 
   private:
     [[maybe_unused]] const std::size_t _object_hash = std::hash<std::string>{}(std::string("WandaComponentDll Object"));
@@ -23,12 +49,20 @@ class wanda_component_dll
     wanda_component_dll(const std::string &wanda_bin);
 
     std::string _wanda_bin;
-    HINSTANCE hGetProcIDDLL;
+    std::string _load_error;
+#ifdef _WIN32
+    HINSTANCE hGetProcIDDLL = nullptr;
+#else
+    // Component64.dll only exists for Windows
+    void *hGetProcIDDLL = nullptr;
+#endif
     std::function<int(const char *, const char *, const int *, float *, float **, float **,
                       const int *, const int *, const float *, const int *, float *, const int *, float *, size_t,
                       size_t)>
         calc_hsc;
     std::function<void(char *, size_t)> get_error_message_dll;
     std::string get_error_message() const;
+    bool use_native(wanda_component &component, wanda_hcs_backend backend) const;
+    void calc_native_pipes(const std::vector<wanda_component *> &pipes, const std::vector<float> &globvars);
 };
 #endif
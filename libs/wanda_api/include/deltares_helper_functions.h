@@ -9,6 +9,7 @@
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <map>
@@ -51,6 +52,19 @@ template <typename T>
     return to_function<T>(lpfnGetProcessID);
 }
 
+//! transparent string hash, allows lookups in unordered containers with std::string_view or const char*
+struct string_hash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const noexcept
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+//! multiplies count values in place with factor, with SSE on x86 and a plain loop elsewhere
+WANDAMODEL_API void scale_values(float *values, std::size_t count, float factor);
+
 //! split string in sections based on delimeter
 std::vector<std::string> split(const std::string &input, char delimeter);
 
@@ -32,6 +32,8 @@ class WANDAMODEL_API nefis_file
     bool is_open() const;
     int open();
     int open(char access_modifier);
+    //! creates a new file, an existing file is replaced
+    int create();
     int close();
     void flush();
     int get_int_attribute(const std::string &, const std::string &) const;
@@ -48,6 +50,9 @@ class WANDAMODEL_API nefis_file
     void get_float_element(std::string, std::string, nefis_uindex uindex, std::vector<float> &) const;
     void get_float_element(std::string, std::string, nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim,
                            std::vector<std::vector<float>> &, bool transpose = false) const;
+    //! reads a block of a two dimensional group without copying, the first dimension varies fastest
+    void get_float_element(const std::string &grpname, const std::string &elmname, nefis_uindex uindex_1st_dim,
+                           nefis_uindex uindex_2nd_dim, std::vector<float> &resarray) const;
     void write_float_elements(std::string, std::string, nefis_uindex uindex, std::vector<float>);
     void write_float_elements(std::string, std::string, nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim,
                               std::vector<std::vector<float>>);
@@ -56,6 +61,15 @@ class WANDAMODEL_API nefis_file
                                std::vector<std::string>);
     void write_string_elements(const std::string &, const std::string &, nefis_uindex uindex_1st_dim,
                                nefis_uindex uindex_2nd_dim, int, const std::vector<std::vector<std::string>> &);
+    //! defines an element, type is one of CHARACTE, INTEGER, LOGICAL or REAL and bytes the size of one value
+    void define_element(const std::string &elementname, const std::string &type, int bytes,
+                        const std::vector<int> &dimensions = {1}, const std::string &quantity = "",
+                        const std::string &unit = "", const std::string &description = "");
+    void define_cell(const std::string &cellname, const std::vector<std::string> &elementnames);
+    //! defines a group of cells, a last dimension of 0 makes the group variable in that dimension
+    void define_group(const std::string &groupdefinition, const std::string &cellname,
+                      const std::vector<int> &dimensions);
+    void create_group(const std::string &groupname, const std::string &groupdefinition);
     int get_group_dim(std::string) const;
     int get_maxdim_index(const std::string &groupname) const;
     std::string get_cel_name(const std::string &grpname) const;
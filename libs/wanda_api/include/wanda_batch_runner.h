@@ -0,0 +1,176 @@
+#ifndef _WANDA_BATCH_RUNNER_
+#define _WANDA_BATCH_RUNNER_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+#include <wanda_solver_process.h>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+
+//! Change of one input property for a batch job
+struct wanda_batch_override
+{
+    //! name of the component, node or signal line, empty for a model property
+    std::string item;
+    //! description of the property
+    std::string property;
+    //! new value, set with wanda_property::set_scalar
+    std::variant<float, std::string> value;
+};
+
+//! One case of a batch: the base case with a set of overrides
+struct wanda_batch_job
+{
+    //! unique name, also used as the name of the working directory of the job
+    std::string name;
+    std::vector<wanda_batch_override> overrides;
+};
+
+//! Statistic collected from an output quantity
+enum class wanda_batch_statistic
+{
+    minimum,
+    maximum,
+    time_of_minimum,
+    time_of_maximum,
+    final_value
+};
+
+//! Output quantity collected for every job, one column of the result table
+struct wanda_batch_output
+{
+    //! name of the component or node
+    std::string item;
+    //! description of the output property
+    std::string property;
+    wanda_batch_statistic statistic = wanda_batch_statistic::maximum;
+    //! element of a pipe, 0 for other components
+    int element = 0;
+};
+
+//! Row of the result table of a batch
+struct wanda_batch_result
+{
+    std::string job_name;
+    std::string working_directory;
+    bool succeeded = false;
+    int attempts = 0;
+    //! error of the last attempt when the job failed
+    std::string error;
+    //! one value per requested output, in the order of the requests
+    std::vector<float> values;
+    std::chrono::duration<double> wall_time{0.0};
+};
+
+//! Settings of a batch run
+struct wanda_batch_options
+{
+    //! number of jobs running at the same time, 0 uses the number of cores
+    unsigned int num_workers = 0;
+    //! number of times a failing job is retried
+    int max_retries = 0;
+    //! run the transient computation after steady
+    bool run_unsteady = true;
+    //! keep the working directories of succeeded jobs
+    bool keep_working_directories = true;
+    //! options for every solver process, e.g. the timeout
+    wanda_solver_options solver;
+    //! called after every finished job, from the worker thread
+    std::function<void(const wanda_batch_result &)> on_job_finished;
+};
+
+//! Runs one job on the copy of the case and fills the values of its result, throws when the job fails
+using wanda_batch_executor = std::function<void(const wanda_batch_job &job, const std::string &case_file,
+                                                const wanda_batch_options &options, wanda_batch_result &result)>;
+
+//!  Runs many variants of one Wanda case in parallel.
+/*!
+Every job gets its own working directory below the batch directory with a copy
+of the files of the base case. The overrides of the job are applied to the copy,
+after which steady and optionally unsteady are run and the requested output is
+collected into one row of the result table.
+
+Jobs are distributed over the workers in round robin, a worker without jobs
+takes jobs from the back of the queue of another worker. The solvers run
+concurrently, reading and writing the case files is done by one worker at a
+time because the nefis library is not thread safe. A failing job does not
+affect the other jobs, it is retried up to max_retries times in a fresh working
+directory.
+*/
+class WANDAMODEL_API wanda_batch_runner
+{
+  public:
+    //! creates a batch runner for the given base case
+    /*!
+    \param base_case path to the *.wdi file of the base case
+    \param wanda_bin path to the Wanda bin directory
+    \param batch_directory directory in which the working directories of the jobs are created
+    */
+    wanda_batch_runner(std::string base_case, std::string wanda_bin, std::string batch_directory);
+    //! creates a batch runner which runs the jobs with another executor than Wanda, e.g. in tests
+    /*!
+    \param base_case path to the file of the base case, files with the same stem are copied for every job
+    \param batch_directory directory in which the working directories of the jobs are created
+    \param executor runs a job, solvers it starts are run with wait_for()
+    */
+    wanda_batch_runner(std::string base_case, std::string batch_directory, wanda_batch_executor executor);
+
+    //! adds a job, its name must be a plain directory name
+    void add_job(wanda_batch_job job);
+    void add_output(wanda_batch_output output);
+    //! runs all jobs and returns the result table, one row per job in the order they were added
+    std::vector<wanda_batch_result> run(const wanda_batch_options &options = {});
+    //! stops starting new jobs and cancels the running solvers, can be called from any thread
+    void cancel();
+    //! returns the column names of the result table
+    std::vector<std::string> get_column_names() const;
+    //! writes the result table as a comma separated file
+    void write_csv(const std::vector<wanda_batch_result> &results, const std::string &file) const;
+    //! waits until the solver has finished, the solver is cancelled when the batch is cancelled
+    void wait_for(const std::shared_ptr<wanda_solver_job> &solver);
+
+  private:
+    std::string _base_case;
+    std::string _wanda_bin;
+    std::string _batch_directory;
+    std::vector<wanda_batch_job> _jobs;
+    std::vector<wanda_batch_output> _outputs;
+    wanda_batch_executor _executor;
+    std::atomic<bool> _cancelled{false};
+    std::mutex _case_file_mutex;
+    // solvers being waited for, cancelled by cancel()
+    std::mutex _running_mutex;
+    std::vector<std::shared_ptr<wanda_solver_job>> _running;
+    // queue of job indices per worker, guarded by one mutex each
+    struct work_queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+    std::vector<work_queue> _queues;
+
+    bool next_job(size_t worker, size_t &job);
+    void worker(size_t worker_id, const wanda_batch_options &options, std::vector<wanda_batch_result> &results);
+    std::string materialize(const wanda_batch_job &job) const;
+    // the executor of Wanda cases, in wanda_batch_model.cpp
+    void run_job(const wanda_batch_job &job, const std::string &case_file, const wanda_batch_options &options,
+                 wanda_batch_result &result);
+    void apply_overrides(wanda_model &model, const wanda_batch_job &job) const;
+    void collect_output(wanda_model &model, wanda_batch_result &result) const;
+};
+
+#endif
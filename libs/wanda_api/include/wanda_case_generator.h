@@ -0,0 +1,67 @@
+#ifndef _WANDA_CASE_GENERATOR_
+#define _WANDA_CASE_GENERATOR_
+
+#include <cstdint>
+#include <string>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+
+//! Size and seed of a synthetic case for scale tests, see wanda_generate_case()
+struct wanda_case_generator_spec
+{
+    //! case to copy the components from, with at least one pipe
+    std::string template_case;
+    //! wdi file of the synthetic case, an existing case is replaced
+    std::string output_case;
+    std::string wanda_bin;
+    //! total number of pipes, chained one after the other
+    int pipes = 1000;
+    //! number of control components added
+    int control_components = 0;
+    //! number of output time steps, 0 for no output file
+    int time_steps = 100;
+    float time_step = 0.1f;
+    //! the same seed and sizes give the same case
+    std::uint64_t seed = 1;
+};
+
+//! keyword of all pipes of a synthetic case, get_route() with it returns the whole chain
+inline const std::string wanda_synthetic_route_keyword = "synthetic_route";
+//! keyword of every tenth pipe of a synthetic case
+inline const std::string wanda_synthetic_tenth_keyword = "synthetic_tenth";
+
+//! Creates a synthetic case of the given size from a template case
+/*!
+The files of the template case are copied to the output case. The first pipe of
+the template is copied until the case has spec.pipes pipes, each connected to the
+previous one, with a pseudo-random length and diameter. The control components
+are copies of the first control component of the template, not connected. The
+input is saved with wanda_model::save_model_input(), which needs a Wanda license.
+
+When spec.time_steps > 0 the output file is written by
+wanda_write_synthetic_output() instead of running the solvers, so the case can be
+read like a computed case without a license.
+*/
+WANDAMODEL_API void wanda_generate_case(const wanda_case_generator_spec &spec);
+
+//! Writes a wdo file with pseudo-random output for all output properties of the model
+/*!
+The file has the groups and indices the output of the solvers has: OUTPUT_TIME,
+the index groups of the components and nodes, and per WDO postfix the series in
+OUTP_ and extremes in EXTR_. The values are smooth functions of time, the same
+for the same seed, so reading the output can be checked and timed at any size.
+
+The output file of the case is replaced, so the model must not have read output
+yet. Open the case again to read the new output.
+*/
+WANDAMODEL_API void wanda_write_synthetic_output(wanda_model &model, int time_steps, float time_step,
+                                                 std::uint64_t seed);
+
+#endif
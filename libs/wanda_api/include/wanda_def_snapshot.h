@@ -0,0 +1,176 @@
+#ifndef _WANDA_DEF_SNAPSHOT_
+#define _WANDA_DEF_SNAPSHOT_
+
+#include <cstdint>
+#include <map>
+#include <nefis_file.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <deltares_helper_functions.h>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+//!  Precompiled, memory mapped copy of the reads done on WandaDef.dat.
+/*!
+A snapshot stores the result of every read wanda_def does on the definition
+file, keyed by group, element, index range and string length. It is written by
+the wandadef_compile tool and stored next to WandaDef.dat. The file layout is:
+
+    header : magic "WNDDEFS", format version, number of records,
+             size and modification time of WandaDef.dat, Wanda version
+    record : key, value type, number of values, values
+
+Integers are 32 bit little endian, the size and time 64 bit, strings are stored
+as length + characters. The file is mapped into memory as a whole and all
+records are checked against the size of the file when it is opened, a truncated
+or corrupt snapshot is ignored. The values of a record are decoded only when
+the record is requested.
+*/
+class WANDAMODEL_API wanda_def_snapshot
+{
+  public:
+    //! name of the snapshot file in the Wanda bin directory
+    static constexpr const char *file_name = "WandaDef.snapshot";
+    //! version of the file layout, files with another version are ignored
+    static constexpr std::uint32_t format_version = 2;
+
+    wanda_def_snapshot() = default;
+    wanda_def_snapshot(const wanda_def_snapshot &) = delete;
+    wanda_def_snapshot &operator=(const wanda_def_snapshot &) = delete;
+    ~wanda_def_snapshot();
+
+    //! maps the given snapshot file, returns false when it does not exist or is not a valid snapshot
+    bool open(const std::string &file);
+    //! unmaps the snapshot file
+    void close();
+    bool is_open() const
+    {
+        return _data != nullptr;
+    }
+    //! returns the Wanda version of the WandaDef.dat the snapshot was made from
+    const std::string &get_wanda_version() const
+    {
+        return _wanda_version;
+    }
+    void set_wanda_version(const std::string &version)
+    {
+        _wanda_version = version;
+    }
+    //! returns the size of the WandaDef.dat the snapshot was made from
+    std::uint64_t get_source_size() const
+    {
+        return _source_size;
+    }
+    //! returns the modification time of the WandaDef.dat the snapshot was made from, in file clock ticks
+    std::int64_t get_source_time() const
+    {
+        return _source_time;
+    }
+    void set_source(std::uint64_t size, std::int64_t time)
+    {
+        _source_size = size;
+        _source_time = time;
+    }
+
+    ///@private
+    bool get_strings(std::string_view key, std::vector<std::string> &values) const;
+    ///@private
+    bool get_ints(std::string_view key, std::vector<int> &values) const;
+    ///@private
+    bool get_floats(std::string_view key, std::vector<float> &values) const;
+    ///@private
+    void add_strings(const std::string &key, const std::vector<std::string> &values);
+    ///@private
+    void add_ints(const std::string &key, const std::vector<int> &values);
+    ///@private
+    void add_floats(const std::string &key, const std::vector<float> &values);
+    //! writes the recorded values to the given file
+    void save(const std::string &file) const;
+
+  private:
+    enum class value_type : std::uint8_t
+    {
+        strings = 0,
+        ints = 1,
+        floats = 2
+    };
+    struct recorded_value
+    {
+        value_type type;
+        std::vector<std::string> strings;
+        std::vector<int> ints;
+        std::vector<float> floats;
+    };
+    // mapped file
+    const char *_data = nullptr;
+    std::size_t _size = 0;
+    void *_file_handle = nullptr;
+    void *_mapping_handle = nullptr;
+    std::unordered_map<std::string_view, const char *, wanda_helper_functions::string_hash, std::equal_to<>> _records;
+    std::string _wanda_version;
+    std::uint64_t _source_size = 0;
+    std::int64_t _source_time = 0;
+    // values recorded for writing a new snapshot, sorted for a reproducible file
+    std::map<std::string, recorded_value, std::less<>> _recorded;
+    const char *find_record(std::string_view key, value_type type, std::uint32_t &count) const;
+    bool map_file(const std::string &file);
+    void unmap_file();
+};
+
+//!  Read access to the Wanda definition, from WandaDef.dat or from its snapshot.
+/*!
+The wanda_def_database offers the subset of the nefis_file interface used by
+wanda_def. When a snapshot made from the same WandaDef.dat, by size,
+modification time and Wanda version, exists next to it the snapshot is used.
+WandaDef.dat is then only read for the version check and for reads which are
+not in the snapshot; without WandaDef.dat the snapshot is not used. In recording mode all reads go to WandaDef.dat and are
+stored, so they can be written as a new snapshot.
+*/
+class WANDAMODEL_API wanda_def_database
+{
+  public:
+    //! opens the definition in the given Wanda bin directory
+    void open(const std::string &data_path, bool record = false);
+    void close();
+    //! returns true when the definition is read from a snapshot
+    bool is_snapshot() const
+    {
+        return _use_snapshot;
+    }
+    //! writes all reads done so far, only available in recording mode
+    void save_snapshot(const std::string &file) const;
+
+    int get_int_attribute(const std::string &groupname, const std::string &attributename) const;
+    void get_string_element(const std::string &groupname, const std::string &elementname, nefis_uindex uindex,
+                            int stringlength, std::vector<std::string> &results) const;
+    void get_string_element(const std::string &groupname, const std::string &elementname,
+                            nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim, int stringlength,
+                            std::vector<std::vector<std::string>> &results) const;
+    void get_int_element(const std::string &groupname, const std::string &elementname, nefis_uindex uindex,
+                         std::vector<int> &results) const;
+    void get_float_element(const std::string &groupname, const std::string &elementname, nefis_uindex uindex,
+                           std::vector<float> &results) const;
+    void get_float_element(const std::string &groupname, const std::string &elementname, nefis_uindex uindex_1st_dim,
+                           nefis_uindex uindex_2nd_dim, std::vector<std::vector<float>> &results,
+                           bool transpose = false) const;
+    int get_maxdim_index(const std::string &groupname) const;
+    int get_element_size(const std::string &element) const;
+
+  private:
+    mutable nefis_file _nefis;
+    wanda_def_snapshot _snapshot;
+    mutable wanda_def_snapshot _recording;
+    std::string _def_file;
+    bool _use_snapshot = false;
+    bool _record = false;
+    const nefis_file &get_nefis() const;
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include <Windows.h>
 #include <functional>
+#include <wanda_engine_handle.h>
 #include <wandamodel.h>
 
 #ifdef WANDAMODEL_EXPORT
@@ -119,6 +120,19 @@ class WANDAMODEL_API wanda_engine
     */
     std::vector<double> get_vector(wanda_component &comp, std::string property);
 
+    //! Resolves the handle of a property of a component
+    /*!
+    The engine must be initialized.
+    \param comp_name name of the component
+    \param property name of the property
+    \param pipe_vector true to address the values of all elements of a pipe
+    */
+    wanda_engine_handle get_handle(const std::string &comp_name, const std::string &property, bool pipe_vector = false);
+    //! Copies the current values of the handle to values, which must hold handle.count values
+    void get_values(const wanda_engine_handle &handle, double *values);
+    //! Sets the current values of the handle from values, which must hold handle.count values
+    void set_values(const wanda_engine_handle &handle, const double *values);
+
     // TODO include get composition and get composition vector, do not know if it
     // is usefull?
     // std::vector<std::vector<double>> get_composition(std::string
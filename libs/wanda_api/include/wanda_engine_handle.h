@@ -0,0 +1,18 @@
+#ifndef _WANDA_ENGINE_HANDLE_
+#define _WANDA_ENGINE_HANDLE_
+
+//! Resolved handle of a property of a component in the Wanda engine
+/*!
+A handle avoids the look up of the component and property by name in every
+call, which matters when the same values are exchanged every time step.
+*/
+struct wanda_engine_handle
+{
+    int component = -999;
+    int property = -999;
+    //! number of values, number of elements + 1 for a pipe vector
+    int count = 1;
+    bool pipe_vector = false;
+};
+
+#endif
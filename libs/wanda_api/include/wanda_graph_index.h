@@ -0,0 +1,106 @@
+#ifndef _WANDA_GRAPH_INDEX_
+#define _WANDA_GRAPH_INDEX_
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_item;
+class wanda_component;
+class wanda_node;
+
+//!  Immutable compressed sparse row (CSR) index of the hydraulic network.
+/*!
+The wanda_graph_index gives every component and node of a wanda_model a dense
+integer id and stores the component-node connectivity in two CSR arrays:
+component -> nodes (one entry per connection point) and node -> components.
+The index is a snapshot, it is rebuilt by the wanda_model whenever the topology
+of the network has changed. Physical components get the ids 0 to
+get_number_of_physical_components() - 1, control components follow after them.
+*/
+class WANDAMODEL_API wanda_graph_index
+{
+  private:
+    std::vector<wanda_component *> _components;
+    std::vector<wanda_node *> _nodes;
+    std::unordered_map<const wanda_item *, int> _component_ids;
+    std::unordered_map<const wanda_item *, int> _node_ids;
+    int _number_of_physical_components = 0;
+    // component -> node, entry (con_point - 1) holds the node id or not_connected
+    std::vector<int> _comp_offsets;
+    std::vector<int> _comp_nodes;
+    // node -> component, with the connection point of the component for each entry
+    std::vector<int> _node_offsets;
+    std::vector<int> _node_comps;
+    std::vector<int> _node_con_points;
+
+  public:
+    //! value used in the adjacency arrays for a connection point without node
+    static constexpr int not_connected = -1;
+
+    ///@private
+    void build(std::unordered_map<std::string, wanda_component> &phys_components,
+               std::unordered_map<std::string, wanda_component> &ctrl_components,
+               std::unordered_map<std::string, wanda_node> &phys_nodes);
+    ///@private
+    void clear();
+    //! returns the number of components (physical and control) in the index
+    int get_number_of_components() const
+    {
+        return static_cast<int>(_components.size());
+    }
+    //! returns the number of physical components in the index
+    int get_number_of_physical_components() const
+    {
+        return _number_of_physical_components;
+    }
+    //! returns the number of nodes in the index
+    int get_number_of_nodes() const
+    {
+        return static_cast<int>(_nodes.size());
+    }
+    //! returns the id of the given component, or not_connected when it is not in the index
+    int get_component_id(const wanda_component &component) const;
+    //! returns the id of the given node, or not_connected when it is not in the index
+    int get_node_id(const wanda_node &node) const;
+    //! returns the component with the given id
+    wanda_component &get_component(int comp_id) const
+    {
+        return *_components[comp_id];
+    }
+    //! returns the node with the given id
+    wanda_node &get_node(int node_id) const
+    {
+        return *_nodes[node_id];
+    }
+    //! returns the node ids connected to the component, indexed by connection point - 1
+    std::span<const int> get_component_nodes(int comp_id) const
+    {
+        return {_comp_nodes.data() + _comp_offsets[comp_id],
+                static_cast<size_t>(_comp_offsets[comp_id + 1] - _comp_offsets[comp_id])};
+    }
+    //! returns the component ids connected to the node
+    std::span<const int> get_node_components(int node_id) const
+    {
+        return {_node_comps.data() + _node_offsets[node_id],
+                static_cast<size_t>(_node_offsets[node_id + 1] - _node_offsets[node_id])};
+    }
+    //! returns the connection points of the components connected to the node, parallel to get_node_components()
+    std::span<const int> get_node_con_points(int node_id) const
+    {
+        return {_node_con_points.data() + _node_offsets[node_id],
+                static_cast<size_t>(_node_offsets[node_id + 1] - _node_offsets[node_id])};
+    }
+    //! returns the first connection point of the component which is connected to the node
+    int get_connect_point(int comp_id, int node_id) const;
+};
+
+#endif
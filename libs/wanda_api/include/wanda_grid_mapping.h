@@ -0,0 +1,212 @@
+#ifndef _WANDA_GRID_MAPPING_
+#define _WANDA_GRID_MAPPING_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+
+//! Regular grid of the groundwater model in plan view
+/*!
+Cell (row, column) covers x from x_origin + column * cell_width and y from
+y_origin + row * cell_height, its index is row * columns + column.
+*/
+struct wanda_grid
+{
+    double x_origin = 0.0;
+    double y_origin = 0.0;
+    double cell_width = 1.0;
+    double cell_height = 1.0;
+    std::uint32_t columns = 0;
+    std::uint32_t rows = 0;
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(columns) * rows;
+    }
+};
+
+//! Route of a pipe, with the number of computational elements
+/*!
+The values of a pipe quantity are at the element boundaries, number of elements
++ 1 points equally spaced along the route. z is optional, when given the
+points are spaced along the length in 3D.
+*/
+struct wanda_pipe_path
+{
+    std::string name;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    int elements = 1;
+};
+
+//! Transformation of diagram positions to the coordinates of the grid, x = x_offset + x_scale * x_diagram
+struct wanda_diagram_transform
+{
+    double x_offset = 0.0;
+    double y_offset = 0.0;
+    double x_scale = 1.0;
+    double y_scale = 1.0;
+};
+
+//! returns the routes of all pipes in use, ordered by name like wanda_state_vector_layout
+/*!
+Pipes with geometry input "xyz" or "xyz dif" follow their Profile table. The
+other pipes run straight between the diagram positions of their nodes, mapped
+by transform. The number of elements is only known after the HCS are computed.
+*/
+WANDAMODEL_API std::vector<wanda_pipe_path> wanda_get_pipe_paths(wanda_model &model,
+                                                                 const wanda_diagram_transform &transform = {});
+
+//! Sparse matrix in compressed sparse row format
+/*!
+The weights are floats and the column indices 32 bit to keep large mappings
+small. When row_index is not empty, only the rows listed in it are stored and
+multiply() leaves the other rows of the result untouched.
+*/
+struct WANDAMODEL_API wanda_sparse_matrix
+{
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    //! start of every stored row in column and weight, one more than the number of stored rows
+    std::vector<std::size_t> row_start{0};
+    //! row of every stored row, empty when all rows are stored
+    std::vector<std::uint32_t> row_index;
+    std::vector<std::uint32_t> column;
+    std::vector<float> weight;
+
+    std::size_t get_number_of_values() const
+    {
+        return weight.size();
+    }
+    //! computes result = matrix * values for the stored rows
+    void multiply(std::span<const double> values, std::span<double> result) const;
+};
+
+//! How values at the pipe points are passed to the grid cells
+enum class wanda_grid_transfer
+{
+    //! every cell gets the length weighted average of the points in it, for pressures and heads
+    average,
+    //! every point divides its value over the cells along its part of the pipe, for leakage
+    /*!
+    The sum of the values over the grid equals the sum over the points, apart
+    from the parts of the pipes outside the grid.
+    */
+    conserve
+};
+
+//!  Precomputed mapping between the points of pipe quantities and the cells of a groundwater grid.
+/*!
+Every point of a pipe stands for the part of the route from halfway the
+previous point to halfway the next point. The routes are traced once through
+the grid, and the length of every such part in every cell it crosses gives
+the weights of two sparse matrices:
+- to_grid() passes values at the points to the cells crossed by the pipes,
+  see wanda_grid_transfer. Cells not crossed by any pipe are left untouched.
+- from_grid() gives every point the length weighted average of the cells
+  along its part of the pipe, e.g. the groundwater head. Points outside the
+  grid get 0.
+
+The points of all pipes are numbered after each other in the order of the
+paths, get_pipe_offset() gives the first point of a pipe.
+*/
+class WANDAMODEL_API wanda_grid_mapping
+{
+  public:
+    wanda_grid_mapping(const wanda_grid &grid, const std::vector<wanda_pipe_path> &paths,
+                       wanda_grid_transfer transfer = wanda_grid_transfer::average);
+    //! maps the pipes of the model, see wanda_get_pipe_paths()
+    wanda_grid_mapping(wanda_model &model, const wanda_grid &grid,
+                       wanda_grid_transfer transfer = wanda_grid_transfer::average,
+                       const wanda_diagram_transform &transform = {});
+
+    //! returns the number of points of all pipes
+    std::size_t get_number_of_points() const
+    {
+        return _pipe_offsets.back();
+    }
+    //! returns the index of the first point of the pipe with the given index in the paths
+    std::size_t get_pipe_offset(std::size_t pipe) const
+    {
+        return _pipe_offsets[pipe];
+    }
+    const wanda_sparse_matrix &get_to_grid_matrix() const
+    {
+        return _to_grid;
+    }
+    const wanda_sparse_matrix &get_from_grid_matrix() const
+    {
+        return _from_grid;
+    }
+
+    //! passes the values at all points to the cells, cells has a value for every cell of the grid
+    void to_grid(std::span<const double> points, std::span<double> cells) const;
+    //! sets the value at all points from the cells of the grid
+    void from_grid(std::span<const double> cells, std::span<double> points) const;
+
+  private:
+    wanda_grid _grid;
+    std::vector<std::size_t> _pipe_offsets{0};
+    wanda_sparse_matrix _to_grid;
+    wanda_sparse_matrix _from_grid;
+
+    void build(const std::vector<wanda_pipe_path> &paths, wanda_grid_transfer transfer);
+};
+
+//! Time average of values over a period, from samples at increasing times
+/*!
+Used to pass the result of the fine WANDA time steps to a stress period of the
+groundwater model. The samples are integrated with the trapezoidal rule.
+*/
+class WANDAMODEL_API wanda_time_averager
+{
+  public:
+    explicit wanda_time_averager(std::size_t size);
+
+    //! adds the values at the given time, which must be after the previous sample
+    void add(double time, std::span<const double> values);
+    //! adds the samples of a series of steps, values holds size() values per time
+    void add_series(std::span<const double> times, std::span<const double> values);
+    //! returns the average from the first to the last sample, or the only sample
+    void get_average(std::span<double> average) const;
+    //! starts a new period at the last sample
+    void restart();
+
+    std::size_t size() const
+    {
+        return _last.size();
+    }
+    double get_start_time() const
+    {
+        return _start_time;
+    }
+    double get_end_time() const
+    {
+        return _last_time;
+    }
+
+  private:
+    std::vector<double> _integral;
+    std::vector<double> _last;
+    double _start_time = 0.0;
+    double _last_time = 0.0;
+    bool _empty = true;
+};
+
+//! interpolates linearly in time between the values at time_0 and time_1, outside the interval the nearest values
+WANDAMODEL_API void wanda_interpolate_in_time(double time_0, std::span<const double> values_0, double time_1,
+                                              std::span<const double> values_1, double time,
+                                              std::span<double> result);
+
+#endif
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <vector>
 #include <wanda_diagram_lines.h>
+#include <wanda_keyword_index.h>
 
 #ifdef WANDAMODEL_EXPORT
 // #define WANDAMODEL_API __declspec(dllexport)
@@ -108,6 +109,14 @@ class WANDAMODEL_API wanda_item
     ///@private
     int *num_of_species = nullptr;
     std::vector<wanda_diagram_lines*> lines_info;
+    ///@private
+    keyword_index_link _keyword_link;
+    friend class wanda_keyword_index;
+    // the model renames items, so its name index stays up to date, see
+    // wanda_model::change_component_name() and wanda_model::change_node_name()
+    friend class wanda_model;
+    ///@private
+    virtual void set_name(std::string name);
   public:
     ///@private
     std::unordered_map<std::string, wanda_property>::iterator begin() noexcept
@@ -163,8 +172,6 @@ class WANDAMODEL_API wanda_item
         return _item_type;
     }
     ///@private
-    virtual void set_name(std::string name);
-    ///@private
     virtual void set_class_name(const std::string &class_name)
     {
         _class_name = class_name;
@@ -215,10 +222,7 @@ class WANDAMODEL_API wanda_item
     */
     virtual void remove_keyword(std::string keyword);
     //! clears the keywords of the component
-    virtual void clear_keywords()
-    {
-        _keywords.clear();
-    }
+    virtual void clear_keywords();
     ///@private
     virtual bool is_modified() const;
     ///@private
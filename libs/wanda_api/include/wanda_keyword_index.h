@@ -0,0 +1,84 @@
+#ifndef _WANDA_KEYWORD_INDEX_
+#define _WANDA_KEYWORD_INDEX_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_item;
+class wanda_keyword_index;
+
+///@private
+// Link from an item to the keyword index it is registered in. A copy of an item
+// is not registered, so copying the link always results in an empty link.
+struct keyword_index_link
+{
+    wanda_keyword_index *index = nullptr;
+    int item_id = -1;
+    keyword_index_link() = default;
+    keyword_index_link(const keyword_index_link &)
+    {
+    }
+    keyword_index_link &operator=(const keyword_index_link &)
+    {
+        index = nullptr;
+        item_id = -1;
+        return *this;
+    }
+};
+
+//!  Inverted index from keyword to the items which have that keyword.
+/*!
+The keywords are interned, every keyword gets an integer id and has a sorted
+list of the ids of the items carrying it. The index is kept up to date by
+wanda_item::add_keyword(), wanda_item::remove_keyword() and
+wanda_item::clear_keywords(). When items are added to or removed from the model
+the index is invalidated and rebuilt by the wanda_model on the next query.
+*/
+class WANDAMODEL_API wanda_keyword_index
+{
+  private:
+    std::unordered_map<std::string, int> _keyword_ids;
+    std::vector<std::string> _keywords;
+    std::vector<std::vector<int>> _postings; // sorted item ids per keyword id
+    std::vector<wanda_item *> _items;
+    bool _valid = false;
+    const std::vector<int> *get_posting(const std::string &keyword) const;
+
+  public:
+    ///@private
+    bool is_valid() const
+    {
+        return _valid;
+    }
+    ///@private
+    void invalidate();
+    ///@private
+    void register_item(wanda_item &item);
+    ///@private
+    void set_valid()
+    {
+        _valid = true;
+    }
+    ///@private
+    void add(const keyword_index_link &link, const std::string &keyword);
+    ///@private
+    void remove(const keyword_index_link &link, const std::string &keyword);
+    //! returns the items which have the given keyword, in registration order
+    std::vector<wanda_item *> find(const std::string &keyword) const;
+    //! returns the items which have all given keywords (AND query)
+    std::vector<wanda_item *> find_all(const std::vector<std::string> &keywords) const;
+    //! returns the items which have at least one of the given keywords (OR query)
+    std::vector<wanda_item *> find_any(const std::vector<std::string> &keywords) const;
+    //! returns all keywords which are used by at least one item, sorted alphabetically
+    std::vector<std::string> get_keywords() const;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef _WANDA_METRICS_
+#define _WANDA_METRICS_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+//! Monotonic counter of a metric
+class WANDAMODEL_API wanda_metric_counter
+{
+  public:
+    void add(std::uint64_t value = 1) noexcept
+    {
+        _value.fetch_add(value, std::memory_order_relaxed);
+    }
+    std::uint64_t get() const noexcept
+    {
+        return _value.load(std::memory_order_relaxed);
+    }
+    void reset() noexcept
+    {
+        _value.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::uint64_t> _value{0};
+};
+
+//! Histogram of durations, with buckets of 1, 2.5 and 5 per decade from 1 microsecond to 500 seconds
+class WANDAMODEL_API wanda_metric_histogram
+{
+  public:
+    constexpr static std::size_t number_of_buckets = 28;
+    //! upper bounds of the buckets in seconds, the last bucket has no upper bound
+    static const std::array<double, number_of_buckets - 1> bounds;
+
+    void observe(std::chrono::duration<double> duration) noexcept;
+    std::uint64_t get_count() const noexcept
+    {
+        return _count.load(std::memory_order_relaxed);
+    }
+    //! returns the sum of all observed durations in seconds
+    double get_sum() const noexcept
+    {
+        return static_cast<double>(_sum_ns.load(std::memory_order_relaxed)) * 1e-9;
+    }
+    //! returns the number of durations in the bucket, not cumulative
+    std::uint64_t get_bucket(std::size_t bucket) const noexcept
+    {
+        return _buckets[bucket].load(std::memory_order_relaxed);
+    }
+    void reset() noexcept;
+
+  private:
+    std::array<std::atomic<std::uint64_t>, number_of_buckets> _buckets{};
+    std::atomic<std::uint64_t> _count{0};
+    std::atomic<std::uint64_t> _sum_ns{0};
+};
+
+//!  Registry of the runtime metrics of the API, exported as Prometheus text
+/*!
+Metrics are identified by their name and their labels, in Prometheus syntax,
+e.g. counter("wanda_nefis_calls_total", "group=\"OUTP_H\""). The API counts:
+- wanda_nefis_calls_total, wanda_nefis_bytes_total: per NEFIS group
+- wanda_nefis_call_seconds: latency of NEFIS reads and writes
+- wanda_engine_calls_total, wanda_engine_call_seconds: per function of the engine DLL
+- wanda_output_cache_hits_total, wanda_output_cache_misses_total: output of a property
+  read from the cache of its WDO postfix or loaded from the file
+- wanda_output_load_seconds: loading the output of one postfix
+- wanda_output_allocations_total, wanda_output_allocated_bytes_total: allocations of
+  the output buffers, counted from the capacity of the vectors when they are sized
+- wanda_solver_seconds: wall time of the solver processes, per result
+
+Counting only happens while the metrics are enabled, disabled it costs one
+relaxed atomic load. The references returned by counter() and histogram() stay
+valid until the process ends, so hot paths look them up once.
+*/
+class WANDAMODEL_API wanda_metrics
+{
+  public:
+    static void enable() noexcept;
+    static void disable() noexcept;
+    static bool is_enabled() noexcept
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    //! returns the counter, created at the first call
+    static wanda_metric_counter &counter(const std::string &name, const std::string &labels = "");
+    //! returns the histogram, created at the first call
+    static wanda_metric_histogram &histogram(const std::string &name, const std::string &labels = "");
+    //! returns the value of the counter, 0 when it does not exist
+    static std::uint64_t get_counter(const std::string &name, const std::string &labels = "");
+    //! sets all counters and histograms to 0
+    static void reset();
+
+    //! writes all metrics in the Prometheus text exposition format
+    static void write_prometheus(std::ostream &stream);
+    //! writes the metrics to a temporary file which then replaces file, so readers never see a partial file
+    static void write_prometheus(const std::string &file);
+
+  private:
+    static std::atomic<bool> _enabled;
+};
+
+//! Observes the time from construction to destruction in a histogram, when the metrics are enabled
+class wanda_metric_timer
+{
+  public:
+    explicit wanda_metric_timer(wanda_metric_histogram &histogram) noexcept
+    {
+        if (wanda_metrics::is_enabled())
+        {
+            _histogram = &histogram;
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+    ~wanda_metric_timer()
+    {
+        if (_histogram != nullptr)
+        {
+            _histogram->observe(std::chrono::steady_clock::now() - _start);
+        }
+    }
+    wanda_metric_timer(const wanda_metric_timer &) = delete;
+    wanda_metric_timer &operator=(const wanda_metric_timer &) = delete;
+
+  private:
+    wanda_metric_histogram *_histogram = nullptr;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#endif
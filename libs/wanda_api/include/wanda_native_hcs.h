@@ -0,0 +1,60 @@
+#ifndef _WANDA_NATIVE_HCS_
+#define _WANDA_NATIVE_HCS_
+
+#include <span>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+//! Implementation used to compute the hydraulic component specifications
+enum class wanda_hcs_backend
+{
+    //! Component64.dll when it is available, the native implementation for supported pipes otherwise
+    automatic,
+    //! the native implementation for supported pipes, Component64.dll for the other components
+    native,
+    //! always Component64.dll
+    component_dll
+};
+
+//! namespace with the native implementation of the hydraulic component specifications (HCS) of pipes
+/*!
+The functions work on arrays with one value per pipe, so the HCS of many pipes
+are computed in one loop which the compiler can vectorize. They have no
+dependency on Component64.dll and are also available on Linux.
+*/
+namespace wanda_native_hcs
+{
+//! value of an HCS which could not be computed, same as the component dll
+constexpr float not_computed = -1e30f;
+
+//! returns the length along a profile given as X-distance and Height, geometry input "l-h"
+WANDAMODEL_API float profile_length(std::span<const float> distance, std::span<const float> height);
+//! returns the length along a profile given as absolute coordinates, geometry input "xyz"
+WANDAMODEL_API float profile_length(std::span<const float> x, std::span<const float> y, std::span<const float> z);
+//! returns the length along a profile given as differences between the points, geometry input "xyz dif"
+/*!
+The first row holds the start point and does not add to the length.
+*/
+WANDAMODEL_API float profile_length_from_differences(std::span<const float> x_diff, std::span<const float> y_diff,
+                                                     std::span<const float> z_diff);
+
+//! computes the number of elements of pipes
+/*!
+The number of elements is the travel time of a pressure wave through the pipe
+divided by the time step, rounded to the nearest integer and at least 1. Pipes
+with a wave speed or length which is not positive get not_computed.
+\param length length of every pipe
+\param wave_speed wave speed of every pipe
+\param time_step time step of the computation
+\param element_count output, number of elements of every pipe
+*/
+WANDAMODEL_API void compute_pipe_element_count(std::span<const float> length, std::span<const float> wave_speed,
+                                               float time_step, std::span<float> element_count);
+} // namespace wanda_native_hcs
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef _WANDA_OUTPUT_READER_
+#define _WANDA_OUTPUT_READER_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+
+//! Output quantity of one component or node, read by wanda_output_reader
+struct wanda_output_column
+{
+    //! complete name of the component or node, e.g. "PIPE P1"
+    std::string item;
+    //! description of the property
+    std::string quantity;
+    //! unit of the case the values are converted to, empty when the quantity has no unit
+    std::string unit;
+    //! factor from the SI values of the output file to unit
+    float unit_factor = 1.0f;
+    ///@private
+    std::string wdo_postfix;
+    ///@private
+    int first_value = 0;
+    //! number of values per step, number of elements + 1 for pipes and 1 otherwise
+    int number_of_values = 1;
+};
+
+//!  Reads the output of selected quantities in blocks of time steps
+/*!
+The reader reads straight from the output file of the model, a block of steps
+of one column at a time, without loading the output into the cache of the
+model. Exporting large results then only needs memory for one block.
+
+The values are in the units of the case at the time the column is added;
+switch the model to SI units first for SI values. The output file is read
+through the model, so the model must not change or run while reading.
+*/
+class WANDAMODEL_API wanda_output_reader
+{
+  public:
+    //! reads the output of model, throws when the model has no output
+    explicit wanda_output_reader(wanda_model &model);
+
+    //! adds a quantity with a series of a component or node, with all elements of pipes
+    const wanda_output_column &add(const std::string &item, const std::string &property);
+    const std::vector<wanda_output_column> &get_columns() const
+    {
+        return _columns;
+    }
+    //! returns the times of the output steps
+    const std::vector<double> &get_times() const
+    {
+        return _times;
+    }
+    int get_number_of_steps() const
+    {
+        return static_cast<int>(_times.size());
+    }
+    //! returns the number of steps of a block of the column holding at most max_values values, at least 1
+    int get_steps_per_block(std::size_t column, std::size_t max_values) const;
+    //! reads steps first_step to first_step + steps of a column
+    /*!
+    \param column index of the column in get_columns()
+    \param values replaced by number_of_values values per step, step after step
+    */
+    void read(std::size_t column, int first_step, int steps, std::vector<float> &values) const;
+
+  private:
+    wanda_model &_model;
+    std::vector<wanda_output_column> _columns;
+    std::vector<double> _times;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef _WANDA_SOLVER_PROCESS_
+#define _WANDA_SOLVER_PROCESS_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+//! Result of a finished solver process
+struct wanda_solver_result
+{
+    int exit_code = -1;
+    bool cancelled = false;
+    bool timed_out = false;
+    std::string output; // captured stdout
+    std::string error;  // captured stderr
+    std::chrono::duration<double> wall_time{0.0};
+
+    //! returns true when the process ran to the end with exit code 0
+    bool succeeded() const
+    {
+        return !cancelled && !timed_out && exit_code == 0;
+    }
+};
+
+//! Options for starting a solver process
+struct wanda_solver_options
+{
+    //! wall clock limit, the process is killed when it runs longer. Zero means no limit
+    std::chrono::milliseconds timeout{0};
+    //! capture stdout and stderr in the result, otherwise they are discarded
+    bool capture_output = true;
+    //! working directory of the process, empty for the current directory
+    std::string working_directory;
+    //! called from the monitoring thread when the process has finished, was cancelled or timed out,
+    //! before the result is available to waiting threads
+    std::function<void(const wanda_solver_result &)> on_finished;
+};
+
+//!  Handle of a running solver process.
+/*!
+A wanda_solver_job is returned by launch(), which starts the executable and
+returns immediately. A monitoring thread captures the output of the process,
+enforces the timeout and publishes the result. The job can be waited on,
+polled or cancelled from any thread. Destroying the last handle of a running
+job cancels it and waits for the monitoring thread. While the completion
+callback runs the monitoring thread holds a handle itself, so the callback may
+release the last handle of the job.
+
+On Windows the process is started with CreateProcess, on other platforms with
+posix_spawn.
+*/
+class WANDAMODEL_API wanda_solver_job
+{
+  public:
+    //! starts the executable with the given arguments
+    /*!
+    \param executable path of the executable
+    \param arguments arguments, quoted where needed by the launcher
+    \param options timeout, output capture and completion callback
+    */
+    static std::shared_ptr<wanda_solver_job> launch(const std::string &executable,
+                                                    const std::vector<std::string> &arguments,
+                                                    wanda_solver_options options = {});
+
+    wanda_solver_job(const wanda_solver_job &) = delete;
+    wanda_solver_job &operator=(const wanda_solver_job &) = delete;
+    ~wanda_solver_job();
+
+    //! requests the process to stop, the result is marked as cancelled
+    void cancel();
+    //! returns true when the process has finished and the result is available
+    bool is_finished() const;
+    //! waits until the process has finished and returns its result
+    const wanda_solver_result &wait();
+    //! waits at most the given time, returns true when the process has finished
+    bool wait_for(std::chrono::milliseconds duration);
+    //! future which becomes ready when the process has finished
+    std::shared_future<wanda_solver_result> get_future() const
+    {
+        return _future;
+    }
+    //! command line of the process, for messages
+    const std::string &get_command_line() const
+    {
+        return _command_line;
+    }
+
+  private:
+    wanda_solver_job() = default;
+    void start(const std::string &executable, const std::vector<std::string> &arguments);
+    void monitor(std::weak_ptr<wanda_solver_job> self);
+    void finish(wanda_solver_result result, const std::weak_ptr<wanda_solver_job> &self);
+
+    wanda_solver_options _options;
+    std::string _command_line;
+    std::atomic<bool> _cancel_requested{false};
+    std::atomic<bool> _finished{false};
+    std::promise<wanda_solver_result> _promise;
+    std::shared_future<wanda_solver_result> _future;
+    std::thread _monitor;
+    //! guards _monitor between launch() and the monitoring thread
+    std::mutex _monitor_mutex;
+    std::chrono::steady_clock::time_point _start_time;
+#ifdef _WIN32
+    void *_process = nullptr;
+    void *_output_pipe = nullptr;
+    void *_error_pipe = nullptr;
+#else
+    int _pid = -1;
+    int _output_pipe = -1;
+    int _error_pipe = -1;
+#endif
+};
+
+#endif
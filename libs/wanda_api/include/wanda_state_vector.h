@@ -0,0 +1,133 @@
+#ifndef _WANDA_STATE_VECTOR_
+#define _WANDA_STATE_VECTOR_
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wanda_engine_handle.h>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+class wanda_engine;
+
+//! Quantities which form the state of a model
+struct wanda_state_vector_spec
+{
+    //! quantities of every pipe, with a value for every element
+    std::vector<std::string> pipe_quantities{"Pressure", "Discharge"};
+    //! quantities of every node
+    std::vector<std::string> node_quantities{"Head"};
+    //! quantities of the other components per class sort key, e.g. the position of valves
+    std::unordered_map<std::string, std::vector<std::string>> component_quantities;
+};
+
+//! Place of one quantity in the state vector
+struct wanda_state_entry
+{
+    //! complete name of the component or node
+    std::string item;
+    std::string property;
+    //! index of the first value in the state vector
+    std::size_t offset = 0;
+    //! number of values, number of elements + 1 for pipes
+    std::size_t count = 1;
+    bool pipe_vector = false;
+};
+
+//!  Layout of the complete state of a model in one contiguous vector.
+/*!
+The layout is built once from the model graph and assigns an offset to every
+state quantity: the quantities of the pipes along all their elements, of the
+nodes and of the selected components, ordered by the name of the item. Models
+of the same case get the same layout, so the layout can be shared by all
+members of an ensemble.
+
+The state of a member is then gathered from, or scattered to, a contiguous
+double array supplied by the caller in one pass, without looking up items or
+properties by name:
+- gather_output() copies the values at a time step of the loaded output, the
+  places in the output are resolved by bind_output().
+- gather_engine() and scatter_engine() exchange the current values with the
+  Wanda engine, the engine handles are resolved by bind_engine().
+
+The engine can only set scalar values, so scatter_engine() refuses a layout
+with pipe quantities; leave pipe_quantities of the spec empty for a state that
+is scattered back.
+*/
+class WANDAMODEL_API wanda_state_vector_layout
+{
+  public:
+    //! builds the layout from the pipes, nodes and components of the model
+    wanda_state_vector_layout(wanda_model &model, const wanda_state_vector_spec &spec = {});
+    //! builds the layout of the given quantities in the given order, the offsets are assigned here
+    explicit wanda_state_vector_layout(const std::vector<wanda_state_entry> &quantities);
+    wanda_state_vector_layout(const wanda_state_vector_layout &) = delete;
+    wanda_state_vector_layout &operator=(const wanda_state_vector_layout &) = delete;
+    ~wanda_state_vector_layout();
+
+    //! returns the number of values in the state vector
+    std::size_t size() const
+    {
+        return _size;
+    }
+    const std::vector<wanda_state_entry> &get_entries() const
+    {
+        return _entries;
+    }
+    //! returns the entry of a quantity, throws when the quantity is not part of the state
+    const wanda_state_entry &get_entry(const std::string &item, const std::string &property) const;
+    //! returns true when the state contains pipe quantities, which can't be scattered to the engine
+    bool has_pipe_quantities() const;
+
+    //! resolves the places of the state in the output of the model
+    /*!
+    Must be called again after the output is reloaded, e.g. after a run.
+    */
+    void bind_output(wanda_model &model);
+    //! binds the series of every value of the state, in the order of the state vector
+    /*!
+    The series must stay valid until the next bind, bind_output(model) binds
+    the series of the output cache of the model.
+    */
+    void bind_output(const std::vector<std::span<const float>> &series);
+    //! returns the number of time steps in the bound output
+    std::size_t get_number_of_time_steps() const
+    {
+        return _number_of_time_steps;
+    }
+    //! copies the state at the given time step of the bound output into state
+    void gather_output(std::size_t time_step, std::span<double> state) const;
+
+    //! resolves the engine handles of the state, the engine must be initialized
+    void bind_engine(wanda_engine &engine);
+    //! copies the current state of the bound engine into state
+    void gather_engine(std::span<double> state);
+    //! sets the quantities of the bound engine from state
+    /*!
+    Throws std::invalid_argument when the state has pipe quantities, before
+    any value is set.
+    */
+    void scatter_engine(std::span<const double> state);
+
+  private:
+    std::vector<wanda_state_entry> _entries;
+    std::size_t _size = 0;
+    // output: start of the series of every value of the state
+    std::vector<const float *> _output_sources;
+    std::size_t _number_of_time_steps = 0;
+    // engine: one handle per entry
+    wanda_engine *_engine = nullptr;
+    std::vector<wanda_engine_handle> _handles;
+
+    void add_entry(const std::string &item, const std::string &property, std::size_t count, bool pipe_vector);
+    void check_size(std::size_t size) const;
+};
+
+#endif
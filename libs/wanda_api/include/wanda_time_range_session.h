@@ -0,0 +1,171 @@
+#ifndef _WANDA_TIME_RANGE_SESSION_
+#define _WANDA_TIME_RANGE_SESSION_
+
+#include <span>
+#include <string>
+#include <vector>
+#include <wanda_engine_handle.h>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+class wanda_model;
+class wanda_engine;
+
+//! Quantity returned for every time step of a window
+struct wanda_session_subscription
+{
+    //! complete name of the component, e.g. "PIPE P1"
+    std::string component;
+    //! description of the property
+    std::string property;
+    //! true to return the values of all elements of a pipe instead of one value
+    bool pipe_vector = false;
+};
+
+//! Output of one call to wanda_time_range_session::advance_to
+struct wanda_time_window
+{
+    //! times of the steps in the window
+    std::vector<double> times;
+    //! per subscription the values of all steps after each other, width values per step
+    std::vector<std::vector<double>> values;
+    //! per subscription the number of values per step, number of elements + 1 for pipe vectors
+    std::vector<int> widths;
+};
+
+//! Range of output steps which belong to a window, from first up to but not including last
+struct wanda_window_steps
+{
+    size_t first = 0;
+    size_t last = 0;
+};
+
+//! returns the steps of the output with a time after current_time and not after end_time
+/*!
+Used without the engine, where the output of a restarted run also holds the
+step at which it restarted. The times are compared in single precision, like
+they are stored in the output.
+*/
+WANDAMODEL_API wanda_window_steps get_window_steps(std::span<const float> times, double current_time,
+                                                   double end_time);
+
+//! How a wanda_time_range_session advances the simulation
+enum class wanda_session_mode
+{
+    //! use the engine when WandaEngine_native64.dll can be loaded, otherwise the case files
+    automatic,
+    //! keep the simulation in memory in the Wanda engine
+    engine,
+    //! restart unsteady.exe for every window through wanda_model::run_unsteady_window
+    files
+};
+
+//!  Advances a transient simulation window by window.
+/*!
+A wanda_time_range_session is meant for couplings which run a simulation in
+consecutive time windows, like OpenDA. With the engine the solver state stays
+in memory: steady is computed once when the session starts and every
+advance_to() computes only the time steps of the new window, no case files are
+rewritten and no output is reloaded. Only the subscribed quantities of the new
+window are returned.
+
+Without the engine every window is computed with run_unsteady_window() and
+the window is cut from the reloaded output, which is as slow as before but gives
+the same interface.
+
+The Wanda engine can only run one model at a time, so there can only be one
+session in engine mode at the time. The model must not be changed or run
+while the session is active.
+*/
+class WANDAMODEL_API wanda_time_range_session
+{
+  public:
+    //! starts a session on the given model
+    /*!
+    Saves modified input and, in engine mode, computes steady.
+    \param model model to simulate
+    \param subscriptions quantities to return for every window
+    \param mode engine, case files or automatic selection
+    */
+    wanda_time_range_session(wanda_model &model, std::vector<wanda_session_subscription> subscriptions,
+                             wanda_session_mode mode = wanda_session_mode::automatic);
+    wanda_time_range_session(const wanda_time_range_session &) = delete;
+    wanda_time_range_session &operator=(const wanda_time_range_session &) = delete;
+    //! finalizes the engine, which closes the case files correctly
+    ~wanda_time_range_session();
+
+    //! computes the time steps up to and including end_time and returns their output
+    wanda_time_window advance_to(double end_time);
+    //! sets a value in the running simulation
+    /*!
+    In engine mode the value is set directly in the solver. Without the engine
+    the input property of the component is changed and saved before the next
+    window is computed.
+    */
+    void set_value(const std::string &component, const std::string &property, double value);
+    //! returns the time of the last computed step
+    double get_current_time() const
+    {
+        return _current_time;
+    }
+    //! returns the time at which the session started
+    double get_start_time() const
+    {
+        return _start_time;
+    }
+    //! returns the end time of the simulation
+    double get_end_time() const
+    {
+        return _end_time;
+    }
+    //! resolves a quantity once for repeated access with get_item_values and set_item_values
+    /*!
+    In engine mode the quantity is resolved to an engine handle, otherwise to
+    the wanda_property of the model.
+    \return index of the item
+    */
+    size_t resolve_item(const wanda_session_subscription &quantity);
+    //! returns the number of values of a resolved item
+    size_t get_item_size(size_t item) const;
+    //! copies the values of a resolved item at the current time into values
+    /*!
+    Without the engine the last computed output is returned, or the input
+    value for input properties.
+    */
+    void get_item_values(size_t item, std::span<double> values);
+    //! sets the values of a resolved item, see set_value
+    void set_item_values(size_t item, std::span<const double> values);
+    //! returns true when the session keeps the simulation in the Wanda engine
+    bool uses_engine() const
+    {
+        return _engine != nullptr;
+    }
+    //! returns the engine of the session, nullptr without the engine
+    wanda_engine *get_engine() const
+    {
+        return _engine;
+    }
+
+  private:
+    wanda_model &_model;
+    std::vector<wanda_session_subscription> _subscriptions;
+    // engine handles of the subscriptions, only in engine mode
+    std::vector<wanda_engine_handle> _subscription_handles;
+    wanda_engine *_engine = nullptr;
+    double _start_time = 0.0;
+    double _current_time = 0.0;
+    double _end_time = 0.0;
+    struct resolved_item;
+    std::vector<resolved_item> _items;
+
+    wanda_time_window create_window() const;
+    wanda_time_window advance_engine(double end_time);
+    wanda_time_window advance_files(double end_time);
+};
+
+#endif
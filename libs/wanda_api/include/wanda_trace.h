@@ -0,0 +1,124 @@
+#ifndef _WANDA_TRACE_
+#define _WANDA_TRACE_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifdef WANDAMODEL_EXPORT
+// #define WANDAMODEL_API __declspec(dllexport)
+#define WANDAMODEL_API
+#else
+#define WANDAMODEL_API __declspec(dllimport)
+#endif
+
+//! Number of NEFIS element and attribute calls and the bytes they moved
+struct wanda_nefis_counters
+{
+    std::uint64_t calls = 0;
+    std::uint64_t bytes = 0;
+};
+
+//!  Tracing of the hot paths of the API, exported as Chrome trace JSON
+/*!
+The API marks its expensive operations with WANDA_TRACE_SCOPE, e.g. initialize,
+reload_output, save_model_input, the solver runs and the solver processes
+themselves. While tracing is disabled a span costs one relaxed atomic load.
+
+Every thread records into its own buffer of fixed size, without locks. When a
+buffer is full later spans of that thread are dropped and counted. Every span
+has the NEFIS calls and bytes of its thread during the span as arguments.
+
+write_chrome_trace() writes the spans of all threads in the Chrome trace event
+format, which chrome://tracing and ui.perfetto.dev open. Exporting while other
+threads record is safe, spans still open are not included.
+
+Define WANDA_TRACE_DISABLED to compile the spans out completely.
+*/
+class WANDAMODEL_API wanda_trace
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    //! starts recording, every thread records at most events_per_thread spans
+    static void enable(std::size_t events_per_thread = 65536);
+    //! stops recording, the spans recorded so far are kept
+    static void disable() noexcept;
+    static bool is_enabled() noexcept
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+    //! discards the recorded spans of all threads
+    static void clear();
+
+    //! records a finished span on the calling thread
+    /*!
+    name and category are not copied, they must be string literals or live as
+    long as the trace.
+    */
+    static void record(const char *name, const char *category, clock::time_point begin, clock::time_point end,
+                       const wanda_nefis_counters &nefis = {}) noexcept;
+    //! counts a NEFIS call of the calling thread which moves the given number of bytes
+    static void count_nefis(std::uint64_t bytes) noexcept;
+    //! returns the NEFIS calls of the calling thread counted while tracing was enabled
+    static wanda_nefis_counters get_nefis_counters() noexcept;
+
+    //! returns the number of spans recorded and not dropped
+    static std::size_t get_number_of_events();
+    //! returns the number of spans dropped because the buffer of their thread was full
+    static std::size_t get_dropped_events();
+
+    //! writes all recorded spans in the Chrome trace event format
+    static void write_chrome_trace(std::ostream &stream);
+    static void write_chrome_trace(const std::string &file);
+
+  private:
+    static std::atomic<bool> _enabled;
+};
+
+//! Scoped span, recorded when it goes out of scope while tracing is enabled
+class wanda_trace_span
+{
+  public:
+    explicit wanda_trace_span(const char *name, const char *category = "wanda_api") noexcept
+    {
+        if (wanda_trace::is_enabled())
+        {
+            _name = name;
+            _category = category;
+            _nefis = wanda_trace::get_nefis_counters();
+            _begin = wanda_trace::clock::now();
+        }
+    }
+    ~wanda_trace_span()
+    {
+        if (_name != nullptr)
+        {
+            auto end = wanda_trace::clock::now();
+            auto nefis = wanda_trace::get_nefis_counters();
+            wanda_trace::record(_name, _category, _begin, end,
+                                {nefis.calls - _nefis.calls, nefis.bytes - _nefis.bytes});
+        }
+    }
+    wanda_trace_span(const wanda_trace_span &) = delete;
+    wanda_trace_span &operator=(const wanda_trace_span &) = delete;
+
+  private:
+    const char *_name = nullptr;
+    const char *_category = nullptr;
+    wanda_trace::clock::time_point _begin;
+    wanda_nefis_counters _nefis;
+};
+
+#define WANDA_TRACE_CONCAT_(a, b) a##b
+#define WANDA_TRACE_CONCAT(a, b) WANDA_TRACE_CONCAT_(a, b)
+#ifdef WANDA_TRACE_DISABLED
+#define WANDA_TRACE_SCOPE(name)
+#else
+//! traces the rest of the enclosing scope under the given name
+#define WANDA_TRACE_SCOPE(name) wanda_trace_span WANDA_TRACE_CONCAT(wanda_trace_span_, __LINE__)(name)
+#endif
+
+#endif
@@ -139,18 +139,6 @@ class WANDAMODEL_API wanda_component : public wanda_item
     void fill_sensor_list(wanda_component comp, int con_point);
     /// @private
     void fill_sensor_list(wanda_node const node);
-    /// @private
-    void connect(wanda_node &node, int connection_point);
-    /// @private
-    void connect(wanda_sig_line &sig_line, int connection_point, bool is_input);
-    /// @private
-    void disconnect(int connection_point);
-    /// @private
-    void disconnect(wanda_node &node);
-    /// @private
-    void disconnect(wanda_sig_line &node);
-    ///@private
-    void disconnect(int connection_point, bool input);
     //! Returns true when a node is connected to the given connection point
     //! otherwise false is returned
     /*!
@@ -265,12 +253,32 @@ class WANDAMODEL_API wanda_component : public wanda_item
     {
         return !hcs_error.empty();
     }
+    ///@private
+    // hash of the inputs of the last HCS computation, 0 when it has not been computed
+    std::size_t get_hcs_input_hash() const
+    {
+        return _hcs_input_hash;
+    }
+    ///@private
+    void set_hcs_input_hash(std::size_t hash)
+    {
+        _hcs_input_hash = hash;
+    }
     std::size_t wnd_get_hash()
     {
         return _object_hash;
     }
 
   private:
+    // the topology only changes through the model, which keeps its graph index up to date,
+    // see wanda_model::connect() and wanda_model::disconnect()
+    friend class wanda_model;
+    void connect(wanda_node &node, int connection_point);
+    void connect(wanda_sig_line &sig_line, int connection_point, bool is_input);
+    void disconnect(int connection_point);
+    void disconnect(wanda_node &node);
+    void disconnect(wanda_sig_line &node);
+    void disconnect(int connection_point, bool input);
     const static std::string _object_name;
     const std::size_t _object_hash;
     void initialize();
@@ -296,5 +304,6 @@ class WANDAMODEL_API wanda_component : public wanda_item
     bool _is_flipped = false;
     wanda_def *_component_definition = nullptr;
     std::string hcs_error = "";
+    std::size_t _hcs_input_hash = 0;
 };
 #endif
@@ -1,9 +1,12 @@
 #ifndef _WANDADEF_
 #define _WANDADEF_
 
+#include <memory>
+#include <mutex>
 #include <nefis_file.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <wanda_def_snapshot.h>
 #include <wandacomponent.h>
 #include <wandanode.h>
 #include <wandaproperty.h>
@@ -19,22 +22,68 @@ struct wanda_tab_info
     std::vector<int> max_points_req;
 };
 
+//! Map from property description to the property, as defined for a class sort key
+using wanda_property_map = std::unordered_map<std::string, wanda_property>;
+
+//! Definition of a component or node class as read from the Wanda definition file.
+/*!
+A wanda_class_definition is built once per class sort key by wanda_def::get_class_definition()
+and is shared, read only, by all components and nodes of that class. Items copy the property
+map to get their own values, the descriptive data of the properties stays shared.
+*/
+struct wanda_class_definition
+{
+    std::string class_sort_key;
+    std::shared_ptr<const wanda_property_map> properties;
+    std::vector<int> num_input_props;
+    std::vector<std::string> core_quants;
+    int number_of_con_points = 0;
+    bool controlable = false;
+    std::string ctrl_input_type;
+    std::string node_type;
+    int num_input_channels = 0;
+    int num_output_channels = 0;
+    std::vector<int> min_input_channels;
+    std::vector<int> max_input_channels;
+    std::vector<std::string> input_channel_type;
+    std::vector<std::string> output_channel_type;
+};
+
+//! Definitions of all component, node and control classes read from WandaDef.dat.
+/*!
+A wanda_def is safe to use from several threads, all access to the definition
+file and the lazily built caches is serialized. Use get_shared() to obtain the
+definition of a Wanda bin directory, it is loaded only once per process and
+shared by all models using that bin directory.
+*/
 class wanda_def
 {
   public:
     //    wanda_def();
     wanda_def(std::string data_path);
+    //! Loads the definition, with record_snapshot all reads are kept so they can be saved with save_snapshot()
+    wanda_def(std::string data_path, bool record_snapshot);
     ~wanda_def();
+    wanda_def(const wanda_def &) = delete;
+    wanda_def &operator=(const wanda_def &) = delete;
+    //! Returns the definition of the given Wanda bin directory, shared with all other users in the process
+    /*!
+    The definition stays loaded as long as it is referenced. When WandaDef.dat has
+    been replaced since it was loaded, for example by a different Wanda version, a
+    new definition is loaded, existing users keep the definition they have.
+    */
+    static std::shared_ptr<wanda_def> get_shared(const std::string &data_path);
     wanda_component *get_component(std::string classsort_key);
     wanda_node *get_node(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_physical_input_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_physical_calc_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_physical_output_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_control_input_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_control_output_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_node_input_properties(std::string classsort_key);
-    std::unordered_map<std::string, wanda_property> get_node_output_properties(std::string classsort_key);
+    std::shared_ptr<const wanda_class_definition> get_class_definition(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_physical_input_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_physical_calc_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_physical_output_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_control_input_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_control_output_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_node_input_properties(const std::string &classsort_key);
+    std::shared_ptr<const wanda_property_map> get_node_output_properties(const std::string &classsort_key);
     std::string get_name_prefix_phys_comp(std::string classsort_key);
     std::string get_name_prefix_phys_node(std::string classsort_key);
     std::string get_name_prefix_ctrl_comp(std::string classsort_key);
@@ -89,10 +138,17 @@ class wanda_def
     std::vector<std::string> get_possible_node_type();
     int get_element_size(std::string &element);
     std::string get_wanda_version() const;
+    //! Reads the definitions of all classes, used to fill a snapshot
+    void load_all_definitions();
+    //! Writes the definition file reads done so far to a snapshot file
+    void save_snapshot(const std::string &file) const;
+    //! Returns true when the definition is read from a precompiled snapshot
+    bool is_snapshot() const;
   private:
+    mutable std::recursive_mutex _mutex;
     void initialize(std::string data_path);
     bool initialized = false;
-    nefis_file _database;
+    wanda_def_database _database;
     int _num_phys_comp;
     int _num_ctrl_comp;
     std::unordered_set<std::string> _phys_class_names; // used for checking if component is a physical
@@ -103,10 +159,25 @@ class wanda_def
     std::unordered_map<std::string, std::string> _phys_type_2_classsort;
     std::unordered_map<std::string, std::string> _node_type_2_classsort;
     std::unordered_map<std::string, std::string> _ctrl_type_2_classsort;
-    std::unordered_map<std::string, std::unordered_map<std::string, wanda_property>> phys_input_props;
-    std::unordered_map<std::string, std::unordered_map<std::string, wanda_property>> phys_output_props;
-    std::unordered_map<std::string, std::unordered_map<std::string, wanda_property>> phys_props;
-    std::unordered_map<std::string, std::unordered_map<std::string, wanda_property>> node_props;
+    // property maps and class definitions are built once per class sort key and shared afterwards
+    using property_map_cache = std::unordered_map<std::string, std::shared_ptr<const wanda_property_map>>;
+    property_map_cache phys_input_props;
+    property_map_cache phys_calc_props;
+    property_map_cache phys_output_props;
+    property_map_cache ctrl_input_props;
+    property_map_cache ctrl_output_props;
+    property_map_cache node_input_props;
+    property_map_cache node_output_props;
+    property_map_cache class_props;
+    std::unordered_map<std::string, std::shared_ptr<const wanda_class_definition>> _class_definitions;
+    wanda_property_map load_physical_input_properties(const std::string &classsort_key);
+    wanda_property_map load_physical_calc_properties(const std::string &classsort_key);
+    wanda_property_map load_physical_output_properties(const std::string &classsort_key);
+    wanda_property_map load_control_input_properties(const std::string &classsort_key);
+    wanda_property_map load_control_output_properties(const std::string &classsort_key);
+    wanda_property_map load_node_input_properties(const std::string &classsort_key);
+    wanda_property_map load_node_output_properties(const std::string &classsort_key);
+    wanda_property_map load_properties(const std::string &classsort_key);
     std::unordered_map<std::string, wanda_component> _components_list;
     std::unordered_map<std::string, wanda_node> _node_list;
     std::unordered_map<std::string, wanda_tab_info> table_info;
@@ -3,12 +3,20 @@
 
 #include <array>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include <nefis_file.h>
 #include <wanda_diagram_lines.h>
+#include <wanda_graph_index.h>
+#include <wanda_keyword_index.h>
+#include <wanda_native_hcs.h>
+#include <wanda_solver_process.h>
 #include <wandacomponent.h>
 #include <wandadef.h>
 #include <wandanode.h>
@@ -24,16 +32,6 @@
 #define WANDAMODEL_API __declspec(dllimport)
 #endif
 
-///@private
-struct wanda_output_data_struct
-{
-    std::vector<std::vector<float>> time_series_data;
-    std::vector<std::vector<float>> maximum_value;
-    std::vector<std::vector<float>> minimum_value;
-    std::vector<std::vector<float>> maximum_value_time;
-    std::vector<std::vector<float>> minimum_value_time;
-};
-
 ///@private
 struct tabcol_meta_record
 {
@@ -58,6 +56,12 @@ struct tab_nefis_info
 /*!
 The wanda_model class is the main interface for the wanda model. This class
 gives the user access to all the components and data included in the model.
+
+A wanda_model does not lock itself. Const access and getters on the model, its
+items and properties can be done from several threads at the same time, as
+long as no thread changes the model. Threads sharing a model with a thread that
+changes it coordinate through lock_shared() and lock_exclusive(). The C
+interface takes these locks for every function with a model handle.
 */
 class WANDAMODEL_API wanda_model final
 {
@@ -70,7 +74,7 @@ class WANDAMODEL_API wanda_model final
     bool initialized = false;
     bool _modified = false;
     char dis_setting = 'X';
-    wanda_def *component_definition;
+    std::shared_ptr<wanda_def> component_definition;
     nefis_file wanda_input_file;
     nefis_file wanda_output_file;
     int number_physical_components = 0;
@@ -90,10 +94,14 @@ class WANDAMODEL_API wanda_model final
         phys_components; // relates Component_key to Physical wanda_component objects
     std::unordered_map<std::string, wanda_sig_line> signal_lines; // relates sigline_key to signal line objects
     std::unordered_map<std::string, wanda_diagram_lines> diagram_lines;
-    std::unordered_map<std::string, wanda_component *>
-        name2_phys_comp; // quick lookup table that relates component id (Complete_spec_descr) to component objects
-    std::unordered_map<std::string, wanda_node *>
-        name2_phys_node; // quick lookup table that relates node id (Complete_spec_descr) to node objects
+    std::unordered_map<std::string, wanda_item *, wanda_helper_functions::string_hash, std::equal_to<>>
+        name2_item; // quick lookup table that relates the id (Complete_spec_descr) of every component, node and
+                    // signal line to its object
+    wanda_graph_index graph_index; // CSR connectivity snapshot, rebuilt lazily after topology changes
+    bool graph_index_valid = false;
+    mutable wanda_keyword_index keyword_index; // keyword -> items, kept up to date by the items themselves
+    mutable std::mutex index_mutex; // guards the lazy rebuild of the indices, which can happen under a shared lock
+    mutable std::shared_mutex access_mutex;
     std::vector<std::string> sig_line_keys;
     std::vector<int> deleted_phys_nodes;
     std::vector<int> deleted_ctrl_components;
@@ -101,6 +109,9 @@ class WANDAMODEL_API wanda_model final
     std::vector<int> deleted_signal_lines;
     std::unordered_map<std::string, std::unordered_map<std::string, float>> unit_list;
     std::unordered_map<std::string, std::string> case_units;
+    std::vector<float> unit_factors; // factor per unit dimension id for the current case units
+    bool output_in_case_units = false;
+    wanda_hcs_backend hcs_backend = wanda_hcs_backend::automatic;
     std::string unit_group;
     bool tables_loaded = false;
     bool num_cols_loaded = false;
@@ -163,8 +174,16 @@ class WANDAMODEL_API wanda_model final
     wanda_sig_line &add_sigline(std::string type, std::vector<float> pos);
     void load_message(std::string group);
     void set_unit_factors();
+    float get_table_unit_factor(int unit_id);
+    int resolve_unit_id(wanda_property &prop);
+    void apply_output_units(wanda_output_data_struct &output);
+    void refresh_output_scalar(wanda_property &prop) const;
+    void refresh_output_scalars();
     bool check_name(std::string name);
     bool check_name(std::string name, std::string key);
+    wanda_item *find_item(std::string_view name) const;
+    void add_to_name_index(wanda_item &item);
+    void remove_from_name_index(const wanda_item &item);
     bool glob_var_modified();
     int num_timesteps = 0;
     int num_of_species = 0; // Used for MST domain
@@ -180,6 +199,23 @@ class WANDAMODEL_API wanda_model final
     void load_wanda_version();
 
     void calc_hsc(wanda_component& component);
+    std::shared_ptr<wanda_solver_job> start_solver(const std::string &executable, wanda_solver_options options);
+    // waits for the solver, a nonzero exit code throws with the error messages the solver wrote
+    void wait_for_solver(wanda_solver_job &job, bool steady);
+    std::string get_error_messages() const;
+    const wanda_graph_index &get_graph_index();
+    void invalidate_graph_index()
+    {
+        graph_index_valid = false;
+    }
+    const wanda_keyword_index &get_keyword_index() const;
+    // to be called when items are added to or removed from the model, connecting
+    // items only changes the graph and calls invalidate_graph_index()
+    void invalidate_item_indices()
+    {
+        invalidate_graph_index();
+        keyword_index.invalidate();
+    }
     
     void load_lines_diagram_information();
     void save_lines_diagram_information();  public:
@@ -206,6 +242,25 @@ class WANDAMODEL_API wanda_model final
     \param upgrade_model, when set to true the model is upgrade when needed
     */
     void initialize(std::string wdifile, bool upgrade_model);
+
+    //! Takes a shared lock on the model
+    /*!
+    Hold the returned lock while reading from the model. Any number of threads
+    can hold a shared lock at the same time.
+    */
+    std::shared_lock<std::shared_mutex> lock_shared() const
+    {
+        return std::shared_lock<std::shared_mutex>(access_mutex);
+    }
+    //! Takes an exclusive lock on the model
+    /*!
+    Hold the returned lock while changing the model, reloading its input or
+    output or running a simulation. It waits until all other locks are released.
+    */
+    std::unique_lock<std::shared_mutex> lock_exclusive() const
+    {
+        return std::unique_lock<std::shared_mutex>(access_mutex);
+    }
     //! Close the wanda case files
     /*!
      * Closes the wanda case files.
@@ -236,6 +291,8 @@ class WANDAMODEL_API wanda_model final
     \param prop the property for which output should be read.
     */
     void read_prop_output(wanda_property &prop);
+    // reads the output of the WDO postfix of prop, returns false when the postfix has no output
+    bool read_output_quantity(wanda_property &prop, wanda_output_data_struct &buffer);
     //! Reads the output data for a single node in the model and stores this in memory.
     /*!
     \param node the component for which output should be read.
@@ -284,7 +341,7 @@ class WANDAMODEL_API wanda_model final
     * and control components
     \param componentname Name of the requested component
     */
-    wanda_component &get_component(const std::string &componentname);
+    wanda_component &get_component(std::string_view componentname);
 
     //! Return a reference to a node from the wanda_model
     /*!
@@ -293,14 +350,14 @@ class WANDAMODEL_API wanda_model final
     * of nodes
     \param nodename Name of the requested node
     */
-    wanda_node &get_node(const std::string &nodename);
+    wanda_node &get_node(std::string_view nodename);
     //! Gets a node from the wanda_model
     /*!
     * get_signal_line() returns a wanda_sig_line object that represents the
     * requested signal line
     \param sig_name Name of the requested signal line
     */
-    wanda_sig_line &get_signal_line(const std::string &sig_name);
+    wanda_sig_line &get_signal_line(std::string_view sig_name);
 
     //! Returns all name of components in model that have a specified keyword.
     /*!
@@ -324,6 +381,16 @@ class WANDAMODEL_API wanda_model final
     components.
     */
     std::vector<wanda_component *> get_components_with_keyword(std::string keyword);
+    //! Returns pointers to all components in model that match a list of keywords.
+    /*!
+    * get_components_with_keywords() looks up the components in the keyword
+    * index of the model.
+    \param keywords the keywords that indicate the desired components.
+    \param match_all when true the components must have all keywords (AND),
+    otherwise one of the keywords is sufficient (OR).
+    */
+    std::vector<wanda_component *> get_components_with_keywords(const std::vector<std::string> &keywords,
+                                                                bool match_all = true);
 
     //! Returns pointers to all nodes in model that have a specified keyword.
     /*!
@@ -335,6 +402,14 @@ class WANDAMODEL_API wanda_model final
     keyword. \param keyword the keyword that indicates the desired nodes.
     */
     std::vector<wanda_node *> get_nodes_with_keyword(std::string keyword);
+    //! Returns pointers to all nodes in model that match a list of keywords.
+    /*!
+    \param keywords the keywords that indicate the desired nodes.
+    \param match_all when true the nodes must have all keywords (AND),
+    otherwise one of the keywords is sufficient (OR).
+    */
+    std::vector<wanda_node *> get_nodes_with_keywords(const std::vector<std::string> &keywords,
+                                                      bool match_all = true);
     //! Returns pointers to all signal_lines in model that have a specified keyword.
     /*!
     * get_signal_line_with_keyword() iterates over all signal_lines in the wanda_model object
@@ -612,7 +687,7 @@ class WANDAMODEL_API wanda_model final
     used \param comp2 the second component to be connected
      \param
     con_point2 the connection point of the second component to be used
-    \param node_name name which will be given to the node which connects the two components.
+    \param node_name name which will be given to the node or signal line which connects the two components.
     */
     wanda_item &connect(wanda_component &comp1, int con_point1, wanda_component &comp2, int con_point2, std::string node_name);
     //! Connects a wanda component to a node
@@ -686,8 +761,38 @@ class WANDAMODEL_API wanda_model final
      * into memory after the computation has finished.
      */
     void run_unsteady();
+    //! Starts the steady state computation without waiting for it
+    /*!
+     * Saves changes to the input and starts steady.exe. The case files stay
+     * closed until finish_steady() is called with the returned job, the model
+     * must not be used until then. The job can be polled, waited on or cancelled.
+     \param options timeout, output capture and completion callback of the solver process
+     */
+    std::shared_ptr<wanda_solver_job> start_steady(wanda_solver_options options = {});
+    //! Waits for a computation started with start_steady() and loads its output
+    /*!
+     * Throws when the solver failed, was cancelled or timed out. The case files
+     * are reopened in all cases.
+     */
+    void finish_steady(wanda_solver_job &job);
+    //! Starts the unsteady computation without waiting for it
+    /*!
+     * Works as run_unsteady(), including running steady first when needed, but
+     * does not wait for unsteady.exe. Call finish_unsteady() with the returned job.
+     \param options timeout, output capture and completion callback of the solver process
+     */
+    std::shared_ptr<wanda_solver_job> start_unsteady(wanda_solver_options options = {});
+    //! Waits for a computation started with start_unsteady() and loads its output
+    void finish_unsteady(wanda_solver_job &job);
     void reset_wdo_pointer();
     void resume_unsteady_until(float simulation_time);
+    //! Runs unsteady from start_time up to end_time
+    /*!
+     * Writes the start and end time to the case and runs unsteady.exe, steady
+     * is not computed again. Unlike resume_unsteady_until() the window does not
+     * depend on the Simulation time of the case.
+     */
+    void run_unsteady_window(float start_time, float end_time);
     //! Returns a list of the case units for the wanda case
     std::vector<std::vector<std::string>> get_case_units() const;
     //! returns a list of the possible dimensions for the given unit
@@ -718,6 +823,36 @@ class WANDAMODEL_API wanda_model final
     void switch_to_unit_user();
     ///@private
     void switch_to_unit_Wanda();
+    //! Selects whether output is returned in the units of the case
+    /*!
+    By default series and extremes are the SI values of the output file and
+    get_unit_factor() of the property converts them. When enabled, the values
+    are multiplied with the unit factor once when the output is read, and
+    rescaled in place when the units of the case are switched, together with
+    the steady state values of the properties. Borrowed series stay valid but
+    show the new units. The times of the extremes are not converted.
+    \param convert true for values in the units of the case, false for SI values
+    */
+    void set_output_in_case_units(bool convert);
+    //! returns true when output is returned in the units of the case
+    bool get_output_in_case_units() const
+    {
+        return output_in_case_units;
+    }
+    //! selects how the hydraulic component specifications are computed
+    /*!
+    The native implementation computes the length, wave speed and number of
+    elements of pipes with a specified wave speed without Component64.dll. It
+    is only available when the library is built with mgwso_ENABLE_NATIVE_HCS,
+    which is on by default except on Windows, otherwise all components are
+    computed by the dll.
+    \param backend implementation to use for this model, automatic by default
+    */
+    void set_hcs_backend(wanda_hcs_backend backend);
+    wanda_hcs_backend get_hcs_backend() const
+    {
+        return hcs_backend;
+    }
     //! Returns the Wanda bin folder
     std::string get_wandabin() const
     {
@@ -728,6 +863,11 @@ class WANDAMODEL_API wanda_model final
     {
         return wanda_input_file.get_filename();
     }
+    ///@private
+    const nefis_file &get_output_file() const
+    {
+        return wanda_output_file;
+    }
     std::vector<float> default_position = {10.0, -10.0};
     ///@private
     std::vector<float> get_globvar_hcs();
@@ -745,17 +885,17 @@ class WANDAMODEL_API wanda_model final
     */
     bool has_property(const std::string &property) const;
     //! returns true when the given component exists in the Wanda model, otherwise it returns false
-    bool component_exists(const std::string &comp_name) const;
+    bool component_exists(std::string_view comp_name) const;
     //! returns true when the given component exists in the Wanda model, otherwise it returns false
     bool component_exists(const wanda_component &comp) const;
     //! returns true when the given node exists in the Wanda model, otherwise it returns false
-    bool node_exists(const std::string &node) const;
+    bool node_exists(std::string_view node) const;
     //! returns true when the given node exists in the Wanda model, otherwise it returns false
     bool node_exists(const wanda_node &node) const;
     //! returns true when the given signal line exists in the Wanda model, otherwise it returns false
     bool sig_line_exists(const wanda_sig_line &sig_line) const;
     //! returns true when the given signal line exists in the Wanda model, otherwise it returns false
-    bool sig_line_exists(const std::string &sig_line) const;
+    bool sig_line_exists(std::string_view sig_line) const;
     //! sets the properties of the model to the values loaded from the property template file
     /*!
     \param data structure created with the load property template function.
@@ -906,6 +1046,8 @@ class WANDAMODEL_API wanda_model final
     void change_component_name(wanda_component &comp, std::string new_name);
     //! changes the name of the node to the given one
     void change_node_name(wanda_node &node, std::string new_name);
+    //! changes the name of the signal line to the given one
+    void change_sig_line_name(wanda_sig_line &sig_line, std::string new_name);
     //! Returns pointers to all properties of the wandamodel.
     /*!
      * get_all_properties() returns a std::vector<wanda_property*>
@@ -34,12 +34,6 @@ class WANDAMODEL_API wanda_node : public wanda_item
     //! Returns a vector of pointers to the components connected to the node
     std::vector<wanda_component *> get_connected_components() const;
     ///@private
-    void connect(wanda_component &component);
-    ///@private
-    void disconnect(wanda_component &component);
-    ///@private
-    void disconnect();
-    ///@private
     std::string get_core_quants() const
     {
         return _core_quantities[0];
@@ -57,6 +51,11 @@ class WANDAMODEL_API wanda_node : public wanda_item
     }
 
   private:
+    // the topology only changes through the model, which keeps its graph index up to date
+    friend class wanda_model;
+    void connect(wanda_component &component);
+    void disconnect(wanda_component &component);
+    void disconnect();
     const static std::string _object_name;
     const std::size_t _object_hash;
     std::vector<wanda_component *> _connected_comps;
@@ -1,6 +1,8 @@
 #ifndef _WANDAPROP_
 #define _WANDAPROP_
 
+#include <memory>
+#include <span>
 #include <vector>
 #include <wanda_table.h>
 
@@ -44,6 +46,44 @@ enum class wanda_property_types
     NONE
 };
 
+///@private
+struct wanda_output_data_struct
+{
+    // factor with which the values are multiplied after reading, 1 for the raw SI values
+    float unit_factor = 1.0f;
+    // index in the unit factor table of the model, -1 when unknown
+    int unit_id = -1;
+    std::vector<std::vector<float>> time_series_data;
+    std::vector<std::vector<float>> maximum_value;
+    std::vector<std::vector<float>> minimum_value;
+    std::vector<std::vector<float>> maximum_value_time;
+    std::vector<std::vector<float>> minimum_value_time;
+};
+
+///@private
+// Class level data of a property. It is shared by all instances of the property of the same component class and
+// is never modified after construction, a setter on wanda_property makes a private copy first.
+struct wanda_property_descriptor
+{
+    std::string description = "not available";
+    std::string wdo_post_fix = "-"; // Postfix for group name in Nefis file
+    std::string unit_dim = ".";
+    std::string short_quant_name;
+    std::string list_dependency;
+    std::vector<std::string> drop_down_list;
+    wanda_property_types wnd_type = wanda_property_types::NONE;
+    int index = 0;
+    char comp_spec_code = ' ';  // Indicates where the property is stored, common or
+                                // oper specs (only used in physical components)
+    char comp_sp_inp_fld = ' '; // type of property, real, char, table, etc.
+    float default_value = 0;
+    float min_value = 0;
+    float max_value = 0;
+    int view_list_mask = 0;
+    char input_type_code = ' ';
+    int view_mask = 0;
+};
+
 //!  main class for the Wanda properties.
 /*!
 The Wanda property class is used to access properties of components (e.g.
@@ -65,32 +105,32 @@ class WANDAMODEL_API wanda_property
     //! returns the name of the property
     std::string get_description() const
     {
-        return _description;
+        return _descr->description;
     }
     ///@private
     void set_description(std::string description)
     {
-        _description = description;
+        edit_descriptor().description = description;
     }
     ///@private
     std::string get_wdo_postfix() const
     {
-        return _wdo_post_fix;
+        return _descr->wdo_post_fix;
     }
     ///@private
     void set_wdo_postfix(std::string wdo_post_fix)
     {
-        _wdo_post_fix = wdo_post_fix;
+        edit_descriptor().wdo_post_fix = wdo_post_fix;
     }
     ///@private
     int get_index() const
     {
-        return _index;
+        return _descr->index;
     }
     ///@private
     void set_index(int index)
     {
-        _index = index;
+        edit_descriptor().index = index;
     }
     ///@private
     int get_group_index() const
@@ -115,17 +155,17 @@ class WANDAMODEL_API wanda_property
     ///@private
     char get_property_spec_inp_fld() const
     {
-        return _comp_sp_inp_fld;
+        return _descr->comp_sp_inp_fld;
     }
     ///@private
     void set_property_spec_inp_fld(char inp_fld)
     {
-        _comp_sp_inp_fld = inp_fld;
+        edit_descriptor().comp_sp_inp_fld = inp_fld;
     }
     ///@private
     char get_property_spec_code() const
     {
-        return _comp_spec_code;
+        return _descr->comp_spec_code;
     }
     //! Returns the multiplication factor from SI to the unit of the wanda model for this property.
     float get_unit_factor() const
@@ -137,23 +177,42 @@ class WANDAMODEL_API wanda_property
     {
         _unit_fac = factor;
     }
-    ///@private
-    void set_unit_factor(std::unordered_map<std::string, std::unordered_map<std::string, float>> &unit_list,
-                         std::unordered_map<std::string, std::string> &case_units);
     //! returns the unit dimension of the property
     std::string get_unit_dim() const
     {
-        return _unit_dim;
+        return _descr->unit_dim;
     }
     ///@private
     void set_unit_dim(std::string unit_dim)
     {
-        _unit_dim = unit_dim;
+        edit_descriptor().unit_dim = unit_dim;
+        _unit_id = -1;
     }
     ///@private
-    void set_extremes(float *, float *, float *, float *);
+    // index of the unit dimension in the unit factor table of the model, -1 when not resolved yet
+    int get_unit_id() const
+    {
+        return _unit_id;
+    }
+    ///@private
+    void set_unit_id(int unit_id)
+    {
+        _unit_id = unit_id;
+    }
+    ///@private
+    // binds the series and extremes of the property to the rows starting at row in the output data
+    void set_output_reference(const wanda_output_data_struct *output, int row);
     ///@private
-    void set_extremes(int, float *, float *, float *, float *);
+    // sets the scalar to the steady state value in row of the output data, for HOV/NOV/COV and HOS without elements
+    void bind_output_scalar(const wanda_output_data_struct *output, int row);
+    ///@private
+    const wanda_output_data_struct *get_scalar_output() const
+    {
+        return _scalar_output;
+    }
+    ///@private
+    // copies the steady state value again after the output data was rescaled to other units
+    void refresh_output_scalar();
     //! Returns the minimum value of the time series of the component
     float get_extr_min() const;
     //! Returns the maximum value of the time series of the component
@@ -215,10 +274,6 @@ class WANDAMODEL_API wanda_property
     \param scalar string to change the drop down list to
     */
     void set_scalar(std::string scalar);
-    ///@private
-    void set_series_by_ref(std::vector<float> *series);
-    ///@private
-    void set_series_pipe_by_ref(int element, std::vector<float> *series);
     //! returns time series of the property
     std::vector<float> get_series() const;
     //! returns time series of the property at the given element
@@ -228,6 +283,17 @@ class WANDAMODEL_API wanda_property
     std::vector<float> get_series(int element) const;
     //! Returns time series of the property at all elements in a pipe.
     std::vector<std::vector<float>> get_series_pipe() const;
+    //! Returns a view on the time series of the property without copying it
+    /*!
+     The view points into the output data of the wanda_model and is valid until the
+     output is reloaded or the model is closed.
+     */
+    std::span<const float> get_series_view() const;
+    //! Returns a view on the time series of the property at the given element without copying it
+    /*!
+     \param element of the pipe for which the time series is returned
+     */
+    std::span<const float> get_series_view(int element) const;
     //! Returns true when the property is an input or an output value
     bool has_scalar() const;
     //! Returns true when the property has a table
@@ -241,7 +307,7 @@ class WANDAMODEL_API wanda_property
     ///@private
     wanda_property_types get_property_type() const
     {
-        return _wnd_type;
+        return _descr->wnd_type;
     }
     //! returns for a drop downlist the item at the given number
     /*!
@@ -269,17 +335,17 @@ class WANDAMODEL_API wanda_property
     //! Returns the minimum possible input value
     float get_min_input_value() const
     {
-        return _min_value;
+        return _descr->min_value;
     }
     //! Returns the maximum recommended input value
     float get_max_input_value() const
     {
-        return _max_value;
+        return _descr->max_value;
     }
     //! Returns the default input value
     float get_default_input_value() const
     {
-        return _default_value;
+        return _descr->default_value;
     }
     ///@private
     bool get_spec_status() const
@@ -294,24 +360,26 @@ class WANDAMODEL_API wanda_property
     //! return true when the property is an input
     bool is_input() const
     {
-        return _wnd_type == wanda_property_types::HIS || _wnd_type == wanda_property_types::NIS ||
-               _wnd_type == wanda_property_types::CIS;
+        auto type = _descr->wnd_type;
+        return type == wanda_property_types::HIS || type == wanda_property_types::NIS ||
+               type == wanda_property_types::CIS;
     }
     //! return true when the property is an input
     bool is_output() const
     {
-        return _wnd_type == wanda_property_types::HOS || _wnd_type == wanda_property_types::NOS ||
-               _wnd_type == wanda_property_types::COS;
+        auto type = _descr->wnd_type;
+        return type == wanda_property_types::HOS || type == wanda_property_types::NOS ||
+               type == wanda_property_types::COS;
     }
     ///@private
     std::string get_short_quant_name() const
     {
-        return _short_quant_name;
+        return _descr->short_quant_name;
     }
     //! returns true when the value is a string or a drop down list
     bool has_string() const
     {
-        return _comp_sp_inp_fld == 'C';
+        return _descr->comp_sp_inp_fld == 'C';
     }
     //! sets the value of the property to the value from the property template
     void set_value_from_template(std::unordered_map<std::string, wanda_prop_template>::value_type item);
@@ -328,19 +396,19 @@ class WANDAMODEL_API wanda_property
     ///@private
     std::string get_list_dependency() const
     {
-        return _list_dependency;
+        return _descr->list_dependency;
     }
     ///@private
     std::vector<int> get_view_list_numbers() const;
     ///@private
     char get_input_type_code() const
     {
-        return _input_type_code;
+        return _descr->input_type_code;
     }
     ///@private
     int get_view_mask() const
     {
-        return _view_mask;
+        return _descr->view_mask;
     }
     ///@private
     // TODO make disused of the property a pointer to the disused of the component so that you do not have to change all
@@ -380,47 +448,35 @@ class WANDAMODEL_API wanda_property
     }
     // copies data from one input to the other
     void copy_data(wanda_property prop_org);
+    ///@private
+    // returns the shared class level data of the property
+    const std::shared_ptr<const wanda_property_descriptor> &get_descriptor() const
+    {
+        return _descr;
+    }
 
   private:
     static std::string _object_name;
-    std::size_t _object_hash = std::hash<std::string>{}(_object_name);
-    bool _modified = false;
-    float _scalar = -999.0f;
-    std::vector<float> *_series;                    // HOS
-    std::vector<std::vector<float> *> _series_pipe; // HOM/gloq for pipes
-    std::vector<float *> extr_min;
-    std::vector<float *> extr_max;
-    std::vector<float *> extr_tmin;
-    std::vector<float *> extr_tmax;
-    std::vector<std::string> drop_down_list;
+    static const std::size_t _object_hash;
+    std::shared_ptr<const wanda_property_descriptor> _descr;
+    wanda_property_descriptor &edit_descriptor();
+    const wanda_output_data_struct *_output = nullptr; // output data of HOS/NOS/COS and pipe quantities
+    int _output_row = 0;                               // first row of this property in _output
+    const wanda_output_data_struct *_scalar_output = nullptr; // output data the scalar was copied from
     wanda_table _table;
-    wanda_property_types _wnd_type;
-    std::string _description;
-    int _index;
-    int _group_index;
-    char _comp_spec_code;      // Indicates where the property is stored, common or
-                               // oper specs (only used in physical components)
-    char _comp_sp_inp_fld;     // type of property, real, char, table, etc.
-    std::string _wdo_post_fix; // Postfix for group name in Nefis file
-    std::string _unit_dim;
+    float _scalar = -999.0f;
     float _unit_fac = 0;
+    int _unit_id = -1;
+    int _group_index = 0;
     int _hos_index = 0;
-    float _default_value = 0;
-    float _min_value = -1e8f;
-    float _max_value = 1e8f;
     int _number_of_elements = 0;
-    ;
-    bool _spec_status = false;
-    std::string _short_quant_name;
-    bool _con_point_quant = true;
-    std::string _list_dependency;
-    int _view_list_mask = 0;
-    char _input_type_code = ' ';
-    int _view_mask = 0;
-    bool disused = false;
     int species_number = 0;
     int connection_point = 0; // Shows to which connection point this quantity belongs, if it is not belong to a
                               // connection point it is zero
+    bool _modified = false;
+    bool _spec_status = false;
+    bool _con_point_quant = true;
+    bool disused = false;
 };
 
 #endif
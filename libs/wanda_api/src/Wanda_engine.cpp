@@ -6,6 +6,39 @@
 #include <stdexcept>
 #include <unordered_map>
 #include <wanda_engine.h>
+#include <wanda_metrics.h>
+#include <wanda_trace.h>
+
+namespace
+{
+template <typename T> struct counted_function;
+
+// wraps a function of the engine DLL, so its calls are counted and timed while the metrics are enabled
+template <typename R, typename... Args> struct counted_function<R(Args...)>
+{
+    static std::function<R(Args...)> load(const HINSTANCE dllhandle, const std::string &function_name)
+    {
+        auto function = wanda_helper_functions::loadDLLfunction<R(Args...)>(dllhandle, function_name);
+        const std::string labels = "function=\"" + function_name + "\"";
+        auto &calls = wanda_metrics::counter("wanda_engine_calls_total", labels);
+        auto &latency = wanda_metrics::histogram("wanda_engine_call_seconds", labels);
+        return [function = std::move(function), &calls, &latency](Args... args) -> R {
+            if (!wanda_metrics::is_enabled())
+            {
+                return function(args...);
+            }
+            calls.add();
+            wanda_metric_timer timer(latency);
+            return function(args...);
+        };
+    }
+};
+
+template <typename T> std::function<T> load_counted_function(const HINSTANCE dllhandle, const std::string &function_name)
+{
+    return counted_function<T>::load(dllhandle, function_name);
+}
+} // namespace
 
 // wanda_engine *wanda_engine::_instance = nullptr;
 // const std::string wanda_engine::_object_name = "WandaEngine Object";
@@ -18,45 +51,45 @@ wanda_engine::wanda_engine(const std::string &wanda_bin) : _wanda_bin(wanda_bin)
         throw std::runtime_error("Could not load WandaEngine_native64.dll or it's dependencies.");
     }
     // spdlog::info("WandaEngine_native64 DLL loaded, handle={}", fmt::ptr(hGetProcIDDLL));
-    wnd_main_init = wanda_helper_functions::loadDLLfunction<int(const char *, size_t)>(hGetProcIDDLL, "WND_MAIN_INIT");
-    wnd_main_final = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_MAIN_FINAL");
-    wnd_load_data = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_LOAD_DATA");
-    wnd_stdy_data_init = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_STEADY_DATA_INIT");
-    wnd_stdy_comp_init = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_STEADY_COMP_INIT");
-    wnd_stdy_compute = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_STEADY_COMPUTE");
-    wnd_stdy_final = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_STEADY_FINAL");
-    wnd_unstdy_init = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_UNSTEADY_INIT");
-    wnd_unstdy_compute = wanda_helper_functions::loadDLLfunction<int(int *)>(hGetProcIDDLL, "WND_UNSTEADY_COMPUTE");
-    wnd_unstdy_final = wanda_helper_functions::loadDLLfunction<int()>(hGetProcIDDLL, "WND_UNSTEADY_FINAL");
+    wnd_main_init = load_counted_function<int(const char *, size_t)>(hGetProcIDDLL, "WND_MAIN_INIT");
+    wnd_main_final = load_counted_function<int()>(hGetProcIDDLL, "WND_MAIN_FINAL");
+    wnd_load_data = load_counted_function<int()>(hGetProcIDDLL, "WND_LOAD_DATA");
+    wnd_stdy_data_init = load_counted_function<int()>(hGetProcIDDLL, "WND_STEADY_DATA_INIT");
+    wnd_stdy_comp_init = load_counted_function<int()>(hGetProcIDDLL, "WND_STEADY_COMP_INIT");
+    wnd_stdy_compute = load_counted_function<int()>(hGetProcIDDLL, "WND_STEADY_COMPUTE");
+    wnd_stdy_final = load_counted_function<int()>(hGetProcIDDLL, "WND_STEADY_FINAL");
+    wnd_unstdy_init = load_counted_function<int()>(hGetProcIDDLL, "WND_UNSTEADY_INIT");
+    wnd_unstdy_compute = load_counted_function<int(int *)>(hGetProcIDDLL, "WND_UNSTEADY_COMPUTE");
+    wnd_unstdy_final = load_counted_function<int()>(hGetProcIDDLL, "WND_UNSTEADY_FINAL");
     wnd_get_current_time =
-        wanda_helper_functions::loadDLLfunction<int(double *)>(hGetProcIDDLL, "WND_GET_CURRENT_TIME");
-    wnd_get_delta_t = wanda_helper_functions::loadDLLfunction<int(double *)>(hGetProcIDDLL, "WND_GET_DELTA_T");
-    wnd_get_start_time = wanda_helper_functions::loadDLLfunction<int(double *)>(hGetProcIDDLL, "WND_GET_START_TIME");
-    wnd_get_end_time = wanda_helper_functions::loadDLLfunction<int(double *)>(hGetProcIDDLL, "WND_GET_END_TIME");
-    wnd_get_component_handle = wanda_helper_functions::loadDLLfunction<int(const char *, const char *, size_t, size_t)>(
+        load_counted_function<int(double *)>(hGetProcIDDLL, "WND_GET_CURRENT_TIME");
+    wnd_get_delta_t = load_counted_function<int(double *)>(hGetProcIDDLL, "WND_GET_DELTA_T");
+    wnd_get_start_time = load_counted_function<int(double *)>(hGetProcIDDLL, "WND_GET_START_TIME");
+    wnd_get_end_time = load_counted_function<int(double *)>(hGetProcIDDLL, "WND_GET_END_TIME");
+    wnd_get_component_handle = load_counted_function<int(const char *, const char *, size_t, size_t)>(
         hGetProcIDDLL, "WND_GETCOMPONENTHANDLE");
-    wnd_get_property_handle = wanda_helper_functions::loadDLLfunction<int(const int *, const char *, size_t)>(
+    wnd_get_property_handle = load_counted_function<int(const int *, const char *, size_t)>(
         hGetProcIDDLL, "WND_GETPROPERTYHANDLE");
-    wnd_get_values = wanda_helper_functions::loadDLLfunction<int(const int *, const int *, double *, int *)>(
+    wnd_get_values = load_counted_function<int(const int *, const int *, double *, int *)>(
         hGetProcIDDLL, "WND_GETVALUES");
-    wnd_set_values = wanda_helper_functions::loadDLLfunction<int(const int *, const int *, double *, int *)>(
+    wnd_set_values = load_counted_function<int(const int *, const int *, double *, int *)>(
         hGetProcIDDLL, "WND_SETVALUES");
-    wnd_get_vector = wanda_helper_functions::loadDLLfunction<int(const int *, const int *, double *, int *)>(
+    wnd_get_vector = load_counted_function<int(const int *, const int *, double *, int *)>(
         hGetProcIDDLL, "WND_GETVECTOR");
     wnd_get_values_by_name =
-        wanda_helper_functions::loadDLLfunction<int(const char *, const char *, const char *, double *, int *, size_t,
+        load_counted_function<int(const char *, const char *, const char *, double *, int *, size_t,
                                                     size_t, size_t)>(hGetProcIDDLL, "WND_GETVALUESBYNAME");
     wnd_set_values_by_name =
-        wanda_helper_functions::loadDLLfunction<int(const char *, const char *, const char *, double *, int *, size_t,
+        load_counted_function<int(const char *, const char *, const char *, double *, int *, size_t,
                                                     size_t, size_t)>(hGetProcIDDLL, "WND_SETVALUESBYNAME");
     wnd_get_vector_by_name =
-        wanda_helper_functions::loadDLLfunction<int(const char *, const char *, const char *, double *, int *, size_t,
+        load_counted_function<int(const char *, const char *, const char *, double *, int *, size_t,
                                                     size_t, size_t)>(hGetProcIDDLL, "WND_GETVECTOR_BY_NAME");
     wnd_get_composition =
-        wanda_helper_functions::loadDLLfunction<int(const char *, const char *, const char *, double *, int *, size_t,
+        load_counted_function<int(const char *, const char *, const char *, double *, int *, size_t,
                                                     size_t, size_t)>(hGetProcIDDLL, "WND_GETCOMPOSITION");
     wnd_get_composition_vector =
-        wanda_helper_functions::loadDLLfunction<int(const char *, const char *, const char *, double *, int *, size_t,
+        load_counted_function<int(const char *, const char *, const char *, double *, int *, size_t,
                                                     size_t, size_t)>(hGetProcIDDLL, "WND_GETCOMPOSITIONVECTOR");
 }
 
@@ -81,6 +114,7 @@ wanda_engine::~wanda_engine()
 
 void wanda_engine::initialize_engine(const std::string &case_path)
 {
+    WANDA_TRACE_SCOPE("wanda_engine::initialize_engine");
     _case_full_path = case_path;
     auto casename = std::make_unique<char[]>(_case_full_path.length() + 1);
     _case_full_path.copy(casename.get(), _case_full_path.length() + 1);
@@ -104,6 +138,7 @@ void wanda_engine::initialize_engine(const std::string &case_path)
 
 void wanda_engine::run_steady()
 {
+    WANDA_TRACE_SCOPE("wanda_engine::run_steady");
     if (!initialized)
     {
         throw std::runtime_error("Model not initialized");
@@ -123,6 +158,7 @@ void wanda_engine::run_steady()
 
 void wanda_engine::run_time_step()
 {
+    WANDA_TRACE_SCOPE("wanda_engine::run_time_step");
     if (!initialized)
     {
         throw std::runtime_error("Model not initiliased");
@@ -184,7 +220,7 @@ double wanda_engine::get_value(std::string comp_name, std::string property)
     {
         _components.emplace(comp_name, wanda_engine_component(get_comp_handle(comp_name)));
     }
-    auto comp = _components.at(comp_name);
+    auto &comp = _components.at(comp_name);
     if (comp.properties.find(property) == comp.properties.end())
     {
         comp.properties.emplace(property, get_prop_handle(comp.comp_number, property));
@@ -215,7 +251,7 @@ void wanda_engine::set_value(const std::string &comp_name, const std::string &pr
     {
         _components.emplace(comp_name, wanda_engine_component(get_comp_handle(comp_name)));
     }
-    auto comp = _components.at(comp_name);
+    auto &comp = _components.at(comp_name);
     if (comp.properties.find(property) == comp.properties.end())
     {
         comp.properties.emplace(property, get_prop_handle(comp.comp_number, property));
@@ -246,7 +282,7 @@ std::vector<double> wanda_engine::get_vector(std::string comp_name, std::string
     {
         _components.emplace(comp_name, wanda_engine_component(get_comp_handle(comp_name)));
     }
-    auto comp = _components.at(comp_name);
+    auto &comp = _components.at(comp_name);
     if (comp.properties.find(property) == comp.properties.end())
     {
         comp.properties.emplace(property, get_prop_handle(comp.comp_number, property));
@@ -276,6 +312,7 @@ std::vector<double> wanda_engine::get_vector(wanda_component &comp, std::string
 
 void wanda_engine::finish_unsteady()
 {
+    WANDA_TRACE_SCOPE("wanda_engine::finish_unsteady");
     int retval = wnd_unstdy_final();
     if (retval != 0)
     {
@@ -283,6 +320,60 @@ void wanda_engine::finish_unsteady()
     }
 }
 
+wanda_engine_handle wanda_engine::get_handle(const std::string &comp_name, const std::string &property,
+                                             bool pipe_vector)
+{
+    if (_components.find(comp_name) == _components.end())
+    {
+        _components.emplace(comp_name, wanda_engine_component(get_comp_handle(comp_name)));
+    }
+    auto &comp = _components.at(comp_name);
+    if (comp.properties.find(property) == comp.properties.end())
+    {
+        comp.properties.emplace(property, get_prop_handle(comp.comp_number, property));
+    }
+    wanda_engine_handle handle;
+    handle.component = comp.comp_number;
+    handle.property = comp.properties.at(property);
+    handle.pipe_vector = pipe_vector;
+    if (pipe_vector)
+    {
+        // the number of elements does not change during a simulation
+        handle.count = int(get_value(comp_name, "Pipe element count") + 1);
+    }
+    return handle;
+}
+
+void wanda_engine::get_values(const wanda_engine_handle &handle, double *values)
+{
+    int numval = handle.count;
+    int retval = handle.pipe_vector ? wnd_get_vector(&handle.component, &handle.property, values, &numval)
+                                    : wnd_get_values(&handle.component, &handle.property, values, &numval);
+    if (retval != 0)
+    {
+        if (retval == -3)
+            throw std::runtime_error("Storage size to small for returning the vector");
+        throw std::runtime_error("Could not get the values of handle " + std::to_string(handle.component) + ", " +
+                                 std::to_string(handle.property));
+    }
+}
+
+void wanda_engine::set_values(const wanda_engine_handle &handle, const double *values)
+{
+    if (handle.pipe_vector)
+    {
+        throw std::invalid_argument("Values of pipe elements can not be set");
+    }
+    int numval = handle.count;
+    // the engine does not change the values, but its interface is not const
+    if (int retval = wnd_set_values(&handle.component, &handle.property, const_cast<double *>(values), &numval);
+        retval != 0)
+    {
+        throw std::runtime_error("Could not set the values of handle " + std::to_string(handle.component) + ", " +
+                                 std::to_string(handle.property));
+    }
+}
+
 int wanda_engine::get_comp_handle(std::string complete_name_spec) const
 {
     std::string class_name = complete_name_spec.substr(0, complete_name_spec.find(' '));
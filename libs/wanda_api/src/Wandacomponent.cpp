@@ -224,26 +224,14 @@ void wanda_component::initialize()
 {
     if (_component_definition->is_physical_component(_class_sort_key))
     {
-        properties = _component_definition->get_properties(_class_sort_key);
-
-        // auto input_properties =
-        // componentDefinition->get_physical_input_properties(_class_sort_key); for
-        // (auto& prop : input_properties)
-        //    properties.emplace(prop.second.get_description(), prop.second);
-        std::vector<int> inputs = _component_definition->get_num_input_props(_class_sort_key);
-        _num_common_specs = inputs[0];
-        _num_oper_specs = inputs[1];
-        _num_hcs = inputs[2];
-        _number_of_connnect_points = _component_definition->get_number_of_con_points(_class_sort_key);
-        _is_controlable = _component_definition->get_controlable(_class_sort_key);
-        // auto calculated_properties =
-        // componentDefinition->get_physical_calc_properties(_class_sort_key); auto
-        // output_properties =
-        // componentDefinition->get_physical_output_properties(_class_sort_key);
-
-        set_ctrl_input_type(_component_definition->get_ctrl_input_type(_class_sort_key));
-        // for (auto& prop : calculated_properties)
-        //    properties.emplace(prop.second.get_description(), prop.second);
+        auto definition = _component_definition->get_class_definition(_class_sort_key);
+        properties = *definition->properties;
+        _num_common_specs = definition->num_input_props[0];
+        _num_oper_specs = definition->num_input_props[1];
+        _num_hcs = definition->num_input_props[2];
+        _number_of_connnect_points = definition->number_of_con_points;
+        _is_controlable = definition->controlable;
+        set_ctrl_input_type(definition->ctrl_input_type);
         for (auto &prop : properties)
         {
             if (prop.second.is_glo_quant())
@@ -256,24 +244,17 @@ void wanda_component::initialize()
                     prop.second.set_number_of_elements(_num_elements);
                 }
             }
-            // properties.emplace(prop.second.get_description(), prop.second);
         }
-        _core_quantities = _component_definition->get_core_quants(_class_sort_key);
+        _core_quantities = definition->core_quants;
     }
     else if (_component_definition->is_control_component(_class_sort_key))
     {
-        auto input_properties = _component_definition->get_control_input_properties(_class_sort_key);
-        auto output_properties = _component_definition->get_control_output_properties(_class_sort_key);
-        for (auto &prop : input_properties)
-            properties.emplace(prop.second.get_description(), prop.second);
-        for (auto &prop : output_properties)
-            properties.emplace(prop.second.get_description(), prop.second);
-        std::vector<int> number_of_in_channels = _component_definition->get_num_input_chanl(_class_sort_key);
-        std::vector<int> number_of_out_channels = _component_definition->get_num_output_chanl(_class_sort_key);
-        num_input_channels = number_of_in_channels[0];
-        num_output_channels = number_of_out_channels[0];
-        min_input_channels = _component_definition->get_min_in_chan(_class_sort_key);
-        max_input_channels = _component_definition->get_max_in_chan(_class_sort_key);
+        auto definition = _component_definition->get_class_definition(_class_sort_key);
+        properties = *definition->properties;
+        num_input_channels = definition->num_input_channels;
+        num_output_channels = definition->num_output_channels;
+        min_input_channels = definition->min_input_channels;
+        max_input_channels = definition->max_input_channels;
 
         if (_class_sort_key == "SENSOR")
         {
@@ -1,18 +1,23 @@
 #include <algorithm>
 #include <cctype>
+#include <filesystem>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <nefis_file.h>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <wanda_def_snapshot.h>
 #include <wandadef.h>
 #include <wandaproperty.h>
 #include <deltares_helper_functions.h>
 
 std::unordered_map<std::string, std::unordered_map<std::string, float>> wanda_def::get_unit_list()
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::unordered_map<std::string, std::unordered_map<std::string, float>> unit_list_local;
     int u_table_size = _database.get_int_attribute("UNIT_TABLE", "N_avail_units");
     std::vector<std::string> unit_descr(u_table_size);
@@ -44,6 +49,7 @@ std::unordered_map<std::string, std::unordered_map<std::string, float>> wanda_de
 
 std::unordered_map<std::string, std::string> wanda_def::get_case_unit(std::string unit_group)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::unordered_map<std::string, std::string> case_units;
     int u_table_size = _database.get_int_attribute("UNIT_TABLE", "N_avail_units");
     int u_case_size = _database.get_int_attribute(unit_group, "N_avail_units");
@@ -65,6 +71,7 @@ std::unordered_map<std::string, std::string> wanda_def::get_case_unit(std::strin
 
 std::string wanda_def::get_class_sort_key(std::string type)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (_phys_type_2_classsort.find(type) != _phys_type_2_classsort.end())
     {
         return _phys_type_2_classsort[type];
@@ -82,6 +89,7 @@ std::string wanda_def::get_class_sort_key(std::string type)
 
 std::vector<std::string> wanda_def::get_core_quants(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<std::string> core_quant(4);
     _database.get_string_element(groupname, "Glob_core_quant", nefis_file::single_elem_uindex, 8, core_quant);
@@ -90,6 +98,7 @@ std::vector<std::string> wanda_def::get_core_quants(std::string classsort_key)
 
 std::string wanda_def::get_node_core_quants(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_NOD";
     std::vector<std::string> core_quant(1);
     _database.get_string_element(groupname, "Node_core_quant", nefis_file::single_elem_uindex, 8, core_quant);
@@ -98,6 +107,7 @@ std::string wanda_def::get_node_core_quants(std::string classsort_key)
 
 std::string wanda_def::get_node_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_NOD";
     std::vector<std::string> node_type(1);
     _database.get_string_element(groupname, "Node_type", nefis_file::single_elem_uindex, 8, node_type);
@@ -106,6 +116,7 @@ std::string wanda_def::get_node_type(std::string classsort_key)
 
 std::vector<int> wanda_def::get_num_input_props(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::vector<int> number;
     if (is_physical_component(classsort_key))
     {
@@ -132,6 +143,7 @@ std::vector<int> wanda_def::get_num_input_props(std::string classsort_key)
 
 void wanda_def::get_ip_fld_his(std::string classsort_key, std::vector<std::string> &com, std::vector<std::string> &ope)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (!is_physical_component(classsort_key))
     {
         throw std::invalid_argument(classsort_key + " is not a physical component");
@@ -165,6 +177,7 @@ void wanda_def::get_ip_fld_his(std::string classsort_key, std::vector<std::strin
 
 void wanda_def::get_ip_fld_his(std::string classsort_key, std::vector<std::string> &com)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (!is_control_component(classsort_key))
     {
         throw std::invalid_argument(classsort_key + " is not a physical component");
@@ -177,6 +190,7 @@ void wanda_def::get_ip_fld_his(std::string classsort_key, std::vector<std::strin
 
 std::vector<std::string> wanda_def::get_ctrl_in_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_CTR";
     std::vector<std::string> in_type(16);
     _database.get_string_element(groupname, "Chanl_in_type", nefis_file::single_elem_uindex, 8, in_type);
@@ -185,6 +199,7 @@ std::vector<std::string> wanda_def::get_ctrl_in_type(std::string classsort_key)
 
 std::vector<std::string> wanda_def::get_ctrl_out_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_CTR";
     std::vector<std::string> out_type(16);
     _database.get_string_element(groupname, "Chanl_out_type", nefis_file::single_elem_uindex, 8, out_type);
@@ -193,6 +208,7 @@ std::vector<std::string> wanda_def::get_ctrl_out_type(std::string classsort_key)
 
 std::vector<int> wanda_def::get_num_input_chanl(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::vector<int> n_chan_in(1);
     std::string groupname = classsort_key + "_CTR";
     _database.get_int_element(groupname, "N_input_chanl", nefis_file::single_elem_uindex, n_chan_in);
@@ -201,6 +217,7 @@ std::vector<int> wanda_def::get_num_input_chanl(std::string classsort_key)
 
 std::vector<int> wanda_def::get_num_output_chanl(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::vector<int> n_chan_out(1);
     std::string groupname = classsort_key + "_CTR";
     _database.get_int_element(groupname, "N_output_chanl", nefis_file::single_elem_uindex, n_chan_out);
@@ -209,6 +226,7 @@ std::vector<int> wanda_def::get_num_output_chanl(std::string classsort_key)
 
 bool wanda_def::check_def_mask(std::string class_sort_key, char mask)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string def_mask = get_default_mask(class_sort_key);
     auto res = std::find(def_mask.begin(), def_mask.end(), mask);
     return res != def_mask.end();
@@ -216,21 +234,25 @@ bool wanda_def::check_def_mask(std::string class_sort_key, char mask)
 
 bool wanda_def::is_obsolete(std::string class_sort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     return check_def_mask(class_sort_key, 'X');
 }
 
 bool wanda_def::is_prototype(std::string class_sort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     return check_def_mask(class_sort_key, 'P');
 }
 
 bool wanda_def::is_special(std::string class_sort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     return check_def_mask(class_sort_key, 'S');
 }
 
 std::vector<std::string> wanda_def::get_possible_phys_comp_type()
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string group = "H_COMP_AVAILABLE";
     int size = _database.get_int_attribute(group, "N_avail_H_class");
     std::vector<std::vector<std::string>> avail_classes(size, std::vector<std::string>(250));
@@ -255,6 +277,7 @@ std::vector<std::string> wanda_def::get_possible_phys_comp_type()
 
 std::vector<std::string> wanda_def::get_possible_ctrl_comp_type()
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string group = "C_COMP_AVAILABLE";
     int size = _database.get_int_attribute(group, "N_avail_C_class");
     std::vector<std::string> avail_classes(size);
@@ -273,6 +296,7 @@ std::vector<std::string> wanda_def::get_possible_ctrl_comp_type()
 
 std::vector<std::string> wanda_def::get_possible_node_type()
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string group = "H_NODE_AVAILABLE";
     int size = _database.get_int_attribute(group, "N_avail_N_class");
     std::vector<std::string> avail_classes(size);
@@ -290,6 +314,7 @@ std::vector<std::string> wanda_def::get_possible_node_type()
 
 int wanda_def::get_element_size(std::string &element)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     return _database.get_element_size(element);
 }
 
@@ -298,19 +323,55 @@ wanda_def::~wanda_def()
     _database.close();
 }
 
-wanda_def::wanda_def(std::string data_path) : _data_path(data_path)
+namespace
+{
+struct wanda_def_registry_entry
+{
+    std::weak_ptr<wanda_def> definition;
+    std::filesystem::file_time_type write_time;
+};
+std::mutex wanda_def_registry_mutex;
+std::unordered_map<std::string, wanda_def_registry_entry> wanda_def_registry;
+} // namespace
+
+std::shared_ptr<wanda_def> wanda_def::get_shared(const std::string &data_path)
+{
+    std::string key = data_path;
+    if (key.empty() || key.back() != '\\')
+    {
+        key.append("\\");
+    }
+    key = std::filesystem::path(key).lexically_normal().string();
+    std::error_code error;
+    auto write_time = std::filesystem::last_write_time(key + "WandaDef.dat", error);
+
+    std::lock_guard<std::mutex> lock(wanda_def_registry_mutex);
+    auto &entry = wanda_def_registry[key];
+    if (auto definition = entry.definition.lock(); definition && entry.write_time == write_time)
+    {
+        return definition;
+    }
+    auto definition = std::make_shared<wanda_def>(key);
+    entry.definition = definition;
+    entry.write_time = write_time;
+    return definition;
+}
+
+wanda_def::wanda_def(std::string data_path) : wanda_def(data_path, false)
+{
+}
+
+wanda_def::wanda_def(std::string data_path, bool record_snapshot) : _data_path(data_path)
 {
     if (_data_path[_data_path.length() - 1] != '\\') // ensure _data_path ends with a backslash
     {
         _data_path.append("\\");
     }
-    std::string wanda_dat = _data_path + "WandaDef.dat";
+    _database.open(_data_path, record_snapshot);
 #ifdef DEBUG
-    std::cout << "Wandadef loaded from: " << wanda_dat << '\n';
+    std::cout << "Wandadef loaded from: " << _data_path
+              << (_database.is_snapshot() ? wanda_def_snapshot::file_name : "WandaDef.dat") << '\n';
 #endif
-    _database.set_file(wanda_dat);
-    _database.open('r'); // open WandaDef as readonly file to prevent
-                         // 'access-denied' issues
     load_version_number();
 
     load_class_sort_keys();
@@ -476,131 +537,128 @@ void wanda_def::load_string_col_types()
     }
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_physical_input_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_physical_input_properties(const std::string &classsort_key)
 {
-    if (phys_input_props.find(classsort_key) == phys_input_props.end())
+    wanda_property_map propertylist;
+    std::string groupname = classsort_key + "_GEN";
+    std::vector<std::string> related_his(1);
+    std::vector<std::string> action_table_type_key(1);
+    _database.get_string_element(groupname, "Related_his", nefis_file::single_elem_uindex, 30, related_his);
+    _database.get_string_element(groupname, "Table_type_key", nefis_file::single_elem_uindex, 8,
+                                 action_table_type_key);
+
+    groupname = classsort_key + "_HIS";
+    int his_com = _database.get_int_attribute(groupname, "N_his_com");
+    int his_oper = _database.get_int_attribute(groupname, "N_his_ope");
+    int hydr_inp_specs = his_com + his_oper;
+
+    if (hydr_inp_specs > 0)
     {
-        std::string groupname = classsort_key + "_GEN";
-        std::vector<std::string> related_his(1);
-        std::vector<std::string> action_table_type_key(1);
-        _database.get_string_element(groupname, "Related_his", nefis_file::single_elem_uindex, 30, related_his);
-        _database.get_string_element(groupname, "Table_type_key", nefis_file::single_elem_uindex, 8,
-                                     action_table_type_key);
-
-        groupname = classsort_key + "_HIS";
-        int his_com = _database.get_int_attribute(groupname, "N_his_com");
-        int his_oper = _database.get_int_attribute(groupname, "N_his_ope");
-        int hydr_inp_specs = his_com + his_oper;
-
-        if (hydr_inp_specs > 0)
+        std::vector<std::string> spec_descr(hydr_inp_specs);
+        std::vector<std::string> spec_descr_short(hydr_inp_specs);
+        std::vector<std::string> comp_spec_code(hydr_inp_specs);
+        std::vector<std::string> comp_sp_inp_fld(hydr_inp_specs);
+        std::vector<std::string> input_type_code(hydr_inp_specs);
+        std::vector<std::string> table_type_key(hydr_inp_specs);
+        std::vector<std::string> unit_dim(hydr_inp_specs);
+        std::vector<std::vector<std::string>> lists(hydr_inp_specs, std::vector<std::string>(10));
+        std::vector<int> N_toggle_fields(hydr_inp_specs);
+        std::vector<float> min_value(hydr_inp_specs);
+        std::vector<float> max_value(hydr_inp_specs);
+        std::vector<float> default_value(hydr_inp_specs);
+        std::vector<std::string> list_dependency(hydr_inp_specs);
+        std::vector<int> view_list_mask(hydr_inp_specs);
+        std::vector<int> view_mask(hydr_inp_specs);
+        _database.get_string_element(groupname, "Spec_descr", {1, hydr_inp_specs, 1}, 30, spec_descr);
+        _database.get_string_element(groupname, "Spec_descr_short", {1, hydr_inp_specs, 1}, 3, spec_descr_short);
+        _database.get_string_element(groupname, "Comp_spec_code", {1, hydr_inp_specs, 1}, 1, comp_spec_code);
+        _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, hydr_inp_specs, 1}, 1, comp_sp_inp_fld);
+        _database.get_string_element(groupname, "Input_type_code", {1, hydr_inp_specs, 1}, 1, input_type_code);
+        _database.get_string_element(groupname, "Table_type_key", {1, hydr_inp_specs, 1}, 8, table_type_key);
+        _database.get_string_element(groupname, "Unit_dimension", {1, hydr_inp_specs, 1}, 12, unit_dim);
+        _database.get_string_element(groupname, "Toggle_fields", {1, hydr_inp_specs, 1}, {1, 10, 1}, 16, lists);
+        _database.get_int_element(groupname, "N_toggle_fields", {1, hydr_inp_specs, 1}, N_toggle_fields);
+        _database.get_float_element(groupname, "Min_value", {1, hydr_inp_specs, 1}, min_value);
+        _database.get_float_element(groupname, "Max_value", {1, hydr_inp_specs, 1}, max_value);
+        _database.get_float_element(groupname, "Default_value", {1, hydr_inp_specs, 1}, default_value);
+        _database.get_string_element(groupname, "List_dependency", {1, hydr_inp_specs, 1}, 30, list_dependency);
+        _database.get_int_element(groupname, "View_list_mask", {1, hydr_inp_specs, 1}, view_list_mask);
+        _database.get_int_element(groupname, "View_mask", {1, hydr_inp_specs, 1}, view_mask);
+        for (int i = 0; i < hydr_inp_specs; i++)
         {
-            std::vector<std::string> spec_descr(hydr_inp_specs);
-            std::vector<std::string> spec_descr_short(hydr_inp_specs);
-            std::vector<std::string> comp_spec_code(hydr_inp_specs);
-            std::vector<std::string> comp_sp_inp_fld(hydr_inp_specs);
-            std::vector<std::string> input_type_code(hydr_inp_specs);
-            std::vector<std::string> table_type_key(hydr_inp_specs);
-            std::vector<std::string> unit_dim(hydr_inp_specs);
-            std::vector<std::vector<std::string>> lists(hydr_inp_specs, std::vector<std::string>(10));
-            std::vector<int> N_toggle_fields(hydr_inp_specs);
-            std::vector<float> min_value(hydr_inp_specs);
-            std::vector<float> max_value(hydr_inp_specs);
-            std::vector<float> default_value(hydr_inp_specs);
-            std::vector<std::string> list_dependency(hydr_inp_specs);
-            std::vector<int> view_list_mask(hydr_inp_specs);
-            std::vector<int> view_mask(hydr_inp_specs);
-            _database.get_string_element(groupname, "Spec_descr", {1, hydr_inp_specs, 1}, 30, spec_descr);
-            _database.get_string_element(groupname, "Spec_descr_short", {1, hydr_inp_specs, 1}, 3, spec_descr_short);
-            _database.get_string_element(groupname, "Comp_spec_code", {1, hydr_inp_specs, 1}, 1, comp_spec_code);
-            _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, hydr_inp_specs, 1}, 1, comp_sp_inp_fld);
-            _database.get_string_element(groupname, "Input_type_code", {1, hydr_inp_specs, 1}, 1, input_type_code);
-            _database.get_string_element(groupname, "Table_type_key", {1, hydr_inp_specs, 1}, 8, table_type_key);
-            _database.get_string_element(groupname, "Unit_dimension", {1, hydr_inp_specs, 1}, 12, unit_dim);
-            _database.get_string_element(groupname, "Toggle_fields", {1, hydr_inp_specs, 1}, {1, 10, 1}, 16, lists);
-            _database.get_int_element(groupname, "N_toggle_fields", {1, hydr_inp_specs, 1}, N_toggle_fields);
-            _database.get_float_element(groupname, "Min_value", {1, hydr_inp_specs, 1}, min_value);
-            _database.get_float_element(groupname, "Max_value", {1, hydr_inp_specs, 1}, max_value);
-            _database.get_float_element(groupname, "Default_value", {1, hydr_inp_specs, 1}, default_value);
-            _database.get_string_element(groupname, "List_dependency", {1, hydr_inp_specs, 1}, 30, list_dependency);
-            _database.get_int_element(groupname, "View_list_mask", {1, hydr_inp_specs, 1}, view_list_mask);
-            _database.get_int_element(groupname, "View_mask", {1, hydr_inp_specs, 1}, view_mask);
-            for (int i = 0; i < hydr_inp_specs; i++)
+            int index;
+            if (i < his_com)
+                index = i; // Common specs
+            else
+                index = i - his_com; // Operational specs
+            if (propertylist.find(spec_descr[i]) == propertylist.end())
             {
-                int index;
-                if (i < his_com)
-                    index = i; // Common specs
-                else
-                    index = i - his_com; // Operational specs
-                if (phys_input_props[classsort_key].find(spec_descr[i]) == phys_input_props[classsort_key].end())
+                propertylist[spec_descr[i]] = wanda_property(
+                    index, spec_descr[i], comp_spec_code[i][0], comp_sp_inp_fld[i][0], "HIS", unit_dim[i],
+                    wanda_property_types::HIS, spec_descr_short[i], default_value[i], min_value[i], max_value[i],
+                    list_dependency[i], view_list_mask[i], input_type_code[i][0], view_mask[i]);
+            }
+            auto &property = propertylist[spec_descr[i]];
+            if (property.get_property_spec_inp_fld() == 'C')
+            {
+                std::vector<std::string> list(lists[i].begin(), lists[i].begin() + N_toggle_fields[i]);
+                property.set_list(list);
+            }
+            else if (property.get_property_spec_inp_fld() != 'R' && property.get_property_spec_inp_fld() != 'I' &&
+                     property.get_property_spec_inp_fld() != 'C')
+            {
+                // setting additional settings for table, numcolumns & stringcolumns
+                wanda_tab_info tab_info;
+                int counter = 0;
+                if (comp_sp_inp_fld[i][0] == 'S')
+                {
+                    tab_info = string_col_info[table_type_key[i]];
+                    counter = 1;
+                }
+                else if (comp_sp_inp_fld[i][0] == 'N')
                 {
-                    phys_input_props[classsort_key][spec_descr[i]] = wanda_property(
-                        index, spec_descr[i], comp_spec_code[i][0], comp_sp_inp_fld[i][0], "HIS", unit_dim[i],
-                        wanda_property_types::HIS, spec_descr_short[i], default_value[i], min_value[i], max_value[i],
-                        list_dependency[i], view_list_mask[i], input_type_code[i][0], view_mask[i]);
+                    tab_info = num_col_info[table_type_key[i]];
+                    counter = 1;
                 }
-                auto &property = phys_input_props[classsort_key][spec_descr[i]];
-                if (property.get_property_spec_inp_fld() == 'C')
+                else if (comp_sp_inp_fld[i][0] == 'T')
                 {
-                    std::vector<std::string> list(lists[i].begin(), lists[i].begin() + N_toggle_fields[i]);
-                    property.set_list(list);
+                    tab_info = table_info[table_type_key[i]];
+                    counter = 2;
                 }
-                else if (property.get_property_spec_inp_fld() != 'R' && property.get_property_spec_inp_fld() != 'I' &&
-                         property.get_property_spec_inp_fld() != 'C')
+                wanda_table &table = property.get_table();
+                for (int j = 0; j < counter; j++)
                 {
-                    // setting additional settings for table, numcolumns & stringcolumns
-                    wanda_tab_info tab_info;
-                    int counter = 0;
-                    if (comp_sp_inp_fld[i][0] == 'S')
-                    {
-                        tab_info = string_col_info[table_type_key[i]];
-                        counter = 1;
-                    }
-                    else if (comp_sp_inp_fld[i][0] == 'N')
-                    {
-                        tab_info = num_col_info[table_type_key[i]];
-                        counter = 1;
-                    }
-                    else if (comp_sp_inp_fld[i][0] == 'T')
-                    {
-                        tab_info = table_info[table_type_key[i]];
-                        counter = 2;
-                    }
-                    wanda_table &table = property.get_table();
-                    for (int j = 0; j < counter; j++)
-                    {
-                        table.add_column(tab_info.description[j], tab_info.unit_dim[j], "Unrefrnc",
-                                         comp_sp_inp_fld[i][0], index, j,
-                                         tab_info.description[j == 0 ? counter - 1 : 0], comp_spec_code[i][0]);
-                    }
+                    table.add_column(tab_info.description[j], tab_info.unit_dim[j], "Unrefrnc",
+                                     comp_sp_inp_fld[i][0], index, j,
+                                     tab_info.description[j == 0 ? counter - 1 : 0], comp_spec_code[i][0]);
                 }
             }
-            // adding action table
-            if (!(related_his[0].compare("None") == 0) && !(related_his[0].compare("") == 0))
+        }
+        // adding action table
+        if (!(related_his[0].compare("None") == 0) && !(related_his[0].compare("") == 0))
+        {
+            auto tab_info = table_info[action_table_type_key[0]];
+            wanda_property prop(-999, "Action table", 'N', 'T', "HIS", tab_info.unit_dim[0],
+                                wanda_property_types::HIS, "AT");
+            wanda_table &table = prop.get_table();
+            for (int j = 0; j < 2; j++)
             {
-                auto tab_info = table_info[action_table_type_key[0]];
-                wanda_property prop(-999, "Action table", 'N', 'T', "HIS", tab_info.unit_dim[0],
-                                    wanda_property_types::HIS, "AT");
-                wanda_table &table = prop.get_table();
-                for (int j = 0; j < 2; j++)
-                {
-                    table.add_column(tab_info.description[j], tab_info.unit_dim[j], "Unrefrnc", 'T', -999, j,
-                                     tab_info.description[j == 0 ? 1 : 0], 'C');
-                }
-                prop.set_property_spec_inp_fld('T');
-                phys_input_props[classsort_key]["Action table"] = prop;
+                table.add_column(tab_info.description[j], tab_info.unit_dim[j], "Unrefrnc", 'T', -999, j,
+                                 tab_info.description[j == 0 ? 1 : 0], 'C');
             }
+            prop.set_property_spec_inp_fld('T');
+            propertylist["Action table"] = prop;
         }
     }
-
-    return phys_input_props[classsort_key];
+    return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_physical_calc_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_physical_calc_properties(const std::string &classsort_key)
 {
     std::string groupname = classsort_key + "_HCS";
 
     int N_hydr_calc_spec = _database.get_int_attribute(groupname, "N_hydr_calc_spec");
-    std::unordered_map<std::string, wanda_property> propertylist;
+    wanda_property_map propertylist;
 
     if (N_hydr_calc_spec > 0)
     {
@@ -622,155 +680,153 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_physical_calc_pro
     return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_physical_output_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_physical_output_properties(const std::string &classsort_key)
 {
-    if (phys_output_props.find(classsort_key) == phys_output_props.end())
+    wanda_property_map propertylist;
+    int numproperties = -1;
+    std::string groupname = classsort_key + "_GEN";
+    std::vector<int> h_node_counts(1);
+    std::vector<std::string> glob_core_quants(4);
+    std::vector<std::string> glob_rest_quants(4);
+    std::vector<std::string> glob_outp_quants(4);
+    std::vector<std::string> comp_type(1);
+    int n_avail_quants = _database.get_int_attribute("GLOBAL_QUANTITIE", "N_avail_quants");
+    std::vector<std::string> quantsymbols(n_avail_quants);
+    std::vector<std::string> quantnames(n_avail_quants);
+    std::vector<std::string> WDO_postfixes(n_avail_quants);
+    std::vector<std::string> unit_dims(n_avail_quants);
+    _database.get_string_element(groupname, "Glob_core_quant", nefis_file::single_elem_uindex, 8, glob_core_quants);
+    _database.get_string_element(groupname, "Glob_rest_quant", nefis_file::single_elem_uindex, 8, glob_rest_quants);
+    for (int i = 0; i < 4; i++)
     {
-        int numproperties = -1;
-        std::string groupname = classsort_key + "_GEN";
-        std::vector<int> h_node_counts(1);
-        std::vector<std::string> glob_core_quants(4);
-        std::vector<std::string> glob_rest_quants(4);
-        std::vector<std::string> glob_outp_quants(4);
-        std::vector<std::string> comp_type(1);
-        int n_avail_quants = _database.get_int_attribute("GLOBAL_QUANTITIE", "N_avail_quants");
-        std::vector<std::string> quantsymbols(n_avail_quants);
-        std::vector<std::string> quantnames(n_avail_quants);
-        std::vector<std::string> WDO_postfixes(n_avail_quants);
-        std::vector<std::string> unit_dims(n_avail_quants);
-        _database.get_string_element(groupname, "Glob_core_quant", nefis_file::single_elem_uindex, 8, glob_core_quants);
-        _database.get_string_element(groupname, "Glob_rest_quant", nefis_file::single_elem_uindex, 8, glob_rest_quants);
-        for (int i = 0; i < 4; i++)
-        {
-            glob_outp_quants[i] = glob_core_quants[i] + glob_rest_quants[i];
-        }
+        glob_outp_quants[i] = glob_core_quants[i] + glob_rest_quants[i];
+    }
 
-        _database.get_string_element(groupname, "Comp_type", nefis_file::single_elem_uindex, 8, comp_type);
-        _database.get_int_element(groupname, "H_node_count", nefis_file::single_elem_uindex, h_node_counts);
-        _database.get_string_element("GLOBAL_QUANTITIE", "Quantity_symbol", {1, n_avail_quants, 1}, 1, quantsymbols);
-        _database.get_string_element("GLOBAL_QUANTITIE", "Quantity_name", {1, n_avail_quants, 1}, 30, quantnames);
-        _database.get_string_element("GLOBAL_QUANTITIE", "WDO_postfix", {1, n_avail_quants, 1}, 11, WDO_postfixes);
-        _database.get_string_element("GLOBAL_QUANTITIE", "Unit_dimension", {1, n_avail_quants, 1}, 12, unit_dims);
+    _database.get_string_element(groupname, "Comp_type", nefis_file::single_elem_uindex, 8, comp_type);
+    _database.get_int_element(groupname, "H_node_count", nefis_file::single_elem_uindex, h_node_counts);
+    _database.get_string_element("GLOBAL_QUANTITIE", "Quantity_symbol", {1, n_avail_quants, 1}, 1, quantsymbols);
+    _database.get_string_element("GLOBAL_QUANTITIE", "Quantity_name", {1, n_avail_quants, 1}, 30, quantnames);
+    _database.get_string_element("GLOBAL_QUANTITIE", "WDO_postfix", {1, n_avail_quants, 1}, 11, WDO_postfixes);
+    _database.get_string_element("GLOBAL_QUANTITIE", "Unit_dimension", {1, n_avail_quants, 1}, 12, unit_dims);
 
-        int H_node_count = h_node_counts[0];
-        for (int i = 0; i < H_node_count; ++i)
+    int H_node_count = h_node_counts[0];
+    for (int i = 0; i < H_node_count; ++i)
+    {
+        std::string glob_outp_quant = glob_outp_quants[i];
+        for (size_t j = 0; j < to_up(glob_outp_quant).size(); ++j)
         {
-            std::string glob_outp_quant = glob_outp_quants[i];
-            for (size_t j = 0; j < to_up(glob_outp_quant).size(); ++j)
-            {
 
-                __int64 index = std::find(quantsymbols.begin(), quantsymbols.end(), glob_outp_quant.substr(j, 1)) -
-                                quantsymbols.begin();
-                if (index == quantsymbols.size())
-                    throw std::out_of_range("Cannot find " + glob_outp_quant.substr(j, 1) + " in global quantity list");
+            __int64 index = std::find(quantsymbols.begin(), quantsymbols.end(), glob_outp_quant.substr(j, 1)) -
+                            quantsymbols.begin();
+            if (index == quantsymbols.size())
+                throw std::out_of_range("Cannot find " + glob_outp_quant.substr(j, 1) + " in global quantity list");
+            if (quantnames[index] == "Composition")
+            {
+                for (int k = 1; k <= max_num_species; k++)
+                {
+                    std::string spec_descr =
+                        std::string(quantnames[index] + " " + std::to_string(k) + " " + std::to_string(i + 1));
+                    numproperties++;
+                    propertylist[spec_descr] =
+                        wanda_property(numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
+                                       wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
+                    propertylist[spec_descr].set_species_number(k);
+                    propertylist[spec_descr].set_connection_point(i);
+                }
+            }
+            else
+            {
+                std::string spec_descr = std::string(quantnames[index] + " " + std::to_string(i + 1));
+                numproperties++;
+                propertylist[spec_descr] =
+                    wanda_property(numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
+                                   wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
+                propertylist[spec_descr].set_connection_point(i);
+            }
+            std::string spec_descr = std::string(quantnames[index]);
+            if (comp_type[0] == "PIPE" &&
+                propertylist.find(spec_descr) == propertylist.end())
+            {
+                // component is a pipe add also internal output properties
                 if (quantnames[index] == "Composition")
                 {
                     for (int k = 1; k <= max_num_species; k++)
                     {
-                        std::string spec_descr =
-                            std::string(quantnames[index] + " " + std::to_string(k) + " " + std::to_string(i + 1));
+                        spec_descr = std::string(quantnames[index] + " " + std::to_string(k));
                         numproperties++;
-                        phys_output_props[classsort_key][spec_descr] =
-                            wanda_property(numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
-                                           wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
-                        phys_output_props[classsort_key][spec_descr].set_species_number(k);
-                        phys_output_props[classsort_key][spec_descr].set_connection_point(i);
+                        propertylist[spec_descr] = wanda_property(
+                            numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
+                            wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
+                        propertylist[spec_descr].set_con_point_quant(false);
+                        propertylist[spec_descr].set_species_number(k);
                     }
                 }
                 else
                 {
-                    std::string spec_descr = std::string(quantnames[index] + " " + std::to_string(i + 1));
+                    spec_descr = std::string(quantnames[index]);
                     numproperties++;
-                    phys_output_props[classsort_key][spec_descr] =
+                    propertylist[spec_descr] =
                         wanda_property(numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
                                        wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
-                    phys_output_props[classsort_key][spec_descr].set_connection_point(i);
-                }
-                std::string spec_descr = std::string(quantnames[index]);
-                if (comp_type[0] == "PIPE" &&
-                    phys_output_props[classsort_key].find(spec_descr) == phys_output_props[classsort_key].end())
-                {
-                    // component is a pipe add also internal output properties
-                    if (quantnames[index] == "Composition")
-                    {
-                        for (int k = 1; k <= max_num_species; k++)
-                        {
-                            spec_descr = std::string(quantnames[index] + " " + std::to_string(k));
-                            numproperties++;
-                            phys_output_props[classsort_key][spec_descr] = wanda_property(
-                                numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
-                                wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
-                            phys_output_props[classsort_key][spec_descr].set_con_point_quant(false);
-                            phys_output_props[classsort_key][spec_descr].set_species_number(k);
-                        }
-                    }
-                    else
-                    {
-                        spec_descr = std::string(quantnames[index]);
-                        numproperties++;
-                        phys_output_props[classsort_key][spec_descr] =
-                            wanda_property(numproperties, spec_descr, '0', 'G', WDO_postfixes[index], unit_dims[index],
-                                           wanda_property_types::GLOQUANT, glob_outp_quant.substr(j, 1));
-                        phys_output_props[classsort_key][spec_descr].set_con_point_quant(false);
-                    }
+                    propertylist[spec_descr].set_con_point_quant(false);
                 }
             }
         }
+    }
 
-        // HOS properties
-        groupname = classsort_key + "_HOS";
-        int n_hydr_out_specs = _database.get_int_attribute(groupname, "N_hydr_out_specs");
-        if (n_hydr_out_specs > 0)
+    // HOS properties
+    groupname = classsort_key + "_HOS";
+    int n_hydr_out_specs = _database.get_int_attribute(groupname, "N_hydr_out_specs");
+    if (n_hydr_out_specs > 0)
+    {
+        std::vector<std::string> spec_descr(n_hydr_out_specs);
+        std::vector<std::string> spec_descr_short(n_hydr_out_specs);
+        std::vector<std::string> comp_sp_inp_fld(n_hydr_out_specs);
+        std::vector<std::string> unit_dim_hos(n_hydr_out_specs);
+        _database.get_string_element(groupname, "Spec_descr", {1, n_hydr_out_specs, 1}, 30, spec_descr);
+        _database.get_string_element(groupname, "Spec_descr_short", {1, n_hydr_out_specs, 1}, 3, spec_descr_short);
+        _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, n_hydr_out_specs, 1}, 1, comp_sp_inp_fld);
+        _database.get_string_element(groupname, "Unit_dimension", {1, n_hydr_out_specs, 1}, 12, unit_dim_hos);
+
+        for (int i = 0; i < n_hydr_out_specs; i++)
         {
-            std::vector<std::string> spec_descr(n_hydr_out_specs);
-            std::vector<std::string> spec_descr_short(n_hydr_out_specs);
-            std::vector<std::string> comp_sp_inp_fld(n_hydr_out_specs);
-            std::vector<std::string> unit_dim_hos(n_hydr_out_specs);
-            _database.get_string_element(groupname, "Spec_descr", {1, n_hydr_out_specs, 1}, 30, spec_descr);
-            _database.get_string_element(groupname, "Spec_descr_short", {1, n_hydr_out_specs, 1}, 3, spec_descr_short);
-            _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, n_hydr_out_specs, 1}, 1, comp_sp_inp_fld);
-            _database.get_string_element(groupname, "Unit_dimension", {1, n_hydr_out_specs, 1}, 12, unit_dim_hos);
-
-            for (int i = 0; i < n_hydr_out_specs; i++)
-            {
-                numproperties++;
-                phys_output_props[classsort_key][spec_descr[i]] =
-                    wanda_property(numproperties, spec_descr[i], '0', comp_sp_inp_fld[i][0], "HOS", unit_dim_hos[i],
-                                   wanda_property_types::HOS, spec_descr_short[i]);
-                ;
-                phys_output_props[classsort_key][spec_descr[i]].set_hos_index(i);
-            }
+            numproperties++;
+            propertylist[spec_descr[i]] =
+                wanda_property(numproperties, spec_descr[i], '0', comp_sp_inp_fld[i][0], "HOS", unit_dim_hos[i],
+                               wanda_property_types::HOS, spec_descr_short[i]);
+            ;
+            propertylist[spec_descr[i]].set_hos_index(i);
         }
-        // HOV properties
-        groupname = classsort_key + "_HOV";
-        n_hydr_out_specs = _database.get_int_attribute(groupname, "N_hydr_out_specs");
-        if (n_hydr_out_specs > 0)
+    }
+    // HOV properties
+    groupname = classsort_key + "_HOV";
+    n_hydr_out_specs = _database.get_int_attribute(groupname, "N_hydr_out_specs");
+    if (n_hydr_out_specs > 0)
+    {
+        std::vector<std::string> spec_descr(n_hydr_out_specs);
+        std::vector<std::string> spec_descr_short(n_hydr_out_specs);
+        std::vector<std::string> comp_sp_inp_fld(n_hydr_out_specs);
+        std::vector<std::string> unit_dim_hov(n_hydr_out_specs);
+        _database.get_string_element(groupname, "Spec_descr", {1, n_hydr_out_specs, 1}, 30, spec_descr);
+        _database.get_string_element(groupname, "Spec_descr_short", {1, n_hydr_out_specs, 1}, 3, spec_descr_short);
+        _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, n_hydr_out_specs, 1}, 1, comp_sp_inp_fld);
+        _database.get_string_element(groupname, "Unit_dimension", {1, n_hydr_out_specs, 1}, 12, unit_dim_hov);
+        for (int i = 0; i <= n_hydr_out_specs - 1; i++)
         {
-            std::vector<std::string> spec_descr(n_hydr_out_specs);
-            std::vector<std::string> spec_descr_short(n_hydr_out_specs);
-            std::vector<std::string> comp_sp_inp_fld(n_hydr_out_specs);
-            std::vector<std::string> unit_dim_hov(n_hydr_out_specs);
-            _database.get_string_element(groupname, "Spec_descr", {1, n_hydr_out_specs, 1}, 30, spec_descr);
-            _database.get_string_element(groupname, "Spec_descr_short", {1, n_hydr_out_specs, 1}, 3, spec_descr_short);
-            _database.get_string_element(groupname, "Comp_sp_inp_fld", {1, n_hydr_out_specs, 1}, 1, comp_sp_inp_fld);
-            _database.get_string_element(groupname, "Unit_dimension", {1, n_hydr_out_specs, 1}, 12, unit_dim_hov);
-            for (int i = 0; i <= n_hydr_out_specs - 1; i++)
-            {
-                numproperties++;
-                phys_output_props[classsort_key][spec_descr[i]] =
-                    wanda_property(numproperties, spec_descr[i], '0', comp_sp_inp_fld[i][0], "HOV", unit_dim_hov[i],
-                                   wanda_property_types::HOV, spec_descr_short[i]);
-                phys_output_props[classsort_key][spec_descr[i]].set_hos_index(i);
-            }
+            numproperties++;
+            propertylist[spec_descr[i]] =
+                wanda_property(numproperties, spec_descr[i], '0', comp_sp_inp_fld[i][0], "HOV", unit_dim_hov[i],
+                               wanda_property_types::HOV, spec_descr_short[i]);
+            propertylist[spec_descr[i]].set_hos_index(i);
         }
     }
-    return phys_output_props[classsort_key];
+    return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_control_input_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_control_input_properties(const std::string &classsort_key)
 {
     std::string groupname = classsort_key + "_CTR";
-    std::unordered_map<std::string, wanda_property> propertylist;
+    wanda_property_map propertylist;
     int n_cis = _database.get_int_attribute(groupname, "N_ctr_specs");
     if (n_cis > 0)
     {
@@ -850,10 +906,10 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_control_input_pro
     return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_control_output_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_control_output_properties(const std::string &classsort_key)
 {
     int numproperties = -1;
-    std::unordered_map<std::string, wanda_property> propertylist;
+    wanda_property_map propertylist;
     std::string groupname = classsort_key + "_CTR";
     std::vector<int> n_output_chanl(1);
     _database.get_int_element(groupname, "N_output_chanl", nefis_file::single_elem_uindex, n_output_chanl);
@@ -917,11 +973,11 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_control_output_pr
     return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_node_input_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_node_input_properties(const std::string &classsort_key)
 {
     std::string groupname = classsort_key + "_NOD";
     int hydr_inp_specs = _database.get_int_attribute(groupname, "N_hydr_inp_specs");
-    std::unordered_map<std::string, wanda_property> propertylist(hydr_inp_specs);
+    wanda_property_map propertylist(hydr_inp_specs);
     if (hydr_inp_specs > 0)
     {
         std::vector<std::string> spec_descr(hydr_inp_specs);
@@ -999,7 +1055,7 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_node_input_proper
     return propertylist;
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_node_output_properties(std::string classsort_key)
+wanda_property_map wanda_def::load_node_output_properties(const std::string &classsort_key)
 {
     int numproperties = -1;
     std::string groupname = classsort_key + "_NOD";
@@ -1009,7 +1065,7 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_node_output_prope
     std::vector<std::string> quantity_name(n_avail_quants);
     std::vector<std::string> WDO_postfix(n_avail_quants);
     std::vector<std::string> unit_dim(n_avail_quants);
-    std::unordered_map<std::string, wanda_property> propertylist;
+    wanda_property_map propertylist;
     const nefis_uindex avail_quants_index = {1, n_avail_quants, 1};
     _database.get_string_element(groupname, "Node_outp_quant", nefis_file::single_elem_uindex, 16, node_outp_quant);
     _database.get_string_element("GLOBAL_QUANTITIE", "Quantity_symbol", avail_quants_index, 1, quantity_symbol);
@@ -1078,6 +1134,7 @@ std::unordered_map<std::string, wanda_property> wanda_def::get_node_output_prope
 
 std::string wanda_def::get_name_prefix_phys_comp(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
 
     std::vector<std::string> resultarray(1);
@@ -1087,6 +1144,7 @@ std::string wanda_def::get_name_prefix_phys_comp(std::string classsort_key)
 
 std::string wanda_def::get_name_prefix_phys_node(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_NOD";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Name_prefix", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1095,6 +1153,7 @@ std::string wanda_def::get_name_prefix_phys_node(std::string classsort_key)
 
 std::string wanda_def::get_name_prefix_ctrl_comp(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_CTR";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Name_prefix", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1103,6 +1162,7 @@ std::string wanda_def::get_name_prefix_ctrl_comp(std::string classsort_key)
 
 std::string wanda_def::get_class_name_phys_comp(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Class_name", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1111,6 +1171,7 @@ std::string wanda_def::get_class_name_phys_comp(std::string classsort_key)
 
 std::string wanda_def::get_class_name_phys_node(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_NOD";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Class_name", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1119,6 +1180,7 @@ std::string wanda_def::get_class_name_phys_node(std::string classsort_key)
 
 std::string wanda_def::get_class_name_ctrl_comp(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_CTR";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Class_name", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1127,6 +1189,7 @@ std::string wanda_def::get_class_name_ctrl_comp(std::string classsort_key)
 
 std::string wanda_def::get_type_phys_comp(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Comp_type", nefis_file::single_elem_uindex, 8, resultarray);
@@ -1135,6 +1198,7 @@ std::string wanda_def::get_type_phys_comp(std::string classsort_key)
 
 std::string wanda_def::get_type_name_phys(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Type_name", nefis_file::single_elem_uindex, 48, resultarray);
@@ -1143,6 +1207,7 @@ std::string wanda_def::get_type_name_phys(std::string classsort_key)
 
 std::string wanda_def::get_type_name_node(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_NOD";
     std::vector<std::string> resultarray(1);
     _database.get_string_element(groupname, "Type_name", nefis_file::single_elem_uindex, 48, resultarray);
@@ -1199,18 +1264,21 @@ std::string wanda_def::get_default_mask(std::string classsort_key)
 
 int wanda_def::get_physical_num_com_his(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_HIS";
     return _database.get_int_attribute(groupname, "N_his_com");
 }
 
 int wanda_def::get_physical_num_ope_his(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_HIS";
     return _database.get_int_attribute(groupname, "N_his_ope");
 }
 
 bool wanda_def::is_physical_component(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     bool out;
     std::unordered_set<std::string>::const_iterator value = _phys_class_sort_keys.find(classsort_key);
     if (value == _phys_class_sort_keys.end())
@@ -1222,6 +1290,7 @@ bool wanda_def::is_physical_component(std::string classsort_key)
 
 bool wanda_def::is_control_component(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     bool out;
     std::unordered_set<std::string>::const_iterator value = _control_class_sort_keys.find(classsort_key);
     if (value == _control_class_sort_keys.end())
@@ -1233,6 +1302,7 @@ bool wanda_def::is_control_component(std::string classsort_key)
 
 bool wanda_def::is_node(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::unordered_set<std::string>::const_iterator value = _node_class_sort_keys.find(classsort_key);
     if (value == _node_class_sort_keys.end())
         return false;
@@ -1256,6 +1326,7 @@ int wanda_def::get_key_index_array(std::vector<std::string> KeyArray, std::strin
 
 std::vector<std::string> wanda_def::get_comp_spec_ip_fld(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::vector<std::string> _spec_ip_fld;
     int nis;
     if (is_control_component(classsort_key))
@@ -1283,6 +1354,7 @@ std::vector<std::string> wanda_def::get_comp_spec_ip_fld(std::string classsort_k
 
 std::vector<int> wanda_def::get_max_in_chan(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string grpname = classsort_key + "_CTR";
     std::vector<int> max_input_chan(16);
     _database.get_int_element(grpname, "Chanl_in_maxsign", nefis_file::single_elem_uindex, max_input_chan);
@@ -1291,6 +1363,7 @@ std::vector<int> wanda_def::get_max_in_chan(std::string classsort_key)
 
 std::vector<int> wanda_def::get_min_in_chan(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string grpname = classsort_key + "_CTR";
     std::vector<int> min_input_chan(16);
     _database.get_int_element(grpname, "Chanl_in_minsign", nefis_file::single_elem_uindex, min_input_chan);
@@ -1299,6 +1372,7 @@ std::vector<int> wanda_def::get_min_in_chan(std::string classsort_key)
 
 std::vector<std::string> wanda_def::get_in_chan_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string grpname = classsort_key + "_CTR";
     std::vector<std::string> input_chan_type(16);
     _database.get_string_element(grpname, "Chanl_in_type", nefis_file::single_elem_uindex, 8, input_chan_type);
@@ -1307,6 +1381,7 @@ std::vector<std::string> wanda_def::get_in_chan_type(std::string classsort_key)
 
 std::vector<std::string> wanda_def::get_out_chan_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string grpname = classsort_key + "_CTR";
     std::vector<std::string> input_chan_type(16);
     _database.get_string_element(grpname, "Chanl_out_type", nefis_file::single_elem_uindex, 8, input_chan_type);
@@ -1315,6 +1390,7 @@ std::vector<std::string> wanda_def::get_out_chan_type(std::string classsort_key)
 
 std::string wanda_def::get_ctrl_input_type(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (ctrl_input_type.find(classsort_key) == ctrl_input_type.end())
     {
         std::string grpname = classsort_key + "_GEN";
@@ -1332,6 +1408,7 @@ std::string wanda_def::get_data_path() const
 
 int wanda_def::get_num_con_points(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string grpname = classsort_key + "_GEN";
     std::vector<int> num_con_points(1);
     _database.get_int_element(grpname, "H_node_count", nefis_file::single_elem_uindex, num_con_points);
@@ -1340,6 +1417,7 @@ int wanda_def::get_num_con_points(std::string classsort_key)
 
 std::string wanda_def::get_quant_name(char symbol)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     int N_avail_quants = _database.get_int_attribute("GLOBAL_QUANTITIE", "N_avail_quants");
     std::vector<std::string> quantsymbol(N_avail_quants);
     std::vector<std::string> quantname(N_avail_quants);
@@ -1352,6 +1430,7 @@ std::string wanda_def::get_quant_name(char symbol)
 
 char wanda_def::get_quant_symbol(std::string quant_name)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     int N_avail_quants = _database.get_int_attribute("GLOBAL_QUANTITIE", "N_avail_quants");
     std::vector<std::string> quantsymbol(N_avail_quants);
     std::vector<std::string> quantname(N_avail_quants);
@@ -1363,6 +1442,7 @@ char wanda_def::get_quant_symbol(std::string quant_name)
 
 std::vector<std::string> wanda_def::get_list_quant_names(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::vector<std::string> glob_outp_quant(1);
     if (is_physical_component(classsort_key))
     {
@@ -1398,6 +1478,7 @@ std::vector<std::string> wanda_def::get_list_quant_names(std::string classsort_k
 
 int wanda_def::get_number_of_con_points(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<int> h_node_counts(1);
     _database.get_int_element(groupname, "H_node_count", nefis_file::single_elem_uindex, h_node_counts);
@@ -1406,6 +1487,7 @@ int wanda_def::get_number_of_con_points(std::string classsort_key)
 
 bool wanda_def::get_controlable(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     std::string groupname = classsort_key + "_GEN";
     std::vector<int> comp_contrl_code(1);
     _database.get_int_element(groupname, "Comp_contrl_code", nefis_file::single_elem_uindex, comp_contrl_code);
@@ -1414,6 +1496,7 @@ bool wanda_def::get_controlable(std::string classsort_key)
 
 float wanda_def::get_unit_factor(std::string unit_dim, std::string unit_descr)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (unit_list.find(unit_dim) == unit_list.end())
     {
         throw std::invalid_argument(unit_dim + " does not exist in Wanda");
@@ -1427,36 +1510,26 @@ float wanda_def::get_unit_factor(std::string unit_dim, std::string unit_descr)
 
 wanda_component *wanda_def::get_component(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (_components_list.find(classsort_key) == _components_list.end())
     {
+        auto definition = get_class_definition(classsort_key);
         std::string name_pre_fix;
         wanda_type type;
         int num_com_spec = 0;
         int num_oper_spec = 0;
         int num_hcs = 0;
-        int number_of_connnect_points = 0;
-        bool controlable = false;
-        std::vector<std::string> core_quants;
-        std::unordered_map<std::string, wanda_property> props = get_properties(classsort_key);
         std::string def_mask = get_default_mask(classsort_key);
         std::string conv2comp = get_convert2_comp(classsort_key);
-        std::string h_ctrl_input;
         std::string type_name;
         std::string typecomp;
-        int max_input_channels = 0;
-        int min_input_channels = 0;
         if (is_physical_component(classsort_key))
         {
-            std::vector<int> inputs = get_num_input_props(classsort_key);
-            num_com_spec = inputs[0];
-            num_oper_spec = inputs[1];
-            num_hcs = inputs[2];
+            num_com_spec = definition->num_input_props[0];
+            num_oper_spec = definition->num_input_props[1];
+            num_hcs = definition->num_input_props[2];
             name_pre_fix = get_name_prefix_phys_comp(classsort_key);
             type = wanda_type::physical;
-            number_of_connnect_points = get_number_of_con_points(classsort_key);
-            controlable = get_controlable(classsort_key);
-            core_quants = get_core_quants(classsort_key);
-            h_ctrl_input = get_ctrl_input_type(classsort_key);
             type_name = get_type_name_phys(classsort_key);
             typecomp = get_type_phys_comp(classsort_key);
         }
@@ -1465,22 +1538,20 @@ wanda_component *wanda_def::get_component(std::string classsort_key)
             name_pre_fix = get_name_prefix_ctrl_comp(classsort_key);
             type = wanda_type::control;
             type_name = get_type_name_ctrl(classsort_key);
-
-            if (classsort_key == "SENSOR")
-            {
-                number_of_connnect_points = 1;
-            }
         }
-        _components_list.emplace(
-            classsort_key, wanda_component(classsort_key, name_pre_fix, type, typecomp, num_com_spec, num_oper_spec,
-                                           num_hcs, number_of_connnect_points, controlable, core_quants, props,
-                                           h_ctrl_input, type_name, def_mask, conv2comp, this));
+        _components_list.emplace(classsort_key,
+                                 wanda_component(classsort_key, name_pre_fix, type, typecomp, num_com_spec,
+                                                 num_oper_spec, num_hcs, definition->number_of_con_points,
+                                                 definition->controlable, definition->core_quants,
+                                                 *definition->properties, definition->ctrl_input_type, type_name,
+                                                 def_mask, conv2comp, this));
     }
     return &_components_list[classsort_key];
 }
 
 wanda_node *wanda_def::get_node(std::string classsort_key)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
     if (_node_list.find(classsort_key) == _node_list.end())
     {
         std::string def_mask = get_default_mask(classsort_key);
@@ -1493,40 +1564,144 @@ wanda_node *wanda_def::get_node(std::string classsort_key)
     return &_node_list[classsort_key];
 }
 
-std::unordered_map<std::string, wanda_property> wanda_def::get_properties(std::string classsort_key)
+namespace
+{
+// returns the cached property map of the class sort key, the map is loaded on first use
+template <typename loader>
+std::shared_ptr<const wanda_property_map> get_cached_properties(
+    std::unordered_map<std::string, std::shared_ptr<const wanda_property_map>> &cache,
+    const std::string &classsort_key, loader load)
+{
+    auto iter = cache.find(classsort_key);
+    if (iter == cache.end())
+    {
+        iter = cache.emplace(classsort_key, std::make_shared<const wanda_property_map>(load())).first;
+    }
+    return iter->second;
+}
+} // namespace
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_physical_input_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(phys_input_props, classsort_key,
+                                 [&]() { return load_physical_input_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_physical_calc_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(phys_calc_props, classsort_key,
+                                 [&]() { return load_physical_calc_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_physical_output_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(phys_output_props, classsort_key,
+                                 [&]() { return load_physical_output_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_control_input_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(ctrl_input_props, classsort_key,
+                                 [&]() { return load_control_input_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_control_output_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(ctrl_output_props, classsort_key,
+                                 [&]() { return load_control_output_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_node_input_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(node_input_props, classsort_key,
+                                 [&]() { return load_node_input_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_node_output_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(node_output_props, classsort_key,
+                                 [&]() { return load_node_output_properties(classsort_key); });
+}
+
+std::shared_ptr<const wanda_property_map> wanda_def::get_properties(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return get_cached_properties(class_props, classsort_key, [&]() { return load_properties(classsort_key); });
+}
+
+wanda_property_map wanda_def::load_properties(const std::string &classsort_key)
 {
     if (is_physical_component(classsort_key))
     {
-        if (phys_props.find(classsort_key) == phys_props.end())
-        {
-            std::unordered_map<std::string, wanda_property> props = get_physical_input_properties(classsort_key);
-            std::unordered_map<std::string, wanda_property> calc_prop = get_physical_calc_properties(classsort_key);
-            std::unordered_map<std::string, wanda_property> out_prop = get_physical_output_properties(classsort_key);
-            props.insert(calc_prop.begin(), calc_prop.end());
-            props.insert(out_prop.begin(), out_prop.end());
-            phys_props.emplace(classsort_key, props);
-        }
-        return phys_props[classsort_key];
+        wanda_property_map props = *get_physical_input_properties(classsort_key);
+        auto calc_prop = get_physical_calc_properties(classsort_key);
+        auto out_prop = get_physical_output_properties(classsort_key);
+        props.insert(calc_prop->begin(), calc_prop->end());
+        props.insert(out_prop->begin(), out_prop->end());
+        return props;
     }
     if (is_control_component(classsort_key))
     {
-        std::unordered_map<std::string, wanda_property> props = get_control_input_properties(classsort_key);
-        std::unordered_map<std::string, wanda_property> out_prop = get_control_output_properties(classsort_key);
-        props.insert(out_prop.begin(), out_prop.end());
+        wanda_property_map props = *get_control_input_properties(classsort_key);
+        auto out_prop = get_control_output_properties(classsort_key);
+        props.insert(out_prop->begin(), out_prop->end());
         return props;
     }
     if (is_node(classsort_key))
     {
-        if (node_props.find(classsort_key) == node_props.end())
+        wanda_property_map props = *get_node_input_properties(classsort_key);
+        auto out_prop = get_node_output_properties(classsort_key);
+        props.insert(out_prop->begin(), out_prop->end());
+        return props;
+    }
+    throw std::invalid_argument(classsort_key + " does not exist in Wandadef");
+}
+
+std::shared_ptr<const wanda_class_definition> wanda_def::get_class_definition(const std::string &classsort_key)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto iter = _class_definitions.find(classsort_key);
+    if (iter != _class_definitions.end())
+    {
+        return iter->second;
+    }
+    auto definition = std::make_shared<wanda_class_definition>();
+    definition->class_sort_key = classsort_key;
+    definition->properties = get_properties(classsort_key);
+    definition->num_input_props = get_num_input_props(classsort_key);
+    if (is_physical_component(classsort_key))
+    {
+        definition->core_quants = get_core_quants(classsort_key);
+        definition->number_of_con_points = get_number_of_con_points(classsort_key);
+        definition->controlable = get_controlable(classsort_key);
+        definition->ctrl_input_type = get_ctrl_input_type(classsort_key);
+    }
+    else if (is_control_component(classsort_key))
+    {
+        definition->num_input_channels = get_num_input_chanl(classsort_key)[0];
+        definition->num_output_channels = get_num_output_chanl(classsort_key)[0];
+        definition->min_input_channels = get_min_in_chan(classsort_key);
+        definition->max_input_channels = get_max_in_chan(classsort_key);
+        definition->input_channel_type = get_in_chan_type(classsort_key);
+        definition->output_channel_type = get_out_chan_type(classsort_key);
+        if (classsort_key == "SENSOR")
         {
-            std::unordered_map<std::string, wanda_property> props = get_node_input_properties(classsort_key);
-            std::unordered_map<std::string, wanda_property> out_prop = get_node_output_properties(classsort_key);
-            props.insert(out_prop.begin(), out_prop.end());
-            node_props.emplace(classsort_key, props);
+            definition->number_of_con_points = 1;
         }
-        return node_props[classsort_key];
     }
-    throw std::invalid_argument(classsort_key + " does not exist in Wandadef");
+    else
+    {
+        definition->core_quants.push_back(get_node_core_quants(classsort_key));
+        definition->node_type = get_node_type(classsort_key);
+    }
+    return _class_definitions.emplace(classsort_key, std::move(definition)).first->second;
 }
 
 void wanda_def::load_unit_list()
@@ -1555,6 +1730,65 @@ void wanda_def::load_unit_list()
     }
 }
 
+void wanda_def::load_all_definitions()
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::vector<std::string> com;
+    std::vector<std::string> ope;
+    for (const auto &classsort_key : _phys_class_sort_keys)
+    {
+        get_class_definition(classsort_key);
+        get_component(classsort_key);
+        get_class_name_phys_comp(classsort_key);
+        get_physical_num_com_his(classsort_key);
+        get_physical_num_ope_his(classsort_key);
+        get_ip_fld_his(classsort_key, com, ope);
+        get_list_quant_names(classsort_key);
+        get_num_con_points(classsort_key);
+        is_obsolete(classsort_key);
+    }
+    for (const auto &classsort_key : _control_class_sort_keys)
+    {
+        get_class_definition(classsort_key);
+        get_component(classsort_key);
+        get_class_name_ctrl_comp(classsort_key);
+        get_ip_fld_his(classsort_key, com);
+        get_ctrl_in_type(classsort_key);
+        get_ctrl_out_type(classsort_key);
+        get_comp_spec_ip_fld(classsort_key);
+        is_obsolete(classsort_key);
+    }
+    for (const auto &classsort_key : _node_class_sort_keys)
+    {
+        get_class_definition(classsort_key);
+        get_node(classsort_key);
+        get_class_name_phys_node(classsort_key);
+        get_comp_spec_ip_fld(classsort_key);
+        get_list_quant_names(classsort_key);
+        is_obsolete(classsort_key);
+    }
+    get_possible_phys_comp_type();
+    get_possible_ctrl_comp_type();
+    get_possible_node_type();
+    get_unit_list();
+    for (const auto &unit_group :
+         {"UNIT_GROUP_SI", "UNIT_GROUP_UK", "UNIT_GROUP_US", "UNIT_GROUP_USER", "UNIT_GROUP_WD"})
+    {
+        get_case_unit(unit_group);
+    }
+}
+
+void wanda_def::save_snapshot(const std::string &file) const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _database.save_snapshot(file);
+}
+
+bool wanda_def::is_snapshot() const
+{
+    return _database.is_snapshot();
+}
+
 std::string wanda_def::get_wanda_version() const
 {
     return wanda_version_.to_string();
@@ -9,6 +9,7 @@
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <mutex>
 #include <numeric>
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,6 +29,8 @@
 #include "wandanode.h"
 #include "wandaproperty.h"
 #include "wandasigline.h"
+#include "wanda_metrics.h"
+#include "wanda_trace.h"
 #include "deltares_helper_functions.h"
 
 #ifdef _WIN32
@@ -495,7 +498,7 @@ wanda_model::wanda_model(const std::string &casefile, const std::string &Wandadi
     std::cout << "Wanda bin directory: " << Wandadir << '\n';
 #endif
 
-    if (!FileExists(Wandadir + "wandadef.dat"))
+    if (!FileExists(Wandadir + "wandadef.dat") && !FileExists(Wandadir + wanda_def_snapshot::file_name))
     {
 #ifdef DEBUG
         std::cout << Wandadir + " Not a valid Wanda bin directory,  wandadef.dat not found";
@@ -511,7 +514,7 @@ wanda_model::wanda_model(const std::string &casefile, const std::string &Wandadi
 
     try
     {
-        component_definition = new wanda_def(wanda_bin);
+        component_definition = wanda_def::get_shared(wanda_bin);
     }
     catch (std::runtime_error error)
     {
@@ -525,7 +528,6 @@ wanda_model::~wanda_model()
     ::checkin(lic_feat_WANDA_SYSTEM);
     ::cleanup(); // cleanup license auth library
     close();
-    delete component_definition;
 }
 
 std::tuple<bool,bool> wanda_model::check_wanda_version()
@@ -545,11 +547,12 @@ void wanda_model::load_wanda_version()
 void wanda_model::calc_hsc(wanda_component& component)
 {
     auto const component_dll = wanda_component_dll::get_instance(wanda_bin);
-    component_dll->calc_hydraulic_spec_component(component, get_globvar_hcs());
+    component_dll->calc_hydraulic_spec_component(component, get_globvar_hcs(), hcs_backend);
 }
 
 void wanda_model::initialize(std::string wdifile, bool upgrade_model_in)
 {
+    WANDA_TRACE_SCOPE("wanda_model::initialize");
     if (!FileExists(wdifile))
     {
         new_wanda_case(wdifile);
@@ -590,6 +593,7 @@ void wanda_model::initialize(std::string wdifile, bool upgrade_model_in)
     read_control_comp();
     read_signal_lines();
     reload_input();
+    get_keyword_index();
     if (FileExists(_wdofile))
     {
         wanda_output_file.open();
@@ -627,6 +631,7 @@ void wanda_model::close()
 
 void wanda_model::save_model_input()
 {
+    WANDA_TRACE_SCOPE("wanda_model::save_model_input");
     // check which license is required (liquid, heat, mst, control)
     std::unordered_map<char, std::string> pos_lic_features;
     pos_lic_features['L'] = "Liquid";
@@ -825,6 +830,7 @@ void wanda_model::save_model_input()
 
 void wanda_model::reload_input()
 {
+    WANDA_TRACE_SCOPE("wanda_model::reload_input");
     num_cols_loaded = false;
     tables_loaded = false;
     table_metainfo_cache.clear();
@@ -857,6 +863,90 @@ void wanda_model::read_component_output(wanda_component &component)
     }
 }
 
+namespace
+{
+struct output_allocations
+{
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+// resizes the output buffer to rows of size values, the allocations are counted from the capacity the vectors get
+void resize_rows(std::vector<std::vector<float>> &rows, size_t number_of_rows, size_t size,
+                 output_allocations &allocations)
+{
+    const auto capacity = rows.capacity();
+    rows.resize(number_of_rows);
+    if (rows.capacity() != capacity)
+    {
+        allocations.count++;
+        allocations.bytes += rows.capacity() * sizeof(std::vector<float>);
+    }
+    for (auto &values : rows)
+    {
+        const auto values_capacity = values.capacity();
+        values.resize(size);
+        if (values.capacity() != values_capacity)
+        {
+            allocations.count++;
+            allocations.bytes += values.capacity() * sizeof(float);
+        }
+    }
+}
+} // namespace
+
+bool wanda_model::read_output_quantity(wanda_property &item, wanda_output_data_struct &buffer)
+{
+    static auto &allocation_count = wanda_metrics::counter("wanda_output_allocations_total");
+    static auto &allocated_bytes = wanda_metrics::counter("wanda_output_allocated_bytes_total");
+    std::string group_name = "OUTP_";
+    group_name.append(item.get_wdo_postfix());
+    std::string group_name_extr = "EXTR_";
+    group_name_extr.append(item.get_wdo_postfix());
+    int N_values = wanda_output_file.get_int_attribute(group_name, "N_values");
+    if (N_values == 0)
+        return false;
+    // num_timesteps = wanda_output_file.get_int_attribute(group_name,
+    // "N_timesteps");
+    num_timesteps = wanda_output_file.get_int_attribute("OUTPUT_TIME", "N_timesteps");
+    output_allocations allocations;
+    const auto rows = static_cast<size_t>(N_values);
+    resize_rows(buffer.time_series_data, rows, static_cast<size_t>(num_timesteps), allocations);
+    resize_rows(buffer.maximum_value_time, rows, 1, allocations);
+    resize_rows(buffer.minimum_value_time, rows, 1, allocations);
+    resize_rows(buffer.minimum_value, rows, 1, allocations);
+    resize_rows(buffer.maximum_value, rows, 1, allocations);
+    if (wanda_metrics::is_enabled())
+    {
+        allocation_count.add(allocations.count);
+        allocated_bytes.add(allocations.bytes);
+    }
+
+    if (item.get_property_type() != wanda_property_types::HOV &&
+        item.get_property_type() != wanda_property_types::NOV &&
+        item.get_property_type() != wanda_property_types::COV)
+    {
+        wanda_output_file.get_float_element(group_name, "Value", {1, N_values, 1}, {1, num_timesteps, 1},
+                                            buffer.time_series_data);
+        wanda_output_file.get_float_element(group_name_extr, "T_Value_max", {1, N_values, 1},
+                                            nefis_file::single_elem_uindex, buffer.maximum_value_time);
+        wanda_output_file.get_float_element(group_name_extr, "T_Value_min", {1, N_values, 1},
+                                            nefis_file::single_elem_uindex, buffer.minimum_value_time);
+        wanda_output_file.get_float_element(group_name_extr, "Value_max", {1, N_values, 1},
+                                            nefis_file::single_elem_uindex, buffer.maximum_value);
+        wanda_output_file.get_float_element(group_name_extr, "Value_min", {1, N_values, 1},
+                                            nefis_file::single_elem_uindex, buffer.minimum_value);
+    }
+    else
+    {
+        wanda_output_file.get_float_element(group_name, "Value", {1, N_values, 1}, nefis_file::single_elem_uindex,
+                                            buffer.time_series_data, false);
+    }
+    buffer.unit_id = resolve_unit_id(item);
+    apply_output_units(buffer);
+    return true;
+}
+
 void wanda_model::read_prop_output(wanda_property &item)
 {
 
@@ -864,75 +954,52 @@ void wanda_model::read_prop_output(wanda_property &item)
         item.get_property_type() == wanda_property_types::HCS ||
         item.get_property_type() == wanda_property_types::CIS || item.get_property_type() == wanda_property_types::NIS)
         return;
-    if (output_quantity_cache.find(item.get_wdo_postfix()) == output_quantity_cache.end())
-    {
-        std::string group_name = "OUTP_";
-        group_name.append(item.get_wdo_postfix());
-        std::string group_name_extr = "EXTR_";
-        group_name_extr.append(item.get_wdo_postfix());
-        int N_values = wanda_output_file.get_int_attribute(group_name, "N_values");
-        if (N_values == 0)
-            return;
-        // num_timesteps = wanda_output_file.get_int_attribute(group_name,
-        // "N_timesteps");
-        num_timesteps = wanda_output_file.get_int_attribute("OUTPUT_TIME", "N_timesteps");
-        wanda_output_data_struct *buffer = new wanda_output_data_struct;
-        buffer->time_series_data.resize(N_values, std::vector<float>(num_timesteps));
-        buffer->maximum_value_time.resize(N_values, std::vector<float>(1));
-        buffer->minimum_value_time.resize(N_values, std::vector<float>(1));
-        buffer->minimum_value.resize(N_values, std::vector<float>(1));
-        buffer->maximum_value.resize(N_values, std::vector<float>(1));
-
-        if (item.get_property_type() != wanda_property_types::HOV &&
-            item.get_property_type() != wanda_property_types::NOV &&
-            item.get_property_type() != wanda_property_types::COV)
-        {
-            wanda_output_file.get_float_element(group_name, "Value", {1, N_values, 1}, {1, num_timesteps, 1},
-                                                buffer->time_series_data);
-            wanda_output_file.get_float_element(group_name_extr, "T_Value_max", {1, N_values, 1},
-                                                nefis_file::single_elem_uindex, buffer->maximum_value_time);
-            wanda_output_file.get_float_element(group_name_extr, "T_Value_min", {1, N_values, 1},
-                                                nefis_file::single_elem_uindex, buffer->minimum_value_time);
-            wanda_output_file.get_float_element(group_name_extr, "Value_max", {1, N_values, 1},
-                                                nefis_file::single_elem_uindex, buffer->maximum_value);
-            wanda_output_file.get_float_element(group_name_extr, "Value_min", {1, N_values, 1},
-                                                nefis_file::single_elem_uindex, buffer->minimum_value);
+    static auto &cache_hits = wanda_metrics::counter("wanda_output_cache_hits_total");
+    static auto &cache_misses = wanda_metrics::counter("wanda_output_cache_misses_total");
+    static auto &load_latency = wanda_metrics::histogram("wanda_output_load_seconds");
+    // the output is read straight into the entry of the cache, properties refer to it until the output is reloaded
+    auto [entry, inserted] = output_quantity_cache.try_emplace(item.get_wdo_postfix());
+    if (inserted)
+    {
+        wanda_metric_timer load_timer(load_latency);
+        if (wanda_metrics::is_enabled())
+        {
+            cache_misses.add();
         }
-        else
+        try
         {
-            wanda_output_file.get_float_element(group_name, "Value", {1, N_values, 1}, nefis_file::single_elem_uindex,
-                                                buffer->time_series_data, false);
+            if (!read_output_quantity(item, entry->second))
+            {
+                output_quantity_cache.erase(entry);
+                return;
+            }
+        }
+        catch (...)
+        {
+            // a partly read entry is not left in the cache
+            output_quantity_cache.erase(entry);
+            throw;
         }
-        output_quantity_cache.emplace(std::make_pair(item.get_wdo_postfix(), *buffer));
-        delete buffer;
     }
-    auto &outputdata = output_quantity_cache[item.get_wdo_postfix()];
+    else if (wanda_metrics::is_enabled())
+    {
+        cache_hits.add();
+    }
+    auto &outputdata = entry->second;
     if (item.get_property_type() == wanda_property_types::HOV ||
         item.get_property_type() == wanda_property_types::COV || item.get_property_type() == wanda_property_types::NOV)
     {
         int index = item.get_group_index() + item.get_hos_index() - 1;
-        item.set_scalar_by_ref(outputdata.time_series_data[index][0]);
-    }
-    else if (item.get_number_of_elements() == 0)
-    {
-        item.set_series_by_ref(&outputdata.time_series_data[(item.get_group_index() + item.get_hos_index() - 1)]);
-        item.set_scalar_by_ref(outputdata.time_series_data[item.get_group_index() + item.get_hos_index() - 1]
-                                                          [0]); // Add steady state value as scalar
-        item.set_extremes(&outputdata.minimum_value[item.get_group_index() + item.get_hos_index() - 1][0],
-                          &outputdata.maximum_value[item.get_group_index() + item.get_hos_index() - 1][0],
-                          &outputdata.minimum_value_time[item.get_group_index() + item.get_hos_index() - 1][0],
-                          &outputdata.maximum_value_time[item.get_group_index() + item.get_hos_index() - 1][0]);
+        item.bind_output_scalar(&outputdata, index);
     }
     else
     {
-        for (int i = 0; i <= item.get_number_of_elements(); i++)
+        // series, steady state value and extremes are read directly from the cached output data
+        int index = item.get_group_index() + item.get_hos_index() - 1;
+        item.set_output_reference(&outputdata, index);
+        if (item.get_number_of_elements() == 0)
         {
-            item.set_series_pipe_by_ref(
-                i, &outputdata.time_series_data[item.get_group_index() + item.get_hos_index() - 1 + i]);
-            item.set_extremes(i, &outputdata.minimum_value[item.get_group_index() + item.get_hos_index() - 1 + i][0],
-                              &outputdata.maximum_value[item.get_group_index() + item.get_hos_index() - 1 + i][0],
-                              &outputdata.minimum_value_time[item.get_group_index() + item.get_hos_index() - 1 + i][0],
-                              &outputdata.maximum_value_time[item.get_group_index() + item.get_hos_index() - 1 + i][0]);
+            item.bind_output_scalar(&outputdata, index); // Add steady state value as scalar
         }
     }
 }
@@ -951,6 +1018,7 @@ void wanda_model::read_node_output(wanda_node &node)
 
 void wanda_model::reload_output()
 {
+    WANDA_TRACE_SCOPE("wanda_model::reload_output");
     if (!FileExists(wanda_output_file.get_filename()))
     {
         throw std::runtime_error("Wanda output file doesn't exist, run steady and/or unsteady "
@@ -978,14 +1046,36 @@ void wanda_model::reload_output()
     }
 }
 
+const wanda_keyword_index &wanda_model::get_keyword_index() const
+{
+    std::lock_guard<std::mutex> lock(index_mutex);
+    if (!keyword_index.is_valid())
+    {
+        // the index is a cache of the model, registering links the items owned by this model to it
+        auto register_items = [this](const auto &items) {
+            for (auto &item : items)
+            {
+                keyword_index.register_item(const_cast<wanda_item &>(static_cast<const wanda_item &>(item.second)));
+            }
+        };
+        keyword_index.invalidate();
+        register_items(phys_components);
+        register_items(ctrl_components);
+        register_items(phys_nodes);
+        register_items(signal_lines);
+        keyword_index.set_valid();
+    }
+    return keyword_index;
+}
+
 std::vector<std::string> wanda_model::get_components_name_with_keyword(std::string keyword)
 {
     std::vector<std::string> ComponentList;
-    for (auto item : phys_components)
+    for (auto item : get_keyword_index().find(keyword))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::physical)
         {
-            ComponentList.push_back(item.second.get_complete_name_spec());
+            ComponentList.push_back(item->get_complete_name_spec());
         }
     }
     return ComponentList;
@@ -993,20 +1083,20 @@ std::vector<std::string> wanda_model::get_components_name_with_keyword(std::stri
 
 std::vector<wanda_component *> wanda_model::get_components_with_keyword(std::string keyword)
 {
-    std::vector<wanda_component *> componentList;
+    return get_components_with_keywords({keyword}, true);
+}
 
-    for (auto &item : phys_components)
-    {
-        if (item.second.has_keyword(keyword))
-        {
-            componentList.push_back(&item.second);
-        }
-    }
-    for (auto &item : ctrl_components)
+std::vector<wanda_component *> wanda_model::get_components_with_keywords(const std::vector<std::string> &keywords,
+                                                                         bool match_all)
+{
+    auto &index = get_keyword_index();
+    std::vector<wanda_component *> componentList;
+    // physical components are registered before the control components, so the order is the same as before
+    for (auto item : match_all ? index.find_all(keywords) : index.find_any(keywords))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::physical || item->get_item_type() == wanda_type::control)
         {
-            componentList.push_back(&item.second);
+            componentList.push_back(static_cast<wanda_component *>(item));
         }
     }
     return componentList;
@@ -1015,11 +1105,11 @@ std::vector<wanda_component *> wanda_model::get_components_with_keyword(std::str
 std::vector<std::string> wanda_model::get_node_names_with_keyword(std::string keyword)
 {
     std::vector<std::string> ComponentList;
-    for (auto item : phys_nodes)
+    for (auto item : get_keyword_index().find(keyword))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::node)
         {
-            ComponentList.push_back(item.second.get_complete_name_spec());
+            ComponentList.push_back(item->get_complete_name_spec());
         }
     }
     return ComponentList;
@@ -1027,12 +1117,19 @@ std::vector<std::string> wanda_model::get_node_names_with_keyword(std::string ke
 
 std::vector<wanda_node *> wanda_model::get_nodes_with_keyword(std::string keyword)
 {
+    return get_nodes_with_keywords({keyword}, true);
+}
+
+std::vector<wanda_node *> wanda_model::get_nodes_with_keywords(const std::vector<std::string> &keywords,
+                                                               bool match_all)
+{
+    auto &index = get_keyword_index();
     std::vector<wanda_node *> ComponentList;
-    for (auto &item : phys_nodes)
+    for (auto item : match_all ? index.find_all(keywords) : index.find_any(keywords))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::node)
         {
-            ComponentList.push_back(&item.second);
+            ComponentList.push_back(static_cast<wanda_node *>(item));
         }
     }
     return ComponentList;
@@ -1041,11 +1138,11 @@ std::vector<wanda_node *> wanda_model::get_nodes_with_keyword(std::string keywor
 std::vector<wanda_sig_line *> wanda_model::get_signal_lines_with_keyword(std::string keyword)
 {
     std::vector<wanda_sig_line *> ComponentList;
-    for (auto &item : signal_lines)
+    for (auto item : get_keyword_index().find(keyword))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::signal_line)
         {
-            ComponentList.push_back(&item.second);
+            ComponentList.push_back(static_cast<wanda_sig_line *>(item));
         }
     }
     return ComponentList;
@@ -1054,15 +1151,16 @@ std::vector<wanda_sig_line *> wanda_model::get_signal_lines_with_keyword(std::st
 std::vector<std::string> wanda_model::get_signal_line_names_with_keyword(std::string keyword)
 {
     std::vector<std::string> line_names;
-    for (auto &item : signal_lines)
+    for (auto item : get_keyword_index().find(keyword))
     {
-        if (item.second.has_keyword(keyword))
+        if (item->get_item_type() == wanda_type::signal_line)
         {
-            line_names.push_back(item.second.get_complete_name_spec());
+            line_names.push_back(item->get_complete_name_spec());
         }
     }
     return line_names;
 }
+
 int wanda_model::get_num_time_steps()
 {
     float sim_time = get_property("Simulation time").get_scalar_float();
@@ -1072,51 +1170,78 @@ int wanda_model::get_num_time_steps()
     return int(floor(((sim_time - start_time) / time_step) / output_inc) + 1);
 }
 
+const wanda_graph_index &wanda_model::get_graph_index()
+{
+    std::lock_guard<std::mutex> lock(index_mutex);
+    if (!graph_index_valid)
+    {
+        graph_index.build(phys_components, ctrl_components, phys_nodes);
+        graph_index_valid = true;
+    }
+    return graph_index;
+}
+
 std::vector<wanda_component *> wanda_model::get_route(std::string keyword, std::vector<int> &dir)
 {
     std::vector<wanda_component *> components = get_components_with_keyword(keyword);
     if (components.empty())
         throw std::invalid_argument("No components with keyword " + keyword);
-    std::unordered_map<std::string, std::vector<std::string>> nodes;
-    std::unordered_map<std::string, std::vector<std::string>> comps;
-    int number_odd = 0;
+    auto &index = get_graph_index();
+    const int num_comps = index.get_number_of_components();
+    const int num_nodes = index.get_number_of_nodes();
+
+    std::vector<int> route_comps; // component ids of the route, in keyword order
+    std::vector<char> in_route(num_comps, 0);
     for (auto comp : components)
     {
-        for (int i = 1; i <= comp->get_number_of_connnect_points(); i++)
+        int comp_id = index.get_component_id(*comp);
+        route_comps.push_back(comp_id);
+        in_route[comp_id] = 1;
+    }
+    // node -> route components, only for the nodes which are part of the route
+    std::vector<std::vector<int>> nodes(num_nodes);
+    std::vector<char> node_in_route(num_nodes, 0);
+    int number_odd = 0;
+    for (int comp_id : route_comps)
+    {
+        auto &comp = index.get_component(comp_id);
+        bool is_junction = comp.get_physcomp_type() == "TEE" || comp.get_physcomp_type() == "CROSS";
+        for (int node_id : index.get_component_nodes(comp_id))
         {
-            auto node = comp->get_connected_node(i);
-            comps[comp->get_complete_name_spec()].push_back(node.get_complete_name_spec());
+            if (node_id == wanda_graph_index::not_connected)
+            {
+                throw std::invalid_argument("No node connected to that connection point");
+            }
             // if the component is a supplier it is a start point
-            if (comp->get_physcomp_type() == "SUPPLIER")
+            if (comp.get_physcomp_type() == "SUPPLIER")
             {
                 number_odd++;
             }
-            if (nodes.find(node.get_complete_name_spec()) == nodes.end())
+            if (!node_in_route[node_id])
             {
-                if (comp->get_physcomp_type() != "TEE" && comp->get_physcomp_type() != "CROSS")
+                if (!is_junction)
                 {
-                    nodes[node.get_complete_name_spec()].push_back(comp->get_complete_name_spec());
+                    node_in_route[node_id] = 1;
+                    nodes[node_id].push_back(comp_id);
                     number_odd++;
                 }
                 else
                 {
-                    for (auto con_comp : node.get_connected_components())
+                    for (int con_comp : index.get_node_components(node_id))
                     {
-                        if (con_comp->get_complete_name_spec() != comp->get_complete_name_spec())
+                        if (con_comp != comp_id && in_route[con_comp])
                         {
-                            if (con_comp->has_keyword(keyword))
-                            {
-                                nodes[node.get_complete_name_spec()].push_back(comp->get_complete_name_spec());
-                                number_odd++;
-                            }
+                            node_in_route[node_id] = 1;
+                            nodes[node_id].push_back(comp_id);
+                            number_odd++;
                         }
                     }
                 }
             }
             else
             {
-                nodes[node.get_complete_name_spec()].push_back(comp->get_complete_name_spec());
-                if ((nodes[node.get_complete_name_spec()].size() & 1) == 1)
+                nodes[node_id].push_back(comp_id);
+                if ((nodes[node_id].size() & 1) == 1)
                 {
                     number_odd++;
                 }
@@ -1139,77 +1264,77 @@ std::vector<wanda_component *> wanda_model::get_route(std::string keyword, std::
     }
 
     std::vector<wanda_component *> comps_ordered;
-    std::vector<std::string> comps_ordered_name;
-    std::vector<std::string> nodes_ordered_name;
-    // std::vector<int> dir;
+    std::vector<char> comp_visited(num_comps, 0);
+    std::vector<char> node_visited(num_nodes, 0);
+    int last_comp = wanda_graph_index::not_connected;
+    int last_node = wanda_graph_index::not_connected;
 
     if (number_odd == 0)
     {
         // startpoint does not matter
-        comps_ordered.push_back(components.at(0));
-        nodes_ordered_name.push_back(comps[components.at(0)->get_complete_name_spec()][0]);
+        last_comp = route_comps[0];
+        last_node = index.get_component_nodes(last_comp)[0];
         dir.push_back(1);
     }
     else
     {
-        for (auto node : nodes)
+        for (int node_id = 0; node_id < num_nodes; node_id++)
         {
-            if (node.second.size() == 1)
+            if (node_in_route[node_id] && nodes[node_id].size() == 1)
             {
-                comps_ordered.push_back(&get_component(node.second[0]));
-                nodes_ordered_name.push_back(node.first);
+                last_comp = nodes[node_id][0];
+                last_node = node_id;
                 // check to which connection point the node is connected. The node is the node which is 'outside' the
                 // route
-                if (comps.at(node.second[0])[0] == node.first)
-                {
-                    dir.push_back(1);
-                }
-                else
-                {
-                    dir.push_back(-1);
-                }
+                dir.push_back(index.get_component_nodes(last_comp)[0] == node_id ? 1 : -1);
                 break;
             }
         }
         // no node found only connected to one component, there are Suppliers which shoudl be used as start point
-        if (comps_ordered.empty())
+        if (last_comp == wanda_graph_index::not_connected)
         {
-            for (auto comp_name : comps)
+            for (int comp_id : route_comps)
             {
-                auto &comp = get_component(comp_name.first);
-                if (comp.get_physcomp_type() == "SUPPLIER")
+                if (index.get_component(comp_id).get_physcomp_type() == "SUPPLIER")
                 {
-                    comps_ordered.push_back(&comp);
-                    nodes_ordered_name.push_back(comp_name.second[0]);
+                    last_comp = comp_id;
+                    last_node = index.get_component_nodes(comp_id)[0];
                     dir.push_back(1);
                     break;
                 }
             }
         }
     }
-    comps_ordered_name.push_back(comps_ordered.back()->get_complete_name_spec());
+    if (last_comp == wanda_graph_index::not_connected)
+    {
+        throw std::runtime_error("No route possible with keyword " + keyword);
+    }
+    comps_ordered.push_back(&index.get_component(last_comp));
+    comp_visited[last_comp] = 1;
+    node_visited[last_node] = 1;
 
-    for (int i = 1; i <= comps.size(); i++)
+    for (size_t i = 1; i <= route_comps.size(); i++)
     {
-        for (auto node : comps[comps_ordered_name.back()])
+        for (int node_id : index.get_component_nodes(last_comp))
         {
-            if (std::find(nodes_ordered_name.begin(), nodes_ordered_name.end(), node) == nodes_ordered_name.end())
+            if (!node_visited[node_id])
             {
-                nodes_ordered_name.push_back(node);
+                node_visited[node_id] = 1;
+                last_node = node_id;
                 break;
             }
         }
-        for (auto comp : nodes[nodes_ordered_name.back()])
+        for (int comp_id : nodes[last_node])
         {
-            if (std::find(comps_ordered_name.begin(), comps_ordered_name.end(), comp) == comps_ordered_name.end())
+            if (!comp_visited[comp_id])
             {
-                comps_ordered.push_back(&get_component(comp));
-                comps_ordered_name.push_back(comp);
-                int con_point = comps_ordered.back()->get_connect_point(get_node(nodes_ordered_name.back()));
-                if (comps_ordered.back()->get_physcomp_type() != "TEE" &&
-                    comps_ordered.back()->get_physcomp_type() != "CROSS")
+                comp_visited[comp_id] = 1;
+                last_comp = comp_id;
+                auto &comp = index.get_component(comp_id);
+                comps_ordered.push_back(&comp);
+                if (comp.get_physcomp_type() != "TEE" && comp.get_physcomp_type() != "CROSS")
                 {
-                    dir.push_back(con_point == 1 ? 1 : -1);
+                    dir.push_back(index.get_connect_point(comp_id, last_node) == 1 ? 1 : -1);
                 }
                 else
                 {
@@ -1305,6 +1430,7 @@ std::vector<std::string> wanda_model::get_all_signal_lines_str()
 
 void wanda_model::new_wanda_case(std::string casename)
 {
+    invalidate_item_indices();
     if (wanda_input_file.is_open())
     {
         wanda_input_file.close();
@@ -1349,8 +1475,7 @@ void wanda_model::new_wanda_case(std::string casename)
     phys_nodes.clear();
     ctrl_components.clear();
     phys_components.clear();
-    name2_phys_comp.clear();
-    name2_phys_node.clear();
+    name2_item.clear();
     signal_lines.clear();
     tables_loaded = false;
     table_metainfo_cache.clear();
@@ -1386,6 +1511,7 @@ void wanda_model::new_wanda_case(std::string casename)
 
 wanda_component &wanda_model::add_component(const std::string type_name, const std::vector<float> position)
 {
+    invalidate_item_indices();
     std::string Class_sort_key = component_definition->get_class_sort_key(type_name);
     if (component_definition->is_obsolete(Class_sort_key))
     {
@@ -1433,7 +1559,7 @@ wanda_component &wanda_model::add_component(const std::string type_name, const s
 
         for (auto &input : phys_components[compkey])
         {
-            input.second.set_unit_factor(unit_list, case_units);
+            input.second.set_unit_factor(get_table_unit_factor(resolve_unit_id(input.second)));
             if (input.second.get_property_type() != wanda_property_types::HIS)
                 continue;
 
@@ -1445,7 +1571,7 @@ wanda_component &wanda_model::add_component(const std::string type_name, const s
         }
         // comp_name_2_comp.emplace(comp.get_complete_name_spec(),
         // &phys_components[compkey]);
-        name2_phys_comp.emplace(phys_components[compkey].get_complete_name_spec(), &phys_components[compkey]);
+        add_to_name_index(phys_components[compkey]);
         return phys_components[compkey];
     }
     if (component_definition->is_control_component(Class_sort_key))
@@ -1473,18 +1599,19 @@ wanda_component &wanda_model::add_component(const std::string type_name, const s
             Name = Name_prefix.substr(0, 1) + std::to_string(j);
         }
         wanda_component comp(key, class_name, Class_sort_key, Name_prefix, Name, wanda_type::control, type, type_name,
-                             component_definition);
+                             component_definition.get());
         comp.set_new(true);
         comp.set_position(position);
-        comp.set_max_input_channels(component_definition->get_max_in_chan(Class_sort_key));
-        comp.set_input_channel_type(component_definition->get_in_chan_type(Class_sort_key));
-        comp.set_output_channel_type(component_definition->get_out_chan_type(Class_sort_key));
+        auto definition = component_definition->get_class_definition(Class_sort_key);
+        comp.set_max_input_channels(definition->max_input_channels);
+        comp.set_input_channel_type(definition->input_channel_type);
+        comp.set_output_channel_type(definition->output_channel_type);
         ctrl_components.emplace(compkey, comp);
         number_control_components++;
 
         for (auto &input : ctrl_components[compkey])
         {
-            input.second.set_unit_factor(unit_list, case_units);
+            input.second.set_unit_factor(get_table_unit_factor(resolve_unit_id(input.second)));
             if (input.second.get_property_type() != wanda_property_types::CIS)
                 continue;
             if (input.second.get_property_spec_inp_fld() == 'C')
@@ -1493,8 +1620,7 @@ wanda_component &wanda_model::add_component(const std::string type_name, const s
             }
             input.second.set_modified(true);
         }
-        // comp_name_2_comp.emplace(comp.get_complete_name_spec(),
-        // &ctrl_components[compkey]);
+        add_to_name_index(ctrl_components[compkey]);
         return ctrl_components[compkey];
     }
     throw std::invalid_argument(type_name + " is not a Wanda component");
@@ -1502,14 +1628,15 @@ wanda_component &wanda_model::add_component(const std::string type_name, const s
 
 wanda_component &wanda_model::add_component(std::string type, std::vector<float> position, std::string name)
 {
+    invalidate_item_indices();
     auto &comp = add_component(type, position);
 
     if (check_name(comp.get_name_prefix() + " " + name, comp.get_key_as_string()))
     {
+        remove_from_name_index(comp);
         if (comp.get_item_type() == wanda_type::physical)
         {
             phys_components.erase(comp.get_key_as_string());
-            name2_phys_comp.erase(comp.get_complete_name_spec());
         }
         else
         {
@@ -1519,19 +1646,19 @@ wanda_component &wanda_model::add_component(std::string type, std::vector<float>
         throw std::invalid_argument("Component with name " + name + " already exists");
     }
 
+    remove_from_name_index(comp);
+    comp.set_name(name);
+    add_to_name_index(comp);
     if (comp.get_item_type() == wanda_type::physical)
     {
-        name2_phys_comp.erase(comp.get_complete_name_spec());
-        comp.set_name(name);
-        name2_phys_comp.emplace(comp.get_complete_name_spec(), &phys_components[comp.get_key_as_string()]);
         return phys_components[comp.get_key_as_string()];
     }
-    comp.set_name(name);
     return ctrl_components[comp.get_key_as_string()];
 }
 
 wanda_component &wanda_model::add_component(wanda_component *comp_org, std::vector<float> position)
 {
+    invalidate_item_indices();
     auto new_comp_temp = add_component(comp_org->get_type_name(), position);
     // check if comp_key has been used if not adjust the comp key of the new component.
     wanda_component *new_comp = nullptr;
@@ -1539,21 +1666,25 @@ wanda_component &wanda_model::add_component(wanda_component *comp_org, std::vect
     {
         if (phys_components.find(comp_org->get_key_as_string()) == phys_components.end())
         {
+            remove_from_name_index(phys_components.at(new_comp_temp.get_key_as_string()));
             phys_components.erase(new_comp_temp.get_key_as_string());
             new_comp_temp.set_comp_key(comp_org->get_key());
             phys_components.emplace(new_comp_temp.get_key_as_string(), new_comp_temp);
         }
         new_comp = &phys_components.at(new_comp_temp.get_key_as_string());
+        add_to_name_index(*new_comp);
     }
     else if ((comp_org->get_item_type() == wanda_type::control))
     {
         if (ctrl_components.find(comp_org->get_key_as_string()) == ctrl_components.end())
         {
+            remove_from_name_index(ctrl_components.at(new_comp_temp.get_key_as_string()));
             ctrl_components.erase(new_comp_temp.get_key_as_string());
             new_comp_temp.set_comp_key(comp_org->get_key());
             ctrl_components.emplace(new_comp_temp.get_key_as_string(), new_comp_temp);
         }
         new_comp = &ctrl_components.at(new_comp_temp.get_key_as_string());
+        add_to_name_index(*new_comp);
     }
     else
     {
@@ -1589,17 +1720,16 @@ wanda_component &wanda_model::add_component(wanda_component *comp_org, std::vect
     {
         new_comp->add_keyword(keyword);
     }
+    remove_from_name_index(*new_comp);
+    new_comp->set_name(name);
+    add_to_name_index(*new_comp);
     if (comp_org->get_item_type() == wanda_type::physical)
     {
-        name2_phys_comp.erase(new_comp->get_complete_name_spec());
-        new_comp->set_name(name);
-        name2_phys_comp.emplace(new_comp->get_complete_name_spec(), &phys_components[compkey]);
         phys_components[compkey].set_number_of_species(&num_of_species);
         return phys_components[compkey];
     }
     if (comp_org->get_item_type() == wanda_type::control)
     {
-        new_comp->set_name(name);
         return ctrl_components[compkey];
     }
     throw std::runtime_error(comp_org->get_complete_name_spec() + " is not a control or physical component");
@@ -1607,6 +1737,7 @@ wanda_component &wanda_model::add_component(wanda_component *comp_org, std::vect
 
 wanda_node &wanda_model::add_node(std::string type, std::vector<float> position)
 {
+    invalidate_item_indices();
     std::string Class_sort_key = component_definition->get_class_sort_key(type);
     if (component_definition->is_obsolete(Class_sort_key))
     {
@@ -1643,22 +1774,25 @@ wanda_node &wanda_model::add_node(std::string type, std::vector<float> position)
 
     // node_name_2_node.try_emplace(new_node.get_complete_name_spec(),
     // &phys_nodes[compkey]);
-    name2_phys_node.emplace(phys_nodes[compkey].get_complete_name_spec(), &phys_nodes[compkey]);
+    add_to_name_index(phys_nodes[compkey]);
     number_physical_nodes++;
     return phys_nodes[compkey];
 }
 
 wanda_node &wanda_model::add_node(wanda_node *node_org, std::vector<float> position)
 {
+    invalidate_item_indices();
     auto new_node_temp = add_node(node_org->get_type_name(), position);
     // chaning the key to the key of the orginal node if it does not exist already
     if (phys_nodes.find(node_org->get_key_as_string()) == phys_nodes.end())
     {
+        remove_from_name_index(phys_nodes.at(new_node_temp.get_key_as_string()));
         phys_nodes.erase(new_node_temp.get_key_as_string());
         new_node_temp.set_comp_key(node_org->get_key());
         phys_nodes.emplace(new_node_temp.get_key_as_string(), new_node_temp);
     }
     auto &new_node = phys_nodes.at(new_node_temp.get_key_as_string());
+    add_to_name_index(new_node);
     for (auto keyword : node_org->get_keywords())
     {
         new_node.add_keyword(keyword);
@@ -1686,9 +1820,9 @@ wanda_node &wanda_model::add_node(wanda_node *node_org, std::vector<float> posit
     {
         name = node_org->get_name();
     }
-    name2_phys_node.erase(new_node.get_complete_name_spec());
+    remove_from_name_index(new_node);
     new_node.set_name(name);
-    name2_phys_node.emplace(name, &new_node);
+    add_to_name_index(new_node);
     new_node.copy_input(*node_org);
     return new_node;
 }
@@ -1712,6 +1846,7 @@ diagram_text& wanda_model::add_text_box(text_field text, int bck_color, int line
 
 void wanda_model::delete_component(wanda_component &component)
 {
+    invalidate_item_indices();
     if (!component_exists(component))
     {
         throw(component.get_complete_name_spec() + " does not exist in Wanda model");
@@ -1727,7 +1862,7 @@ void wanda_model::delete_component(wanda_component &component)
             num_of_species -= 1;
         }
         deleted_phys_components.push_back(component.get_key());
-        name2_phys_comp.erase(component.get_complete_name_spec());
+        remove_from_name_index(component);
         phys_components.erase(component.get_key_as_string());
         number_physical_components -= 1;
     }
@@ -1742,6 +1877,7 @@ void wanda_model::delete_component(wanda_component &component)
             disconnect(component, i, false);
         }
         deleted_ctrl_components.push_back(component.get_key());
+        remove_from_name_index(component);
         ctrl_components.erase(component.get_key_as_string());
         number_control_components += -1;
     }
@@ -1749,6 +1885,7 @@ void wanda_model::delete_component(wanda_component &component)
 
 void wanda_model::delete_node(wanda_node &node)
 {
+    invalidate_item_indices();
     if (!node_exists(node))
     {
         throw(node.get_complete_name_spec() + " does not exist in Wanda model");
@@ -1759,12 +1896,13 @@ void wanda_model::delete_node(wanda_node &node)
         comp->disconnect(node);
     }
     deleted_phys_nodes.push_back(node.get_key());
-    name2_phys_node.erase(node.get_complete_name_spec());
+    remove_from_name_index(node);
     phys_nodes.erase(node.get_key_as_string());
 }
 
 void wanda_model::delete_sig_line(wanda_sig_line &sig_line)
 {
+    invalidate_item_indices();
     if (!sig_line_exists(sig_line))
     {
         throw(sig_line.get_complete_name_spec() + " does not exist in Wanda model");
@@ -1783,6 +1921,7 @@ void wanda_model::delete_sig_line(wanda_sig_line &sig_line)
     deleted_signal_lines.push_back(sig_line.get_key());
     auto loc = std::find(sig_line_keys.begin(), sig_line_keys.end(), sig_line.get_key_as_string());
     sig_line_keys.erase(loc);
+    remove_from_name_index(sig_line);
     signal_lines.erase(sig_line.get_key_as_string());
 }
 
@@ -1843,12 +1982,16 @@ wanda_item &wanda_model::connect(wanda_component &component1, int connection_poi
     {
         change_node_name(get_node(item.get_complete_name_spec()), node_name);
     }
-    // TODO change signal line name.
+    else if (sig_line_exists(item.get_complete_name_spec()))
+    {
+        change_sig_line_name(get_signal_line(item.get_complete_name_spec()), node_name);
+    }
     return item;
 }
 
 void wanda_model::connect(wanda_component &component1, const int connection_point1, wanda_node &node)
 {
+    invalidate_graph_index();
     // todo check if connecting sensor to node!.
     if (phys_components.find(component1.get_key_as_string()) == phys_components.end()) // only has to check
     {
@@ -1908,9 +2051,18 @@ void wanda_model::merge_nodes(wanda_node &node2, wanda_node &node1)
     {
         throw(node2.get_complete_name_spec() + " does not exist in Wanda model");
     }
-    for (auto comp : node1.get_connected_components())
+    // take a copy of the connections, connect() invalidates the graph index
+    auto &index = get_graph_index();
+    int node_id = index.get_node_id(node1);
+    std::vector<std::pair<wanda_component *, int>> connections;
+    auto comp_ids = index.get_node_components(node_id);
+    auto con_points = index.get_node_con_points(node_id);
+    for (size_t i = 0; i < comp_ids.size(); i++)
+    {
+        connections.emplace_back(&index.get_component(comp_ids[i]), con_points[i]);
+    }
+    for (auto &[comp, con_point] : connections)
     {
-        int con_point = comp->get_connect_point(node1);
         comp->disconnect(con_point);
         node1.disconnect(*comp);
         connect(*comp, con_point, node2);
@@ -1920,6 +2072,7 @@ void wanda_model::merge_nodes(wanda_node &node2, wanda_node &node1)
 
 void wanda_model::disconnect(wanda_component &component, int connection_point)
 {
+    invalidate_graph_index();
     if (phys_components.find(component.get_key_as_string()) == phys_components.end())
         throw std::invalid_argument("Component " + component.get_complete_name_spec() +
                                     " is not found in this wanda model");
@@ -1968,6 +2121,7 @@ void wanda_model::disconnect(wanda_component &component, int connection_point, b
 wanda_node &wanda_model::connect_phys_comps(wanda_component &comp1, int con_point1, wanda_component &comp2,
                                             int con_point2)
 {
+    invalidate_graph_index();
 
     if (comp1.get_number_of_connnect_points() < con_point1)
         throw std::invalid_argument(comp1.get_complete_name_spec() + " does not have connection point " +
@@ -2118,6 +2272,7 @@ wanda_sig_line &wanda_model::connect_ctrl2phys_comps(wanda_component &c_comp1, i
 
 wanda_sig_line &wanda_model::add_sigline(std::string type, std::vector<float> pos)
 {
+    invalidate_item_indices();
     std::string compkey = get_unique_key(sig_line_keys, 'S', last_key);
     sig_line_keys.push_back(compkey);
 
@@ -2135,106 +2290,104 @@ wanda_sig_line &wanda_model::add_sigline(std::string type, std::vector<float> po
     new_sig_line.set_position(pos);
 
     signal_lines.try_emplace(compkey, new_sig_line);
-    // sig_line_name_2_sig_line.emplace(new_sig_line.get_complete_name_spec(),
-    // &signal_lines[compkey]);
+    add_to_name_index(signal_lines[compkey]);
     num_signal_lines++;
     return signal_lines[compkey];
 }
 
-void run_external_program_win(std::string exepath, std::string args)
-{
-    STARTUPINFOA si;
-    PROCESS_INFORMATION pi;
-    LPVOID lpMsgBuf;
-    ZeroMemory(&si, sizeof(si));
-    ZeroMemory(&pi, sizeof(pi));
-    si.cb = sizeof(si);
-    std::string commandline(exepath);
-    commandline.append(" ").append(args);
-
-    if (exepath.length() > MAX_PATH)
-        throw std::runtime_error("Executable path is longer than MAX_PATH: " + exepath);
-    if ((commandline.size() + 1) > 32768) // limit accoording to documentation
-        throw std::runtime_error("length of path = " + std::to_string(commandline.length()) + " max=32768");
-    char *stringbuf = new char[commandline.size() + 1];
-    strcpy_s(stringbuf, commandline.size() + 1, commandline.c_str());
-    DWORD exitcode;
-    if (!CreateProcessA(NULL,             // No module name (use command line)
-                        stringbuf,        // Command line
-                        NULL,             // Process handle not inheritable
-                        NULL,             // Thread handle not inheritable
-                        false,            // Set handle inheritance to FALSE
-                        CREATE_NO_WINDOW, // Creation flags
-                        NULL,             // Use parent's environment block
-                        NULL,             // Use parent's starting directory
-                        &si,              // Pointer to STARTUPINFO structure
-                        &pi)              // Pointer to PROCESS_INFORMATION structure
-    )
-    {
-        exitcode = GetLastError();
-        FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-                       NULL, exitcode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&lpMsgBuf, 0, NULL);
-        std::string errormsg(static_cast<char *>(lpMsgBuf));
-        LocalFree(lpMsgBuf); // because FORMAT_MESSAGE_ALLOCATE_BUFFER flag
-        throw std::runtime_error("CreateProcess failed: " + std::to_string(exitcode) + " = " + errormsg +
-                                 "path=" + exepath);
-    }
-    // Wait until child process exits.
-    WaitForSingleObject(pi.hProcess, INFINITE);
-    GetExitCodeProcess(pi.hProcess, &exitcode);
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-    delete[] stringbuf;
-    if (exitcode != 0)
-        throw std::runtime_error("Process exit code: " + std::to_string(exitcode) + '\n');
-}
-
-void wanda_model::run_steady()
+std::shared_ptr<wanda_solver_job> wanda_model::start_solver(const std::string &executable,
+                                                            wanda_solver_options options)
 {
-    if (this->is_modified())
-    {
-        save_model_input();
-    }
     wanda_input_file.close();
     if (wanda_output_file.is_open())
     {
         wanda_output_file.close();
     }
+    try
+    {
+        return wanda_solver_job::launch(wanda_bin + executable, {wanda_input_file.get_filename()},
+                                        std::move(options));
+    }
+    catch (std::exception &)
+    {
+        wanda_input_file.open();
+        wanda_output_file.open();
+        throw;
+    }
+}
 
-    std::string file = wanda_input_file.get_filename();
-    auto sl = file.find_last_of('\\');
-    if (sl > file.size())
+void wanda_model::wait_for_solver(wanda_solver_job &job, bool steady)
+{
+    WANDA_TRACE_SCOPE("wanda_model::wait_for_solver");
+    auto &result = job.wait();
+    wanda_input_file.open();
+    wanda_output_file.open();
+    if (result.cancelled)
+        throw std::runtime_error("Solver was cancelled: " + job.get_command_line());
+    if (result.timed_out)
+        throw std::runtime_error("Solver timed out: " + job.get_command_line());
+    if (result.exit_code != 0)
     {
-        sl = file.find_last_of('/');
+        // the solver writes its errors to the message groups before it exits, those explain the exit code
+        if (steady)
+        {
+            load_steady_messages();
+        }
+        else
+        {
+            load_unsteady_messages();
+        }
+        throw std::runtime_error("Process exit code: " + std::to_string(result.exit_code) + '\n' + result.error +
+                                 get_error_messages());
     }
+}
 
-    std::string casename =
-        wanda_input_file.get_filename().substr(sl + 1, wanda_input_file.get_filename().size() - 4 - sl - 1);
-    std::string exe = "\"" + wanda_bin + "steady.exe" + "\"";
-    std::string command_line = " \"" + wanda_input_file.get_filename() + "\" \"";
-#ifdef _WINDOWS
-    try
+std::string wanda_model::get_error_messages() const
+{
+    std::string text;
+    auto add_messages = [&text](const wanda_item &item) {
+        for (const auto &message : item.get_all_messages())
+        {
+            if (message.message_type == 'E' || message.message_type == 'T')
+            {
+                text += item.get_complete_name_spec() + ": " + message.message + '\n';
+            }
+        }
+    };
+    for (const auto &item : phys_components)
     {
-        run_external_program_win(exe, command_line);
+        add_messages(item.second);
     }
-    catch (std::exception &ex)
+    for (const auto &item : ctrl_components)
     {
-        throw(ex);
+        add_messages(item.second);
     }
-#else
-    try
+    for (const auto &item : phys_nodes)
     {
-        command_line = "\"" + exe + command_line + "\"";
-        const char *command = command_line.c_str();
-        system(command);
+        add_messages(item.second);
     }
-    catch (std::exception &ex)
+    return text;
+}
+
+void wanda_model::run_steady()
+{
+    WANDA_TRACE_SCOPE("wanda_model::run_steady");
+    auto job = start_steady();
+    finish_steady(*job);
+}
+
+std::shared_ptr<wanda_solver_job> wanda_model::start_steady(wanda_solver_options options)
+{
+    if (this->is_modified())
     {
-        throw(ex);
+        save_model_input();
     }
-#endif
-    wanda_input_file.open();
-    wanda_output_file.open();
+    return start_solver("steady.exe", std::move(options));
+}
+
+void wanda_model::finish_steady(wanda_solver_job &job)
+{
+    wait_for_solver(job, true);
     re_calculate_hcs();
     load_steady_messages();
     std::vector<int> status_steady(1);
@@ -2251,6 +2404,13 @@ void wanda_model::run_steady()
 }
 
 void wanda_model::run_unsteady()
+{
+    WANDA_TRACE_SCOPE("wanda_model::run_unsteady");
+    auto job = start_unsteady();
+    finish_unsteady(*job);
+}
+
+std::shared_ptr<wanda_solver_job> wanda_model::start_unsteady(wanda_solver_options options)
 {
     float trans = get_property("Transient mode").get_scalar_float();
     if (trans != 1.0)
@@ -2311,43 +2471,12 @@ void wanda_model::run_unsteady()
         }
         throw std::runtime_error("Steady error check steady message file");
     }
-    wanda_input_file.close();
-    wanda_output_file.close();
-    std::string file = wanda_input_file.get_filename();
-    auto sl = file.find_last_of('\\');
-    if (sl > file.size())
-    {
-        sl = file.find_last_of('/');
-    }
-
-    std::string casename =
-        wanda_input_file.get_filename().substr(sl + 1, wanda_input_file.get_filename().size() - 4 - sl - 1);
-    std::string exe = wanda_bin + "unsteady.exe";
-    std::string command_line = " \"" + wanda_input_file.get_filename() + "\" \"";
+    return start_solver("unsteady.exe", std::move(options));
+}
 
-#ifdef _WINDOWS
-    try
-    {
-        run_external_program_win(exe, command_line);
-    }
-    catch (std::exception &ex)
-    {
-        throw(ex);
-    }
-#else
-    try
-    {
-        command_line = exe + command_line;
-        const char *command = command_line.c_str();
-        system(command);
-    }
-    catch (std::exception &ex)
-    {
-        throw(ex);
-    }
-#endif
-    wanda_input_file.open();
-    wanda_output_file.open();
+void wanda_model::finish_unsteady(wanda_solver_job &job)
+{
+    wait_for_solver(job, false);
     reload_component_indices();
     reload_output();
     load_unsteady_messages();
@@ -2366,14 +2495,21 @@ void wanda_model::resume_unsteady_until(float simulation_time)
 {
     auto &sim_time = get_property("Simulation time");
     auto dt = get_property("Time step").get_scalar_float();
-    auto &start_time = get_property("Start time");
-    start_time.set_scalar(sim_time.get_scalar_float() + dt);
-    sim_time.set_scalar(simulation_time);
+    // the window starts one step after the previous end, taken before the simulation time is moved on
+    run_unsteady_window(sim_time.get_scalar_float() + dt, simulation_time);
+}
+
+void wanda_model::run_unsteady_window(float start_time, float end_time)
+{
+    auto &sim_time = get_property("Simulation time");
+    auto &start = get_property("Start time");
+    start.set_scalar(start_time);
+    sim_time.set_scalar(end_time);
     sim_time.set_modified(false);
-    start_time.set_modified(false);
-    std::vector<float> value(4, simulation_time);
+    start.set_modified(false);
+    std::vector<float> value(4, end_time);
     wanda_input_file.write_float_elements("CALC_CONTR_DATA", "End_time", nefis_file::single_elem_uindex, value);
-    std::vector<float> value2(4, sim_time.get_scalar_float() + dt);
+    std::vector<float> value2(4, start_time);
     wanda_input_file.write_float_elements("CALC_CONTR_DATA", "Start_time", nefis_file::single_elem_uindex, value2);
     run_unsteady();
 }
@@ -2511,16 +2647,20 @@ std::vector<float> wanda_model::get_globvar_hcs()
 
 void wanda_model::re_calculate_hcs()
 {
+    const bool globvars_modified = glob_var_modified();
+    std::vector<wanda_component *> components;
     for (auto &comp : phys_components)
     {
-        if (comp.second.get_num_hcs() != 0)
+        if (comp.second.get_num_hcs() != 0 && !comp.second.is_disused() &&
+            (globvars_modified || comp.second.is_modified()))
         {
-            if (comp.second.is_modified() || glob_var_modified() && !comp.second.is_disused())
-            {
-                calc_hsc(comp.second);                
-            }
+            components.push_back(&comp.second);
         }
     }
+    if (components.empty())
+        return;
+    // components whose inputs did not change since their last computation are skipped by the batch
+    wanda_component_dll::get_instance(wanda_bin)->calc_hydraulic_spec_components(components, get_globvar_hcs(), hcs_backend);
 }
 
 void wanda_model::load_steady_messages()
@@ -2556,23 +2696,11 @@ bool wanda_model::has_property(const std::string &description) const
     return global_vars.find(description) != global_vars.end() || mode_and_opt.find(description) != mode_and_opt.end();
 }
 
-bool wanda_model::component_exists(const std::string &comp_name) const
+bool wanda_model::component_exists(std::string_view comp_name) const
 {
-    for (auto &comp : phys_components)
-    {
-        if (comp.second.get_complete_name_spec() == comp_name)
-        {
-            return true;
-        }
-    }
-    for (auto &comp : ctrl_components)
-    {
-        if (comp.second.get_complete_name_spec() == comp_name)
-        {
-            return true;
-        }
-    }
-    return false;
+    auto item = find_item(comp_name);
+    return item != nullptr &&
+           (item->get_item_type() == wanda_type::physical || item->get_item_type() == wanda_type::control);
 }
 
 bool wanda_model::component_exists(const wanda_component &comp) const
@@ -2588,9 +2716,10 @@ bool wanda_model::component_exists(const wanda_component &comp) const
     return false;
 }
 
-bool wanda_model::node_exists(const std::string &node_name) const
+bool wanda_model::node_exists(std::string_view node_name) const
 {
-    return name2_phys_node.contains(node_name);
+    auto item = find_item(node_name);
+    return item != nullptr && item->get_item_type() == wanda_type::node;
 }
 
 bool wanda_model::node_exists(const wanda_node &node) const
@@ -2598,16 +2727,10 @@ bool wanda_model::node_exists(const wanda_node &node) const
     return phys_nodes.contains(node.get_key_as_string());
 }
 
-bool wanda_model::sig_line_exists(const std::string &comp_name) const
-{ 
-    for (auto &comp : signal_lines)
-    {
-        if (comp.second.get_complete_name_spec() == comp_name)
-        {
-            return true;
-        }
-    }
-    return false;
+bool wanda_model::sig_line_exists(std::string_view comp_name) const
+{
+    auto item = find_item(comp_name);
+    return item != nullptr && item->get_item_type() == wanda_type::signal_line;
 }
 
 bool wanda_model::sig_line_exists(const wanda_sig_line &sig_line) const
@@ -2770,6 +2893,7 @@ std::vector<int> wanda_model::parse_date_time(std::string date_time_string)
 
 void wanda_model::upgrade_components()
 {
+    invalidate_item_indices();
     auto list_of_comps = get_all_components_str();
     for (auto &comp_name : list_of_comps)
     {
@@ -2921,7 +3045,7 @@ void wanda_model::upgrade_components()
             std::string name = comp.get_name();
             auto key = comp.get_key();
             delete_component(comp);
-            name2_phys_comp.erase(new_comp.get_complete_name_spec());
+            remove_from_name_index(new_comp);
             new_comp.set_name(name);
             // changing the component key to the orginal component key to ensure it works with the wdx file
             auto old_key = new_comp.get_key_as_string();
@@ -2930,8 +3054,7 @@ void wanda_model::upgrade_components()
             phys_components.erase(old_key);
             phys_components.erase(comp_temp.get_key_as_string());
             phys_components.emplace(comp_temp.get_key_as_string(), comp_temp);
-            name2_phys_comp.emplace(comp_temp.get_complete_name_spec(),
-                                    &phys_components.at(comp_temp.get_key_as_string()));
+            add_to_name_index(phys_components.at(comp_temp.get_key_as_string()));
             wanda_component *new_comp2 = &phys_components.at(comp_temp.get_key_as_string());
 
             for (i = 0; i < new_comp2->get_number_of_connnect_points(); i++)
@@ -2989,6 +3112,7 @@ void wanda_model::upgrade_components()
 
 void wanda_model::change_comp_type(const std::string &name, const std::string &type)
 {
+    invalidate_item_indices();
     auto &comp = get_component(name);
     auto &comp_new = add_component(type, comp.get_position());
     if ((component_definition->is_physical_component(comp.get_class_sort_key()) &
@@ -3051,8 +3175,9 @@ void wanda_model::change_comp_type(const std::string &name, const std::string &t
             }
             const auto comp_name = comp.get_name();
             delete_component(comp);
+            remove_from_name_index(comp_new);
             comp_new.set_name(comp_name);
-            name2_phys_comp.emplace(name, &phys_components.at(comp_new.get_key_as_string()));
+            add_to_name_index(comp_new);
         }
         else
         {
@@ -3084,7 +3209,9 @@ void wanda_model::change_comp_type(const std::string &name, const std::string &t
             }
             const auto comp_name = comp.get_name();
             delete_component(comp);
+            remove_from_name_index(comp_new);
             comp_new.set_name(comp_name);
+            add_to_name_index(comp_new);
         }
     }
     else
@@ -3096,6 +3223,7 @@ void wanda_model::change_comp_type(const std::string &name, const std::string &t
 
 void wanda_model::change_node_type(const std::string &name, const std::string &type)
 {
+    invalidate_item_indices();
     auto &node = get_node(name);
     auto &node_new = add_node(type, node.get_position());
 
@@ -3118,9 +3246,10 @@ void wanda_model::change_node_type(const std::string &name, const std::string &t
 
     const auto node_name = node.get_name();
     delete_node(node);
+    remove_from_name_index(node_new);
     node_new.set_name(node_name);
     phys_nodes.emplace(node_new.get_key_as_string(), node_new);
-    name2_phys_node.emplace(name, &phys_nodes.at(node_new.get_key_as_string()));
+    add_to_name_index(phys_nodes.at(node_new.get_key_as_string()));
 }
 
 std::unordered_map<std::string, std::vector<std::string>> wanda_model::validate_model_input()
@@ -3166,34 +3295,33 @@ std::unordered_map<std::string, std::vector<std::string>> wanda_model::validate_
 std::unordered_map<std::string, std::vector<int>> wanda_model::validate_connectivity()
 {
     std::unordered_map<std::string, std::vector<int>> results;
-    for (auto &component : phys_components)
+    auto &index = get_graph_index();
+    for (int comp_id = 0; comp_id < index.get_number_of_physical_components(); comp_id++)
     {
-        if (!component.second.is_disused())
+        auto &component = index.get_component(comp_id);
+        if (!component.is_disused())
         {
             std::vector<int> temp_result;
-            for (int i = 1; i <= component.second.get_number_of_connnect_points(); i++)
+            auto con_nodes = index.get_component_nodes(comp_id);
+            for (size_t i = 0; i < con_nodes.size(); i++)
             {
-                if (!component.second.is_node_connected(i))
+                if (con_nodes[i] == wanda_graph_index::not_connected)
                 {
-                    temp_result.push_back(i);
+                    temp_result.push_back(static_cast<int>(i) + 1);
                 }
             }
             if (!temp_result.empty())
             {
-                results.emplace(component.second.get_complete_name_spec(), temp_result);
+                results.emplace(component.get_complete_name_spec(), temp_result);
             }
         }
     }
-    for (auto &node : phys_nodes)
+    for (int node_id = 0; node_id < index.get_number_of_nodes(); node_id++)
     {
-        if (!node.second.is_disused())
+        auto &node = index.get_node(node_id);
+        if (!node.is_disused() && index.get_node_components(node_id).empty())
         {
-            std::vector<int> temp_result;
-            temp_result.push_back(0);
-            if (node.second.get_connected_components().size() == 0)
-            {
-                results.emplace(node.second.get_complete_name_spec(), temp_result);
-            }
+            results.emplace(node.get_complete_name_spec(), std::vector<int>{0});
         }
     }
     for (auto &component : ctrl_components)
@@ -3811,14 +3939,12 @@ void wanda_model::change_component_name(wanda_component &comp, std::string new_n
         throw std::invalid_argument(comp.get_complete_name_spec() + " does not exist in model");
     }
     // remove name from name_2_phys name
-    if (name2_phys_comp.find(comp.get_name_prefix() + " " + new_name) == name2_phys_comp.end())
+    if (!check_name(comp.get_name_prefix() + " " + new_name))
     {
-        name2_phys_comp.erase(name2_phys_comp.find(comp.get_complete_name_spec()));
-        name2_phys_comp.emplace(comp.get_name_prefix() + new_name, &phys_components.at(comp.get_key_as_string()));
-
-        //
+        remove_from_name_index(comp);
         // changes name of component
         comp.set_name(new_name);
+        add_to_name_index(comp);
         return;
     }
 
@@ -3833,13 +3959,12 @@ void wanda_model::change_node_name(wanda_node &node, std::string new_name)
         throw std::invalid_argument(node.get_complete_name_spec() + " does not exist in model");
     }
     // remove name from name_2_phys name
-    if (name2_phys_node.find(node.get_name_prefix() + " " + new_name) == name2_phys_node.end())
+    if (!check_name(node.get_name_prefix() + " " + new_name))
     {
-        name2_phys_node.erase(name2_phys_node.find(node.get_complete_name_spec()));
-        name2_phys_node.emplace(node.get_name_prefix() + new_name, &phys_nodes.at(node.get_key_as_string()));
-        //
-        // changes name of component
+        remove_from_name_index(node);
+        // changes name of node
         node.set_name(new_name);
+        add_to_name_index(node);
         return;
     }
 
@@ -3847,6 +3972,24 @@ void wanda_model::change_node_name(wanda_node &node, std::string new_name)
                                 " already exists in model");
 }
 
+void wanda_model::change_sig_line_name(wanda_sig_line &sig_line, std::string new_name)
+{
+    if (!sig_line_exists(sig_line))
+    {
+        throw std::invalid_argument(sig_line.get_complete_name_spec() + " does not exist in model");
+    }
+    if (!check_name(sig_line.get_name_prefix() + " " + new_name))
+    {
+        remove_from_name_index(sig_line);
+        sig_line.set_name(new_name);
+        add_to_name_index(sig_line);
+        return;
+    }
+
+    throw std::invalid_argument("Signal line with name " + sig_line.get_name_prefix() + " " + new_name +
+                                " already exists in model");
+}
+
 std::vector<wanda_property *> wanda_model::get_all_properties()
 {
     std::vector<wanda_property *> list;
@@ -3887,37 +4030,7 @@ int wanda_model::get_element_size_def(std::string &element)
 
 std::vector<std::string> wanda_model::get_all_keywords() const
 {
-    std::set<std::string> keywords;
-    for (auto comp : phys_components)
-    {
-        for(auto keyword : comp.second.get_keywords())
-        {
-            keywords.emplace(keyword);
-        }
-    }
-    for (auto comp : ctrl_components)
-    {
-        for (auto keyword : comp.second.get_keywords())
-        {
-            keywords.emplace(keyword);
-        }
-    }
-    for (auto comp : phys_nodes)
-    {
-        for (auto keyword : comp.second.get_keywords())
-        {
-            keywords.emplace(keyword);
-        }
-    }
-    for (auto comp : signal_lines)
-    {
-        for (auto keyword : comp.second.get_keywords())
-        {
-            keywords.emplace(keyword);
-        }
-    }
-    std::vector<std ::string> result(keywords.begin(), keywords.end());
-    return result;
+    return get_keyword_index().get_keywords();
 }
 
 // float offset_x and float offset_y both have default value = 0.0
@@ -4013,10 +4126,12 @@ void wanda_model::copy_all_from_model(wanda_model &model, float offset_x, float
         new_sig_line.set_disused(sig_line->is_disused());
         if (signal_lines.find(sig_line->get_key_as_string()) == signal_lines.end())
         {
+            remove_from_name_index(new_sig_line);
             signal_lines.erase(new_sig_line.get_key_as_string());
             new_sig_line.set_comp_key(sig_line->get_key());
             signal_lines.emplace(new_sig_line.get_key_as_string(), new_sig_line);
             auto &sig_line_point = signal_lines.at(new_sig_line.get_key_as_string());
+            add_to_name_index(sig_line_point);
             incomp->disconnect(con_point_in, true);
             outcomp->disconnect(con_point_out, false);
             incomp->connect(sig_line_point, con_point_in, true);
@@ -4100,7 +4215,7 @@ void wanda_model::get_globvar_data()
             if (element.unit_description != "")
             {
                 prop.set_unit_dim(element.unit_description);
-                prop.set_unit_factor(unit_list, case_units);
+                prop.set_unit_factor(get_table_unit_factor(resolve_unit_id(prop)));
             }
         }
         if (element.type == "INTEGER")
@@ -4209,6 +4324,7 @@ void wanda_model::save_mode_and_options()
 // private method
 void wanda_model::read_nodes()
 {
+    invalidate_item_indices();
     number_physical_nodes = 0;
     int numrecords = wanda_input_file.get_maxdim_index("H_NODES");
     if (numrecords <= 0)
@@ -4260,13 +4376,14 @@ void wanda_model::read_nodes()
         phys_nodes[nodekey].set_group_index(i);
         // node_name_2_node.try_emplace(phys_nodes[nodekey].get_complete_name_spec(),
         // &phys_nodes[nodekey]);
-        name2_phys_node.emplace(phys_nodes[nodekey].get_complete_name_spec(), &phys_nodes[nodekey]);
+        add_to_name_index(phys_nodes[nodekey]);
     }
 }
 
 // private method
 void wanda_model::read_signal_lines()
 {
+    invalidate_item_indices();
     num_signal_lines = 0;
     int numrecords = wanda_input_file.get_maxdim_index("SIGNAL_LINES");
 
@@ -4324,6 +4441,7 @@ void wanda_model::read_signal_lines()
         wanda_input_file.get_int_element("SIGNAL_LINES", "Sig_chnl_ndx", {i + 1, i + 1, 1}, chn_index);
         sig_line.set_con_point(chn_index);
         signal_lines.emplace(sig_key, sig_line);
+        add_to_name_index(signal_lines[sig_key]);
         // connecting the signal line to components
         for (int j = 0; j <= 1; j++)
         {
@@ -4363,7 +4481,6 @@ void wanda_model::read_signal_lines()
             comp->connect(signal_lines[sig_key], chn_index[j], j == 1);
         }
 
-        // sig_line_name_2_sig_line.emplace(name ,&signal_lines[sig_key]);
         sig_line_keys.push_back(sig_key);
         signal_lines[sig_key].set_new(false);
     }
@@ -4372,6 +4489,7 @@ void wanda_model::read_signal_lines()
 // private method
 void wanda_model::read_physical_comp()
 {
+    invalidate_item_indices();
     phys_components.clear();
     number_physical_components = 0;
     int numrecords = wanda_input_file.get_maxdim_index("H_COMPONENTS");
@@ -4483,7 +4601,7 @@ void wanda_model::read_physical_comp()
         phys_components[compkey].set_comp_num(i + 1);
         phys_components[compkey].set_new(false);
         number_physical_components++;
-        name2_phys_comp.emplace(phys_components[compkey].get_complete_name_spec(), &phys_components[compkey]);
+        add_to_name_index(phys_components[compkey]);
         // comp_name_2_comp.emplace(phys_components[compkey].get_complete_name_spec(),
         // &phys_components[compkey]);
         if (phys_components[compkey].contains_property("Composition 1 1"))
@@ -4498,6 +4616,7 @@ void wanda_model::read_physical_comp()
 // private method
 void wanda_model::read_control_comp()
 {
+    invalidate_item_indices();
     number_control_components = 0;
     int numrecords = wanda_input_file.get_maxdim_index("C_COMPONENTS");
 
@@ -4547,10 +4666,11 @@ void wanda_model::read_control_comp()
         {
             ctrl_components[compkey].add_keyword(keyword);
         }
-        ctrl_components[compkey].set_max_input_channels(component_definition->get_max_in_chan(Class_name[i]));
-        ctrl_components[compkey].set_min_input_channels(component_definition->get_min_in_chan(Class_name[i]));
-        ctrl_components[compkey].set_input_channel_type(component_definition->get_in_chan_type(Class_name[i]));
-        ctrl_components[compkey].set_output_channel_type(component_definition->get_out_chan_type(Class_name[i]));
+        auto definition = component_definition->get_class_definition(Class_name[i]);
+        ctrl_components[compkey].set_max_input_channels(definition->max_input_channels);
+        ctrl_components[compkey].set_min_input_channels(definition->min_input_channels);
+        ctrl_components[compkey].set_input_channel_type(definition->input_channel_type);
+        ctrl_components[compkey].set_output_channel_type(definition->output_channel_type);
         ctrl_components[compkey].set_name(Name[i]);
         ctrl_components[compkey].set_comp_key(key);
         // ctrl_components.emplace(compkey, ctrl_components[compkey]);
@@ -4560,8 +4680,7 @@ void wanda_model::read_control_comp()
         pos[0] = centrpos[2 * i];
         pos[1] = centrpos[2 * i + 1];
         ctrl_components[compkey].set_position(pos);
-        // comp_name_2_comp.emplace(comp.get_complete_name_spec(),
-        // &ctrl_components[compkey]);
+        add_to_name_index(ctrl_components[compkey]);
         number_control_components++;
     }
 }
@@ -4569,6 +4688,7 @@ void wanda_model::read_control_comp()
 // private method
 void wanda_model::read_phys_component_input()
 {
+    invalidate_item_indices();
     if (number_physical_components <= 0)
     {
         return;
@@ -4890,6 +5010,7 @@ void wanda_model::read_phys_node_input()
 // private method
 void wanda_model::read_ctrl_component_input()
 {
+    invalidate_item_indices();
     if (number_control_components <= 0)
     {
         return;
@@ -5035,6 +5156,7 @@ std::string wanda_model::get_unique_key(std::vector<std::string> keys, char pref
 // private method
 void wanda_model::reload_component_indices()
 {
+    WANDA_TRACE_SCOPE("wanda_model::reload_component_indices");
     output_index_group_cache.clear(); // clear cache
 #ifdef DEBUG
     std::cout << "Reloading component indices\n";
@@ -5243,47 +5365,39 @@ std::string wanda_model::to_lower(std::string in) const
 
 wanda_property &wanda_model::get_property(std::string PropertyDescription)
 {
-    if (global_vars.find(PropertyDescription) != global_vars.end())
+    // find instead of operator[], so concurrent readers do not call a modifying member
+    auto global = global_vars.find(PropertyDescription);
+    if (global != global_vars.end())
     {
-        return global_vars[PropertyDescription];
+        return global->second;
     }
-    if (mode_and_opt.find(PropertyDescription) != mode_and_opt.end())
+    auto option = mode_and_opt.find(PropertyDescription);
+    if (option != mode_and_opt.end())
     {
-        return mode_and_opt[PropertyDescription];
+        return option->second;
     }
     throw std::invalid_argument(PropertyDescription + " does not exist in WandaModel object");
 }
 
-wanda_component &wanda_model::get_component(const std::string &componentname)
+wanda_component &wanda_model::get_component(std::string_view componentname)
 {
-    if (name2_phys_comp.find(componentname) != name2_phys_comp.end())
-    {
-        return *name2_phys_comp.at(componentname);
-    }
-    for (auto &comp : phys_components)
+    auto item = find_item(componentname);
+    if (item != nullptr &&
+        (item->get_item_type() == wanda_type::physical || item->get_item_type() == wanda_type::control))
     {
-        if (comp.second.get_complete_name_spec() == componentname)
-        {
-            return comp.second;
-        }
-    }
-    for (auto &comp : ctrl_components)
-    {
-        if (comp.second.get_complete_name_spec() == componentname)
-        {
-            return comp.second;
-        }
+        return *static_cast<wanda_component *>(item);
     }
-    throw std::invalid_argument(componentname + "does not exist in WandaModel object");
+    throw std::invalid_argument(std::string(componentname) + "does not exist in WandaModel object");
 }
 
-wanda_node &wanda_model::get_node(const std::string &nodename)
+wanda_node &wanda_model::get_node(std::string_view nodename)
 {
-    if (name2_phys_node.find(nodename) != name2_phys_node.end())
+    auto item = find_item(nodename);
+    if (item != nullptr && item->get_item_type() == wanda_type::node)
     {
-        return *name2_phys_node.at(nodename);
+        return *static_cast<wanda_node *>(item);
     }
-    throw std::invalid_argument(nodename + "does not exist in WandaModel object");
+    throw std::invalid_argument(std::string(nodename) + "does not exist in WandaModel object");
 }
 
 //! Gets a node from the wanda_model
@@ -5292,16 +5406,39 @@ wanda_node &wanda_model::get_node(const std::string &nodename)
 * requested signal line
 \param sig_name Name of the requested signal line
 */
-wanda_sig_line &wanda_model::get_signal_line(const std::string &sig_name)
+wanda_sig_line &wanda_model::get_signal_line(std::string_view sig_name)
 {
-    for (auto &sigline : signal_lines)
+    auto item = find_item(sig_name);
+    if (item != nullptr && item->get_item_type() == wanda_type::signal_line)
     {
-        if (sigline.second.get_complete_name_spec() == sig_name)
-        {
-            return sigline.second;
-        }
+        return *static_cast<wanda_sig_line *>(item);
+    }
+    throw std::invalid_argument(std::string(sig_name) + " not found");
+}
+
+wanda_item *wanda_model::find_item(std::string_view name) const
+{
+    auto iter = name2_item.find(name);
+    if (iter == name2_item.end())
+    {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+void wanda_model::add_to_name_index(wanda_item &item)
+{
+    name2_item.insert_or_assign(item.get_complete_name_spec(), &item);
+}
+
+void wanda_model::remove_from_name_index(const wanda_item &item)
+{
+    // another item may have taken the name already, its entry stays
+    auto iter = name2_item.find(item.get_complete_name_spec());
+    if (iter != name2_item.end() && iter->second == &item)
+    {
+        name2_item.erase(iter);
     }
-    throw std::invalid_argument(sig_name + " not found");
 }
 
 // private method
@@ -5333,6 +5470,7 @@ wanda_item &wanda_model::connect_sensor(wanda_component &h_comp1, int con_point1
 
 void wanda_model::connect_sensor(wanda_node &node, wanda_component &sensor)
 {
+    invalidate_graph_index();
     // check if they are already connected on the given connectpoints
 
     if (sensor.is_node_connected(1))
@@ -5611,7 +5749,8 @@ bool wanda_model::save_new_phys_comp()
             nefis_uindex com_rec_uindex = {com_rec, com_rec, 1};
             wanda_input_file.write_string_elements("H_COM_SPEC_VAL", "Spec_comm_key", com_rec_uindex, 8, spc_com_keys);
             wanda_input_file.write_string_elements("H_COM_SPEC_VAL", "Class_sort_key", com_rec_uindex, 8, class_name);
-            std::vector<int> nhis = component_definition->get_num_input_props(comp.get_class_sort_key());
+            std::vector<int> nhis =
+                component_definition->get_class_definition(comp.get_class_sort_key())->num_input_props;
             std::vector<int> N_his_com;
             N_his_com.push_back(nhis[0]);
             wanda_input_file.write_int_elements("H_COM_SPEC_VAL", "N_his", com_rec_uindex, N_his_com);
@@ -5824,7 +5963,8 @@ bool wanda_model::save_new_node()
         wanda_input_file.write_int_elements("H_NODES", "Is_valid_connect", uindex, is_val_con);
 
         // n his
-        std::vector<int> n_nis = component_definition->get_num_input_props(node.get_class_sort_key());
+        std::vector<int> n_nis =
+            component_definition->get_class_definition(node.get_class_sort_key())->num_input_props;
         wanda_input_file.write_int_elements("H_NODES", "N_nis", uindex, n_nis);
 
         // specchrval nis
@@ -6706,96 +6846,214 @@ void wanda_model::load_message(std::string group)
     }
 }
 
-void wanda_model::set_unit_factors()
+namespace
+{
+// process wide ids of the unit dimensions, so ids stay valid when items are copied between models
+std::mutex unit_dim_mutex;
+std::unordered_map<std::string, int> unit_dim_ids;
+std::vector<std::string> unit_dim_names;
+
+int get_unit_dim_id(const std::string &unit_dim)
+{
+    std::lock_guard<std::mutex> lock(unit_dim_mutex);
+    auto iter = unit_dim_ids.find(unit_dim);
+    if (iter != unit_dim_ids.end())
+    {
+        return iter->second;
+    }
+    unit_dim_names.push_back(unit_dim);
+    return unit_dim_ids.emplace(unit_dim, static_cast<int>(unit_dim_names.size() - 1)).first->second;
+}
+
+std::string get_unit_dim_name(int unit_id)
+{
+    std::lock_guard<std::mutex> lock(unit_dim_mutex);
+    return unit_dim_names[unit_id];
+}
+
+float lookup_unit_factor(const std::unordered_map<std::string, std::unordered_map<std::string, float>> &unit_list,
+                         const std::unordered_map<std::string, std::string> &case_units, const std::string &unit_dim)
+{
+    auto case_unit = case_units.find(unit_dim);
+    if (case_unit == case_units.end())
+    {
+        return 1.0f;
+    }
+    auto units = unit_list.find(unit_dim);
+    if (units == unit_list.end())
+    {
+        return 0.0f;
+    }
+    auto factor = units->second.find(case_unit->second);
+    return factor != units->second.end() ? factor->second : 0.0f;
+}
+} // namespace
+
+float wanda_model::get_table_unit_factor(int unit_id)
+{
+    while (unit_factors.size() <= static_cast<size_t>(unit_id))
+    {
+        auto unit_dim = get_unit_dim_name(static_cast<int>(unit_factors.size()));
+        unit_factors.push_back(lookup_unit_factor(unit_list, case_units, unit_dim));
+    }
+    return unit_factors[unit_id];
+}
+
+int wanda_model::resolve_unit_id(wanda_property &prop)
+{
+    if (prop.get_unit_id() < 0)
+    {
+        prop.set_unit_id(get_unit_dim_id(prop.get_unit_dim()));
+    }
+    return prop.get_unit_id();
+}
+
+void wanda_model::apply_output_units(wanda_output_data_struct &output)
+{
+    float target = 1.0f;
+    if (output_in_case_units && output.unit_id >= 0)
+    {
+        target = get_table_unit_factor(output.unit_id);
+        // unknown units have factor 0, those stay in SI
+        if (target <= 0.0f)
+            target = 1.0f;
+    }
+    if (target == output.unit_factor)
+    {
+        return;
+    }
+    // the values are rescaled in place, so series borrowed from the cache stay valid and no SI copy is kept, a
+    // switch back to SI can differ from the output file in the last bit
+    const float ratio = target / output.unit_factor;
+    for (auto *rows : {&output.time_series_data, &output.maximum_value, &output.minimum_value})
+    {
+        for (auto &values : *rows)
+        {
+            wanda_helper_functions::scale_values(values.data(), values.size(), ratio);
+        }
+    }
+    output.unit_factor = target;
+}
+
+void wanda_model::refresh_output_scalar(wanda_property &prop) const
+{
+    if (prop.get_scalar_output() == nullptr)
+    {
+        return;
+    }
+    // properties which still refer to the output of before a reload or close are left alone
+    auto entry = output_quantity_cache.find(prop.get_wdo_postfix());
+    if (entry != output_quantity_cache.end() && &entry->second == prop.get_scalar_output())
+    {
+        prop.refresh_output_scalar();
+    }
+}
+
+void wanda_model::refresh_output_scalars()
 {
     for (auto &comp : phys_components)
     {
         for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            it->second.set_unit_factor(unit_list, case_units);
+            refresh_output_scalar(it->second);
         }
     }
     for (auto &comp : ctrl_components)
     {
         for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            it->second.set_unit_factor(unit_list, case_units);
+            refresh_output_scalar(it->second);
         }
     }
     for (auto &comp : phys_nodes)
     {
         for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            it->second.set_unit_factor(unit_list, case_units);
-            // for (auto& item : unit_list.at(prop.get_unit_dim())) {
-            //	  if (item.second.unit_factor == 1.0) {
-            //	  set_unit(prop.get_unit_dim(), item.second.unit_description);
-            //	  break;
-            //  }
-            //  }
+            refresh_output_scalar(it->second);
         }
     }
 }
 
-bool wanda_model::check_name(std::string name, std::string key)
+void wanda_model::set_output_in_case_units(bool convert)
 {
-    if (name2_phys_comp.find(name) != name2_phys_comp.end())
+    output_in_case_units = convert;
+    for (auto &output : output_quantity_cache)
     {
-        return true;
+        apply_output_units(output.second);
     }
+    refresh_output_scalars();
+}
 
-    for (auto &comp : ctrl_components)
+void wanda_model::set_hcs_backend(wanda_hcs_backend backend)
+{
+#ifndef WANDA_NATIVE_HCS
+    if (backend == wanda_hcs_backend::native)
     {
-        if (comp.second.get_complete_name_spec() == name && comp.first != key)
-        {
-            return true;
-        }
+        throw std::invalid_argument("The native HCS is not built in, build with mgwso_ENABLE_NATIVE_HCS to use it");
     }
-    if (name2_phys_node.find(name) != name2_phys_node.end())
+#endif
+    hcs_backend = backend;
+}
+
+void wanda_model::set_unit_factors()
+{
+    // one lookup per unit dimension, the properties only index the table
+    for (size_t unit_id = 0; unit_id < unit_factors.size(); unit_id++)
     {
-        return true;
+        unit_factors[unit_id] =
+            lookup_unit_factor(unit_list, case_units, get_unit_dim_name(static_cast<int>(unit_id)));
     }
-    for (auto &comp : signal_lines)
+    // the output is rescaled first, so the steady state values of the properties can be copied again
+    for (auto &output : output_quantity_cache)
     {
-        if (comp.second.get_complete_name_spec() == name && comp.first != key)
-        {
-            return true;
-        }
+        apply_output_units(output.second);
     }
-    return false;
-}
-
-bool wanda_model::check_name(std::string name)
-{
+    auto apply = [this](wanda_property &prop) {
+        prop.set_unit_factor(get_table_unit_factor(resolve_unit_id(prop)));
+        refresh_output_scalar(prop);
+    };
     for (auto &comp : phys_components)
     {
-        if (comp.second.get_complete_name_spec() == name)
+        for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            return true;
+            apply(it->second);
         }
     }
     for (auto &comp : ctrl_components)
     {
-        if (comp.second.get_complete_name_spec() == name)
+        for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            return true;
+            apply(it->second);
         }
     }
     for (auto &comp : phys_nodes)
     {
-        if (comp.second.get_complete_name_spec() == name)
+        for (auto it = comp.second.begin(); it != comp.second.end(); ++it)
         {
-            return true;
+            apply(it->second);
         }
     }
-    for (auto &comp : signal_lines)
+}
+
+bool wanda_model::check_name(std::string name, std::string key)
+{
+    auto item = find_item(name);
+    if (item == nullptr)
     {
-        if (comp.second.get_complete_name_spec() == name)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    // physical components and nodes are always reported, for control components and signal lines an item with the
+    // same key is the item itself
+    if (item->get_item_type() == wanda_type::physical || item->get_item_type() == wanda_type::node)
+    {
+        return true;
+    }
+    return item->get_key_as_string() != key;
+}
+
+bool wanda_model::check_name(std::string name)
+{
+    return name2_item.contains(name);
 }
 
 bool wanda_model::glob_var_modified()
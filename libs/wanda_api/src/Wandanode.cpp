@@ -10,11 +10,10 @@ wanda_node::wanda_node(int compkey, std::string classname, std::string csKey, st
     : wanda_item(compkey, classname, csKey, namePrefix, name, wanda_type::node, type_name),
       _object_hash(std::hash<std::string>{}(_object_name))
 {
-    wanda_def *componentDefinition = component_definition;
-
-    properties = componentDefinition->get_properties(_class_sort_key);
-    _core_quantities.push_back(componentDefinition->get_node_core_quants(_class_sort_key));
-    _node_type = componentDefinition->get_node_type(_class_sort_key);
+    auto definition = component_definition->get_class_definition(_class_sort_key);
+    properties = *definition->properties;
+    _core_quantities = definition->core_quants;
+    _node_type = definition->node_type;
 }
 
 wanda_node::wanda_node(std::string class_sort_key, wanda_type type, std::string name_pre_fix, std::string type_name,
@@ -22,11 +21,10 @@ wanda_node::wanda_node(std::string class_sort_key, wanda_type type, std::string
     : wanda_item(class_sort_key, name_pre_fix, type, def_mask, convert2comp, type_name),
       _object_hash(std::hash<std::string>{}(_object_name))
 {
-    wanda_def *componentDefinition = component_definition;
-    properties = componentDefinition->get_properties(_class_sort_key);
-    auto node_core_quants = componentDefinition->get_node_core_quants(_class_sort_key);
-    _core_quantities.push_back(node_core_quants);
-    _node_type = componentDefinition->get_node_type(_class_sort_key);
+    auto definition = component_definition->get_class_definition(_class_sort_key);
+    properties = *definition->properties;
+    _core_quantities = definition->core_quants;
+    _node_type = definition->node_type;
 }
 
 std::vector<wanda_component *> wanda_node::get_connected_components() const
@@ -1,79 +1,88 @@
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <vector>
 #include <wandaproperty.h>
 
 std::string wanda_property::_object_name = "WandaProperty Object";
 
-wanda_property::wanda_property()
-    : _wnd_type(wanda_property_types::NONE), _description("not available"), _index(0), _group_index(0),
-      _comp_spec_code(' '), _comp_sp_inp_fld(' '), _wdo_post_fix("-"), _unit_dim("."), _modified(false),
-      _scalar(-999.0), _default_value(0), _min_value(0), _max_value(0), _series(nullptr), _number_of_elements(0),
-      _object_hash(std::hash<std::string>{}(_object_name))
+const std::size_t wanda_property::_object_hash = std::hash<std::string>{}(_object_name);
+
+// all default constructed properties share the same descriptor
+static const std::shared_ptr<const wanda_property_descriptor> &default_descriptor()
+{
+    static const auto descr = std::make_shared<const wanda_property_descriptor>();
+    return descr;
+}
+
+wanda_property::wanda_property() : _descr(default_descriptor())
 {
-    extr_min.push_back(nullptr);
-    extr_max.push_back(nullptr);
-    extr_tmin.push_back(nullptr);
-    extr_tmax.push_back(nullptr);
 }
 
 wanda_property::wanda_property(int index, std::string spec_descr, char comp_spec_code, char comp_sp_inp_fld,
                                std::string wdo_post_fix, std::string unit_dim, wanda_property_types wnd_type,
                                std::string short_quant_name, float def_val, float min_val, float max_val,
                                std::string list_dependency, int view_list_mask, char input_type_code, int view_mask)
-    : _modified(false), _scalar(def_val), _series(nullptr), _wnd_type(wnd_type), _description(spec_descr),
-      _index(index), _group_index(0), _comp_spec_code(comp_spec_code), _comp_sp_inp_fld(comp_sp_inp_fld),
-      _wdo_post_fix(wdo_post_fix), _unit_dim(unit_dim), _default_value(def_val), _min_value(min_val),
-      _max_value(max_val), _number_of_elements(0), _short_quant_name(short_quant_name),
-      _list_dependency(list_dependency), _view_list_mask(view_list_mask), _input_type_code(input_type_code),
-      _view_mask(view_mask), _object_hash(std::hash<std::string>{}(_object_name))
+    : _scalar(def_val)
 {
-    extr_min.push_back(nullptr);
-    extr_max.push_back(nullptr);
-    extr_tmin.push_back(nullptr);
-    extr_tmax.push_back(nullptr);
-    _series_pipe.push_back(nullptr);
-    _spec_status = _default_value != -999;
-    if (_comp_sp_inp_fld == 'C')
+    auto descr = std::make_shared<wanda_property_descriptor>();
+    descr->description = std::move(spec_descr);
+    descr->wdo_post_fix = std::move(wdo_post_fix);
+    descr->unit_dim = std::move(unit_dim);
+    descr->short_quant_name = std::move(short_quant_name);
+    descr->list_dependency = std::move(list_dependency);
+    descr->wnd_type = wnd_type;
+    descr->index = index;
+    descr->comp_spec_code = comp_spec_code;
+    descr->comp_sp_inp_fld = comp_sp_inp_fld;
+    descr->default_value = def_val;
+    descr->min_value = min_val;
+    descr->max_value = max_val;
+    descr->view_list_mask = view_list_mask;
+    descr->input_type_code = input_type_code;
+    descr->view_mask = view_mask;
+    _descr = std::move(descr);
+    _spec_status = def_val != -999;
+    if (comp_sp_inp_fld == 'C')
     {
-        _spec_status = _default_value != 0;
+        _spec_status = def_val != 0;
     }
 }
 
-void wanda_property::set_unit_factor(std::unordered_map<std::string, std::unordered_map<std::string, float>> &unit_list,
-                                     std::unordered_map<std::string, std::string> &case_units)
+wanda_property_descriptor &wanda_property::edit_descriptor()
 {
-    auto unit_dim = get_unit_dim();
-    auto it1 = unit_list.find(unit_dim);
-    auto it2 = case_units.find(unit_dim);
-    if (case_units.find(unit_dim) != case_units.end())
+    // descriptors are shared between instances, so the property gets its own copy before it is changed
+    auto descr = std::make_shared<wanda_property_descriptor>(*_descr);
+    _descr = descr;
+    return *descr;
+}
+
+void wanda_property::set_output_reference(const wanda_output_data_struct *output, int row)
+{
+    if (!has_series())
     {
-        set_unit_factor(unit_list[unit_dim][case_units[unit_dim]]);
-        return;
+        throw std::runtime_error(get_description() + " property has no series");
     }
-    set_unit_factor(1.0);
+    _output = output;
+    _output_row = row;
 }
 
-void wanda_property::set_extremes(float *min, float *max, float *Tmin, float *Tmax)
+void wanda_property::bind_output_scalar(const wanda_output_data_struct *output, int row)
 {
-    extr_min[0] = min;
-    extr_max[0] = max;
-    extr_tmin[0] = Tmin;
-    extr_tmax[0] = Tmax;
+    _scalar_output = output;
+    _output_row = row;
+    float scalar = output->time_series_data[row][0];
+    set_scalar_by_ref(scalar);
 }
 
-void wanda_property::set_extremes(int element, float *min, float *max, float *Tmin, float *Tmax)
+void wanda_property::refresh_output_scalar()
 {
-    if (element <= _number_of_elements)
+    if (_scalar_output == nullptr || static_cast<size_t>(_output_row) >= _scalar_output->time_series_data.size())
     {
-        extr_min[element] = min;
-        extr_max[element] = max;
-        extr_tmin[element] = Tmin;
-        extr_tmax[element] = Tmax;
         return;
     }
-    throw std::runtime_error("Element not within total number of elements");
+    _scalar = _scalar_output->time_series_data[_output_row][0];
 }
 
 float wanda_property::get_extr_min() const
@@ -82,11 +91,11 @@ float wanda_property::get_extr_min() const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_min[0] == nullptr)
+    if (_output == nullptr)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_min[0];
+    return _output->minimum_value[_output_row][0];
 }
 
 float wanda_property::get_extr_max() const
@@ -95,11 +104,11 @@ float wanda_property::get_extr_max() const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_max[0] == nullptr)
+    if (_output == nullptr)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_max[0];
+    return _output->maximum_value[_output_row][0];
 }
 
 float wanda_property::get_extr_tmin() const
@@ -108,11 +117,11 @@ float wanda_property::get_extr_tmin() const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_tmin[0] == nullptr)
+    if (_output == nullptr)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_tmin[0];
+    return _output->minimum_value_time[_output_row][0];
 }
 
 float wanda_property::get_extr_tmax() const
@@ -121,11 +130,11 @@ float wanda_property::get_extr_tmax() const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_tmax[0] == nullptr)
+    if (_output == nullptr)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_tmax[0];
+    return _output->maximum_value_time[_output_row][0];
 }
 
 float wanda_property::get_extr_min(int element) const
@@ -134,11 +143,11 @@ float wanda_property::get_extr_min(int element) const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_min[element] == nullptr)
+    if (_output == nullptr || element > _number_of_elements)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_min[element];
+    return _output->minimum_value[_output_row + element][0];
 }
 
 float wanda_property::get_extr_max(int element) const
@@ -147,11 +156,11 @@ float wanda_property::get_extr_max(int element) const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_max[element] == nullptr)
+    if (_output == nullptr || element > _number_of_elements)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_max[element];
+    return _output->maximum_value[_output_row + element][0];
 }
 
 float wanda_property::get_extr_tmin(int element) const
@@ -160,11 +169,11 @@ float wanda_property::get_extr_tmin(int element) const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_tmin[element] == nullptr)
+    if (_output == nullptr || element > _number_of_elements)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_tmin[element];
+    return _output->minimum_value_time[_output_row + element][0];
 }
 
 float wanda_property::get_extr_tmax(int element) const
@@ -173,11 +182,11 @@ float wanda_property::get_extr_tmax(int element) const
     {
         throw std::runtime_error("Component is disused");
     }
-    if (extr_tmax[element] == nullptr)
+    if (_output == nullptr || element > _number_of_elements)
     {
         throw std::runtime_error("Data not loaded");
     }
-    return *extr_tmax[element];
+    return _output->maximum_value_time[_output_row + element][0];
 }
 
 std::vector<float> wanda_property::get_extr_min_pipe() const
@@ -239,11 +248,6 @@ std::vector<float> wanda_property::get_extr_tmax_pipe() const
 void wanda_property::set_number_of_elements(int number_of_elements)
 {
     _number_of_elements = number_of_elements;
-    _series_pipe.resize(_number_of_elements + 1, nullptr);
-    extr_min.resize(_number_of_elements + 1, nullptr);
-    extr_max.resize(_number_of_elements + 1, nullptr);
-    extr_tmin.resize(_number_of_elements + 1, nullptr);
-    extr_tmax.resize(_number_of_elements + 1, nullptr);
 }
 
 // functions below are fast, but they assume that the user knows what type of
@@ -254,37 +258,43 @@ float wanda_property::get_scalar_float() const
     {
         return _scalar;
     }
-    throw std::runtime_error(_description + " has no input yet");
+    throw std::runtime_error(_descr->description + " has no input yet");
 }
 
 std::string wanda_property::get_scalar_str()
 {
-    if (drop_down_list.size() > 0 && _scalar > 0)
+    if (_descr->drop_down_list.size() > 0 && _scalar > 0)
         return get_selected_item();
-    throw std::runtime_error(_description + " has no input yet");
+    throw std::runtime_error(_descr->description + " has no input yet");
 }
 
 std::vector<float> wanda_property::get_series() const
+{
+    auto series = get_series_view();
+    return {series.begin(), series.end()};
+}
+
+std::span<const float> wanda_property::get_series_view() const
 {
     if (disused)
     {
         throw std::runtime_error("Component is disused");
     }
-    if (_series == nullptr)
+    if (_output == nullptr)
     {
         throw std::runtime_error("Data is not loaded yet, please load data first");
     }
-    return *_series;
+    return _output->time_series_data[_output_row];
 }
 
 void wanda_property::set_scalar(float scalar)
 {
-    if (_wnd_type == wanda_property_types::HIS || _wnd_type == wanda_property_types::NIS ||
-        _wnd_type == wanda_property_types::CIS)
+    if (_descr->wnd_type == wanda_property_types::HIS || _descr->wnd_type == wanda_property_types::NIS ||
+        _descr->wnd_type == wanda_property_types::CIS)
     {
-        if (scalar < _min_value && scalar != _default_value)
+        if (scalar < _descr->min_value && scalar != _descr->default_value)
         {
-            throw std::runtime_error(_description + " value below minimum value");
+            throw std::runtime_error(_descr->description + " value below minimum value");
         }
     }
     _scalar = scalar;
@@ -294,10 +304,10 @@ void wanda_property::set_scalar(float scalar)
 
 void wanda_property::set_scalar_by_ref(float &scalar)
 {
-    if (_wnd_type == wanda_property_types::HIS || _wnd_type == wanda_property_types::NIS ||
-        _wnd_type == wanda_property_types::CIS)
+    if (_descr->wnd_type == wanda_property_types::HIS || _descr->wnd_type == wanda_property_types::NIS ||
+        _descr->wnd_type == wanda_property_types::CIS)
     {
-        if (scalar < _min_value)
+        if (scalar < _descr->min_value)
         {
             throw std::runtime_error("Value below minimum value");
         }
@@ -309,13 +319,14 @@ void wanda_property::set_scalar_by_ref(float &scalar)
 
 void wanda_property::set_scalar(std::string scalarin)
 {
-    if (_wnd_type == wanda_property_types::NIS || _wnd_type == wanda_property_types::CIS ||
-        _wnd_type == wanda_property_types::HIS || _wnd_type == wanda_property_types::GLOV)
+    if (_descr->wnd_type == wanda_property_types::NIS || _descr->wnd_type == wanda_property_types::CIS ||
+        _descr->wnd_type == wanda_property_types::HIS || _descr->wnd_type == wanda_property_types::GLOV)
     {
-        if (_comp_sp_inp_fld == 'C')
+        if (_descr->comp_sp_inp_fld == 'C')
         {
-            _scalar = std::find(drop_down_list.begin(), drop_down_list.end(), scalarin) - drop_down_list.begin() + 1;
-            if (_scalar - 1 >= drop_down_list.size())
+            auto &list = _descr->drop_down_list;
+            _scalar = std::find(list.begin(), list.end(), scalarin) - list.begin() + 1;
+            if (_scalar - 1 >= list.size())
             {
                 _scalar = 1.0;
             }
@@ -325,41 +336,12 @@ void wanda_property::set_scalar(std::string scalarin)
     }
 }
 
-void wanda_property::set_series_by_ref(std::vector<float> *series)
-{
-    if (has_series())
-    // TODO  access & error checking?
-    {
-        _series = series;
-        return;
-    }
-    throw std::runtime_error(_description + " property has no series");
-}
-
-void wanda_property::set_series_pipe_by_ref(int element, std::vector<float> *series)
-{
-    // TODO  access & error checking?
-    if (!has_series())
-    {
-        throw std::runtime_error(_description + " property has no series");
-    }
-    if (_number_of_elements < 1)
-    {
-        throw std::runtime_error(_description + " is not from a pipe");
-    }
-    if (element > _number_of_elements)
-    {
-        throw std::runtime_error(_description + " has only " + std::to_string(_number_of_elements) + " element");
-    }
-    _series_pipe[element] = series;
-}
-
 bool wanda_property::has_scalar() const
 {
-    if ((_wnd_type == wanda_property_types::NOV || _wnd_type == wanda_property_types::COV ||
-         _wnd_type == wanda_property_types::HOV || _wnd_type == wanda_property_types::NIS ||
-         _wnd_type == wanda_property_types::CIS || _wnd_type == wanda_property_types::HIS ||
-         _wnd_type == wanda_property_types::GLOV || _wnd_type == wanda_property_types::MAO) &&
+    if ((_descr->wnd_type == wanda_property_types::NOV || _descr->wnd_type == wanda_property_types::COV ||
+         _descr->wnd_type == wanda_property_types::HOV || _descr->wnd_type == wanda_property_types::NIS ||
+         _descr->wnd_type == wanda_property_types::CIS || _descr->wnd_type == wanda_property_types::HIS ||
+         _descr->wnd_type == wanda_property_types::GLOV || _descr->wnd_type == wanda_property_types::MAO) &&
         !has_table())
     {
         return true;
@@ -369,7 +351,7 @@ bool wanda_property::has_scalar() const
 
 bool wanda_property::has_table() const
 {
-    if (_comp_sp_inp_fld == 'T' || _comp_sp_inp_fld == 'N' || _comp_sp_inp_fld == 'S')
+    if (_descr->comp_sp_inp_fld == 'T' || _descr->comp_sp_inp_fld == 'N' || _descr->comp_sp_inp_fld == 'S')
     {
         return true;
     }
@@ -378,8 +360,8 @@ bool wanda_property::has_table() const
 
 bool wanda_property::has_series() const
 {
-    if (_wnd_type == wanda_property_types::NOS || _wnd_type == wanda_property_types::COS ||
-        _wnd_type == wanda_property_types::HOS || _wnd_type == wanda_property_types::GLOQUANT)
+    if (_descr->wnd_type == wanda_property_types::NOS || _descr->wnd_type == wanda_property_types::COS ||
+        _descr->wnd_type == wanda_property_types::HOS || _descr->wnd_type == wanda_property_types::GLOQUANT)
     {
         return true;
     }
@@ -388,7 +370,7 @@ bool wanda_property::has_series() const
 
 bool wanda_property::is_glo_quant() const
 {
-    if (_wnd_type == wanda_property_types::GLOQUANT)
+    if (_descr->wnd_type == wanda_property_types::GLOQUANT)
     {
         return true;
     }
@@ -397,57 +379,58 @@ bool wanda_property::is_glo_quant() const
 
 void wanda_property::settype()
 {
-    if (_wdo_post_fix == "HIS")
+    auto &descr = edit_descriptor();
+    if (descr.wdo_post_fix == "HIS")
     {
-        _wnd_type = wanda_property_types::HIS;
+        descr.wnd_type = wanda_property_types::HIS;
     }
-    else if (_wdo_post_fix == "HCS")
+    else if (descr.wdo_post_fix == "HCS")
     {
-        _wnd_type = wanda_property_types::HCS;
+        descr.wnd_type = wanda_property_types::HCS;
     }
-    else if (_wdo_post_fix == "HOS")
+    else if (descr.wdo_post_fix == "HOS")
     {
-        _wnd_type = wanda_property_types::HOS;
+        descr.wnd_type = wanda_property_types::HOS;
     }
-    else if (_wdo_post_fix == "HOV")
+    else if (descr.wdo_post_fix == "HOV")
     {
-        _wnd_type = wanda_property_types::HOV;
+        descr.wnd_type = wanda_property_types::HOV;
     }
-    else if (_wdo_post_fix == "CIS")
+    else if (descr.wdo_post_fix == "CIS")
     {
-        _wnd_type = wanda_property_types::CIS;
+        descr.wnd_type = wanda_property_types::CIS;
     }
-    else if (_wdo_post_fix == "COS")
+    else if (descr.wdo_post_fix == "COS")
     {
-        _wnd_type = wanda_property_types::COS;
+        descr.wnd_type = wanda_property_types::COS;
     }
-    else if (_wdo_post_fix == "COV")
+    else if (descr.wdo_post_fix == "COV")
     {
-        _wnd_type = wanda_property_types::COV;
+        descr.wnd_type = wanda_property_types::COV;
     }
-    else if (_wdo_post_fix == "NIS")
+    else if (descr.wdo_post_fix == "NIS")
     {
-        _wnd_type = wanda_property_types::NIS;
+        descr.wnd_type = wanda_property_types::NIS;
     }
-    else if (_wdo_post_fix == "NOS")
+    else if (descr.wdo_post_fix == "NOS")
     {
-        _wnd_type = wanda_property_types::NOS;
+        descr.wnd_type = wanda_property_types::NOS;
     }
-    else if (_wdo_post_fix == "NOV")
+    else if (descr.wdo_post_fix == "NOV")
     {
-        _wnd_type = wanda_property_types::NOV;
+        descr.wnd_type = wanda_property_types::NOV;
     }
-    else if (_wdo_post_fix == "GLOV")
+    else if (descr.wdo_post_fix == "GLOV")
     {
-        _wnd_type = wanda_property_types::GLOV;
+        descr.wnd_type = wanda_property_types::GLOV;
     }
-    else if (_wdo_post_fix == "MAO")
+    else if (descr.wdo_post_fix == "MAO")
     {
-        _wnd_type = wanda_property_types::MAO;
+        descr.wnd_type = wanda_property_types::MAO;
     }
     else
     {
-        _wnd_type = wanda_property_types::GLOQUANT;
+        descr.wnd_type = wanda_property_types::GLOQUANT;
     }
 }
 
@@ -457,21 +440,21 @@ std::string wanda_property::get_list_item(int num_item)
     {
         return "";
     }
-    if (num_item > drop_down_list.size())
+    if (num_item > _descr->drop_down_list.size())
     {
         return "";
     }
-    return drop_down_list[num_item - 1];
+    return _descr->drop_down_list[num_item - 1];
 }
 
 void wanda_property::set_list(std::vector<std::string> list)
 {
-    drop_down_list = list;
+    edit_descriptor().drop_down_list = std::move(list);
 }
 
 std::vector<std::string> wanda_property::get_list() const
 {
-    return drop_down_list;
+    return _descr->drop_down_list;
 }
 
 std::string wanda_property::get_selected_item()
@@ -480,7 +463,7 @@ std::string wanda_property::get_selected_item()
     {
         return ""; // return empty string since no item is selected
     }
-    return drop_down_list[_scalar - 1];
+    return _descr->drop_down_list[_scalar - 1];
 }
 
 bool wanda_property::is_modified() const
@@ -505,7 +488,7 @@ wanda_table &wanda_property::get_table()
     {
         return _table;
     }
-    throw std::runtime_error(_description + " is not a table");
+    throw std::runtime_error(_descr->description + " is not a table");
 }
 
 void wanda_property::set_value_from_template(std::unordered_map<std::string, wanda_prop_template>::value_type item)
@@ -576,7 +559,7 @@ void wanda_property::set_value_from_template(std::unordered_map<std::string, wan
 std::vector<int> wanda_property::get_view_list_numbers() const
 {
     std::vector<int> view_list_numbers;
-    int value = _view_list_mask;
+    int value = _descr->view_list_mask;
     int bit_exp = 0;
     while (value != 0)
     {
@@ -614,18 +597,24 @@ void wanda_property::copy_data(wanda_property prop_org)
 }
 
 std::vector<float> wanda_property::get_series(int element) const
+{
+    auto series = get_series_view(element);
+    return {series.begin(), series.end()};
+}
+
+std::span<const float> wanda_property::get_series_view(int element) const
 {
     if (disused)
     {
         throw std::runtime_error("Component is disused");
     }
-    if (element <= _number_of_elements)
+    if (element >= 0 && element <= _number_of_elements)
     {
-        if (_series_pipe[element] == nullptr)
+        if (_output == nullptr)
         {
             throw std::runtime_error("Data is not loaded yet, please load data first");
         }
-        return *(_series_pipe[element]);
+        return _output->time_series_data[_output_row + element];
     }
     throw std::runtime_error("Element not within total number of elements");
 }
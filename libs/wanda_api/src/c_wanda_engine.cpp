@@ -2,7 +2,7 @@
 #include "wanda_engine.h"
 #include <functional>
 
-static std::string wnd_eng_error_message = "no error";
+static thread_local std::string wnd_eng_error_message = "no error";
 
 static std::string engine_Id_string("WandaEngine Object");
 static std::string wandamodel_Id_string("WandaModel Object");
@@ -1,8 +1,10 @@
 // c interface functions
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
+#include <wanda_metrics.h>
 #include <wandamodel.h>
 
 static std::string wandamodel_Id_string("WandaModel Object");
@@ -20,7 +22,8 @@ static std::size_t _singal_line_Id_hash = std::hash<std::string>{}(signal_line_I
 static std::size_t _prop_Id_hash = std::hash<std::string>{}(prop_Id_string);
 static std::size_t _table_Id_hash = std::hash<std::string>{}(table_Id_string);
 
-static std::string wnd_model_error_message = "no error";
+// error messages are kept per thread, so failing calls on different threads do not overwrite each other
+static thread_local std::string wnd_model_error_message = "no error";
 
 wanda_model *cast_to_wanda_model(void *void_pointer)
 {
@@ -113,7 +116,11 @@ extern "C" __declspec(dllexport) int wnd_close_wanda_model(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
-        model->close();
+        {
+            // waits for calls on other threads to finish, the model must not be used after this
+            auto lock = model->lock_exclusive();
+            model->close();
+        }
         delete model;
         return 0;
     }
@@ -132,6 +139,7 @@ extern "C" __declspec(dllexport) int wnd_save_model_input(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->save_model_input();
         return 0;
     }
@@ -150,6 +158,7 @@ extern "C" __declspec(dllexport) int wnd_reload_model_input(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->reload_input();
         return 0;
     }
@@ -168,6 +177,7 @@ extern "C" __declspec(dllexport) int wnd_reload_model_output(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->reload_output();
         return 0;
     }
@@ -186,6 +196,7 @@ extern "C" __declspec(dllexport) int wnd_get_num_time_steps(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         return model->get_num_time_steps();
     }
     catch (std::exception &e)
@@ -203,6 +214,7 @@ extern "C" __declspec(dllexport) int wnd_get_num_components(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         return static_cast<int>(model->get_all_components().size());
     }
     catch (std::exception &e)
@@ -220,6 +232,7 @@ extern "C" __declspec(dllexport) int wnd_get_num_nodes(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         return static_cast<int>(model->get_all_nodes().size());
         ;
     }
@@ -238,6 +251,7 @@ extern "C" __declspec(dllexport) int wnd_get_num_pipes(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         return static_cast<int>(model->get_all_pipes().size());
     }
     catch (std::exception &e)
@@ -255,6 +269,7 @@ extern "C" __declspec(dllexport) int wnd_get_all_component_handles(void *model_h
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto allcomp = model->get_all_components();
         if (size < allcomp.size())
             throw std::invalid_argument("buffer is too small, should be " + std::to_string(allcomp.size()) + " bytes");
@@ -279,6 +294,7 @@ extern "C" __declspec(dllexport) int wnd_get_all_node_handles(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto all_nodes = model->get_all_nodes();
         if (size < all_nodes.size())
             throw std::invalid_argument("buffer is too small");
@@ -303,6 +319,7 @@ extern "C" __declspec(dllexport) int wnd_get_all_pipe_handles(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto allpipes = model->get_all_pipes();
         if (size < allpipes.size())
             throw std::invalid_argument("buffer is too small");
@@ -327,7 +344,8 @@ extern "C" __declspec(dllexport) void *wnd_get_component_handle(void *model_hand
     try
     {
         auto model = cast_to_wanda_model(model_handle);
-        auto &component = model->get_component(std::string(component_name));
+        auto lock = model->lock_shared();
+        auto &component = model->get_component(component_name);
         return static_cast<void *>(&component);
     }
     catch (std::exception &e)
@@ -345,7 +363,8 @@ extern "C" __declspec(dllexport) void *wnd_get_node_handle(void *model_handle, c
     try
     {
         auto model = cast_to_wanda_model(model_handle);
-        auto &handle = model->get_node(std::string(node_name));
+        auto lock = model->lock_shared();
+        auto &handle = model->get_node(node_name);
         return static_cast<void *>(&handle);
     }
     catch (std::exception &e)
@@ -363,6 +382,7 @@ extern "C" __declspec(dllexport) void *wnd_get_model_property_handle(void *model
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto &handle = model->get_property(std::string(property_name));
         return static_cast<void *>(&handle);
     }
@@ -496,6 +516,7 @@ extern "C" __declspec(dllexport) int wnd_new_wanda_case(void *model_handle, cons
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->new_wanda_case(std::string(new_case_name));
         return 0;
     }
@@ -531,6 +552,7 @@ extern "C" __declspec(dllexport) void *wnd_add_component(void *model_handle, con
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto &p = model->add_component(std::string(component_type_name), {x_pos, y_pos});
         return static_cast<void *>(&p);
     }
@@ -550,6 +572,7 @@ extern "C" __declspec(dllexport) void *wnd_add_node(void *model_handle, const ch
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto &p = model->add_node(std::string(node_type_name), {x_pos, y_pos});
         return static_cast<void *>(&p);
     }
@@ -568,6 +591,7 @@ extern "C" __declspec(dllexport) int wnd_delete_component(void *model_handle, vo
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto component = cast_to_wanda_component(component_handle);
         model->delete_component(*component);
         return 0;
@@ -587,6 +611,7 @@ extern "C" __declspec(dllexport) int wnd_delete_node(void *model_handle, void *n
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto node = cast_to_wanda_node(node_handle);
         model->delete_node(*node);
         return 0;
@@ -606,6 +631,7 @@ extern "C" __declspec(dllexport) int wnd_delete_signal_line(void *model_handle,
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto signal_line = cast_to_wanda_sig_line(sigline_handle);
         model->delete_sig_line(*signal_line);
         return 0;
@@ -627,6 +653,7 @@ extern "C" __declspec(dllexport) void *wnd_connect_components(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto comp1 = cast_to_wanda_component(component1);
         auto comp2 = cast_to_wanda_component(component2);
         auto &item_handle = model->connect(*comp1, connection_point1, *comp2, connection_point2);
@@ -648,6 +675,7 @@ extern "C" __declspec(dllexport) int wnd_connect_component_to_node(void *model_h
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto comp1 = cast_to_wanda_component(component1);
         auto node_handle = cast_to_wanda_node(node);
         model->connect(*comp1, connection_point1, *node_handle);
@@ -669,6 +697,7 @@ extern "C" __declspec(dllexport) int wnd_disconnect_component(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto comp1 = cast_to_wanda_component(component_handle);
         model->disconnect(*comp1, connection_point);
         return 0;
@@ -889,6 +918,7 @@ extern "C" __declspec(dllexport) int wnd_run_steady(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->run_steady();
         return 0;
     }
@@ -907,6 +937,7 @@ extern "C" __declspec(dllexport) int wnd_run_unsteady(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->run_unsteady();
         return 0;
     }
@@ -925,6 +956,7 @@ extern "C" __declspec(dllexport) void *wnd_split_pipe(void *model_handle, void *
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto comp = static_cast<wanda_component *>(comp_handle);
         if (comp->wnd_get_hash() != _item_Id_hash)
             throw std::exception("Invalid pointer cast: comp_handle");
@@ -946,6 +978,7 @@ extern "C" __declspec(dllexport) int wnd_get_number_results_val_model(void *mode
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         size_t size = 0;
         auto res = model->validate_model_input();
         for (auto &item : res)
@@ -970,6 +1003,7 @@ extern "C" __declspec(dllexport) int wnd_validate_model_input(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto res = model->validate_model_input();
         size_t size = 0;
         for (auto &item : res)
@@ -1014,6 +1048,7 @@ extern "C" __declspec(dllexport) int wnd_get_number_results_check_con_model(void
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         size_t size = 0;
         auto res = model->validate_connectivity();
         for (auto &item : res)
@@ -1039,6 +1074,7 @@ extern "C" __declspec(dllexport) int wnd_check_connectivity(void *model_handle,
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto res = model->validate_connectivity();
         if (comp_size < res.size() * (sizeof(char) * (8 + 1 + 16)))
         {
@@ -1334,7 +1370,7 @@ extern "C" __declspec(dllexport) int wnd_get_series(void *property_handle, float
     try
     {
         auto property = cast_to_wanda_property(property_handle);
-        auto result = property->get_series();
+        auto result = property->get_series_view();
         if ((result.size() * sizeof(float)) > buffersize)
             throw std::invalid_argument("Buffer is too small");
         memcpy_s(buffer, buffersize, result.data(), result.size() * sizeof(float));
@@ -1356,7 +1392,7 @@ extern "C" __declspec(dllexport) int wnd_get_time_series_pipe(void *property_han
     try
     {
         auto property = cast_to_wanda_property(property_handle);
-        auto result = property->get_series(element);
+        auto result = property->get_series_view(element);
         if (result.size() * sizeof(float) > buffersize)
             throw std::invalid_argument("Buffer is too small");
         memcpy_s(buffer, buffersize, result.data(), result.size() * sizeof(float));
@@ -1377,17 +1413,127 @@ extern "C" __declspec(dllexport) int wnd_get_series_pipe(void *property_handle,
     try
     {
         const auto property = cast_to_wanda_property(property_handle);
-        const size_t num_elements = property->get_number_of_elements();
-        const auto result = property->get_series_pipe();
-        const size_t num_timesteps = result[0].size();
+        const int num_elements = property->get_number_of_elements();
+        if (num_elements == 0)
+            throw std::runtime_error(property->get_description() + " does not belong to a pipe");
+        const size_t num_timesteps = property->get_series_view(0).size();
         if ((num_elements + std::size_t{1}) * num_timesteps * sizeof(float) > buffersize)
             throw std::invalid_argument("Buffer is too small");
 
         for (int i = 0; i <= num_elements; i++)
         {
-            for (int j = 0; j <= num_timesteps - 1; j++)
+            auto series = property->get_series_view(i);
+            std::copy(series.begin(), series.end(), buffer + i * num_timesteps);
+        }
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+#ifdef DEBUG
+        std::cerr << e.what() << std::endl;
+#endif
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
+// number of series or extremes of a property in the bulk functions, pipes give one per element
+static int get_bulk_rows(const wanda_property &property)
+{
+    return property.get_number_of_elements() + 1;
+}
+
+extern "C" __declspec(dllexport) int wnd_get_series_bulk(void **property_handles, const size_t num_properties,
+                                                         float *buffer, const size_t buffersize, size_t *offsets)
+{
+    try
+    {
+        if (property_handles == nullptr || offsets == nullptr)
+            throw std::invalid_argument("No property handles or offsets given");
+        std::vector<wanda_property *> properties(num_properties);
+        offsets[0] = 0;
+        for (size_t i = 0; i < num_properties; i++)
+        {
+            properties[i] = cast_to_wanda_property(property_handles[i]);
+            size_t length = 0;
+            for (int element = 0; element < get_bulk_rows(*properties[i]); element++)
+            {
+                length += properties[i]->get_series_view(element).size();
+            }
+            offsets[i + 1] = offsets[i] + length;
+        }
+        if (buffer == nullptr)
+            return 0;
+        // buffersize is in bytes like in wnd_get_series, the offsets count values
+        if (offsets[num_properties] * sizeof(float) > buffersize)
+            throw std::invalid_argument("Buffer is too small, should be " +
+                                        std::to_string(offsets[num_properties] * sizeof(float)) + " bytes");
+        for (size_t i = 0; i < num_properties; i++)
+        {
+            float *position = buffer + offsets[i];
+            for (int element = 0; element < get_bulk_rows(*properties[i]); element++)
+            {
+                auto series = properties[i]->get_series_view(element);
+                position = std::copy(series.begin(), series.end(), position);
+            }
+        }
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+#ifdef DEBUG
+        std::cerr << e.what() << std::endl;
+#endif
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
+extern "C" __declspec(dllexport) int wnd_get_extremes_bulk(void **property_handles, const size_t num_properties,
+                                                           int extreme_type, float *buffer, const size_t buffersize,
+                                                           size_t *offsets)
+{
+    try
+    {
+        if (property_handles == nullptr || offsets == nullptr)
+            throw std::invalid_argument("No property handles or offsets given");
+        if (extreme_type < 0 || extreme_type > 3)
+            throw std::invalid_argument("Invalid extreme type " + std::to_string(extreme_type));
+        std::vector<wanda_property *> properties(num_properties);
+        offsets[0] = 0;
+        for (size_t i = 0; i < num_properties; i++)
+        {
+            properties[i] = cast_to_wanda_property(property_handles[i]);
+            offsets[i + 1] = offsets[i] + get_bulk_rows(*properties[i]);
+        }
+        if (buffer == nullptr)
+            return 0;
+        // buffersize is in bytes like in wnd_get_series, the offsets count values
+        if (offsets[num_properties] * sizeof(float) > buffersize)
+            throw std::invalid_argument("Buffer is too small, should be " +
+                                        std::to_string(offsets[num_properties] * sizeof(float)) + " bytes");
+        for (size_t i = 0; i < num_properties; i++)
+        {
+            const auto &property = *properties[i];
+            for (int element = 0; element < get_bulk_rows(property); element++)
             {
-                buffer[i * num_timesteps + j] = result[i][j];
+                float value = 0.0f;
+                switch (extreme_type)
+                {
+                case 0:
+                    value = property.get_extr_min(element);
+                    break;
+                case 1:
+                    value = property.get_extr_max(element);
+                    break;
+                case 2:
+                    value = property.get_extr_tmin(element);
+                    break;
+                default:
+                    value = property.get_extr_tmax(element);
+                    break;
+                }
+                buffer[offsets[i] + element] = value;
             }
         }
         return 0;
@@ -1402,6 +1548,29 @@ extern "C" __declspec(dllexport) int wnd_get_series_pipe(void *property_handle,
     }
 }
 
+extern "C" __declspec(dllexport) int wnd_borrow_series(void *property_handle, int element, const float **data,
+                                                       size_t *length)
+{
+    try
+    {
+        if (data == nullptr || length == nullptr)
+            throw std::invalid_argument("No data or length pointer given");
+        auto property = cast_to_wanda_property(property_handle);
+        auto series = property->get_series_view(element);
+        *data = series.data();
+        *length = series.size();
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+#ifdef DEBUG
+        std::cerr << e.what() << std::endl;
+#endif
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
 extern "C" __declspec(dllexport) int wnd_has_series(void *property_handle)
 {
     try
@@ -1427,6 +1596,7 @@ extern "C" __declspec(dllexport) int wnd_merge_pipes(void *model, void *pipe1, v
         auto comp_1 = cast_to_wanda_component(pipe1);
         auto comp_2 = cast_to_wanda_component(pipe2);
         auto model_ = cast_to_wanda_model(model);
+        auto lock = model_->lock_exclusive();
         model_->merge_pipes(*comp_1, *comp_2, option);
         return 0;
     }
@@ -1446,6 +1616,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_of_route(void *model_handle, c
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         std::vector<int> direction;
         auto route = model->get_route(keyword, direction);
         return static_cast<int>(route.size());
@@ -1466,6 +1637,7 @@ extern "C" __declspec(dllexport) int wnd_get_route(void *model_handle, const cha
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         std::vector<int> direction;
         auto route = model->get_route(keyword, direction);
         if (size < route.size())
@@ -1492,6 +1664,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_of_phys_comp_type(void *model_
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_phys_comp_type();
         return static_cast<int>(types_list.size());
     }
@@ -1511,6 +1684,7 @@ extern "C" __declspec(dllexport) int wnd_get_possible_phys_comp_type(void *model
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_phys_comp_type();
         if (size < types_list.size())
             throw std::invalid_argument("wnd_get_possible_phys_comp_type buffer is too small should be " +
@@ -1536,6 +1710,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_all_keywords(void *model_handl
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_all_keywords();
         return static_cast<int>(types_list.size());
     }
@@ -1555,6 +1730,7 @@ extern "C" __declspec(dllexport) int wnd_get_all_keywords(void *model_handle, ch
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_all_keywords();
         if (size < types_list.size())
             throw std::invalid_argument("wnd_get_all_keywords buffer is too small should be " +
@@ -1581,6 +1757,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_of_ctrl_comp_type(void *model_
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_ctrl_comp_type();
         return types_list.size();
     }
@@ -1600,6 +1777,7 @@ extern "C" __declspec(dllexport) int wnd_get_possible_ctrl_comp_type(void *model
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_ctrl_comp_type();
         if (size < types_list.size())
             throw std::invalid_argument("wnd_get_possible_ctrl_comp_type buffer is too small should be " +
@@ -1625,6 +1803,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_of_node_type(void *model_handl
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_node_type();
         return types_list.size();
     }
@@ -1643,6 +1822,7 @@ extern "C" __declspec(dllexport) int wnd_get_possible_node_type(void *model_hand
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto types_list = model->get_possible_node_type();
         if (size < types_list.size())
             throw std::invalid_argument("wnd_get_possible_node_type buffer is too small should be " +
@@ -1668,6 +1848,7 @@ extern "C" __declspec(dllexport) int wnd_switch_to_transient_mode(void *model_po
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->switch_to_transient_mode();
         return 0;
     }
@@ -1686,6 +1867,7 @@ extern "C" __declspec(dllexport) int wnd_switch_to_engineering_mode(void *model_
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->switch_to_engineering_mode();
         return 0;
     }
@@ -1705,6 +1887,7 @@ extern "C" __declspec(dllexport) int wnd_change_component_type(void *model_point
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->change_comp_type(comp_name, type);
         return 0;
     }
@@ -1723,6 +1906,7 @@ extern "C" __declspec(dllexport) int wnd_change_node_type(void *model_pointer, c
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->change_node_type(node_name, type);
         return 0;
     }
@@ -1741,6 +1925,7 @@ extern "C" __declspec(dllexport) int wnd_switch_to_SI_unit(void *model_pointer)
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->switch_to_unit_SI();
         return 0;
     }
@@ -1759,6 +1944,7 @@ extern "C" __declspec(dllexport) int wnd_switch_to_user_unit(void *model_pointer
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->switch_to_unit_SI();
         return 0;
     }
@@ -1777,6 +1963,7 @@ extern "C" __declspec(dllexport) void *wnd_get_signal_line(void *model_pointer,
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_shared();
         auto &sig_line = model->get_signal_line(name);
         return static_cast<void *>(&sig_line);
     }
@@ -1993,6 +2180,25 @@ extern "C" __declspec(dllexport) int wnd_get_unit_factor(void *prop_handle, floa
     }
 }
 
+extern "C" __declspec(dllexport) int wnd_set_output_in_case_units(void *model_handle, int convert)
+{
+    try
+    {
+        auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
+        model->set_output_in_case_units(convert != 0);
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+#ifdef DEBUG
+        std::cerr << e.what() << std::endl;
+#endif
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
 extern "C" __declspec(dllexport) int wnd_get_float_column(void *table_handle, const char *description, float *values,
                                                           const size_t size)
 {
@@ -2088,6 +2294,7 @@ extern "C" __declspec(dllexport) int wnd_load_data_from_template_to_model(void *
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_exclusive();
         model->add_data_from_template_file(template_file);
     }
     catch (std::exception &e)
@@ -2106,6 +2313,7 @@ extern "C" __declspec(dllexport) int wnd_get_time_steps(void *model_pointer, flo
     try
     {
         auto model = cast_to_wanda_model(model_pointer);
+        auto lock = model->lock_shared();
         auto time_steps_vec = model->get_time_steps();
         if (time_steps_vec.size() > size)
         {
@@ -2130,6 +2338,7 @@ extern "C" __declspec(dllexport) int wnd_get_components_with_keyword(void *model
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto comps = model->get_components_with_keyword(keyword);
         if (comps.size() > size)
         {
@@ -2156,6 +2365,7 @@ extern "C" __declspec(dllexport) int wnd_get_number_of_components_with_keyword(v
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto comps = model->get_components_with_keyword(keyword);
         return comps.size();
     }
@@ -2174,6 +2384,7 @@ extern "C" __declspec(dllexport) int wnd_get_number_of_model_properties(void *mo
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto props = model->get_all_properties();
         return props.size();
     }
@@ -2192,6 +2403,7 @@ extern "C" __declspec(dllexport) int wnd_get_model_properties(void *model_handle
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto props = model->get_all_properties();
         if (props.size() > size)
         {
@@ -2218,6 +2430,7 @@ extern "C" __declspec(dllexport) int wnd_get_max_string_size_properties_model(vo
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto props = model->get_all_properties_string();
         size_t max_size = 0;
         for (auto &prop : props)
@@ -2245,6 +2458,7 @@ extern "C" __declspec(dllexport) int wnd_get_model_properties_string(void *model
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         auto props = model->get_all_properties_string();
         size_t max_size = 0;
         for (auto &prop : props)
@@ -2327,6 +2541,7 @@ extern "C" __declspec(dllexport) int wnd_get_size_item_property_string(void *mod
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         std::string element = "Spec_descr";
         return model->get_element_size_def(element);
     }
@@ -2402,6 +2617,7 @@ extern "C" __declspec(dllexport) int wnd_get_table_descriptions(void *model_hand
     {
         auto table = cast_to_wanda_table(table_handle);
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         auto descriptions_ = table->get_descriptions();
         std::string element = "Table_descr";
         int string_size = model->get_element_size_wdi(element);
@@ -2470,6 +2686,7 @@ extern "C" __declspec(dllexport) int wnd_get_string_size_table_description(void
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         std::string element = "Table_descr";
         return model->get_element_size_wdi(element);
     }
@@ -2488,6 +2705,7 @@ extern "C" __declspec(dllexport) int wnd_component_exists(void *model_handle, ch
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         std::string str_name = name;
         return model->component_exists(str_name) ? 1 : 0;
     }
@@ -2506,6 +2724,7 @@ extern "C" __declspec(dllexport) int wnd_node_exists(void *model_handle, char *n
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_shared();
         std::string str_name = name;
         return model->node_exists(str_name) ? 1 : 0;
     }
@@ -2524,6 +2743,7 @@ extern "C" __declspec(dllexport) int wnd_reset_wdo_pointer(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->reset_wdo_pointer();
         return 0;
     }
@@ -2542,6 +2762,7 @@ extern "C" __declspec(dllexport) int wnd_resume_unsteady_until(void *model_handl
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->resume_unsteady_until(end_time);
         return 0;
     }
@@ -2561,6 +2782,7 @@ extern "C" __declspec(dllexport) int wnd_upgrade_model(void *model_handle)
     try
     {
         auto model = cast_to_wanda_model(model_handle);
+        auto lock = model->lock_exclusive();
         model->upgrade_model();
         return 0;
     }
@@ -2572,4 +2794,72 @@ extern "C" __declspec(dllexport) int wnd_upgrade_model(void *model_handle)
         wnd_model_error_message = e.what();
         return -1;
     }
-}
\ No newline at end of file
+}
+extern "C" __declspec(dllexport) int wnd_enable_metrics(int enable)
+{
+    if (enable != 0)
+        wanda_metrics::enable();
+    else
+        wanda_metrics::disable();
+    return 0;
+}
+
+extern "C" __declspec(dllexport) int wnd_get_metric_counter(const char *name, const char *labels,
+                                                            unsigned long long *value)
+{
+    try
+    {
+        *value = wanda_metrics::get_counter(name, labels == nullptr ? "" : labels);
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
+extern "C" __declspec(dllexport) int wnd_get_metric_histogram(const char *name, const char *labels,
+                                                              unsigned long long *count, double *sum)
+{
+    try
+    {
+        auto &histogram = wanda_metrics::histogram(name, labels == nullptr ? "" : labels);
+        *count = histogram.get_count();
+        *sum = histogram.get_sum();
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
+extern "C" __declspec(dllexport) int wnd_write_metrics(const char *file)
+{
+    try
+    {
+        wanda_metrics::write_prometheus(std::string(file));
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
+
+extern "C" __declspec(dllexport) int wnd_reset_metrics()
+{
+    try
+    {
+        wanda_metrics::reset();
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        wnd_model_error_message = e.what();
+        return -1;
+    }
+}
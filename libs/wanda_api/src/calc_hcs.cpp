@@ -1,8 +1,13 @@
 #include "calc_hcs.h"
 
+#ifdef _WIN32
 #include "deltares_helper_functions.h"
+#endif
+#include "wanda_native_hcs.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <string>
 
 
 wanda_component_dll * wanda_component_dll::get_instance(const std::string &wanda_bin)
@@ -18,83 +23,301 @@ wanda_component_dll * wanda_component_dll::get_instance(const std::string &wanda
 
 wanda_component_dll::~wanda_component_dll()
 {
-    FreeLibrary(hGetProcIDDLL);
-    hGetProcIDDLL = NULL;
+#ifdef _WIN32
+    if (hGetProcIDDLL)
+    {
+        FreeLibrary(hGetProcIDDLL);
+    }
+#endif
+    hGetProcIDDLL = nullptr;
 }
 
 wanda_component_dll::wanda_component_dll(const std::string &wanda_bin) : _wanda_bin(wanda_bin)
 {
+#ifdef _WIN32
     SetDllDirectoryA(_wanda_bin.c_str());
     hGetProcIDDLL = LoadLibrary("Component64.dll");
     if (!hGetProcIDDLL)
     {
-        throw std::runtime_error("Could not load Component64.dll or it's dependencies.");
+        // the components get an HCS error with this reason, or the pipes are computed natively when that is enabled
+        _load_error = "Component64.dll could not be loaded from " + _wanda_bin + ", error " +
+                      std::to_string(GetLastError());
+        return;
     }
     calc_hsc = wanda_helper_functions::loadDLLfunction<int(
         const char *, const char *, const int *, float *, float **, float **, const int *, const int *,
         const float *, const int *, float *, const int *, float *, size_t, size_t)>(hGetProcIDDLL, "calc_hcs_c");
     get_error_message_dll = wanda_helper_functions::loadDLLfunction<void(char *, size_t)>(hGetProcIDDLL, "ERRORMSG_HCS");
+#else
+    _load_error = "Component64.dll is only available on Windows";
+#endif
 }
 
-void wanda_component_dll::calc_hydraulic_spec_component(wanda_component &component, std::vector<float> globvars)
+namespace
 {
-    int const number_hsc = component.get_number_hsc();
-    if (number_hsc == 0)
-        return;
+void hash_combine(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
 
-    // setting the geometry table all length to the largest value
-    // this needs to be doen here, since we do not know if user changed the profile tabel
-    if (component.is_pipe() && component.contains_property("Profile"))
+void hash_floats(std::size_t &seed, const float *values, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        hash_combine(seed, std::hash<float>{}(values[i]));
+    }
+}
+
+// hash of everything the dll uses to compute the HCS of the component
+std::size_t hash_hcs_input(wanda_component &component, const float *his, size_t his_count, const float *ht,
+                           size_t ht_count, const std::vector<float> &globvars)
+{
+    std::size_t seed = std::hash<std::string>{}(component.get_class_sort_key());
+    hash_floats(seed, his, his_count);
+    hash_floats(seed, ht, ht_count);
+    hash_floats(seed, globvars.data(), globvars.size());
+    for (auto it = component.begin(); it != component.end(); ++it)
+    {
+        if (!it->second.has_table() || it->first == "Action table")
+            continue;
+        auto &table = it->second.get_table();
+        for (auto &description : table.get_descriptions())
+        {
+            auto &values = table.get_table_data(description)->floattable;
+            hash_combine(seed, values.size());
+            hash_floats(seed, values.data(), values.size());
+        }
+    }
+    // 0 marks a component which has never been computed
+    return seed != 0 ? seed : 1;
+}
+// geometry of a pipe, the length along the profile
+float get_native_pipe_length(wanda_component &component)
+{
+    auto geometry = component.get_property("Geometry input").get_scalar_str();
+    if (geometry == "Length")
+    {
+        return component.get_property("Length").get_scalar_float();
+    }
+    auto &profile = component.get_property("Profile").get_table();
+    if (geometry == "l-h")
+    {
+        return wanda_native_hcs::profile_length(profile.get_float_column("X-distance"),
+                                                profile.get_float_column("Height"));
+    }
+    if (geometry == "xyz")
     {
-        component.get_property("Profile").get_table().resize_table_to_max_column_size();
+        return wanda_native_hcs::profile_length(profile.get_float_column("X-abs"), profile.get_float_column("Y-abs"),
+                                                profile.get_float_column("Z-abs"));
     }
+    return wanda_native_hcs::profile_length_from_differences(
+        profile.get_float_column("X-diff"), profile.get_float_column("Y-diff"), profile.get_float_column("Z-diff"));
+}
+} // namespace
 
-    std::vector<wanda_property *> hcs;
+bool wanda_component_dll::has_native_hcs(wanda_component &component)
+{
+    if (!component.is_pipe() || !component.contains_property("Wave speed mode") ||
+        !component.contains_property("Geometry input"))
+    {
+        return false;
+    }
+    // only the HCS which are implemented natively
+    for (auto it = component.begin(); it != component.end(); ++it)
+    {
+        if (it->second.get_property_type() == wanda_property_types::HCS && it->first != "Wave speed" &&
+            it->first != "Pipe element count")
+        {
+            return false;
+        }
+    }
+    if (component.get_property("Wave speed mode").get_scalar_str() != "Specified" ||
+        !component.get_property("Specified wave speed").get_spec_status())
+    {
+        return false;
+    }
+    auto geometry = component.get_property("Geometry input").get_scalar_str();
+    if (geometry == "Length")
+    {
+        return component.get_property("Length").get_spec_status();
+    }
+    return (geometry == "l-h" || geometry == "xyz" || geometry == "xyz dif") && component.contains_property("Profile");
+}
 
-    std::vector<float> his = component.get_his_values();
-    std::vector<float> ht = component.get_height_nodes();
+bool wanda_component_dll::use_native(wanda_component &component, wanda_hcs_backend backend) const
+{
+#ifndef WANDA_NATIVE_HCS
+    // not built in, every component is computed by the dll
+    (void)component;
+    (void)backend;
+    return false;
+#else
+    switch (backend)
+    {
+    case wanda_hcs_backend::component_dll:
+        return false;
+    case wanda_hcs_backend::native:
+        return has_native_hcs(component);
+    default:
+        return !is_dll_loaded() && has_native_hcs(component);
+    }
+#endif
+}
 
-    // TT2 contains pointers to the second column of a table. TT1
-    // contains pointers to the rest.
-    //TL contains the length of all the tables
-    table_data data = component.get_table_data();
+void wanda_component_dll::calc_native_pipes(const std::vector<wanda_component *> &pipes,
+                                            const std::vector<float> &globvars)
+{
+    // gather the inputs into one array per quantity, a pipe whose input can't be read gets an HCS error like a
+    // component which the dll can't compute
+    std::vector<float> length(pipes.size());
+    std::vector<float> wave_speed(pipes.size());
+    std::vector<float> element_count(pipes.size());
+    std::vector<std::string> errors(pipes.size());
+    for (size_t i = 0; i < pipes.size(); i++)
+    {
+        try
+        {
+            length[i] = get_native_pipe_length(*pipes[i]);
+            wave_speed[i] = pipes[i]->get_property("Specified wave speed").get_scalar_float();
+        }
+        catch (const std::exception &e)
+        {
+            errors[i] = e.what();
+            // a length of 0 is not computed by compute_pipe_element_count
+            length[i] = 0.0f;
+        }
+    }
 
-    
-    char *classname_pt = new char[8];
-    std::string const classname = component.get_class_sort_key();
-    for (size_t i = 0; i < classname.size(); i++)
+    // the time step is the fourth global variable, see wanda_model::get_globvar_hcs
+    try
+    {
+        wanda_native_hcs::compute_pipe_element_count(length, wave_speed, globvars[3], element_count);
+    }
+    catch (const std::exception &e)
     {
-        classname_pt[i] = classname[i];
+        std::fill(element_count.begin(), element_count.end(), wanda_native_hcs::not_computed);
+        for (auto &error : errors)
+        {
+            if (error.empty())
+                error = e.what();
+        }
     }
-    char mode = 'E';
-    if (globvars.back() == float(1.0))
+
+    for (size_t i = 0; i < pipes.size(); i++)
     {
-        mode = 'T';
+        auto &pipe = *pipes[i];
+        std::vector<float> results(pipe.get_number_hsc(), wanda_native_hcs::not_computed);
+        if (pipe.contains_property("Wave speed"))
+        {
+            results[pipe.get_property("Wave speed").get_index()] = wave_speed[i];
+        }
+        if (pipe.contains_property("Pipe element count"))
+        {
+            results[pipe.get_property("Pipe element count").get_index()] = element_count[i];
+        }
+        if (!errors[i].empty())
+        {
+            pipe.set_hcs_error("HCS of " + pipe.get_complete_name_spec() + " could not be computed: " + errors[i]);
+        }
+        else if (element_count[i] == wanda_native_hcs::not_computed)
+        {
+            pipe.set_hcs_error("Length and wave speed of " + pipe.get_complete_name_spec() + " must be positive");
+        }
+        pipe.set_hsc_results(results);
+        if (errors[i].empty())
+        {
+            pipe.get_property("Length").set_scalar(length[i]);
+        }
+        auto his = pipe.get_his_values();
+        auto ht = pipe.get_height_nodes();
+        pipe.set_hcs_input_hash(element_count[i] == wanda_native_hcs::not_computed
+                                    ? 0
+                                    : hash_hcs_input(pipe, his.data(), his.size(), ht.data(), ht.size(), globvars));
     }
-    
-    std::vector<float> hcs_result(number_hsc);
-    int ni = int(his.size());
+}
+
+void wanda_component_dll::calc_hydraulic_spec_component(wanda_component &component, const std::vector<float> &globvars,
+                                                        wanda_hcs_backend backend)
+{
+    calc_hydraulic_spec_components({&component}, globvars, backend, true);
+}
+
+int wanda_component_dll::calc_hydraulic_spec_components(const std::vector<wanda_component *> &components,
+                                                        const std::vector<float> &globvars, wanda_hcs_backend backend,
+                                                        bool force)
+{
+    std::vector<wanda_component *> native_pipes;
+    int computed = 0;
+    char mode = globvars.back() == float(1.0) ? 'T' : 'E';
     int nglob = int(globvars.size());
-    int nht = int(ht.size());
-    // calculating the calculated specs
-    int retval = calc_hsc(&mode, classname_pt, &ni, his.data(), data.column1.data(), data.column2.data(), data.size_tables.data(), &nglob,
-                          globvars.data(), &number_hsc, hcs_result.data(), &nht, ht.data(), 1,
-                          classname.size());
-    if (retval != 0)
-    {
-        //auto error = get_error_message();
-        component.set_hcs_error(get_error_message());
-        //throw std::runtime_error("Error during calc_hsc(): " + error);
-    }
-    component.set_hsc_results(hcs_result);
-    component.set_length_from_hsc(his);
+    for (auto component : components)
+    {
+        int number_hsc = component->get_number_hsc();
+        if (number_hsc == 0)
+            continue;
+
+        // setting the geometry table all length to the largest value
+        // this needs to be doen here, since we do not know if user changed the profile tabel
+        if (component->is_pipe() && component->contains_property("Profile"))
+        {
+            component->get_property("Profile").get_table().resize_table_to_max_column_size();
+        }
+        std::vector<float> his = component->get_his_values();
+        std::vector<float> ht = component->get_height_nodes();
+        if (!force && component->get_hcs_input_hash() ==
+                          hash_hcs_input(*component, his.data(), his.size(), ht.data(), ht.size(), globvars))
+        {
+            continue;
+        }
+        if (use_native(*component, backend))
+        {
+            native_pipes.push_back(component);
+            continue;
+        }
+        if (!is_dll_loaded())
+        {
+            component->set_hcs_error("No native HCS for " + component->get_class_sort_key() + ": " + _load_error);
+            component->set_hcs_input_hash(0);
+            continue;
+        }
+        // the dll computes one component per call and keeps its error message in global state, so the
+        // components are computed one after the other
+        table_data tables = component->get_table_data();
+        std::string classname = component->get_class_sort_key();
+        classname.resize(8, ' ');
+        std::vector<float> hcs_result(number_hsc);
+        int ni = int(his.size());
+        int nht = int(ht.size());
+        int retval = calc_hsc(&mode, classname.data(), &ni, his.data(), tables.column1.data(), tables.column2.data(),
+                              tables.size_tables.data(), &nglob, globvars.data(), &number_hsc, hcs_result.data(), &nht,
+                              ht.data(), 1, classname.size());
+        if (retval != 0)
+        {
+            component->set_hcs_error(get_error_message());
+        }
+        component->set_hsc_results(hcs_result);
+        // the dll can change the HIS values, e.g. the length of a pipe
+        component->set_length_from_hsc(his);
+        component->set_hcs_input_hash(
+            retval == 0 ? hash_hcs_input(*component, his.data(), his.size(), ht.data(), ht.size(), globvars) : 0);
+        computed++;
+    }
+    if (!native_pipes.empty())
+    {
+        calc_native_pipes(native_pipes, globvars);
+    }
+    return computed + static_cast<int>(native_pipes.size());
 }
 
 std::string wanda_component_dll::get_error_message() const
 {
+#ifdef _WIN32
     char error[150]; //length is hard coded in component dll.
     get_error_message_dll(error, 150);
     std::string error_string(error);
     wanda_helper_functions::rtrim(error_string);
     return error_string;
+#else
+    return "Component64.dll is not available";
+#endif
 }
@@ -12,8 +12,32 @@
 
 #include <wandaproperty.h>
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <immintrin.h>
+#define WANDA_SCALE_SSE
+#endif
+
 namespace wanda_helper_functions
 {
+void scale_values(float *values, std::size_t count, float factor)
+{
+    std::size_t i = 0;
+#ifdef WANDA_SCALE_SSE
+    const __m128 factors = _mm_set1_ps(factor);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 low = _mm_loadu_ps(values + i);
+        __m128 high = _mm_loadu_ps(values + i + 4);
+        _mm_storeu_ps(values + i, _mm_mul_ps(low, factors));
+        _mm_storeu_ps(values + i + 4, _mm_mul_ps(high, factors));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        values[i] *= factor;
+    }
+}
+
 std::vector<std::string> split(const std::string &input, char delimeter)
 {
     std::stringstream ss(input);
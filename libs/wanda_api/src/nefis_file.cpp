@@ -1,17 +1,81 @@
 #include <array>
+#include <deltares_helper_functions.h>
 #include <filesystem>
 #include <iomanip>
 #include <nefis_exception.h>
 #include <nefis_file.h>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include <wanda_metrics.h>
+#include <wanda_trace.h>
 
 extern "C"
 {
 #include <nefis.h>
 }
 
+namespace
+{
+struct nefis_group_counters
+{
+    wanda_metric_counter *calls;
+    wanda_metric_counter *bytes;
+};
+
+// the counters of a group, looked up in the registry once per thread and group
+nefis_group_counters &get_group_counters(const char *group)
+{
+    thread_local std::unordered_map<std::string, nefis_group_counters, wanda_helper_functions::string_hash,
+                                    std::equal_to<>>
+        cache;
+    if (auto found = cache.find(std::string_view(group)); found != cache.end())
+    {
+        return found->second;
+    }
+    const std::string labels = std::string("group=\"") + group + '"';
+    nefis_group_counters counters{&wanda_metrics::counter("wanda_nefis_calls_total", labels),
+                                  &wanda_metrics::counter("wanda_nefis_bytes_total", labels)};
+    return cache.emplace(group, counters).first->second;
+}
+
+// counts a NEFIS element or attribute call for the trace and the metrics, and times it until the end of the scope
+class nefis_call_metrics
+{
+  public:
+    nefis_call_metrics(const char *group, std::uint64_t bytes, bool write)
+    {
+        wanda_trace::count_nefis(bytes);
+        if (wanda_metrics::is_enabled())
+        {
+            static auto &read_latency = wanda_metrics::histogram("wanda_nefis_call_seconds", "operation=\"read\"");
+            static auto &write_latency = wanda_metrics::histogram("wanda_nefis_call_seconds", "operation=\"write\"");
+            auto &counters = get_group_counters(group);
+            counters.calls->add();
+            counters.bytes->add(bytes);
+            _latency = write ? &write_latency : &read_latency;
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+    ~nefis_call_metrics()
+    {
+        if (_latency != nullptr)
+        {
+            _latency->observe(std::chrono::steady_clock::now() - _start);
+        }
+    }
+    nefis_call_metrics(const nefis_call_metrics &) = delete;
+    nefis_call_metrics &operator=(const nefis_call_metrics &) = delete;
+
+  private:
+    wanda_metric_histogram *_latency = nullptr;
+    std::chrono::steady_clock::time_point _start;
+};
+} // namespace
+
 void nefis_file::set_file(std::string const &filein)
 {
     file_name = filein;
@@ -46,6 +110,27 @@ int nefis_file::open(char access_modifier)
     throw nefis_exception("Error: " + file_name + " does not exist");
 }
 
+int nefis_file::create()
+{
+    file_status_open = false;
+    for (const auto &extension : {".def", ".dat"})
+    {
+        // a NEFIS file with separate definition and data parts would be opened by Crenef
+        std::filesystem::remove(std::filesystem::path(file_name).replace_extension(extension));
+    }
+    std::filesystem::remove(file_name);
+    char coding = ' ';
+    auto filename_copy = std::make_unique<char[]>(file_name.length() + 1);
+    file_name.copy(filename_copy.get(), file_name.length() + 1);
+    int retval = Crenef(&file_pointer, filename_copy.get(), filename_copy.get(), coding, 'c');
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+    file_status_open = true;
+    return 0;
+}
+
 int nefis_file::close()
 {
     int retval = Clsnef(&file_pointer);
@@ -67,6 +152,7 @@ void nefis_file::write_float_elements(std::string groupname, std::string element
     auto elementname_ = std::make_unique<char[]>(elementname.length() + 1);
     elementname.copy(elementname_.get(), elementname.length() + 1);
 
+    nefis_call_metrics call_metrics(groupname_.get(), buffer.size() * sizeof(float), true);
     auto retval =
         Putelt(&file_pointer, groupname_.get(), elementname_.get(), uindex_.data(), usrord.data(), buffer.data());
     if (retval != 0)
@@ -95,6 +181,7 @@ void nefis_file::write_float_elements(std::string groupname, std::string element
         // check if the data fits in the length
         alldata.insert(alldata.end(), vec_dat.begin(), vec_dat.end());
     }
+    nefis_call_metrics call_metrics(groupname_.get(), alldata.size() * sizeof(float), true);
     auto retval =
         Putelt(&file_pointer, groupname_.get(), elementname_.get(), uindex.data(), usrord.data(), alldata.data());
     if (retval != 0)
@@ -114,6 +201,7 @@ void nefis_file::write_int_elements(std::string groupname, std::string elementna
     elementname.copy(elementname_.get(), elementname.length() + 1);
 
     int *buf_pt = buffer.data();
+    nefis_call_metrics call_metrics(groupname_.get(), buffer.size() * sizeof(int), true);
     auto retval = Putelt(&file_pointer, groupname_.get(), elementname_.get(), uindex_.data(), usrord.data(), buf_pt);
     if (retval != 0)
     {
@@ -152,6 +240,7 @@ void nefis_file::write_string_elements(const std::string &groupname, const std::
                                 " String length " + std::to_string(stringlength));
     }
     data.copy(pt.get(), data.length());
+    nefis_call_metrics call_metrics(groupname_.get(), data.length(), true);
     auto retval = Putelt(&file_pointer, groupname_.get(), elementname_.get(), uindex_.data(), usrord.data(), pt.get());
     if (retval != 0)
     {
@@ -223,6 +312,7 @@ void nefis_file::write_string_elements(const std::string &groupname, const std::
     }
     data.copy(pt.get(), data.length());
 
+    nefis_call_metrics call_metrics(groupname_.get(), data.length(), true);
     auto retval = Putelt(&file_pointer, groupname_.get(), elementname_.get(), uindex.data(), usrord.data(), pt.get());
     if (retval != 0)
     {
@@ -230,6 +320,88 @@ void nefis_file::write_string_elements(const std::string &groupname, const std::
     }
 }
 
+void nefis_file::define_element(const std::string &elementname, const std::string &type, int bytes,
+                                const std::vector<int> &dimensions, const std::string &quantity,
+                                const std::string &unit, const std::string &description)
+{
+    if (dimensions.empty() || dimensions.size() > std_order.size())
+    {
+        throw std::invalid_argument("Element " + elementname + " needs 1 to 5 dimensions");
+    }
+    auto copy = [](const std::string &text) {
+        auto result = std::make_unique<char[]>(text.length() + 1);
+        text.copy(result.get(), text.length() + 1);
+        return result;
+    };
+    auto elementname_ = copy(elementname);
+    auto type_ = copy(type);
+    auto quantity_ = copy(quantity);
+    auto unit_ = copy(unit);
+    auto description_ = copy(description);
+    std::vector<int> dimensions_ = dimensions;
+    auto retval = Defelm(&file_pointer, elementname_.get(), type_.get(), bytes, quantity_.get(), unit_.get(),
+                         description_.get(), static_cast<int>(dimensions_.size()), dimensions_.data());
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+}
+
+void nefis_file::define_cell(const std::string &cellname, const std::vector<std::string> &elementnames)
+{
+    auto cellname_ = std::make_unique<char[]>(cellname.length() + 1);
+    cellname.copy(cellname_.get(), cellname.length() + 1);
+    std::vector<std::array<char, MAX_NAME + 1>> elementnames_(elementnames.size());
+    for (std::size_t i = 0; i < elementnames.size(); i++)
+    {
+        if (elementnames[i].length() > MAX_NAME)
+        {
+            throw std::invalid_argument("Element name " + elementnames[i] + " is too long");
+        }
+        elementnames[i].copy(elementnames_[i].data(), MAX_NAME);
+    }
+    auto retval = Defcel(&file_pointer, cellname_.get(), static_cast<int>(elementnames_.size()),
+                         reinterpret_cast<char(*)[MAX_NAME + 1]>(elementnames_.data()));
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+}
+
+void nefis_file::define_group(const std::string &groupdefinition, const std::string &cellname,
+                              const std::vector<int> &dimensions)
+{
+    if (dimensions.empty() || dimensions.size() > std_order.size())
+    {
+        throw std::invalid_argument("Group " + groupdefinition + " needs 1 to 5 dimensions");
+    }
+    auto groupdefinition_ = std::make_unique<char[]>(groupdefinition.length() + 1);
+    groupdefinition.copy(groupdefinition_.get(), groupdefinition.length() + 1);
+    auto cellname_ = std::make_unique<char[]>(cellname.length() + 1);
+    cellname.copy(cellname_.get(), cellname.length() + 1);
+    std::vector<int> dimensions_ = dimensions;
+    std::array order = std_order;
+    auto retval = Defgrp(&file_pointer, groupdefinition_.get(), cellname_.get(), static_cast<int>(dimensions_.size()),
+                         dimensions_.data(), order.data());
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+}
+
+void nefis_file::create_group(const std::string &groupname, const std::string &groupdefinition)
+{
+    auto groupname_ = std::make_unique<char[]>(groupname.length() + 1);
+    groupname.copy(groupname_.get(), groupname.length() + 1);
+    auto groupdefinition_ = std::make_unique<char[]>(groupdefinition.length() + 1);
+    groupdefinition.copy(groupdefinition_.get(), groupdefinition.length() + 1);
+    auto retval = Credat(&file_pointer, groupname_.get(), groupdefinition_.get());
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+}
+
 int nefis_file::get_group_dim(std::string grpname) const
 {
     char celnam[16 + 1];
@@ -254,6 +426,7 @@ int nefis_file::get_int_attribute(const std::string &groupname, const std::strin
     auto attnam2 = std::make_unique<char[]>(attributename.length() + 1);
     attributename.copy(attnam2.get(), attributename.length() + 1);
     int attval = 0;
+    nefis_call_metrics call_metrics(groupname2.get(), sizeof(attval), false);
     auto retval = Getiat(&file_pointer, groupname2.get(), attnam2.get(), &attval);
     if (retval != 0)
     {
@@ -268,6 +441,7 @@ void nefis_file::set_int_attribute(const std::string &groupname, const std::stri
     groupname.copy(groupname2.get(), groupname.length() + 1);
     auto attnam2 = std::make_unique<char[]>(attributename.length() + 1);
     attributename.copy(attnam2.get(), attributename.length() + 1);
+    nefis_call_metrics call_metrics(groupname2.get(), sizeof(value), true);
     auto retval = Putiat(&file_pointer, groupname2.get(), attnam2.get(), &value);
     if (retval != 0)
     {
@@ -373,6 +547,7 @@ void nefis_file::get_int_element(std::string grpname, std::string elmname, nefis
 
     int buflen = static_cast<int>(size * 4);
     int *pt = resarray.data();
+    nefis_call_metrics call_metrics(grpname2.get(), buflen, false);
     auto retval = Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex_.data(), usrord.data(), &buflen, pt);
     if (retval != 0)
     {
@@ -400,6 +575,7 @@ void nefis_file::get_int_element(std::string grpname, std::string elmname, nefis
     grpname.copy(grpname2.get(), grpname.length() + 1);
     auto elmname2 = std::make_unique<char[]>(elmname.length() + 1);
     elmname.copy(elmname2.get(), elmname.length() + 1);
+    nefis_call_metrics call_metrics(grpname2.get(), buflen, false);
     auto retval = Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex.data(), usrord.data(), &buflen, buffer);
     if (retval != 0)
     {
@@ -430,6 +606,7 @@ void nefis_file::get_float_element(std::string grpname, std::string elmname, nef
     grpname.copy(grpname2.get(), grpname.length() + 1);
     auto elmname2 = std::make_unique<char[]>(elmname.length() + 1);
     elmname.copy(elmname2.get(), elmname.length() + 1);
+    nefis_call_metrics call_metrics(grpname2.get(), buflen, false);
     auto retval = Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex_.data(), usrord.data(), &buflen, pt);
     if (retval != 0)
     {
@@ -463,6 +640,7 @@ void nefis_file::get_float_element(std::string grpname, std::string elmname, nef
     auto grpname2 = std::make_unique<char[]>(grpname.length() + 1);
     grpname.copy(grpname2.get(), grpname.length() + 1);
 
+    nefis_call_metrics call_metrics(grpname2.get(), buffersize, false);
     auto retval =
         Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex.data(), usrord.data(), &buffersize, buffer.get());
     if (retval != 0)
@@ -483,6 +661,32 @@ void nefis_file::get_float_element(std::string grpname, std::string elmname, nef
     }
 }
 
+void nefis_file::get_float_element(const std::string &grpname, const std::string &elmname,
+                                   nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim,
+                                   std::vector<float> &resarray) const
+{
+    int count1 = (uindex_1st_dim.end - uindex_1st_dim.start) / uindex_1st_dim.step + 1;
+    int count2 = (uindex_2nd_dim.end - uindex_2nd_dim.start) / uindex_2nd_dim.step + 1;
+    resarray.resize(static_cast<std::size_t>(count1) * count2);
+
+    std::array uindex = {uindex_1st_dim.start, uindex_1st_dim.end, uindex_1st_dim.step,
+                         uindex_2nd_dim.start, uindex_2nd_dim.end, uindex_2nd_dim.step};
+    std::array usrord = std_order;
+    auto buffersize = static_cast<int>(resarray.size() * sizeof(float));
+    auto elmname2 = std::make_unique<char[]>(elmname.length() + 1);
+    elmname.copy(elmname2.get(), elmname.length() + 1);
+    auto grpname2 = std::make_unique<char[]>(grpname.length() + 1);
+    grpname.copy(grpname2.get(), grpname.length() + 1);
+
+    nefis_call_metrics call_metrics(grpname2.get(), buffersize, false);
+    auto retval = Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex.data(), usrord.data(), &buffersize,
+                         resarray.data());
+    if (retval != 0)
+    {
+        throw nefis_exception(this);
+    }
+}
+
 void nefis_file::get_string_element(const std::string &grpname, const std::string &elmname, nefis_uindex uindex_1st_dim,
                                     nefis_uindex uindex_2nd_dim, int stringlength,
                                     std::vector<std::vector<std::string>> &results) const
@@ -511,6 +715,7 @@ void nefis_file::get_string_element(const std::string &grpname, const std::strin
     auto grpname2 = std::make_unique<char[]>(grpname.length() + 1);
     grpname.copy(grpname2.get(), grpname.length() + 1);
 
+    nefis_call_metrics call_metrics(grpname2.get(), buflen, false);
     auto retval =
         Getelt(&file_pointer, grpname2.get(), elmname2.get(), uindex.data(), usrord.data(), &buflen, pt.get());
     if (retval != 0)
@@ -558,6 +763,7 @@ void nefis_file::get_string_element(const std::string &groupname, const std::str
 
     int buflen = size * stringlength + 1;
     auto pt = std::make_unique<char[]>(buflen);
+    nefis_call_metrics call_metrics(grpname2.get(), buflen, false);
     auto retval =
         Getels(&file_pointer, grpname2.get(), elmname2.get(), uindex_.data(), usrord.data(), &buflen, pt.get());
     if (retval != 0)
@@ -0,0 +1,123 @@
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <wanda_batch_runner.h>
+#include <wandamodel.h>
+
+namespace
+{
+wanda_item &get_item(wanda_model &model, const std::string &name)
+{
+    if (model.component_exists(name))
+    {
+        return model.get_component(name);
+    }
+    if (model.node_exists(name))
+    {
+        return model.get_node(name);
+    }
+    if (model.sig_line_exists(name))
+    {
+        return model.get_signal_line(name);
+    }
+    throw std::invalid_argument(name + " does not exist in the model");
+}
+} // namespace
+
+wanda_batch_runner::wanda_batch_runner(std::string base_case, std::string wanda_bin, std::string batch_directory)
+    : wanda_batch_runner(std::move(base_case), std::move(batch_directory),
+                         [this](const wanda_batch_job &job, const std::string &case_file,
+                                const wanda_batch_options &options,
+                                wanda_batch_result &result) { run_job(job, case_file, options, result); })
+{
+    _wanda_bin = std::move(wanda_bin);
+}
+
+void wanda_batch_runner::run_job(const wanda_batch_job &job, const std::string &case_file,
+                                 const wanda_batch_options &options, wanda_batch_result &result)
+{
+    std::unique_ptr<wanda_model> model;
+    try
+    {
+        std::shared_ptr<wanda_solver_job> solver;
+        {
+            std::lock_guard<std::mutex> lock(_case_file_mutex);
+            model = std::make_unique<wanda_model>(case_file, _wanda_bin);
+            apply_overrides(*model, job);
+            solver = model->start_steady(options.solver);
+        }
+        // only the solvers run concurrently
+        wait_for(solver);
+        {
+            std::lock_guard<std::mutex> lock(_case_file_mutex);
+            model->finish_steady(*solver);
+            solver.reset();
+            if (options.run_unsteady)
+            {
+                solver = model->start_unsteady(options.solver);
+            }
+        }
+        if (solver)
+        {
+            wait_for(solver);
+            std::lock_guard<std::mutex> lock(_case_file_mutex);
+            model->finish_unsteady(*solver);
+        }
+        std::lock_guard<std::mutex> lock(_case_file_mutex);
+        collect_output(*model, result);
+        model.reset();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_case_file_mutex);
+        model.reset();
+        throw;
+    }
+}
+
+void wanda_batch_runner::apply_overrides(wanda_model &model, const wanda_batch_job &job) const
+{
+    for (auto &change : job.overrides)
+    {
+        auto &property = change.item.empty() ? model.get_property(change.property)
+                                             : get_item(model, change.item).get_property(change.property);
+        std::visit([&property](auto &value) { property.set_scalar(value); }, change.value);
+    }
+    if (!job.overrides.empty())
+    {
+        model.save_model_input();
+    }
+}
+
+void wanda_batch_runner::collect_output(wanda_model &model, wanda_batch_result &result) const
+{
+    result.values.clear();
+    for (auto &output : _outputs)
+    {
+        auto &property = get_item(model, output.item).get_property(output.property);
+        switch (output.statistic)
+        {
+        case wanda_batch_statistic::minimum:
+            result.values.push_back(property.get_extr_min(output.element));
+            break;
+        case wanda_batch_statistic::maximum:
+            result.values.push_back(property.get_extr_max(output.element));
+            break;
+        case wanda_batch_statistic::time_of_minimum:
+            result.values.push_back(property.get_extr_tmin(output.element));
+            break;
+        case wanda_batch_statistic::time_of_maximum:
+            result.values.push_back(property.get_extr_tmax(output.element));
+            break;
+        default: {
+            auto series = property.get_series_view(output.element);
+            if (series.empty())
+            {
+                throw std::runtime_error(output.item + " " + output.property + " has no time series");
+            }
+            result.values.push_back(series.back());
+            break;
+        }
+        }
+    }
+}
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <wanda_batch_runner.h>
+
+namespace
+{
+std::string get_statistic_name(wanda_batch_statistic statistic)
+{
+    switch (statistic)
+    {
+    case wanda_batch_statistic::minimum:
+        return "min";
+    case wanda_batch_statistic::maximum:
+        return "max";
+    case wanda_batch_statistic::time_of_minimum:
+        return "tmin";
+    case wanda_batch_statistic::time_of_maximum:
+        return "tmax";
+    default:
+        return "final";
+    }
+}
+
+std::string quote_csv(const std::string &text)
+{
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"')
+        {
+            quoted.push_back('"');
+        }
+        quoted.push_back(c);
+    }
+    quoted.push_back('"');
+    return quoted;
+}
+} // namespace
+
+wanda_batch_runner::wanda_batch_runner(std::string base_case, std::string batch_directory,
+                                       wanda_batch_executor executor)
+    : _base_case(std::move(base_case)), _batch_directory(std::move(batch_directory)), _executor(std::move(executor))
+{
+    if (!std::filesystem::exists(_base_case))
+    {
+        throw std::invalid_argument("Base case does not exist: " + _base_case);
+    }
+    if (!_executor)
+    {
+        throw std::invalid_argument("Batch runner without an executor");
+    }
+}
+
+void wanda_batch_runner::add_job(wanda_batch_job job)
+{
+    if (job.name.empty())
+    {
+        throw std::invalid_argument("Batch job without a name");
+    }
+    // the name is the working directory below the batch directory, which is removed before every attempt
+    if (job.name.find_first_of("/\\:") != std::string::npos || std::filesystem::path(job.name).has_root_path() ||
+        job.name == "." || job.name == "..")
+    {
+        throw std::invalid_argument("Batch job name " + job.name + " is not a plain directory name");
+    }
+    for (auto &existing : _jobs)
+    {
+        if (existing.name == job.name)
+        {
+            throw std::invalid_argument("Batch job " + job.name + " already exists");
+        }
+    }
+    _jobs.push_back(std::move(job));
+}
+
+void wanda_batch_runner::add_output(wanda_batch_output output)
+{
+    _outputs.push_back(std::move(output));
+}
+
+void wanda_batch_runner::cancel()
+{
+    _cancelled = true;
+    std::lock_guard<std::mutex> lock(_running_mutex);
+    for (auto &solver : _running)
+    {
+        solver->cancel();
+    }
+}
+
+std::vector<std::string> wanda_batch_runner::get_column_names() const
+{
+    std::vector<std::string> names;
+    for (auto &output : _outputs)
+    {
+        std::string name = output.item + "/" + output.property;
+        if (output.element != 0)
+        {
+            name += "[" + std::to_string(output.element) + "]";
+        }
+        names.push_back(name + " " + get_statistic_name(output.statistic));
+    }
+    return names;
+}
+
+std::vector<wanda_batch_result> wanda_batch_runner::run(const wanda_batch_options &options)
+{
+    _cancelled = false;
+    std::vector<wanda_batch_result> results(_jobs.size());
+    for (size_t i = 0; i < _jobs.size(); i++)
+    {
+        results[i].job_name = _jobs[i].name;
+        results[i].error = "Not started";
+    }
+    if (_jobs.empty())
+    {
+        return results;
+    }
+
+    size_t num_workers = options.num_workers != 0 ? options.num_workers : std::thread::hardware_concurrency();
+    num_workers = std::max<size_t>(1, std::min(num_workers, _jobs.size()));
+    _queues = std::vector<work_queue>(num_workers);
+    for (size_t i = 0; i < _jobs.size(); i++)
+    {
+        _queues[i % num_workers].jobs.push_back(i);
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        workers.emplace_back(&wanda_batch_runner::worker, this, i, std::cref(options), std::ref(results));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return results;
+}
+
+bool wanda_batch_runner::next_job(size_t worker, size_t &job)
+{
+    {
+        auto &own = _queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.front();
+            own.jobs.pop_front();
+            return true;
+        }
+    }
+    // steal from the back of the other queues, the owner takes from the front
+    for (size_t i = 1; i < _queues.size(); i++)
+    {
+        auto &other = _queues[(worker + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.jobs.empty())
+        {
+            job = other.jobs.back();
+            other.jobs.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void wanda_batch_runner::worker(size_t worker_id, const wanda_batch_options &options,
+                                std::vector<wanda_batch_result> &results)
+{
+    size_t index = 0;
+    while (!_cancelled && next_job(worker_id, index))
+    {
+        auto &job = _jobs[index];
+        auto &result = results[index];
+        auto start = std::chrono::steady_clock::now();
+        for (int attempt = 1; attempt <= options.max_retries + 1 && !_cancelled; attempt++)
+        {
+            result.attempts = attempt;
+            try
+            {
+                std::string case_file;
+                {
+                    std::lock_guard<std::mutex> lock(_case_file_mutex);
+                    result.working_directory = (std::filesystem::path(_batch_directory) / job.name).string();
+                    case_file = materialize(job);
+                }
+                _executor(job, case_file, options, result);
+                result.succeeded = true;
+                result.error.clear();
+                break;
+            }
+            catch (std::exception &e)
+            {
+                result.error = e.what();
+                result.values.clear();
+            }
+            catch (...)
+            {
+                // anything escaping the worker thread would terminate the process
+                result.error = "Unknown error";
+                result.values.clear();
+            }
+        }
+        result.wall_time = std::chrono::steady_clock::now() - start;
+        if (result.succeeded && !options.keep_working_directories)
+        {
+            std::error_code error;
+            std::filesystem::remove_all(result.working_directory, error);
+        }
+        if (options.on_job_finished)
+        {
+            try
+            {
+                options.on_job_finished(result);
+            }
+            catch (...)
+            {
+                // the callback can't stop the other jobs, the worker carries on
+            }
+        }
+    }
+}
+
+std::string wanda_batch_runner::materialize(const wanda_batch_job &job) const
+{
+    namespace fs = std::filesystem;
+    const fs::path base(_base_case);
+    const fs::path directory = fs::path(_batch_directory) / job.name;
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    // all files of the case share the name of the wdi file: .wdi, .wdo, .wdx, ...
+    for (auto &entry : fs::directory_iterator(base.parent_path().empty() ? fs::path(".") : base.parent_path()))
+    {
+        if (entry.is_regular_file() && entry.path().stem() == base.stem())
+        {
+            fs::copy_file(entry.path(), directory / entry.path().filename(), fs::copy_options::overwrite_existing);
+        }
+    }
+    return (directory / base.filename()).string();
+}
+
+void wanda_batch_runner::wait_for(const std::shared_ptr<wanda_solver_job> &solver)
+{
+    {
+        // either cancel() sees the solver or the solver sees the cancellation
+        std::lock_guard<std::mutex> lock(_running_mutex);
+        _running.push_back(solver);
+        if (_cancelled)
+        {
+            solver->cancel();
+        }
+    }
+    solver->get_future().wait();
+    std::lock_guard<std::mutex> lock(_running_mutex);
+    _running.erase(std::find(_running.begin(), _running.end(), solver));
+}
+
+void wanda_batch_runner::write_csv(const std::vector<wanda_batch_result> &results, const std::string &file) const
+{
+    std::ofstream stream(file);
+    if (!stream)
+    {
+        throw std::runtime_error("Could not open " + file);
+    }
+    stream << "job,succeeded,attempts,wall_time";
+    for (auto &name : get_column_names())
+    {
+        stream << ',' << quote_csv(name);
+    }
+    stream << ",error\n";
+    for (auto &result : results)
+    {
+        stream << quote_csv(result.job_name) << ',' << (result.succeeded ? 1 : 0) << ',' << result.attempts << ','
+               << result.wall_time.count();
+        for (size_t i = 0; i < _outputs.size(); i++)
+        {
+            stream << ',';
+            if (i < result.values.size())
+            {
+                stream << result.values[i];
+            }
+        }
+        stream << ',' << quote_csv(result.error) << '\n';
+    }
+}
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <nefis_file.h>
+#include <stdexcept>
+#include <wanda_case_generator.h>
+#include <wandamodel.h>
+
+namespace
+{
+// splitmix64, small and the same on every platform, unlike the distributions of <random>
+class pseudo_random
+{
+  public:
+    explicit pseudo_random(std::uint64_t seed) : _state(seed)
+    {
+    }
+    std::uint64_t next()
+    {
+        std::uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    //! uniform in [low, high)
+    double uniform(double low, double high)
+    {
+        return low + (high - low) * static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+  private:
+    std::uint64_t _state;
+};
+
+std::uint64_t hash_string(const std::string &text)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text)
+    {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string to_lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+void copy_case_files(const std::filesystem::path &source, const std::filesystem::path &target)
+{
+    namespace fs = std::filesystem;
+    if (!fs::exists(source))
+    {
+        throw std::invalid_argument(source.string() + " does not exist");
+    }
+    if (target.has_parent_path())
+    {
+        fs::create_directories(target.parent_path());
+    }
+    auto directory = source.parent_path().empty() ? fs::path(".") : source.parent_path();
+    for (auto &entry : fs::directory_iterator(directory))
+    {
+        // the wdi, wdx and other input files, output of the template is not copied
+        auto extension = to_lower(entry.path().extension().string());
+        if (entry.path().stem() == source.stem() && extension != ".wdo" && extension != ".wdc")
+        {
+            auto copy = target;
+            copy.replace_extension(entry.path().extension());
+            fs::copy_file(entry.path(), copy, fs::copy_options::overwrite_existing);
+        }
+    }
+    for (auto extension : {".wdo", ".WDO"})
+    {
+        fs::remove(fs::path(target).replace_extension(extension));
+    }
+}
+
+void set_random_scalar(wanda_component &component, const std::string &property, double low, double high,
+                       pseudo_random &random)
+{
+    if (component.contains_property(property))
+    {
+        component.get_property(property).set_scalar(static_cast<float>(random.uniform(low, high)));
+    }
+}
+
+// values of an output property, one per point along a pipe
+int get_number_of_values(const wanda_property &property)
+{
+    return property.get_number_of_elements() > 0 ? property.get_number_of_elements() + 1 : 1;
+}
+
+bool is_series(wanda_property_types type)
+{
+    return type != wanda_property_types::HOV && type != wanda_property_types::NOV &&
+           type != wanda_property_types::COV;
+}
+
+// values in the OUTP_ group of one WDO postfix
+struct postfix_output
+{
+    int size = 0;
+    int values = 0;
+    bool series = false;
+};
+
+// first index in the OUTP_ groups of every item of an index group, per WDO postfix
+struct index_group
+{
+    std::size_t items = 0;
+    std::map<std::string, std::vector<int>> first;
+
+    std::vector<int> &get(const std::string &postfix)
+    {
+        return first.try_emplace(postfix, items, 0).first->second;
+    }
+};
+
+// assigns every item its range in the OUTP_ groups, like the solvers number the output
+class output_numbering
+{
+  public:
+    output_numbering(int species, int species_stride) : _species(species), _species_stride(species_stride)
+    {
+    }
+
+    //! adds the output properties of the item with the given position in the index group
+    void add(index_group &group, wanda_item &item, std::size_t position, int elements)
+    {
+        std::map<std::string, std::pair<int, int>> needed;
+        for (auto &property : item)
+        {
+            auto type = property.second.get_property_type();
+            if (type != wanda_property_types::GLOQUANT && type != wanda_property_types::HOS &&
+                type != wanda_property_types::HOV && type != wanda_property_types::NOS &&
+                type != wanda_property_types::NOV && type != wanda_property_types::COS &&
+                type != wanda_property_types::COV)
+                continue;
+            // the offset wanda_model adds to the first index of the item, see reload_component_indices()
+            int offset = 0;
+            int species_offset = 0;
+            if (property.second.is_glo_quant() && item.get_item_type() == wanda_type::physical &&
+                property.second.get_species_number() <= _species)
+            {
+                int connection = property.second.get_connection_point();
+                offset = elements != 0 ? connection * elements : connection;
+                if (property.second.get_species_number() > 0)
+                {
+                    species_offset = (property.second.get_species_number() - 1) * _species_stride;
+                }
+            }
+            int end = offset + std::max(property.second.get_hos_index(), 1) - 1 + get_number_of_values(property.second);
+            auto &range = needed[property.second.get_wdo_postfix()];
+            range.first = std::max(range.first, end);
+            range.second = std::max(range.second, end + species_offset);
+            _postfixes[property.second.get_wdo_postfix()].series |= is_series(type);
+        }
+        for (auto &[name, range] : needed)
+        {
+            auto &postfix = _postfixes[name];
+            group.get(name)[position] = postfix.size;
+            // values of other species may lie beyond the items after this one
+            postfix.values = std::max(postfix.values, postfix.size + range.second);
+            postfix.size += range.first;
+        }
+    }
+
+    const std::map<std::string, postfix_output> &get_postfixes() const
+    {
+        return _postfixes;
+    }
+
+  private:
+    int _species;
+    int _species_stride;
+    std::map<std::string, postfix_output> _postfixes;
+};
+
+// writes the index group with the key of every item and one index element per postfix
+void write_index_group(nefis_file &file, const std::string &group, const std::string &key_element,
+                       const std::vector<std::string> &keys, const std::map<std::string, std::vector<int>> &first)
+{
+    file.define_element(key_element, "CHARACTE", 8);
+    std::vector<std::string> elements{key_element};
+    for (auto &index : first)
+    {
+        elements.push_back(index.first);
+    }
+    file.define_cell(group, elements);
+    file.define_group(group, group, {0});
+    file.create_group(group, group);
+    if (keys.empty())
+        return;
+    file.write_string_elements(group, key_element, {1, static_cast<int>(keys.size()), 1}, 8, keys);
+    for (auto &index : first)
+    {
+        file.write_int_elements(group, index.first, {1, static_cast<int>(keys.size()), 1}, index.second);
+    }
+}
+
+// the index elements of an index group, named after the postfixes
+std::map<std::string, std::vector<int>> get_index_elements(const index_group &group)
+{
+    std::map<std::string, std::vector<int>> elements;
+    for (auto &[postfix, first] : group.first)
+    {
+        elements.emplace("Ndx_" + to_lower(postfix), first);
+    }
+    return elements;
+}
+
+// pseudo-random output of one postfix: every value oscillates around its own mean
+void write_postfix(nefis_file &file, const std::string &name, const postfix_output &postfix,
+                   const std::vector<float> &times, std::uint64_t seed)
+{
+    const int values = std::max(postfix.values, 1);
+    const int time_steps = static_cast<int>(times.size());
+    std::vector<float> mean(values), amplitude(values), frequency(values);
+    pseudo_random random(seed ^ hash_string(name));
+    for (int i = 0; i < values; i++)
+    {
+        mean[i] = static_cast<float>(random.uniform(-100.0, 100.0));
+        amplitude[i] = static_cast<float>(random.uniform(0.0, 10.0));
+        frequency[i] = static_cast<float>(random.uniform(0.1, 2.0));
+    }
+
+    const std::string group = "OUTP_" + name;
+    const std::string extremes = "EXTR_" + name;
+    file.define_cell(group, {"Value"});
+    file.define_group(group, group, {values, 0});
+    file.create_group(group, group);
+    file.set_int_attribute(group, "N_values", postfix.values);
+
+    std::vector<float> maximum(values, -1e30f), minimum(values, 1e30f), maximum_time(values), minimum_time(values);
+    std::vector<std::vector<float>> step(1, std::vector<float>(values));
+    for (int t = 0; t < time_steps; t++)
+    {
+        for (int i = 0; i < values; i++)
+        {
+            float value = mean[i] + amplitude[i] * std::sin(frequency[i] * times[t]);
+            step[0][i] = value;
+            if (value > maximum[i])
+            {
+                maximum[i] = value;
+                maximum_time[i] = times[t];
+            }
+            if (value < minimum[i])
+            {
+                minimum[i] = value;
+                minimum_time[i] = times[t];
+            }
+        }
+        file.write_float_elements(group, "Value", {1, values, 1}, {t + 1, t + 1, 1}, step);
+    }
+
+    file.define_cell(extremes, {"T_Value_max", "T_Value_min", "Value_max", "Value_min"});
+    file.define_group(extremes, extremes, {values});
+    file.create_group(extremes, extremes);
+    file.write_float_elements(extremes, "T_Value_max", {1, values, 1}, maximum_time);
+    file.write_float_elements(extremes, "T_Value_min", {1, values, 1}, minimum_time);
+    file.write_float_elements(extremes, "Value_max", {1, values, 1}, maximum);
+    file.write_float_elements(extremes, "Value_min", {1, values, 1}, minimum);
+}
+
+void define_message_group(nefis_file &file, const std::string &group)
+{
+    file.define_cell(group, {"Message", "Message_class", "Message_comp_key", "Time"});
+    file.define_group(group, group, {0});
+    file.create_group(group, group);
+}
+} // namespace
+
+void wanda_write_synthetic_output(wanda_model &model, int time_steps, float time_step, std::uint64_t seed)
+{
+    if (time_steps < 1)
+    {
+        throw std::invalid_argument("Synthetic output needs at least one time step");
+    }
+    std::vector<wanda_component *> physical;
+    std::vector<wanda_component *> control;
+    int species_stride = 0;
+    for (auto component : model.get_all_components())
+    {
+        if (component->get_item_type() == wanda_type::physical && component->contains_property("Composition 1 1"))
+        {
+            species_stride += component->get_number_of_connnect_points() - 1 + component->get_num_elements();
+        }
+        if (component->is_disused())
+            continue;
+        (component->get_item_type() == wanda_type::physical ? physical : control).push_back(component);
+    }
+    std::vector<wanda_node *> nodes;
+    for (auto node : model.get_all_nodes())
+    {
+        if (!node->is_disused())
+        {
+            nodes.push_back(node);
+        }
+    }
+
+    // components and nodes with the same postfix share its OUTP_ group
+    output_numbering numbering(model.get_number_of_species(), species_stride);
+    index_group component_index{physical.size()};
+    for (std::size_t i = 0; i < physical.size(); i++)
+    {
+        numbering.add(component_index, *physical[i], i, physical[i]->get_num_elements());
+    }
+    index_group node_index{nodes.size()};
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        numbering.add(node_index, *nodes[i], i, 0);
+    }
+    index_group control_index{control.size()};
+    for (auto postfix : {"CHANNEL", "COS", "COV"})
+    {
+        // control components always have the three indices
+        control_index.get(postfix);
+    }
+    for (std::size_t i = 0; i < control.size(); i++)
+    {
+        numbering.add(control_index, *control[i], i, 0);
+    }
+
+    auto path = std::filesystem::path(model.get_case_path()).replace_extension(".wdo");
+    nefis_file file(path.string());
+    file.create();
+
+    // element definitions are shared by all groups
+    file.define_element("Value", "REAL", 4);
+    for (auto element : {"T_Value_max", "T_Value_min", "Value_max", "Value_min", "Time"})
+    {
+        file.define_element(element, "REAL", 4);
+    }
+    file.define_element("Message", "CHARACTE", 256);
+    file.define_element("Message_class", "CHARACTE", 1);
+    file.define_element("Message_comp_key", "CHARACTE", 8);
+    auto component_elements = get_index_elements(component_index);
+    auto node_elements = get_index_elements(node_index);
+    std::map<std::string, std::vector<int>> control_elements{{"Frst_chn_ndx", control_index.get("CHANNEL")},
+                                                             {"Frst_cos_ndx", control_index.get("COS")},
+                                                             {"Frst_cov_ndx", control_index.get("COV")}};
+    std::set<std::string> index_elements;
+    for (auto elements : {&component_elements, &node_elements, &control_elements})
+    {
+        for (auto &element : *elements)
+        {
+            index_elements.insert(element.first);
+        }
+    }
+    for (auto &element : index_elements)
+    {
+        file.define_element(element, "INTEGER", 4);
+    }
+
+    std::vector<float> times(time_steps);
+    for (int t = 0; t < time_steps; t++)
+    {
+        times[t] = static_cast<float>(t) * time_step;
+    }
+    file.define_cell("OUTPUT_TIME", {"Value"});
+    file.define_group("OUTPUT_TIME", "OUTPUT_TIME", {0});
+    file.create_group("OUTPUT_TIME", "OUTPUT_TIME");
+    file.write_float_elements("OUTPUT_TIME", "Value", {1, time_steps, 1}, times);
+    file.set_int_attribute("OUTPUT_TIME", "N_timesteps", time_steps);
+
+    auto keys_of = [](const auto &items) {
+        std::vector<std::string> keys;
+        for (auto item : items)
+        {
+            keys.push_back(item->get_key_as_string());
+        }
+        return keys;
+    };
+    write_index_group(file, "H_COMP_INDEX", "H_comp_key", keys_of(physical), component_elements);
+    write_index_group(file, "H_NODE_INDEX", "H_node_key", keys_of(nodes), node_elements);
+    write_index_group(file, "C_COMP_INDEX", "C_comp_key", keys_of(control), control_elements);
+
+    const std::vector<float> steady{0.0f};
+    for (auto &[name, postfix] : numbering.get_postfixes())
+    {
+        // the values of HOV, NOV and COV properties are only read at the first time
+        write_postfix(file, name, postfix, postfix.series ? times : steady, seed);
+    }
+    define_message_group(file, "STEADY_MESSAGE");
+    define_message_group(file, "UNSTEADY_MESSAGE");
+    file.close();
+}
+
+void wanda_generate_case(const wanda_case_generator_spec &spec)
+{
+    if (spec.pipes < 1 || spec.control_components < 0)
+    {
+        throw std::invalid_argument("A synthetic case needs at least one pipe");
+    }
+    copy_case_files(spec.template_case, spec.output_case);
+
+    wanda_model model(spec.output_case, spec.wanda_bin);
+    auto pipes = model.get_all_pipes();
+    if (pipes.empty())
+    {
+        throw std::runtime_error(spec.template_case + " has no pipe to copy");
+    }
+    if (static_cast<int>(pipes.size()) > spec.pipes)
+    {
+        throw std::invalid_argument(spec.template_case + " has more than " + std::to_string(spec.pipes) + " pipes");
+    }
+    wanda_component *template_control = nullptr;
+    for (auto component : model.get_all_components())
+    {
+        if (component->get_item_type() == wanda_type::control && !component->is_disused())
+        {
+            template_control = component;
+            break;
+        }
+    }
+    if (spec.control_components > 0 && template_control == nullptr)
+    {
+        throw std::runtime_error(spec.template_case + " has no control component to copy");
+    }
+
+    pseudo_random random(spec.seed);
+    auto position = [](int i, float y_offset) {
+        return std::vector<float>{100.0f * static_cast<float>(i % 100), y_offset + 100.0f * static_cast<float>(i / 100)};
+    };
+    wanda_component *previous = pipes.front();
+    previous->add_keyword(wanda_synthetic_route_keyword);
+    for (int i = static_cast<int>(pipes.size()); i < spec.pipes; i++)
+    {
+        auto &pipe = model.add_component(previous, position(i, 0.0f));
+        model.connect(*previous, 2, pipe, 1);
+        set_random_scalar(pipe, "Length", 10.0, 1000.0, random);
+        set_random_scalar(pipe, "Inner diameter", 0.1, 1.0, random);
+        pipe.add_keyword(wanda_synthetic_route_keyword);
+        if (i % 10 == 0)
+        {
+            pipe.add_keyword(wanda_synthetic_tenth_keyword);
+        }
+        previous = &pipe;
+    }
+    const float control_offset = 100.0f * static_cast<float>(spec.pipes / 100 + 2);
+    for (int i = 0; i < spec.control_components; i++)
+    {
+        model.add_component(template_control, position(i, control_offset));
+    }
+    model.save_model_input();
+
+    if (spec.time_steps > 0)
+    {
+        wanda_write_synthetic_output(model, spec.time_steps, spec.time_step, spec.seed);
+    }
+    model.close();
+}
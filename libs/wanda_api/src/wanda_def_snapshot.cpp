@@ -0,0 +1,594 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <wanda_def_snapshot.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr char snapshot_magic[8] = {'W', 'N', 'D', 'D', 'E', 'F', 'S', '\0'};
+
+// reads from the mapped file, every read checks the bytes left so a truncated or
+// corrupt snapshot is rejected instead of read past the mapping
+struct snapshot_reader
+{
+    const char *pos;
+    const char *end;
+    bool ok = true;
+
+    bool has(std::size_t bytes)
+    {
+        ok = ok && static_cast<std::size_t>(end - pos) >= bytes;
+        return ok;
+    }
+    // the records are not aligned
+    template <typename T> T read_value()
+    {
+        T value{};
+        if (has(sizeof(T)))
+        {
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+        }
+        return value;
+    }
+    std::string_view read_string()
+    {
+        auto length = read_value<std::uint32_t>();
+        if (!has(length))
+        {
+            return {};
+        }
+        std::string_view value(pos, length);
+        pos += length;
+        return value;
+    }
+    void skip(std::size_t bytes)
+    {
+        if (has(bytes))
+        {
+            pos += bytes;
+        }
+    }
+};
+
+// modification time of a file in the ticks of the file clock, 0 when it cannot be read
+std::int64_t get_file_time(const std::string &file)
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(file, error);
+    return error ? 0 : static_cast<std::int64_t>(time.time_since_epoch().count());
+}
+
+template <typename T> void write_value(std::ofstream &file, T value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write_string(std::ofstream &file, std::string_view value)
+{
+    write_value(file, static_cast<std::uint32_t>(value.size()));
+    file.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+std::string make_key(char kind, const std::string &groupname, const std::string &elementname)
+{
+    std::string key(1, kind);
+    key.append("|").append(groupname).append("|").append(elementname);
+    return key;
+}
+
+std::string make_key(char kind, const std::string &groupname, const std::string &elementname, nefis_uindex uindex,
+                     int stringlength = 0)
+{
+    return make_key(kind, groupname, elementname) + "|" + std::to_string(uindex.start) + "," +
+           std::to_string(uindex.end) + "," + std::to_string(uindex.step) + "|" + std::to_string(stringlength);
+}
+
+std::string make_key(char kind, const std::string &groupname, const std::string &elementname,
+                     nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim, int stringlength = 0)
+{
+    return make_key(kind, groupname, elementname, uindex_1st_dim, stringlength) + "|" +
+           std::to_string(uindex_2nd_dim.start) + "," + std::to_string(uindex_2nd_dim.end) + "," +
+           std::to_string(uindex_2nd_dim.step);
+}
+
+// two dimensional results are stored row after row, the caller supplies the shape
+template <typename T> std::vector<T> flatten(const std::vector<std::vector<T>> &values)
+{
+    std::vector<T> flat;
+    for (const auto &row : values)
+    {
+        flat.insert(flat.end(), row.begin(), row.end());
+    }
+    return flat;
+}
+
+template <typename T> void unflatten(const std::vector<T> &flat, std::vector<std::vector<T>> &values)
+{
+    size_t pos = 0;
+    for (auto &row : values)
+    {
+        for (auto &value : row)
+        {
+            if (pos < flat.size())
+            {
+                value = flat[pos++];
+            }
+        }
+    }
+}
+} // namespace
+
+wanda_def_snapshot::~wanda_def_snapshot()
+{
+    close();
+}
+
+bool wanda_def_snapshot::map_file(const std::string &file)
+{
+#ifdef _WIN32
+    HANDLE file_handle =
+        CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    HANDLE mapping_handle = nullptr;
+    if (GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0)
+    {
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (mapping_handle == nullptr)
+    {
+        CloseHandle(file_handle);
+        return false;
+    }
+    _data = static_cast<const char *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        return false;
+    }
+    _size = static_cast<std::size_t>(file_size.QuadPart);
+    _file_handle = file_handle;
+    _mapping_handle = mapping_handle;
+#else
+    int file_descriptor = ::open(file.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        return false;
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 || file_status.st_size == 0)
+    {
+        ::close(file_descriptor);
+        return false;
+    }
+    void *data = mmap(nullptr, static_cast<std::size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    ::close(file_descriptor);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    _data = static_cast<const char *>(data);
+    _size = static_cast<std::size_t>(file_status.st_size);
+#endif
+    return true;
+}
+
+void wanda_def_snapshot::unmap_file()
+{
+    if (_data == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(static_cast<HANDLE>(_mapping_handle));
+    CloseHandle(static_cast<HANDLE>(_file_handle));
+    _mapping_handle = nullptr;
+    _file_handle = nullptr;
+#else
+    munmap(const_cast<char *>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
+bool wanda_def_snapshot::open(const std::string &file)
+{
+    close();
+    if (!std::filesystem::exists(file) || !map_file(file))
+    {
+        return false;
+    }
+    snapshot_reader reader{_data, _data + _size};
+    if (!reader.has(sizeof(snapshot_magic)) || std::memcmp(reader.pos, snapshot_magic, sizeof(snapshot_magic)) != 0)
+    {
+        close();
+        return false;
+    }
+    reader.skip(sizeof(snapshot_magic));
+    if (reader.read_value<std::uint32_t>() != format_version)
+    {
+        close();
+        return false;
+    }
+    auto number_of_records = reader.read_value<std::uint32_t>();
+    _source_size = reader.read_value<std::uint64_t>();
+    _source_time = reader.read_value<std::int64_t>();
+    _wanda_version = std::string(reader.read_string());
+    // every record is checked completely here, so the getters can decode without checks
+    for (std::uint32_t i = 0; i < number_of_records && reader.ok; i++)
+    {
+        auto key = reader.read_string();
+        const char *record = reader.pos;
+        auto type = reader.read_value<std::uint8_t>();
+        auto count = reader.read_value<std::uint32_t>();
+        if (type == static_cast<std::uint8_t>(value_type::strings))
+        {
+            for (std::uint32_t j = 0; j < count && reader.ok; j++)
+            {
+                reader.read_string();
+            }
+        }
+        else if (type == static_cast<std::uint8_t>(value_type::ints) ||
+                 type == static_cast<std::uint8_t>(value_type::floats))
+        {
+            reader.skip(static_cast<std::size_t>(count) * 4);
+        }
+        else
+        {
+            reader.ok = false;
+        }
+        if (reader.ok)
+        {
+            _records.emplace(key, record);
+        }
+    }
+    if (!reader.ok || _records.size() != number_of_records)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void wanda_def_snapshot::close()
+{
+    _records.clear();
+    _wanda_version.clear();
+    _source_size = 0;
+    _source_time = 0;
+    unmap_file();
+}
+
+const char *wanda_def_snapshot::find_record(std::string_view key, value_type type, std::uint32_t &count) const
+{
+    auto iter = _records.find(key);
+    if (iter == _records.end())
+    {
+        return nullptr;
+    }
+    snapshot_reader reader{iter->second, _data + _size};
+    if (static_cast<value_type>(reader.read_value<std::uint8_t>()) != type)
+    {
+        throw std::runtime_error("Definition snapshot has an invalid type for " + std::string(key));
+    }
+    count = reader.read_value<std::uint32_t>();
+    return reader.pos;
+}
+
+bool wanda_def_snapshot::get_strings(std::string_view key, std::vector<std::string> &values) const
+{
+    std::uint32_t count = 0;
+    const char *pos = find_record(key, value_type::strings, count);
+    if (pos == nullptr)
+    {
+        return false;
+    }
+    snapshot_reader reader{pos, _data + _size};
+    values.resize(count);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        values[i] = reader.read_string();
+    }
+    return true;
+}
+
+bool wanda_def_snapshot::get_ints(std::string_view key, std::vector<int> &values) const
+{
+    std::uint32_t count = 0;
+    const char *pos = find_record(key, value_type::ints, count);
+    if (pos == nullptr)
+    {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), pos, static_cast<std::size_t>(count) * sizeof(int));
+    return true;
+}
+
+bool wanda_def_snapshot::get_floats(std::string_view key, std::vector<float> &values) const
+{
+    std::uint32_t count = 0;
+    const char *pos = find_record(key, value_type::floats, count);
+    if (pos == nullptr)
+    {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), pos, static_cast<std::size_t>(count) * sizeof(float));
+    return true;
+}
+
+void wanda_def_snapshot::add_strings(const std::string &key, const std::vector<std::string> &values)
+{
+    auto &record = _recorded[key];
+    record.type = value_type::strings;
+    record.strings = values;
+}
+
+void wanda_def_snapshot::add_ints(const std::string &key, const std::vector<int> &values)
+{
+    auto &record = _recorded[key];
+    record.type = value_type::ints;
+    record.ints = values;
+}
+
+void wanda_def_snapshot::add_floats(const std::string &key, const std::vector<float> &values)
+{
+    auto &record = _recorded[key];
+    record.type = value_type::floats;
+    record.floats = values;
+}
+
+void wanda_def_snapshot::save(const std::string &file) const
+{
+    static_assert(sizeof(int) == 4 && sizeof(float) == 4, "snapshot layout assumes 32 bit int and float");
+    std::ofstream output(file, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        throw std::runtime_error("Cannot write definition snapshot " + file);
+    }
+    output.write(snapshot_magic, sizeof(snapshot_magic));
+    write_value(output, format_version);
+    write_value(output, static_cast<std::uint32_t>(_recorded.size()));
+    write_value(output, _source_size);
+    write_value(output, _source_time);
+    write_string(output, _wanda_version);
+    for (const auto &[key, record] : _recorded)
+    {
+        write_string(output, key);
+        write_value(output, static_cast<std::uint8_t>(record.type));
+        switch (record.type)
+        {
+        case value_type::strings:
+            write_value(output, static_cast<std::uint32_t>(record.strings.size()));
+            for (const auto &value : record.strings)
+            {
+                write_string(output, value);
+            }
+            break;
+        case value_type::ints:
+            write_value(output, static_cast<std::uint32_t>(record.ints.size()));
+            output.write(reinterpret_cast<const char *>(record.ints.data()),
+                         static_cast<std::streamsize>(record.ints.size() * sizeof(int)));
+            break;
+        case value_type::floats:
+            write_value(output, static_cast<std::uint32_t>(record.floats.size()));
+            output.write(reinterpret_cast<const char *>(record.floats.data()),
+                         static_cast<std::streamsize>(record.floats.size() * sizeof(float)));
+            break;
+        }
+    }
+    if (!output)
+    {
+        throw std::runtime_error("Error writing definition snapshot " + file);
+    }
+}
+
+void wanda_def_database::open(const std::string &data_path, bool record)
+{
+    _def_file = data_path + "WandaDef.dat";
+    _record = record;
+    _use_snapshot = false;
+    if (!record && _snapshot.open(data_path + wanda_def_snapshot::file_name))
+    {
+        // only use the snapshot when it was made from this WandaDef.dat: the same size,
+        // modification time and Wanda version. Without WandaDef.dat it can't be checked.
+        std::error_code error;
+        auto size = std::filesystem::file_size(_def_file, error);
+        if (!error && size == _snapshot.get_source_size() && get_file_time(_def_file) == _snapshot.get_source_time())
+        {
+            std::vector<std::string> version(1);
+            get_string_element("WANDA", "Wanda_version", nefis_file::single_elem_uindex, 0, version);
+            if (version[0] == _snapshot.get_wanda_version())
+            {
+                _use_snapshot = true;
+                return;
+            }
+        }
+        _snapshot.close();
+    }
+    get_nefis();
+}
+
+void wanda_def_database::close()
+{
+    if (_nefis.is_open())
+    {
+        _nefis.close();
+    }
+    _snapshot.close();
+    _use_snapshot = false;
+}
+
+void wanda_def_database::save_snapshot(const std::string &file) const
+{
+    if (!_record)
+    {
+        throw std::runtime_error("Definition is not opened in recording mode, cannot save snapshot");
+    }
+    std::vector<std::string> version(1);
+    get_string_element("WANDA", "Wanda_version", nefis_file::single_elem_uindex, 0, version);
+    _recording.set_wanda_version(version[0]);
+    _recording.set_source(std::filesystem::file_size(_def_file), get_file_time(_def_file));
+    _recording.save(file);
+}
+
+const nefis_file &wanda_def_database::get_nefis() const
+{
+    if (!_nefis.is_open())
+    {
+        if (!std::filesystem::exists(_def_file))
+        {
+            throw std::runtime_error("Definition not available in snapshot and " + _def_file + " does not exist");
+        }
+        _nefis.set_file(_def_file);
+        _nefis.open('r'); // open WandaDef as readonly file to prevent 'access-denied' issues
+    }
+    return _nefis;
+}
+
+int wanda_def_database::get_int_attribute(const std::string &groupname, const std::string &attributename) const
+{
+    auto key = make_key('A', groupname, attributename);
+    std::vector<int> values;
+    if (_use_snapshot && _snapshot.get_ints(key, values) && values.size() == 1)
+    {
+        return values[0];
+    }
+    int value = get_nefis().get_int_attribute(groupname, attributename);
+    if (_record)
+    {
+        _recording.add_ints(key, {value});
+    }
+    return value;
+}
+
+void wanda_def_database::get_string_element(const std::string &groupname, const std::string &elementname,
+                                            nefis_uindex uindex, int stringlength,
+                                            std::vector<std::string> &results) const
+{
+    auto key = make_key('S', groupname, elementname, uindex, stringlength);
+    if (_use_snapshot && _snapshot.get_strings(key, results))
+    {
+        return;
+    }
+    get_nefis().get_string_element(groupname, elementname, uindex, stringlength, results);
+    if (_record)
+    {
+        _recording.add_strings(key, results);
+    }
+}
+
+void wanda_def_database::get_string_element(const std::string &groupname, const std::string &elementname,
+                                            nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim,
+                                            int stringlength, std::vector<std::vector<std::string>> &results) const
+{
+    auto key = make_key('S', groupname, elementname, uindex_1st_dim, uindex_2nd_dim, stringlength);
+    std::vector<std::string> flat;
+    if (_use_snapshot && _snapshot.get_strings(key, flat))
+    {
+        unflatten(flat, results);
+        return;
+    }
+    get_nefis().get_string_element(groupname, elementname, uindex_1st_dim, uindex_2nd_dim, stringlength, results);
+    if (_record)
+    {
+        _recording.add_strings(key, flatten(results));
+    }
+}
+
+void wanda_def_database::get_int_element(const std::string &groupname, const std::string &elementname,
+                                         nefis_uindex uindex, std::vector<int> &results) const
+{
+    auto key = make_key('I', groupname, elementname, uindex);
+    if (_use_snapshot && _snapshot.get_ints(key, results))
+    {
+        return;
+    }
+    get_nefis().get_int_element(groupname, elementname, uindex, results);
+    if (_record)
+    {
+        _recording.add_ints(key, results);
+    }
+}
+
+void wanda_def_database::get_float_element(const std::string &groupname, const std::string &elementname,
+                                           nefis_uindex uindex, std::vector<float> &results) const
+{
+    auto key = make_key('F', groupname, elementname, uindex);
+    if (_use_snapshot && _snapshot.get_floats(key, results))
+    {
+        return;
+    }
+    get_nefis().get_float_element(groupname, elementname, uindex, results);
+    if (_record)
+    {
+        _recording.add_floats(key, results);
+    }
+}
+
+void wanda_def_database::get_float_element(const std::string &groupname, const std::string &elementname,
+                                           nefis_uindex uindex_1st_dim, nefis_uindex uindex_2nd_dim,
+                                           std::vector<std::vector<float>> &results, bool transpose) const
+{
+    auto key = make_key(transpose ? 'T' : 'F', groupname, elementname, uindex_1st_dim, uindex_2nd_dim);
+    std::vector<float> flat;
+    if (_use_snapshot && _snapshot.get_floats(key, flat))
+    {
+        unflatten(flat, results);
+        return;
+    }
+    get_nefis().get_float_element(groupname, elementname, uindex_1st_dim, uindex_2nd_dim, results, transpose);
+    if (_record)
+    {
+        _recording.add_floats(key, flatten(results));
+    }
+}
+
+int wanda_def_database::get_maxdim_index(const std::string &groupname) const
+{
+    auto key = make_key('M', groupname, "");
+    std::vector<int> values;
+    if (_use_snapshot && _snapshot.get_ints(key, values) && values.size() == 1)
+    {
+        return values[0];
+    }
+    int value = get_nefis().get_maxdim_index(groupname);
+    if (_record)
+    {
+        _recording.add_ints(key, {value});
+    }
+    return value;
+}
+
+int wanda_def_database::get_element_size(const std::string &element) const
+{
+    auto key = make_key('E', "", element);
+    std::vector<int> values;
+    if (_use_snapshot && _snapshot.get_ints(key, values) && values.size() == 1)
+    {
+        return values[0];
+    }
+    int value = get_nefis().get_element_size(element);
+    if (_record)
+    {
+        _recording.add_ints(key, {value});
+    }
+    return value;
+}
@@ -0,0 +1,128 @@
+#include <stdexcept>
+#include <wanda_graph_index.h>
+#include <wandacomponent.h>
+#include <wandanode.h>
+
+void wanda_graph_index::clear()
+{
+    _components.clear();
+    _nodes.clear();
+    _component_ids.clear();
+    _node_ids.clear();
+    _number_of_physical_components = 0;
+    _comp_offsets.assign(1, 0);
+    _comp_nodes.clear();
+    _node_offsets.assign(1, 0);
+    _node_comps.clear();
+    _node_con_points.clear();
+}
+
+void wanda_graph_index::build(std::unordered_map<std::string, wanda_component> &phys_components,
+                              std::unordered_map<std::string, wanda_component> &ctrl_components,
+                              std::unordered_map<std::string, wanda_node> &phys_nodes)
+{
+    clear();
+    _nodes.reserve(phys_nodes.size());
+    _node_ids.reserve(phys_nodes.size());
+    for (auto &node : phys_nodes)
+    {
+        _node_ids.emplace(&node.second, static_cast<int>(_nodes.size()));
+        _nodes.push_back(&node.second);
+    }
+
+    _components.reserve(phys_components.size() + ctrl_components.size());
+    _component_ids.reserve(phys_components.size() + ctrl_components.size());
+    for (auto &comp : phys_components)
+    {
+        _component_ids.emplace(&comp.second, static_cast<int>(_components.size()));
+        _components.push_back(&comp.second);
+    }
+    _number_of_physical_components = static_cast<int>(_components.size());
+    // control components are only connected to nodes in case of sensors
+    for (auto &comp : ctrl_components)
+    {
+        _component_ids.emplace(&comp.second, static_cast<int>(_components.size()));
+        _components.push_back(&comp.second);
+    }
+
+    // component -> node rows, one entry per connection point
+    _comp_offsets.resize(_components.size() + 1);
+    std::vector<int> node_degree(_nodes.size() + 1, 0);
+    for (size_t i = 0; i < _components.size(); i++)
+    {
+        auto &comp = *_components[i];
+        for (int con_point = 1; con_point <= comp.get_number_of_connnect_points(); con_point++)
+        {
+            int node_id = not_connected;
+            if (comp.is_node_connected(con_point))
+            {
+                auto iter = _node_ids.find(&comp.get_connected_node(con_point));
+                if (iter != _node_ids.end())
+                {
+                    node_id = iter->second;
+                    node_degree[node_id + 1]++;
+                }
+            }
+            _comp_nodes.push_back(node_id);
+        }
+        _comp_offsets[i + 1] = static_cast<int>(_comp_nodes.size());
+    }
+
+    // node -> component rows, derived from the component rows
+    for (size_t i = 1; i < node_degree.size(); i++)
+    {
+        node_degree[i] += node_degree[i - 1];
+    }
+    _node_offsets = node_degree;
+    _node_comps.resize(_node_offsets.back());
+    _node_con_points.resize(_node_offsets.back());
+    std::vector<int> fill(_node_offsets.begin(), _node_offsets.end() - 1);
+    for (int comp_id = 0; comp_id < get_number_of_components(); comp_id++)
+    {
+        auto row = get_component_nodes(comp_id);
+        for (size_t j = 0; j < row.size(); j++)
+        {
+            if (row[j] == not_connected)
+            {
+                continue;
+            }
+            int pos = fill[row[j]]++;
+            _node_comps[pos] = comp_id;
+            _node_con_points[pos] = static_cast<int>(j) + 1;
+        }
+    }
+}
+
+int wanda_graph_index::get_component_id(const wanda_component &component) const
+{
+    auto iter = _component_ids.find(&component);
+    if (iter == _component_ids.end())
+    {
+        return not_connected;
+    }
+    return iter->second;
+}
+
+int wanda_graph_index::get_node_id(const wanda_node &node) const
+{
+    auto iter = _node_ids.find(&node);
+    if (iter == _node_ids.end())
+    {
+        return not_connected;
+    }
+    return iter->second;
+}
+
+int wanda_graph_index::get_connect_point(int comp_id, int node_id) const
+{
+    auto row = get_component_nodes(comp_id);
+    for (size_t j = 0; j < row.size(); j++)
+    {
+        if (row[j] == node_id)
+        {
+            return static_cast<int>(j) + 1;
+        }
+    }
+    throw std::runtime_error(_nodes[node_id]->get_complete_name_spec() + " not connected to component " +
+                             _components[comp_id]->get_complete_name_spec());
+}
@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <wanda_grid_mapping.h>
+
+namespace
+{
+// part of a route inside one cell, from start to end along the route
+struct route_piece
+{
+    double start;
+    double end;
+    std::uint32_t cell;
+};
+
+// weight of a point in a cell, before the rows are compressed
+struct point_weight
+{
+    std::uint32_t cell;
+    double length;
+};
+
+// Liang-Barsky clipping of the parameter range of a segment against one side of the grid
+bool clip(double direction, double distance, double &t_enter, double &t_exit)
+{
+    if (direction == 0.0)
+    {
+        return distance >= 0.0;
+    }
+    const double t = distance / direction;
+    if (direction < 0.0)
+    {
+        t_enter = std::max(t_enter, t);
+    }
+    else
+    {
+        t_exit = std::min(t_exit, t);
+    }
+    return t_enter < t_exit;
+}
+
+// first cell along a direction, a start exactly on a cell boundary belongs to the cell the segment moves into
+std::int64_t get_start_cell(double position, double direction, std::uint32_t count)
+{
+    auto cell = static_cast<std::int64_t>(std::floor(position));
+    if (direction < 0.0 && position == static_cast<double>(cell))
+    {
+        cell--;
+    }
+    return std::clamp<std::int64_t>(cell, 0, static_cast<std::int64_t>(count) - 1);
+}
+
+// walks a straight segment through the cells of the grid, the route length runs from start to start + length
+void trace_segment(const wanda_grid &grid, double x_0, double y_0, double x_1, double y_1, double start,
+                   double length, std::vector<route_piece> &pieces)
+{
+    // in cell units
+    const double u_0 = (x_0 - grid.x_origin) / grid.cell_width;
+    const double v_0 = (y_0 - grid.y_origin) / grid.cell_height;
+    const double du = (x_1 - x_0) / grid.cell_width;
+    const double dv = (y_1 - y_0) / grid.cell_height;
+
+    double t_enter = 0.0;
+    double t_exit = 1.0;
+    if (!clip(-du, u_0, t_enter, t_exit) || !clip(du, grid.columns - u_0, t_enter, t_exit) ||
+        !clip(-dv, v_0, t_enter, t_exit) || !clip(dv, grid.rows - v_0, t_enter, t_exit))
+    {
+        return;
+    }
+
+    auto column = get_start_cell(u_0 + du * t_enter, du, grid.columns);
+    auto row = get_start_cell(v_0 + dv * t_enter, dv, grid.rows);
+    constexpr double never = std::numeric_limits<double>::infinity();
+    const double t_delta_u = du != 0.0 ? std::abs(1.0 / du) : never;
+    const double t_delta_v = dv != 0.0 ? std::abs(1.0 / dv) : never;
+    const auto column_edge = static_cast<double>(column);
+    const auto row_edge = static_cast<double>(row);
+    double t_next_u = du > 0.0 ? (column_edge + 1 - u_0) / du : du < 0.0 ? (column_edge - u_0) / du : never;
+    double t_next_v = dv > 0.0 ? (row_edge + 1 - v_0) / dv : dv < 0.0 ? (row_edge - v_0) / dv : never;
+
+    double t = t_enter;
+    while (t < t_exit)
+    {
+        const double t_next = std::min({t_next_u, t_next_v, t_exit});
+        if (t_next > t)
+        {
+            pieces.push_back({start + t * length, start + t_next * length,
+                              static_cast<std::uint32_t>(row * grid.columns + column)});
+        }
+        if (t_next >= t_exit)
+        {
+            break;
+        }
+        if (t_next_u <= t_next_v)
+        {
+            column += du > 0.0 ? 1 : -1;
+            t_next_u += t_delta_u;
+        }
+        else
+        {
+            row += dv > 0.0 ? 1 : -1;
+            t_next_v += t_delta_v;
+        }
+        if (column < 0 || column >= grid.columns || row < 0 || row >= grid.rows)
+        {
+            break;
+        }
+        t = t_next;
+    }
+}
+
+// compresses the row of a point, pieces of a route can enter the same cell more than once
+void add_row(std::vector<point_weight> &row, std::vector<std::uint32_t> &cells, std::vector<double> &lengths)
+{
+    std::sort(row.begin(), row.end(), [](const point_weight &a, const point_weight &b) { return a.cell < b.cell; });
+    for (std::size_t i = 0; i < row.size(); i++)
+    {
+        if (i > 0 && row[i].cell == row[i - 1].cell)
+        {
+            lengths.back() += row[i].length;
+        }
+        else
+        {
+            cells.push_back(row[i].cell);
+            lengths.push_back(row[i].length);
+        }
+    }
+    row.clear();
+}
+} // namespace
+
+void wanda_sparse_matrix::multiply(std::span<const double> values, std::span<double> result) const
+{
+    if (values.size() != columns || result.size() != rows)
+    {
+        throw std::invalid_argument("Vectors do not match the size of the sparse matrix");
+    }
+    const std::size_t stored_rows = row_start.size() - 1;
+    const std::size_t *start = row_start.data();
+    const std::uint32_t *index = column.data();
+    const float *weights = weight.data();
+    const double *x = values.data();
+    for (std::size_t row = 0; row < stored_rows; row++)
+    {
+        // two independent partial sums, so the loop does not wait on a single chain of additions
+        double sum_0 = 0.0;
+        double sum_1 = 0.0;
+        std::size_t k = start[row];
+        const std::size_t end = start[row + 1];
+        for (; k + 1 < end; k += 2)
+        {
+            sum_0 += static_cast<double>(weights[k]) * x[index[k]];
+            sum_1 += static_cast<double>(weights[k + 1]) * x[index[k + 1]];
+        }
+        if (k < end)
+        {
+            sum_0 += static_cast<double>(weights[k]) * x[index[k]];
+        }
+        result[row_index.empty() ? row : row_index[row]] = sum_0 + sum_1;
+    }
+}
+
+wanda_grid_mapping::wanda_grid_mapping(const wanda_grid &grid, const std::vector<wanda_pipe_path> &paths,
+                                       wanda_grid_transfer transfer)
+    : _grid(grid)
+{
+    build(paths, transfer);
+}
+
+void wanda_grid_mapping::build(const std::vector<wanda_pipe_path> &paths, wanda_grid_transfer transfer)
+{
+    if (_grid.cell_width <= 0.0 || _grid.cell_height <= 0.0)
+    {
+        throw std::invalid_argument("Cells of the grid must have a positive size");
+    }
+    if (_grid.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::invalid_argument("The grid has too many cells");
+    }
+
+    // lengths of the points in the cells, one row per point, cells ordered per row
+    std::vector<std::size_t> row_start{0};
+    std::vector<std::uint32_t> cells;
+    std::vector<double> lengths;
+    // length of the route every point stands for, inside and outside the grid
+    std::vector<double> point_lengths;
+
+    std::vector<route_piece> pieces;
+    std::vector<point_weight> row;
+    for (auto &path : paths)
+    {
+        if (path.x.size() != path.y.size() || (!path.z.empty() && path.z.size() != path.x.size()) ||
+            path.x.size() < 2)
+        {
+            throw std::invalid_argument("Route of " + path.name + " needs at least two points with x and y");
+        }
+        if (path.elements < 1)
+        {
+            throw std::invalid_argument(path.name + " has no elements, compute the HCS first");
+        }
+
+        pieces.clear();
+        double route_length = 0.0;
+        for (std::size_t i = 1; i < path.x.size(); i++)
+        {
+            const double dx = path.x[i] - path.x[i - 1];
+            const double dy = path.y[i] - path.y[i - 1];
+            const double dz = path.z.empty() ? 0.0 : path.z[i] - path.z[i - 1];
+            const double length = std::sqrt(dx * dx + dy * dy + dz * dz);
+            trace_segment(_grid, path.x[i - 1], path.y[i - 1], path.x[i], path.y[i], route_length, length, pieces);
+            route_length += length;
+        }
+        if (route_length <= 0.0)
+        {
+            throw std::invalid_argument("Route of " + path.name + " has no length");
+        }
+
+        // point i stands for the route from (i - 0.5) to (i + 0.5) element lengths
+        const auto points = static_cast<std::size_t>(path.elements) + 1;
+        const double element_length = route_length / path.elements;
+        std::size_t point = 0;
+        for (auto &piece : pieces)
+        {
+            double position = piece.start;
+            while (position < piece.end)
+            {
+                const auto piece_point = std::min(
+                    points - 1, static_cast<std::size_t>(std::floor(position / element_length + 0.5)));
+                // pieces follow the route, so the points only move forward
+                while (point < piece_point)
+                {
+                    add_row(row, cells, lengths);
+                    row_start.push_back(cells.size());
+                    point++;
+                }
+                const double point_end = point + 1 < points ? (static_cast<double>(point) + 0.5) * element_length
+                                                            : std::numeric_limits<double>::infinity();
+                if (point_end <= position)
+                {
+                    // rounded onto the boundary between two points
+                    add_row(row, cells, lengths);
+                    row_start.push_back(cells.size());
+                    point++;
+                    continue;
+                }
+                const double end = std::min(piece.end, point_end);
+                row.push_back({piece.cell, end - position});
+                position = end;
+            }
+        }
+        for (; point < points; point++)
+        {
+            add_row(row, cells, lengths);
+            row_start.push_back(cells.size());
+        }
+        for (std::size_t i = 0; i < points; i++)
+        {
+            point_lengths.push_back(i == 0 || i + 1 == points ? 0.5 * element_length : element_length);
+        }
+        _pipe_offsets.push_back(_pipe_offsets.back() + points);
+    }
+
+    const std::size_t number_of_points = _pipe_offsets.back();
+    const std::size_t number_of_values = cells.size();
+
+    // from the grid: length weighted average of the cells of every point
+    _from_grid.rows = number_of_points;
+    _from_grid.columns = _grid.size();
+    _from_grid.row_start = row_start;
+    _from_grid.column = cells;
+    _from_grid.weight.resize(number_of_values);
+    for (std::size_t point = 0; point < number_of_points; point++)
+    {
+        double total = 0.0;
+        for (std::size_t k = row_start[point]; k < row_start[point + 1]; k++)
+        {
+            total += lengths[k];
+        }
+        for (std::size_t k = row_start[point]; k < row_start[point + 1]; k++)
+        {
+            _from_grid.weight[k] = static_cast<float>(lengths[k] / total);
+        }
+    }
+
+    // to the grid: the transpose, only the rows of the cells crossed by a pipe
+    std::vector<std::uint32_t> cell_count(_grid.size(), 0);
+    for (auto cell : cells)
+    {
+        cell_count[cell]++;
+    }
+    _to_grid.rows = _grid.size();
+    _to_grid.columns = number_of_points;
+    _to_grid.row_start.assign(1, 0);
+    _to_grid.row_index.clear();
+    // reuse the counts as the position of the next value of every cell
+    for (std::size_t cell = 0; cell < cell_count.size(); cell++)
+    {
+        if (cell_count[cell] == 0)
+        {
+            continue;
+        }
+        _to_grid.row_index.push_back(static_cast<std::uint32_t>(cell));
+        const auto count = cell_count[cell];
+        cell_count[cell] = static_cast<std::uint32_t>(_to_grid.row_index.size() - 1);
+        _to_grid.row_start.push_back(_to_grid.row_start.back() + count);
+    }
+    std::vector<std::size_t> next(_to_grid.row_start.begin(), _to_grid.row_start.end() - 1);
+    std::vector<double> transposed_lengths(number_of_values);
+    _to_grid.column.resize(number_of_values);
+    _to_grid.weight.resize(number_of_values);
+    for (std::size_t point = 0; point < number_of_points; point++)
+    {
+        for (std::size_t k = row_start[point]; k < row_start[point + 1]; k++)
+        {
+            const auto position = next[cell_count[cells[k]]]++;
+            _to_grid.column[position] = static_cast<std::uint32_t>(point);
+            transposed_lengths[position] = lengths[k];
+        }
+    }
+    for (std::size_t cell_row = 0; cell_row + 1 < _to_grid.row_start.size(); cell_row++)
+    {
+        const auto first = _to_grid.row_start[cell_row];
+        const auto last = _to_grid.row_start[cell_row + 1];
+        double total = 0.0;
+        for (auto k = first; k < last; k++)
+        {
+            total += transposed_lengths[k];
+        }
+        for (auto k = first; k < last; k++)
+        {
+            const double divisor =
+                transfer == wanda_grid_transfer::conserve ? point_lengths[_to_grid.column[k]] : total;
+            _to_grid.weight[k] = static_cast<float>(transposed_lengths[k] / divisor);
+        }
+    }
+}
+
+void wanda_grid_mapping::to_grid(std::span<const double> points, std::span<double> cells) const
+{
+    _to_grid.multiply(points, cells);
+}
+
+void wanda_grid_mapping::from_grid(std::span<const double> cells, std::span<double> points) const
+{
+    _from_grid.multiply(cells, points);
+}
+
+wanda_time_averager::wanda_time_averager(std::size_t size) : _integral(size, 0.0), _last(size, 0.0)
+{
+}
+
+void wanda_time_averager::add(double time, std::span<const double> values)
+{
+    if (values.size() != _last.size())
+    {
+        throw std::invalid_argument("Sample has " + std::to_string(values.size()) + " values, the averager " +
+                                    std::to_string(_last.size()));
+    }
+    if (_empty)
+    {
+        _start_time = time;
+        _empty = false;
+    }
+    else
+    {
+        if (time <= _last_time)
+        {
+            throw std::invalid_argument("Samples must be added at increasing times");
+        }
+        const double half_step = 0.5 * (time - _last_time);
+        double *integral = _integral.data();
+        const double *last = _last.data();
+        const double *value = values.data();
+        for (std::size_t i = 0; i < _integral.size(); i++)
+        {
+            integral[i] += half_step * (last[i] + value[i]);
+        }
+    }
+    std::copy(values.begin(), values.end(), _last.begin());
+    _last_time = time;
+}
+
+void wanda_time_averager::add_series(std::span<const double> times, std::span<const double> values)
+{
+    if (values.size() != times.size() * _last.size())
+    {
+        throw std::invalid_argument("Series does not have a value per time for every value of the averager");
+    }
+    for (std::size_t step = 0; step < times.size(); step++)
+    {
+        add(times[step], values.subspan(step * _last.size(), _last.size()));
+    }
+}
+
+void wanda_time_averager::get_average(std::span<double> average) const
+{
+    if (average.size() != _last.size())
+    {
+        throw std::invalid_argument("Average does not match the size of the averager");
+    }
+    if (_empty)
+    {
+        throw std::runtime_error("No samples to average");
+    }
+    if (_last_time == _start_time)
+    {
+        std::copy(_last.begin(), _last.end(), average.begin());
+        return;
+    }
+    const double scale = 1.0 / (_last_time - _start_time);
+    for (std::size_t i = 0; i < _integral.size(); i++)
+    {
+        average[i] = _integral[i] * scale;
+    }
+}
+
+void wanda_time_averager::restart()
+{
+    std::fill(_integral.begin(), _integral.end(), 0.0);
+    _start_time = _last_time;
+}
+
+void wanda_interpolate_in_time(double time_0, std::span<const double> values_0, double time_1,
+                               std::span<const double> values_1, double time, std::span<double> result)
+{
+    if (values_0.size() != values_1.size() || values_0.size() != result.size())
+    {
+        throw std::invalid_argument("Values to interpolate have a different size");
+    }
+    double fraction = time_1 > time_0 ? (time - time_0) / (time_1 - time_0) : 1.0;
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    for (std::size_t i = 0; i < result.size(); i++)
+    {
+        result[i] = values_0[i] + fraction * (values_1[i] - values_0[i]);
+    }
+}
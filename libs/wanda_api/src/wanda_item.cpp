@@ -27,9 +27,25 @@ void wanda_item::remove_keyword(std::string keyword)
     }
     auto const result = std::find(_keywords.begin(), _keywords.end(), keyword);
     _keywords.erase(result);
+    if (_keyword_link.index != nullptr && _keyword_link.index->is_valid() && !has_keyword(keyword))
+    {
+        _keyword_link.index->remove(_keyword_link, keyword);
+    }
     set_modified(true);
 }
 
+void wanda_item::clear_keywords()
+{
+    if (_keyword_link.index != nullptr && _keyword_link.index->is_valid())
+    {
+        for (auto &keyword : _keywords)
+        {
+            _keyword_link.index->remove(_keyword_link, keyword);
+        }
+    }
+    _keywords.clear();
+}
+
 bool wanda_item::is_action_table_used()
 {
     if (has_action_table())
@@ -62,6 +78,10 @@ void wanda_item::add_keyword(std::string keywordin)
 
     _keywords.push_back(keywordin);
     _is_modified = true;
+    if (_keyword_link.index != nullptr && _keyword_link.index->is_valid())
+    {
+        _keyword_link.index->add(_keyword_link, keywordin);
+    }
     // determine the size of the keywords group
     std::size_t size = 0;
     for (auto const keyword : _keywords)
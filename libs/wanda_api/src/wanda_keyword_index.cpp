@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <iterator>
+#include <wanda_item.h>
+#include <wanda_keyword_index.h>
+
+void wanda_keyword_index::invalidate()
+{
+    _valid = false;
+    _keyword_ids.clear();
+    _keywords.clear();
+    _postings.clear();
+    _items.clear();
+}
+
+void wanda_keyword_index::register_item(wanda_item &item)
+{
+    item._keyword_link.index = this;
+    item._keyword_link.item_id = static_cast<int>(_items.size());
+    _items.push_back(&item);
+    for (auto &keyword : item._keywords)
+    {
+        add(item._keyword_link, keyword);
+    }
+}
+
+void wanda_keyword_index::add(const keyword_index_link &link, const std::string &keyword)
+{
+    auto iter = _keyword_ids.find(keyword);
+    if (iter == _keyword_ids.end())
+    {
+        iter = _keyword_ids.emplace(keyword, static_cast<int>(_keywords.size())).first;
+        _keywords.push_back(keyword);
+        _postings.emplace_back();
+    }
+    auto &posting = _postings[iter->second];
+    auto pos = std::lower_bound(posting.begin(), posting.end(), link.item_id);
+    if (pos == posting.end() || *pos != link.item_id)
+    {
+        posting.insert(pos, link.item_id);
+    }
+}
+
+void wanda_keyword_index::remove(const keyword_index_link &link, const std::string &keyword)
+{
+    auto iter = _keyword_ids.find(keyword);
+    if (iter == _keyword_ids.end())
+    {
+        return;
+    }
+    auto &posting = _postings[iter->second];
+    auto pos = std::lower_bound(posting.begin(), posting.end(), link.item_id);
+    if (pos != posting.end() && *pos == link.item_id)
+    {
+        posting.erase(pos);
+    }
+}
+
+const std::vector<int> *wanda_keyword_index::get_posting(const std::string &keyword) const
+{
+    auto iter = _keyword_ids.find(keyword);
+    if (iter == _keyword_ids.end())
+    {
+        return nullptr;
+    }
+    return &_postings[iter->second];
+}
+
+std::vector<wanda_item *> wanda_keyword_index::find(const std::string &keyword) const
+{
+    std::vector<wanda_item *> result;
+    auto posting = get_posting(keyword);
+    if (posting == nullptr)
+    {
+        return result;
+    }
+    result.reserve(posting->size());
+    for (int item_id : *posting)
+    {
+        result.push_back(_items[item_id]);
+    }
+    return result;
+}
+
+std::vector<wanda_item *> wanda_keyword_index::find_all(const std::vector<std::string> &keywords) const
+{
+    std::vector<wanda_item *> result;
+    std::vector<const std::vector<int> *> postings;
+    for (auto &keyword : keywords)
+    {
+        auto posting = get_posting(keyword);
+        if (posting == nullptr || posting->empty())
+        {
+            return result;
+        }
+        postings.push_back(posting);
+    }
+    if (postings.empty())
+    {
+        return result;
+    }
+    // intersect starting with the shortest list, this keeps the intermediate results small
+    std::sort(postings.begin(), postings.end(),
+              [](const std::vector<int> *a, const std::vector<int> *b) { return a->size() < b->size(); });
+    std::vector<int> ids = *postings[0];
+    std::vector<int> temp;
+    for (size_t i = 1; i < postings.size() && !ids.empty(); i++)
+    {
+        temp.clear();
+        std::set_intersection(ids.begin(), ids.end(), postings[i]->begin(), postings[i]->end(),
+                              std::back_inserter(temp));
+        ids.swap(temp);
+    }
+    result.reserve(ids.size());
+    for (int item_id : ids)
+    {
+        result.push_back(_items[item_id]);
+    }
+    return result;
+}
+
+std::vector<wanda_item *> wanda_keyword_index::find_any(const std::vector<std::string> &keywords) const
+{
+    std::vector<wanda_item *> result;
+    std::vector<int> ids;
+    std::vector<int> temp;
+    for (auto &keyword : keywords)
+    {
+        auto posting = get_posting(keyword);
+        if (posting == nullptr)
+        {
+            continue;
+        }
+        temp.clear();
+        std::set_union(ids.begin(), ids.end(), posting->begin(), posting->end(), std::back_inserter(temp));
+        ids.swap(temp);
+    }
+    result.reserve(ids.size());
+    for (int item_id : ids)
+    {
+        result.push_back(_items[item_id]);
+    }
+    return result;
+}
+
+std::vector<std::string> wanda_keyword_index::get_keywords() const
+{
+    std::vector<std::string> result;
+    for (size_t i = 0; i < _keywords.size(); i++)
+    {
+        if (!_postings[i].empty())
+        {
+            result.push_back(_keywords[i]);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <wanda_metrics.h>
+
+std::atomic<bool> wanda_metrics::_enabled{false};
+
+const std::array<double, wanda_metric_histogram::number_of_buckets - 1> wanda_metric_histogram::bounds = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2,
+    5e-2, 0.1,    0.25, 0.5,  1.0,    2.5,  5.0,  10.0,   25.0, 50.0,   100.0,  250.0,  500.0};
+
+namespace
+{
+// metrics by name and labels, sorted so the metrics of one name are written together
+struct metrics_registry
+{
+    std::shared_mutex mutex;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<wanda_metric_counter>> counters;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<wanda_metric_histogram>> histograms;
+};
+
+metrics_registry &get_registry()
+{
+    static metrics_registry registry;
+    return registry;
+}
+
+template <typename T>
+T &get_or_create(std::shared_mutex &mutex, std::map<std::pair<std::string, std::string>, std::unique_ptr<T>> &metrics,
+                 const std::string &name, const std::string &labels)
+{
+    auto key = std::make_pair(name, labels);
+    {
+        std::shared_lock lock(mutex);
+        if (auto found = metrics.find(key); found != metrics.end())
+        {
+            return *found->second;
+        }
+    }
+    std::unique_lock lock(mutex);
+    auto &metric = metrics[key];
+    if (!metric)
+    {
+        metric = std::make_unique<T>();
+    }
+    return *metric;
+}
+
+// name{labels}, with the extra label appended for the buckets of histograms
+std::string get_series(const std::string &name, const std::string &labels, const std::string &extra = "")
+{
+    if (labels.empty() && extra.empty())
+    {
+        return name;
+    }
+    std::string series = name + "{" + labels;
+    if (!labels.empty() && !extra.empty())
+    {
+        series += ",";
+    }
+    return series + extra + "}";
+}
+} // namespace
+
+void wanda_metric_histogram::observe(std::chrono::duration<double> duration) noexcept
+{
+    auto seconds = duration.count();
+    std::size_t bucket = 0;
+    while (bucket < bounds.size() && seconds > bounds[bucket])
+    {
+        bucket++;
+    }
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum_ns.fetch_add(static_cast<std::uint64_t>(std::max(seconds, 0.0) * 1e9), std::memory_order_relaxed);
+}
+
+void wanda_metric_histogram::reset() noexcept
+{
+    for (auto &bucket : _buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum_ns.store(0, std::memory_order_relaxed);
+}
+
+void wanda_metrics::enable() noexcept
+{
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+void wanda_metrics::disable() noexcept
+{
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+wanda_metric_counter &wanda_metrics::counter(const std::string &name, const std::string &labels)
+{
+    auto &registry = get_registry();
+    return get_or_create(registry.mutex, registry.counters, name, labels);
+}
+
+wanda_metric_histogram &wanda_metrics::histogram(const std::string &name, const std::string &labels)
+{
+    auto &registry = get_registry();
+    return get_or_create(registry.mutex, registry.histograms, name, labels);
+}
+
+std::uint64_t wanda_metrics::get_counter(const std::string &name, const std::string &labels)
+{
+    auto &registry = get_registry();
+    std::shared_lock lock(registry.mutex);
+    auto found = registry.counters.find(std::make_pair(name, labels));
+    return found == registry.counters.end() ? 0 : found->second->get();
+}
+
+void wanda_metrics::reset()
+{
+    auto &registry = get_registry();
+    std::shared_lock lock(registry.mutex);
+    for (auto &counter : registry.counters)
+    {
+        counter.second->reset();
+    }
+    for (auto &histogram : registry.histograms)
+    {
+        histogram.second->reset();
+    }
+}
+
+void wanda_metrics::write_prometheus(std::ostream &stream)
+{
+    auto &registry = get_registry();
+    std::shared_lock lock(registry.mutex);
+    std::string previous;
+    for (auto &[key, counter] : registry.counters)
+    {
+        if (key.first != previous)
+        {
+            stream << "# TYPE " << key.first << " counter\n";
+            previous = key.first;
+        }
+        stream << get_series(key.first, key.second) << ' ' << counter->get() << '\n';
+    }
+    previous.clear();
+    for (auto &[key, histogram] : registry.histograms)
+    {
+        if (key.first != previous)
+        {
+            stream << "# TYPE " << key.first << " histogram\n";
+            previous = key.first;
+        }
+        // Prometheus buckets are cumulative, the count is that of the last bucket even while others observe
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < wanda_metric_histogram::number_of_buckets; i++)
+        {
+            cumulative += histogram->get_bucket(i);
+            std::ostringstream bound;
+            if (i < wanda_metric_histogram::bounds.size())
+            {
+                bound << "le=\"" << wanda_metric_histogram::bounds[i] << '"';
+            }
+            else
+            {
+                bound << "le=\"+Inf\"";
+            }
+            stream << get_series(key.first + "_bucket", key.second, bound.str()) << ' ' << cumulative << '\n';
+        }
+        stream << get_series(key.first + "_sum", key.second) << ' ' << histogram->get_sum() << '\n';
+        stream << get_series(key.first + "_count", key.second) << ' ' << cumulative << '\n';
+    }
+}
+
+void wanda_metrics::write_prometheus(const std::string &file)
+{
+    auto temporary = file + ".tmp";
+    {
+        std::ofstream stream(temporary);
+        if (!stream)
+        {
+            throw std::runtime_error("Cannot write metrics to " + temporary);
+        }
+        write_prometheus(stream);
+    }
+    std::filesystem::rename(temporary, file);
+}
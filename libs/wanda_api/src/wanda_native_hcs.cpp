@@ -0,0 +1,77 @@
+#include <cmath>
+#include <stdexcept>
+#include <wanda_native_hcs.h>
+
+namespace wanda_native_hcs
+{
+float profile_length(std::span<const float> distance, std::span<const float> height)
+{
+    if (distance.size() != height.size())
+    {
+        throw std::invalid_argument("Columns of the profile have a different length");
+    }
+    float length = 0.0f;
+    for (size_t i = 1; i < distance.size(); i++)
+    {
+        const float dl = distance[i] - distance[i - 1];
+        const float dh = height[i] - height[i - 1];
+        length += std::sqrt(dl * dl + dh * dh);
+    }
+    return length;
+}
+
+float profile_length(std::span<const float> x, std::span<const float> y, std::span<const float> z)
+{
+    if (x.size() != y.size() || x.size() != z.size())
+    {
+        throw std::invalid_argument("Columns of the profile have a different length");
+    }
+    float length = 0.0f;
+    for (size_t i = 1; i < x.size(); i++)
+    {
+        const float dx = x[i] - x[i - 1];
+        const float dy = y[i] - y[i - 1];
+        const float dz = z[i] - z[i - 1];
+        length += std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    return length;
+}
+
+float profile_length_from_differences(std::span<const float> x_diff, std::span<const float> y_diff,
+                                      std::span<const float> z_diff)
+{
+    if (x_diff.size() != y_diff.size() || x_diff.size() != z_diff.size())
+    {
+        throw std::invalid_argument("Columns of the profile have a different length");
+    }
+    float length = 0.0f;
+    // row 0 holds the coordinates of the start of the pipe instead of a difference, like in the Wanda GUI, so the
+    // segments start at row 1
+    for (size_t i = 1; i < x_diff.size(); i++)
+    {
+        length += std::sqrt(x_diff[i] * x_diff[i] + y_diff[i] * y_diff[i] + z_diff[i] * z_diff[i]);
+    }
+    return length;
+}
+
+void compute_pipe_element_count(std::span<const float> length, std::span<const float> wave_speed, float time_step,
+                                std::span<float> element_count)
+{
+    if (length.size() != wave_speed.size() || length.size() != element_count.size())
+    {
+        throw std::invalid_argument("Input and output of the pipe HCS have a different size");
+    }
+    if (!(time_step > 0.0f))
+    {
+        throw std::invalid_argument("Time step must be positive to compute the number of pipe elements");
+    }
+    const float inverse_time_step = 1.0f / time_step;
+    // no calls and only selects in the loop, so it is vectorized
+    for (size_t i = 0; i < length.size(); i++)
+    {
+        const bool valid = length[i] > 0.0f && wave_speed[i] > 0.0f;
+        const float count = std::floor(length[i] * inverse_time_step / wave_speed[i] + 0.5f);
+        element_count[i] = valid ? (count < 1.0f ? 1.0f : count) : not_computed;
+    }
+}
+} // namespace wanda_native_hcs
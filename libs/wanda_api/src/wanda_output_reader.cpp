@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <stdexcept>
+#include <wanda_output_reader.h>
+#include <wanda_trace.h>
+#include <wandamodel.h>
+
+wanda_output_reader::wanda_output_reader(wanda_model &model) : _model(model)
+{
+    auto &file = _model.get_output_file();
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Wanda output file doesn't exist, run steady and/or unsteady "
+                                 "computations to create simulation output");
+    }
+    int steps = file.get_int_attribute("OUTPUT_TIME", "N_timesteps");
+    if (steps > 0)
+    {
+        std::vector<float> times(steps);
+        file.get_float_element("OUTPUT_TIME", "Value", {1, steps, 1}, times);
+        _times.assign(times.begin(), times.end());
+    }
+}
+
+const wanda_output_column &wanda_output_reader::add(const std::string &item, const std::string &property)
+{
+    auto &prop = _model.component_exists(item) ? _model.get_component(item).get_property(property)
+                                               : _model.get_node(item).get_property(property);
+    if (!prop.has_series())
+    {
+        throw std::invalid_argument(item + " " + property + " has no series");
+    }
+    wanda_output_column column;
+    column.item = item;
+    column.quantity = property;
+    column.unit_factor = prop.get_unit_factor();
+    auto unit_dim = prop.get_unit_dim();
+    if (unit_dim != ".")
+    {
+        try
+        {
+            column.unit = _model.get_current_dim(unit_dim);
+        }
+        catch (const std::invalid_argument &)
+        {
+            column.unit = unit_dim;
+        }
+    }
+    column.wdo_postfix = prop.get_wdo_postfix();
+    column.first_value = prop.get_group_index() + prop.get_hos_index() - 1;
+    column.number_of_values = prop.get_number_of_elements() + 1;
+    int values = _model.get_output_file().get_int_attribute("OUTP_" + column.wdo_postfix, "N_values");
+    if (column.first_value < 0 || column.first_value + column.number_of_values > values)
+    {
+        throw std::runtime_error("No output of " + item + " " + property + " in the output file");
+    }
+    _columns.push_back(std::move(column));
+    return _columns.back();
+}
+
+int wanda_output_reader::get_steps_per_block(std::size_t column, std::size_t max_values) const
+{
+    auto steps = max_values / static_cast<std::size_t>(_columns.at(column).number_of_values);
+    return static_cast<int>(std::clamp<std::size_t>(steps, 1, std::max<std::size_t>(_times.size(), 1)));
+}
+
+void wanda_output_reader::read(std::size_t column, int first_step, int steps, std::vector<float> &values) const
+{
+    WANDA_TRACE_SCOPE("wanda_output_reader::read");
+    auto &quantity = _columns.at(column);
+    if (first_step < 0 || steps <= 0 || first_step + steps > get_number_of_steps())
+    {
+        throw std::out_of_range("Steps " + std::to_string(first_step) + " to " + std::to_string(first_step + steps) +
+                                " are not in the output");
+    }
+    _model.get_output_file().get_float_element(
+        "OUTP_" + quantity.wdo_postfix, "Value",
+        {quantity.first_value + 1, quantity.first_value + quantity.number_of_values, 1},
+        {first_step + 1, first_step + steps, 1}, values);
+    if (quantity.unit_factor != 1.0f)
+    {
+        for (auto &value : values)
+        {
+            value *= quantity.unit_factor;
+        }
+    }
+}
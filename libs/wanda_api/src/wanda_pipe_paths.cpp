@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <wanda_grid_mapping.h>
+#include <wandamodel.h>
+
+namespace
+{
+std::vector<double> to_doubles(const std::vector<float> &values)
+{
+    return std::vector<double>(values.begin(), values.end());
+}
+
+// straight route between the diagram positions of the nodes of the pipe
+void set_diagram_route(wanda_component &pipe, const wanda_diagram_transform &transform, wanda_pipe_path &path)
+{
+    if (!pipe.is_node_connected(1) || !pipe.is_node_connected(2))
+    {
+        throw std::runtime_error(pipe.get_complete_name_spec() + " is not connected at both ends");
+    }
+    for (int connection_point = 1; connection_point <= 2; connection_point++)
+    {
+        auto position = pipe.get_connected_node(connection_point).get_position();
+        path.x.push_back(transform.x_offset + transform.x_scale * position[0]);
+        path.y.push_back(transform.y_offset + transform.y_scale * position[1]);
+    }
+}
+} // namespace
+
+std::vector<wanda_pipe_path> wanda_get_pipe_paths(wanda_model &model, const wanda_diagram_transform &transform)
+{
+    auto pipes = model.get_all_pipes();
+    std::sort(pipes.begin(), pipes.end(), [](wanda_component *a, wanda_component *b) {
+        return a->get_complete_name_spec() < b->get_complete_name_spec();
+    });
+    std::vector<wanda_pipe_path> paths;
+    for (auto pipe : pipes)
+    {
+        if (pipe->is_disused())
+            continue;
+        wanda_pipe_path path;
+        path.name = pipe->get_complete_name_spec();
+        path.elements = pipe->get_num_elements();
+        auto geometry = pipe->contains_property("Geometry input")
+                            ? pipe->get_property("Geometry input").get_scalar_str()
+                            : std::string("Length");
+        if (geometry == "xyz")
+        {
+            auto &profile = pipe->get_property("Profile").get_table();
+            path.x = to_doubles(profile.get_float_column("X-abs"));
+            path.y = to_doubles(profile.get_float_column("Y-abs"));
+            path.z = to_doubles(profile.get_float_column("Z-abs"));
+        }
+        else if (geometry == "xyz dif")
+        {
+            // the first row is the start point, the other rows the differences to the previous point
+            auto &profile = pipe->get_property("Profile").get_table();
+            path.x = to_doubles(profile.get_float_column("X-diff"));
+            path.y = to_doubles(profile.get_float_column("Y-diff"));
+            path.z = to_doubles(profile.get_float_column("Z-diff"));
+            for (std::size_t i = 1; i < path.x.size(); i++)
+            {
+                path.x[i] += path.x[i - 1];
+                path.y[i] += path.y[i - 1];
+                path.z[i] += path.z[i - 1];
+            }
+        }
+        else
+        {
+            set_diagram_route(*pipe, transform, path);
+        }
+        paths.push_back(std::move(path));
+    }
+    return paths;
+}
+
+wanda_grid_mapping::wanda_grid_mapping(wanda_model &model, const wanda_grid &grid, wanda_grid_transfer transfer,
+                                       const wanda_diagram_transform &transform)
+    : wanda_grid_mapping(grid, wanda_get_pipe_paths(model, transform), transfer)
+{
+}
@@ -0,0 +1,487 @@
+#include <stdexcept>
+#include <wanda_metrics.h>
+#include <wanda_solver_process.h>
+#include <wanda_trace.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+namespace
+{
+// interval at which the monitoring thread checks for cancellation and the timeout
+constexpr int poll_interval_ms = 50;
+
+// quotes an argument such that CommandLineToArgvW and the C runtime parse it back unchanged:
+// backslashes are literal, except when they precede a quote or the closing quote
+std::string quote_argument(const std::string &argument)
+{
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (char c : argument)
+    {
+        if (c == '\\')
+        {
+            backslashes++;
+            continue;
+        }
+        if (c == '"')
+        {
+            // the backslashes are doubled and the quote is escaped
+            quoted.append(2 * backslashes + 1, '\\');
+        }
+        else
+        {
+            quoted.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        quoted.push_back(c);
+    }
+    quoted.append(2 * backslashes, '\\');
+    quoted.push_back('"');
+    return quoted;
+}
+
+#ifdef _WIN32
+std::string get_last_error_message(DWORD error)
+{
+    LPVOID lpMsgBuf = nullptr;
+    FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, NULL,
+                   error, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&lpMsgBuf, 0, NULL);
+    std::string errormsg(lpMsgBuf != nullptr ? static_cast<char *>(lpMsgBuf) : "");
+    LocalFree(lpMsgBuf); // because FORMAT_MESSAGE_ALLOCATE_BUFFER flag
+    return std::to_string(error) + " = " + errormsg;
+}
+
+// reads everything that is available in the pipe without blocking, closes the pipe at its end
+void drain_pipe(void *&pipe, std::string &target)
+{
+    if (pipe == nullptr)
+    {
+        return;
+    }
+    char buffer[4096];
+    DWORD available = 0;
+    while (true)
+    {
+        if (!PeekNamedPipe(pipe, NULL, 0, NULL, &available, NULL))
+        {
+            // broken pipe, the process has closed its end
+            CloseHandle(pipe);
+            pipe = nullptr;
+            return;
+        }
+        if (available == 0)
+        {
+            return;
+        }
+        DWORD read = 0;
+        if (!ReadFile(pipe, buffer, available < sizeof(buffer) ? available : DWORD{sizeof(buffer)}, &read, NULL) || read == 0)
+        {
+            CloseHandle(pipe);
+            pipe = nullptr;
+            return;
+        }
+        target.append(buffer, read);
+    }
+}
+#else
+// reads everything that is available in the pipe without blocking, closes the pipe at its end
+void drain_pipe(int &pipe, std::string &target)
+{
+    if (pipe < 0)
+    {
+        return;
+    }
+    char buffer[4096];
+    while (true)
+    {
+        auto count = read(pipe, buffer, sizeof(buffer));
+        if (count > 0)
+        {
+            target.append(buffer, static_cast<size_t>(count));
+            continue;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && errno == EAGAIN)
+        {
+            return;
+        }
+#if EAGAIN != EWOULDBLOCK
+        if (count < 0 && errno == EWOULDBLOCK)
+        {
+            return;
+        }
+#endif
+        close(pipe);
+        pipe = -1;
+        return;
+    }
+}
+#endif
+} // namespace
+
+std::shared_ptr<wanda_solver_job> wanda_solver_job::launch(const std::string &executable,
+                                                           const std::vector<std::string> &arguments,
+                                                           wanda_solver_options options)
+{
+    std::shared_ptr<wanda_solver_job> job(new wanda_solver_job());
+    job->_options = std::move(options);
+    job->_future = job->_promise.get_future().share();
+    job->start(executable, arguments);
+    // the thread only holds a weak handle, so releasing the last handle still cancels the job
+    std::lock_guard<std::mutex> lock(job->_monitor_mutex);
+    job->_monitor = std::thread(&wanda_solver_job::monitor, job.get(), std::weak_ptr<wanda_solver_job>(job));
+    return job;
+}
+
+wanda_solver_job::~wanda_solver_job()
+{
+    // the monitoring thread detaches itself when it holds a handle, otherwise it is joined here
+    if (!_monitor.joinable())
+    {
+        return;
+    }
+    cancel();
+    _monitor.join();
+}
+
+void wanda_solver_job::cancel()
+{
+    _cancel_requested = true;
+}
+
+bool wanda_solver_job::is_finished() const
+{
+    return _finished;
+}
+
+const wanda_solver_result &wanda_solver_job::wait()
+{
+    return _future.get();
+}
+
+bool wanda_solver_job::wait_for(std::chrono::milliseconds duration)
+{
+    return _future.wait_for(duration) == std::future_status::ready;
+}
+
+void wanda_solver_job::finish(wanda_solver_result result, const std::weak_ptr<wanda_solver_job> &self)
+{
+    auto end_time = std::chrono::steady_clock::now();
+    result.wall_time = end_time - _start_time;
+    if (wanda_trace::is_enabled())
+    {
+        // the whole life of the process, recorded on the monitoring thread
+        wanda_trace::record("solver process", "solver", _start_time, end_time);
+    }
+    if (wanda_metrics::is_enabled())
+    {
+        const char *outcome = result.cancelled   ? "cancelled"
+                              : result.timed_out ? "timed_out"
+                              : result.exit_code == 0 ? "succeeded"
+                                                      : "failed";
+        wanda_metrics::histogram("wanda_solver_seconds", std::string("result=\"") + outcome + '"')
+            .observe(result.wall_time);
+    }
+    // the callback may release the last handle, so the thread holds one until the result is published
+    // and is not joined anymore. Without a handle the job is being destroyed and waits for this thread
+    auto keep_alive = self.lock();
+    if (keep_alive)
+    {
+        std::lock_guard<std::mutex> lock(_monitor_mutex);
+        _monitor.detach();
+    }
+    // the callback runs before the result is published, so waiting threads see its effects
+    if (_options.on_finished)
+    {
+        try
+        {
+            _options.on_finished(result);
+        }
+        catch (...)
+        {
+            // there is nobody to report this to on the monitoring thread
+        }
+    }
+    _promise.set_value(std::move(result));
+    _finished = true;
+}
+
+#ifdef _WIN32
+void wanda_solver_job::start(const std::string &executable, const std::vector<std::string> &arguments)
+{
+    _command_line = quote_argument(executable);
+    for (auto &argument : arguments)
+    {
+        _command_line.append(" ").append(quote_argument(argument));
+    }
+    if (executable.length() > MAX_PATH)
+        throw std::runtime_error("Executable path is longer than MAX_PATH: " + executable);
+    if ((_command_line.size() + 1) > 32768) // limit accoording to documentation
+        throw std::runtime_error("length of path = " + std::to_string(_command_line.length()) + " max=32768");
+
+    SECURITY_ATTRIBUTES security;
+    ZeroMemory(&security, sizeof(security));
+    security.nLength = sizeof(security);
+    security.bInheritHandle = TRUE;
+    HANDLE output_write = NULL;
+    HANDLE error_write = NULL;
+    if (_options.capture_output)
+    {
+        HANDLE output_read = NULL;
+        HANDLE error_read = NULL;
+        if (!CreatePipe(&output_read, &output_write, &security, 0) ||
+            !CreatePipe(&error_read, &error_write, &security, 0))
+        {
+            throw std::runtime_error("CreatePipe failed: " + get_last_error_message(GetLastError()));
+        }
+        // only the write ends are inherited by the solver
+        SetHandleInformation(output_read, HANDLE_FLAG_INHERIT, 0);
+        SetHandleInformation(error_read, HANDLE_FLAG_INHERIT, 0);
+        _output_pipe = output_read;
+        _error_pipe = error_read;
+    }
+    else
+    {
+        output_write = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &security, OPEN_EXISTING, 0, NULL);
+        error_write = output_write;
+    }
+
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&si, sizeof(si));
+    ZeroMemory(&pi, sizeof(pi));
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = output_write;
+    si.hStdError = error_write;
+    std::vector<char> stringbuf(_command_line.begin(), _command_line.end());
+    stringbuf.push_back('\0');
+    const char *directory = _options.working_directory.empty() ? NULL : _options.working_directory.c_str();
+    _start_time = std::chrono::steady_clock::now();
+    BOOL started = CreateProcessA(NULL,             // No module name (use command line)
+                                  stringbuf.data(), // Command line
+                                  NULL,             // Process handle not inheritable
+                                  NULL,             // Thread handle not inheritable
+                                  TRUE,             // Inherit the redirected standard handles
+                                  CREATE_NO_WINDOW, // Creation flags
+                                  NULL,             // Use parent's environment block
+                                  directory,        // Starting directory
+                                  &si,              // Pointer to STARTUPINFO structure
+                                  &pi);             // Pointer to PROCESS_INFORMATION structure
+    DWORD error = GetLastError();
+    // the solver has its own copies of the write ends now
+    CloseHandle(output_write);
+    if (error_write != output_write)
+    {
+        CloseHandle(error_write);
+    }
+    if (!started)
+    {
+        if (_output_pipe != nullptr)
+            CloseHandle(_output_pipe);
+        if (_error_pipe != nullptr)
+            CloseHandle(_error_pipe);
+        _output_pipe = nullptr;
+        _error_pipe = nullptr;
+        throw std::runtime_error("CreateProcess failed: " + get_last_error_message(error) + "path=" + executable);
+    }
+    CloseHandle(pi.hThread);
+    _process = pi.hProcess;
+}
+
+void wanda_solver_job::monitor(std::weak_ptr<wanda_solver_job> self)
+{
+    try
+    {
+        wanda_solver_result result;
+        bool killed = false;
+        while (true)
+        {
+            DWORD state = WaitForSingleObject(_process, poll_interval_ms);
+            drain_pipe(_output_pipe, result.output);
+            drain_pipe(_error_pipe, result.error);
+            if (state == WAIT_OBJECT_0)
+            {
+                break;
+            }
+            if (killed)
+            {
+                continue;
+            }
+            if (_cancel_requested)
+            {
+                result.cancelled = true;
+            }
+            else if (_options.timeout.count() > 0 &&
+                     std::chrono::steady_clock::now() - _start_time > _options.timeout)
+            {
+                result.timed_out = true;
+            }
+            if (result.cancelled || result.timed_out)
+            {
+                TerminateProcess(_process, 1);
+                killed = true;
+            }
+        }
+        DWORD exitcode = 0;
+        GetExitCodeProcess(_process, &exitcode);
+        result.exit_code = static_cast<int>(exitcode);
+        CloseHandle(_process);
+        _process = nullptr;
+        if (_output_pipe != nullptr)
+            CloseHandle(_output_pipe);
+        if (_error_pipe != nullptr)
+            CloseHandle(_error_pipe);
+        _output_pipe = nullptr;
+        _error_pipe = nullptr;
+        finish(std::move(result), self);
+    }
+    catch (...)
+    {
+        _promise.set_exception(std::current_exception());
+        _finished = true;
+    }
+}
+#else
+void wanda_solver_job::start(const std::string &executable, const std::vector<std::string> &arguments)
+{
+    _command_line = quote_argument(executable);
+    for (auto &argument : arguments)
+    {
+        _command_line.append(" ").append(quote_argument(argument));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    int output_pipe[2] = {-1, -1};
+    int error_pipe[2] = {-1, -1};
+    if (_options.capture_output)
+    {
+        // close on exec, so solvers started concurrently from other threads don't inherit the pipes
+        if (pipe2(output_pipe, O_CLOEXEC) != 0 || pipe2(error_pipe, O_CLOEXEC) != 0)
+        {
+            posix_spawn_file_actions_destroy(&actions);
+            throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+        }
+        posix_spawn_file_actions_adddup2(&actions, output_pipe[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, error_pipe[1], STDERR_FILENO);
+    }
+    else
+    {
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    }
+    if (!_options.working_directory.empty())
+    {
+        posix_spawn_file_actions_addchdir_np(&actions, _options.working_directory.c_str());
+    }
+
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(executable.c_str()));
+    for (auto &argument : arguments)
+    {
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    _start_time = std::chrono::steady_clock::now();
+    pid_t pid = -1;
+    int error = posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    // the solver has its own copies of the write ends now
+    for (int fd : {output_pipe[1], error_pipe[1]})
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+    if (error != 0)
+    {
+        for (int fd : {output_pipe[0], error_pipe[0]})
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+        throw std::runtime_error(std::string("posix_spawn failed: ") + std::strerror(error) + " path=" + executable);
+    }
+    _pid = pid;
+    _output_pipe = output_pipe[0];
+    _error_pipe = error_pipe[0];
+    for (int fd : {_output_pipe, _error_pipe})
+    {
+        if (fd >= 0)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+}
+
+void wanda_solver_job::monitor(std::weak_ptr<wanda_solver_job> self)
+{
+    try
+    {
+        wanda_solver_result result;
+        bool killed = false;
+        int status = 0;
+        while (true)
+        {
+            pollfd fds[2] = {{_output_pipe, POLLIN, 0}, {_error_pipe, POLLIN, 0}};
+            poll(fds, 2, poll_interval_ms);
+            drain_pipe(_output_pipe, result.output);
+            drain_pipe(_error_pipe, result.error);
+            if (waitpid(_pid, &status, WNOHANG) == _pid)
+            {
+                // output written before the exit is still in the pipes
+                drain_pipe(_output_pipe, result.output);
+                drain_pipe(_error_pipe, result.error);
+                break;
+            }
+            if (killed)
+            {
+                continue;
+            }
+            if (_cancel_requested)
+            {
+                result.cancelled = true;
+            }
+            else if (_options.timeout.count() > 0 &&
+                     std::chrono::steady_clock::now() - _start_time > _options.timeout)
+            {
+                result.timed_out = true;
+            }
+            if (result.cancelled || result.timed_out)
+            {
+                kill(_pid, SIGKILL);
+                killed = true;
+            }
+        }
+        result.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        _pid = -1;
+        for (int *fd : {&_output_pipe, &_error_pipe})
+        {
+            if (*fd >= 0)
+                close(*fd);
+            *fd = -1;
+        }
+        finish(std::move(result), self);
+    }
+    catch (...)
+    {
+        _promise.set_exception(std::current_exception());
+        _finished = true;
+    }
+}
+#endif
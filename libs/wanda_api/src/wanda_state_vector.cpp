@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <wanda_state_vector.h>
+
+wanda_state_vector_layout::wanda_state_vector_layout(const std::vector<wanda_state_entry> &quantities)
+{
+    for (auto &quantity : quantities)
+    {
+        add_entry(quantity.item, quantity.property, quantity.count, quantity.pipe_vector);
+    }
+}
+
+wanda_state_vector_layout::~wanda_state_vector_layout() = default;
+
+void wanda_state_vector_layout::add_entry(const std::string &item, const std::string &property, std::size_t count,
+                                          bool pipe_vector)
+{
+    _entries.push_back({item, property, _size, count, pipe_vector});
+    _size += count;
+}
+
+const wanda_state_entry &wanda_state_vector_layout::get_entry(const std::string &item,
+                                                              const std::string &property) const
+{
+    for (auto &entry : _entries)
+    {
+        if (entry.item == item && entry.property == property)
+        {
+            return entry;
+        }
+    }
+    throw std::invalid_argument(item + " " + property + " is not part of the state");
+}
+
+void wanda_state_vector_layout::check_size(std::size_t size) const
+{
+    if (size != _size)
+    {
+        throw std::invalid_argument("State vector has " + std::to_string(size) + " values, the layout " +
+                                    std::to_string(_size));
+    }
+}
+
+bool wanda_state_vector_layout::has_pipe_quantities() const
+{
+    return std::any_of(_entries.begin(), _entries.end(),
+                       [](const wanda_state_entry &entry) { return entry.pipe_vector; });
+}
+
+void wanda_state_vector_layout::bind_output(const std::vector<std::span<const float>> &series)
+{
+    if (series.size() != _size)
+    {
+        throw std::invalid_argument("Got " + std::to_string(series.size()) + " series for a state of " +
+                                    std::to_string(_size) + " values");
+    }
+    _output_sources.clear();
+    _output_sources.reserve(_size);
+    _number_of_time_steps = _entries.empty() ? 0 : SIZE_MAX;
+    for (auto &values : series)
+    {
+        _output_sources.push_back(values.data());
+        _number_of_time_steps = std::min(_number_of_time_steps, values.size());
+    }
+}
+
+void wanda_state_vector_layout::gather_output(std::size_t time_step, std::span<double> state) const
+{
+    check_size(state.size());
+    if (_output_sources.size() != _size)
+    {
+        throw std::runtime_error("The output is not bound to the state vector layout");
+    }
+    if (time_step >= _number_of_time_steps)
+    {
+        throw std::out_of_range("Time step " + std::to_string(time_step) + " is not in the output");
+    }
+    const float *const *sources = _output_sources.data();
+    double *values = state.data();
+    for (std::size_t i = 0; i < _size; i++)
+    {
+        values[i] = sources[i][time_step];
+    }
+}
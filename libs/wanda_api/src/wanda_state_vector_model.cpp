@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <stdexcept>
+#include <wanda_engine.h>
+#include <wanda_state_vector.h>
+#include <wandamodel.h>
+
+namespace
+{
+wanda_property &get_state_property(wanda_model &model, const wanda_state_entry &entry)
+{
+    if (model.component_exists(entry.item))
+    {
+        return model.get_component(entry.item).get_property(entry.property);
+    }
+    return model.get_node(entry.item).get_property(entry.property);
+}
+
+template <typename T> void sort_by_name(std::vector<T *> &items)
+{
+    std::sort(items.begin(), items.end(),
+              [](T *a, T *b) { return a->get_complete_name_spec() < b->get_complete_name_spec(); });
+}
+} // namespace
+
+wanda_state_vector_layout::wanda_state_vector_layout(wanda_model &model, const wanda_state_vector_spec &spec)
+{
+    auto pipes = model.get_all_pipes();
+    sort_by_name(pipes);
+    for (auto pipe : pipes)
+    {
+        if (pipe->is_disused())
+            continue;
+        for (auto &quantity : spec.pipe_quantities)
+        {
+            if (!pipe->contains_property(quantity))
+                continue;
+            auto &property = pipe->get_property(quantity);
+            add_entry(pipe->get_complete_name_spec(), quantity, property.get_number_of_elements() + 1, true);
+        }
+    }
+
+    auto nodes = model.get_all_nodes();
+    sort_by_name(nodes);
+    for (auto node : nodes)
+    {
+        if (node->is_disused())
+            continue;
+        for (auto &quantity : spec.node_quantities)
+        {
+            if (node->contains_property(quantity))
+            {
+                add_entry(node->get_complete_name_spec(), quantity, 1, false);
+            }
+        }
+    }
+
+    if (spec.component_quantities.empty())
+        return;
+    auto components = model.get_all_components();
+    sort_by_name(components);
+    for (auto component : components)
+    {
+        auto quantities = spec.component_quantities.find(component->get_class_sort_key());
+        if (component->is_disused() || component->is_pipe() || quantities == spec.component_quantities.end())
+            continue;
+        for (auto &quantity : quantities->second)
+        {
+            if (component->contains_property(quantity))
+            {
+                add_entry(component->get_complete_name_spec(), quantity, 1, false);
+            }
+        }
+    }
+}
+
+void wanda_state_vector_layout::bind_output(wanda_model &model)
+{
+    std::vector<std::span<const float>> series;
+    series.reserve(_size);
+    for (auto &entry : _entries)
+    {
+        auto &property = get_state_property(model, entry);
+        for (std::size_t element = 0; element < entry.count; element++)
+        {
+            series.push_back(property.get_series_view(static_cast<int>(element)));
+        }
+    }
+    bind_output(series);
+}
+
+void wanda_state_vector_layout::bind_engine(wanda_engine &engine)
+{
+    _handles.clear();
+    _handles.reserve(_entries.size());
+    for (auto &entry : _entries)
+    {
+        _handles.push_back(engine.get_handle(entry.item, entry.property, entry.pipe_vector));
+        if (static_cast<std::size_t>(_handles.back().count) != entry.count)
+        {
+            throw std::runtime_error(entry.item + " has a different number of elements in the engine");
+        }
+    }
+    _engine = &engine;
+}
+
+void wanda_state_vector_layout::gather_engine(std::span<double> state)
+{
+    check_size(state.size());
+    if (_engine == nullptr)
+    {
+        throw std::runtime_error("The engine is not bound to the state vector layout");
+    }
+    for (std::size_t i = 0; i < _entries.size(); i++)
+    {
+        _engine->get_values(_handles[i], state.data() + _entries[i].offset);
+    }
+}
+
+void wanda_state_vector_layout::scatter_engine(std::span<const double> state)
+{
+    check_size(state.size());
+    // the engine has no setter for pipe vectors, a partly scattered state would be inconsistent
+    if (has_pipe_quantities())
+    {
+        throw std::invalid_argument("The engine can't set pipe quantities, the state can't be scattered");
+    }
+    if (_engine == nullptr)
+    {
+        throw std::runtime_error("The engine is not bound to the state vector layout");
+    }
+    for (std::size_t i = 0; i < _entries.size(); i++)
+    {
+        _engine->set_values(_handles[i], state.data() + _entries[i].offset);
+    }
+}
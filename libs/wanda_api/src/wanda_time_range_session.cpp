@@ -0,0 +1,244 @@
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <wanda_engine.h>
+#include <wanda_time_range_session.h>
+#include <wanda_trace.h>
+#include <wandamodel.h>
+
+struct wanda_time_range_session::resolved_item
+{
+    wanda_engine_handle handle;
+    // used without the engine
+    wanda_property *property = nullptr;
+    size_t size = 1;
+    bool pipe_vector = false;
+};
+
+wanda_time_range_session::wanda_time_range_session(wanda_model &model,
+                                                   std::vector<wanda_session_subscription> subscriptions,
+                                                   wanda_session_mode mode)
+    : _model(model), _subscriptions(std::move(subscriptions))
+{
+    if (_model.is_modified())
+    {
+        _model.save_model_input();
+    }
+    if (mode != wanda_session_mode::files)
+    {
+        try
+        {
+            _engine = wanda_engine::get_instance(_model.get_wandabin());
+        }
+        catch (std::runtime_error &)
+        {
+            // the engine dll is not available
+            if (mode == wanda_session_mode::engine)
+                throw;
+        }
+    }
+    if (_engine != nullptr)
+    {
+        _engine->initialize_engine(_model.get_case_path());
+        _engine->run_steady();
+        _current_time = _engine->get_start_time();
+        _end_time = _engine->get_end_time();
+        // resolved once, every time step reads the values by handle
+        for (auto &subscription : _subscriptions)
+        {
+            _subscription_handles.push_back(
+                _engine->get_handle(subscription.component, subscription.property, subscription.pipe_vector));
+        }
+    }
+    else
+    {
+        _current_time = _model.get_property("Start time").get_scalar_float();
+        _end_time = _model.get_property("Simulation time").get_scalar_float();
+    }
+    _start_time = _current_time;
+}
+
+wanda_time_range_session::~wanda_time_range_session()
+{
+    if (_engine != nullptr)
+    {
+        _engine->close_engine();
+    }
+}
+
+wanda_time_window wanda_time_range_session::advance_to(double end_time)
+{
+    WANDA_TRACE_SCOPE("wanda_time_range_session::advance_to");
+    if (end_time <= _current_time)
+    {
+        throw std::invalid_argument("End time " + std::to_string(end_time) + " is not after the current time " +
+                                    std::to_string(_current_time));
+    }
+    if (end_time > _end_time)
+    {
+        throw std::invalid_argument("End time " + std::to_string(end_time) + " is after the end of the simulation " +
+                                    std::to_string(_end_time));
+    }
+    return _engine != nullptr ? advance_engine(end_time) : advance_files(end_time);
+}
+
+void wanda_time_range_session::set_value(const std::string &component, const std::string &property, double value)
+{
+    if (_engine != nullptr)
+    {
+        _engine->set_value(component, property, value);
+        return;
+    }
+    // the input is saved before the next window is computed
+    _model.get_component(component).get_property(property).set_scalar(static_cast<float>(value));
+}
+
+size_t wanda_time_range_session::resolve_item(const wanda_session_subscription &quantity)
+{
+    resolved_item item;
+    item.pipe_vector = quantity.pipe_vector;
+    if (_engine != nullptr)
+    {
+        item.handle = _engine->get_handle(quantity.component, quantity.property, quantity.pipe_vector);
+        item.size = static_cast<size_t>(item.handle.count);
+    }
+    else
+    {
+        item.property = &_model.get_component(quantity.component).get_property(quantity.property);
+        item.size = quantity.pipe_vector ? item.property->get_number_of_elements() + 1 : 1;
+    }
+    _items.push_back(item);
+    return _items.size() - 1;
+}
+
+size_t wanda_time_range_session::get_item_size(size_t item) const
+{
+    return _items.at(item).size;
+}
+
+void wanda_time_range_session::get_item_values(size_t item, std::span<double> values)
+{
+    auto &resolved = _items.at(item);
+    if (values.size() != resolved.size)
+    {
+        throw std::invalid_argument("Item " + std::to_string(item) + " has " + std::to_string(resolved.size) +
+                                    " values, not " + std::to_string(values.size()));
+    }
+    if (_engine != nullptr)
+    {
+        _engine->get_values(resolved.handle, values.data());
+        return;
+    }
+    if (!resolved.property->is_output())
+    {
+        values[0] = resolved.property->get_scalar_float();
+        return;
+    }
+    for (size_t element = 0; element < resolved.size; element++)
+    {
+        auto series = resolved.property->get_series_view(static_cast<int>(element));
+        if (series.empty())
+        {
+            throw std::runtime_error(resolved.property->get_description() + " has not been computed yet");
+        }
+        values[element] = series.back();
+    }
+}
+
+void wanda_time_range_session::set_item_values(size_t item, std::span<const double> values)
+{
+    auto &resolved = _items.at(item);
+    if (values.size() != resolved.size)
+    {
+        throw std::invalid_argument("Item " + std::to_string(item) + " has " + std::to_string(resolved.size) +
+                                    " values, not " + std::to_string(values.size()));
+    }
+    if (_engine != nullptr)
+    {
+        _engine->set_values(resolved.handle, values.data());
+        return;
+    }
+    if (resolved.pipe_vector || !resolved.property->is_input())
+    {
+        throw std::invalid_argument(resolved.property->get_description() + " is not an input which can be set");
+    }
+    resolved.property->set_scalar(static_cast<float>(values[0]));
+}
+
+wanda_time_window wanda_time_range_session::create_window() const
+{
+    wanda_time_window window;
+    window.values.resize(_subscriptions.size());
+    window.widths.resize(_subscriptions.size(), 1);
+    return window;
+}
+
+wanda_time_window wanda_time_range_session::advance_engine(double end_time)
+{
+    auto window = create_window();
+    const double delta_t = _engine->get_delta_t();
+    const double half_step = 0.5 * delta_t;
+    const auto steps = static_cast<size_t>(std::ceil((end_time - _current_time) / delta_t));
+    window.times.reserve(steps);
+    for (size_t i = 0; i < _subscription_handles.size(); i++)
+    {
+        window.widths[i] = _subscription_handles[i].count;
+        window.values[i].reserve(steps * static_cast<size_t>(_subscription_handles[i].count));
+    }
+    while (_current_time + half_step < end_time)
+    {
+        _engine->run_time_step();
+        _current_time = _engine->get_current_time();
+        window.times.push_back(_current_time);
+        for (size_t i = 0; i < _subscription_handles.size(); i++)
+        {
+            auto &values = window.values[i];
+            const size_t offset = values.size();
+            values.resize(offset + static_cast<size_t>(_subscription_handles[i].count));
+            _engine->get_values(_subscription_handles[i], values.data() + offset);
+        }
+    }
+    return window;
+}
+
+wanda_time_window wanda_time_range_session::advance_files(double end_time)
+{
+    if (_model.is_modified())
+    {
+        _model.save_model_input();
+    }
+    // the run restarts at the last computed step, so the window is independent of the Simulation time in the case
+    _model.run_unsteady_window(static_cast<float>(_current_time), static_cast<float>(end_time));
+    auto window = create_window();
+    auto times = _model.get_time_steps();
+    auto [first, last] = get_window_steps(times, _current_time, end_time);
+    for (size_t step = first; step < last; step++)
+    {
+        window.times.push_back(times[step]);
+    }
+    for (size_t i = 0; i < _subscriptions.size(); i++)
+    {
+        auto &subscription = _subscriptions[i];
+        auto &property = _model.get_component(subscription.component).get_property(subscription.property);
+        const int elements = subscription.pipe_vector ? property.get_number_of_elements() + 1 : 1;
+        window.widths[i] = elements;
+        std::vector<std::span<const float>> series;
+        for (int element = 0; element < elements; element++)
+        {
+            series.push_back(property.get_series_view(element));
+        }
+        window.values[i].reserve((last - first) * static_cast<size_t>(elements));
+        for (size_t step = first; step < last; step++)
+        {
+            for (auto &element_series : series)
+            {
+                window.values[i].push_back(element_series[step]);
+            }
+        }
+    }
+    if (!window.times.empty())
+    {
+        _current_time = window.times.back();
+    }
+    return window;
+}
@@ -0,0 +1,18 @@
+#include <wanda_time_range_session.h>
+
+wanda_window_steps get_window_steps(std::span<const float> times, double current_time, double end_time)
+{
+    const auto after = static_cast<float>(current_time);
+    const auto until = static_cast<float>(end_time);
+    wanda_window_steps steps;
+    while (steps.first < times.size() && times[steps.first] <= after)
+    {
+        steps.first++;
+    }
+    steps.last = steps.first;
+    while (steps.last < times.size() && times[steps.last] <= until)
+    {
+        steps.last++;
+    }
+    return steps;
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <wanda_trace.h>
+
+std::atomic<bool> wanda_trace::_enabled{false};
+
+namespace
+{
+struct trace_event
+{
+    const char *name;
+    const char *category;
+    std::int64_t begin_ns;
+    std::int64_t duration_ns;
+    wanda_nefis_counters nefis;
+};
+
+// spans of one thread, written only by that thread and read by the exporter up to size
+struct thread_buffer
+{
+    thread_buffer(std::size_t capacity, std::uint32_t id, std::uint64_t buffer_generation)
+        : events(capacity), thread_id(id), generation(buffer_generation)
+    {
+    }
+    std::vector<trace_event> events;
+    std::atomic<std::size_t> size{0};
+    std::atomic<std::size_t> dropped{0};
+    std::uint32_t thread_id;
+    std::uint64_t generation;
+};
+
+// buffers of all threads, only locked when a thread records its first span after enable() or clear()
+struct trace_registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<thread_buffer>> buffers;
+    std::size_t capacity = 65536;
+    std::atomic<std::uint64_t> generation{1};
+    std::uint32_t next_thread_id = 1;
+};
+
+trace_registry &get_registry()
+{
+    static trace_registry registry;
+    return registry;
+}
+
+const wanda_trace::clock::time_point trace_epoch = wanda_trace::clock::now();
+
+thread_local std::shared_ptr<thread_buffer> local_buffer;
+thread_local wanda_nefis_counters local_nefis;
+
+thread_buffer *get_local_buffer()
+{
+    auto &registry = get_registry();
+    auto generation = registry.generation.load(std::memory_order_acquire);
+    if (!local_buffer || local_buffer->generation != generation)
+    {
+        std::lock_guard lock(registry.mutex);
+        local_buffer = std::make_shared<thread_buffer>(registry.capacity, registry.next_thread_id++,
+                                                       registry.generation.load(std::memory_order_relaxed));
+        registry.buffers.push_back(local_buffer);
+    }
+    return local_buffer.get();
+}
+
+void write_json_string(std::ostream &stream, const char *text)
+{
+    stream << '"';
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            stream << '\\';
+        }
+        stream << *c;
+    }
+    stream << '"';
+}
+
+// Chrome traces are in microseconds, written with nanosecond resolution
+void write_microseconds(std::ostream &stream, std::int64_t nanoseconds)
+{
+    nanoseconds = std::max<std::int64_t>(nanoseconds, 0);
+    auto fraction = std::to_string(1000 + nanoseconds % 1000);
+    stream << nanoseconds / 1000 << '.' << fraction.substr(1);
+}
+} // namespace
+
+void wanda_trace::enable(std::size_t events_per_thread)
+{
+    if (events_per_thread == 0)
+    {
+        throw std::invalid_argument("A trace needs room for at least one event per thread");
+    }
+    auto &registry = get_registry();
+    {
+        std::lock_guard lock(registry.mutex);
+        if (registry.capacity != events_per_thread)
+        {
+            // threads get buffers of the new size at their next span
+            registry.capacity = events_per_thread;
+            registry.generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+void wanda_trace::disable() noexcept
+{
+    _enabled.store(false, std::memory_order_relaxed);
+}
+
+void wanda_trace::clear()
+{
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    registry.buffers.clear();
+    registry.next_thread_id = 1;
+    registry.generation.fetch_add(1, std::memory_order_release);
+}
+
+void wanda_trace::record(const char *name, const char *category, clock::time_point begin, clock::time_point end,
+                         const wanda_nefis_counters &nefis) noexcept
+{
+    thread_buffer *buffer = nullptr;
+    try
+    {
+        buffer = get_local_buffer();
+    }
+    catch (...)
+    {
+        return; // no memory for the buffer, the span is lost
+    }
+    auto index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->events.size())
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = {name, category,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(begin - trace_epoch).count(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(), nefis};
+    // publishes the event to the exporter
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void wanda_trace::count_nefis(std::uint64_t bytes) noexcept
+{
+    if (is_enabled())
+    {
+        local_nefis.calls++;
+        local_nefis.bytes += bytes;
+    }
+}
+
+wanda_nefis_counters wanda_trace::get_nefis_counters() noexcept
+{
+    return local_nefis;
+}
+
+std::size_t wanda_trace::get_number_of_events()
+{
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    std::size_t events = 0;
+    for (auto &buffer : registry.buffers)
+    {
+        events += buffer->size.load(std::memory_order_acquire);
+    }
+    return events;
+}
+
+std::size_t wanda_trace::get_dropped_events()
+{
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    std::size_t dropped = 0;
+    for (auto &buffer : registry.buffers)
+    {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void wanda_trace::write_chrome_trace(std::ostream &stream)
+{
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    std::size_t dropped = 0;
+    bool first = true;
+    auto separator = [&]() -> std::ostream & {
+        stream << (first ? "\n" : ",\n");
+        first = false;
+        return stream;
+    };
+    stream << "{\"traceEvents\":[";
+    for (auto &buffer : registry.buffers)
+    {
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id
+                    << ",\"args\":{\"name\":\"thread " << buffer->thread_id << "\"}}";
+        auto size = buffer->size.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            auto &event = buffer->events[i];
+            separator() << "{\"name\":";
+            write_json_string(stream, event.name);
+            stream << ",\"cat\":";
+            write_json_string(stream, event.category);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            write_microseconds(stream, event.begin_ns);
+            stream << ",\"dur\":";
+            write_microseconds(stream, event.duration_ns);
+            stream << ",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"nefis_calls\":" << event.nefis.calls
+                   << ",\"nefis_bytes\":" << event.nefis.bytes << "}}";
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+}
+
+void wanda_trace::write_chrome_trace(const std::string &file)
+{
+    std::ofstream stream(file);
+    if (!stream)
+    {
+        throw std::runtime_error("Cannot write trace to " + file);
+    }
+    write_chrome_trace(stream);
+}
@@ -0,0 +1,351 @@
+#include "coupling_driver.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+#include <wanda_time_range_session.h>
+#include <wanda_metrics.h>
+#include <wanda_trace.h>
+#include <wandamodel.h>
+
+namespace mgwso {
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  std::vector<std::string> split_csv_line(const std::string &line)
+  {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+      if (field.size() >= 2 && field.front() == '"' && field.back() == '"') { field = field.substr(1, field.size() - 2); }
+      fields.push_back(field);
+    }
+    return fields;
+  }
+
+  // names of the columns of a window, one per value of a step
+  std::vector<std::string> get_column_names(const std::vector<std::string> &quantities, const wanda_time_window &window,
+    size_t first)
+  {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < quantities.size(); i++) {
+      const int width = window.widths[first + i];
+      if (width == 1 && !quantities[i].ends_with("[]")) {
+        names.push_back(quantities[i]);
+        continue;
+      }
+      auto base = quantities[i].substr(0, quantities[i].size() - 2);
+      for (int element = 0; element < width; element++) {
+        names.push_back(base + "[" + std::to_string(element) + "]");
+      }
+    }
+    return names;
+  }
+}// namespace
+
+// splits "ITEM/Property" or "ITEM/Property[]" into a subscription
+wanda_session_subscription parse_quantity(const std::string &quantity)
+{
+  auto separator = quantity.find('/');
+  if (separator == std::string::npos || separator == 0 || separator + 1 == quantity.size()) {
+    throw std::invalid_argument("Quantity " + quantity + " is not of the form ITEM/Property");
+  }
+  wanda_session_subscription subscription;
+  subscription.component = quantity.substr(0, separator);
+  subscription.property = quantity.substr(separator + 1);
+  if (subscription.property.ends_with("[]")) {
+    subscription.property.resize(subscription.property.size() - 2);
+    subscription.pipe_vector = true;
+  }
+  return subscription;
+}
+
+wanda_session_mode parse_mode(const std::string &mode)
+{
+  if (mode == "automatic") { return wanda_session_mode::automatic; }
+  if (mode == "engine") { return wanda_session_mode::engine; }
+  if (mode == "files") { return wanda_session_mode::files; }
+  throw std::invalid_argument("Unknown mode " + mode + ", use automatic, engine or files");
+}
+
+void copy_case(const std::filesystem::path &case_file, const std::filesystem::path &directory)
+{
+  namespace fs = std::filesystem;
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  // .wdi, .wdo, .wdx, ...
+  auto case_directory = case_file.parent_path().empty() ? fs::path(".") : case_file.parent_path();
+  for (auto &entry : fs::directory_iterator(case_directory)) {
+    if (entry.is_regular_file() && entry.path().stem() == case_file.stem()) {
+      fs::copy_file(entry.path(), directory / entry.path().filename(), fs::copy_options::overwrite_existing);
+    }
+  }
+}
+
+file_coupling_adapter::file_coupling_adapter(const std::string &boundary_file, std::string exchange_file)
+  : _exchange_file(std::move(exchange_file))
+{
+  if (boundary_file.empty()) { return; }
+  std::ifstream stream(boundary_file);
+  if (!stream) { throw std::runtime_error("Could not open boundary file " + boundary_file); }
+  std::string line;
+  if (!std::getline(stream, line)) { throw std::runtime_error("Boundary file " + boundary_file + " is empty"); }
+  auto header = split_csv_line(line);
+  for (size_t i = 1; i < header.size(); i++) {
+    auto subscription = parse_quantity(header[i]);
+    _columns.push_back({ subscription.component, subscription.property, 0.0 });
+  }
+  while (std::getline(stream, line)) {
+    if (line.empty()) { continue; }
+    auto fields = split_csv_line(line);
+    if (fields.size() != header.size()) {
+      throw std::runtime_error("Row at time " + fields.front() + " of " + boundary_file + " has the wrong number of columns");
+    }
+    _times.push_back(std::stod(fields[0]));
+    std::vector<double> row;
+    for (size_t i = 1; i < fields.size(); i++) { row.push_back(std::stod(fields[i])); }
+    _rows.push_back(std::move(row));
+  }
+}
+
+std::vector<boundary_value> file_coupling_adapter::get_boundary_values(double start_time, double)
+{
+  if (_times.empty() || _times.front() > start_time) { return {}; }
+  size_t row = 0;
+  while (row + 1 < _times.size() && _times[row + 1] <= start_time) { row++; }
+  auto values = _columns;
+  for (size_t i = 0; i < values.size(); i++) { values[i].value = _rows[row][i]; }
+  return values;
+}
+
+void file_coupling_adapter::put_exchange_values(double end_time, const std::vector<std::string> &names,
+  const std::vector<double> &values)
+{
+  if (_exchange_file.empty()) { return; }
+  std::ofstream stream(_exchange_file, _header_written ? std::ios::app : std::ios::trunc);
+  if (!stream) { throw std::runtime_error("Could not open exchange file " + _exchange_file); }
+  if (!_header_written) {
+    stream << "time";
+    for (auto &name : names) { stream << ",\"" << name << '"'; }
+    stream << '\n';
+    _header_written = true;
+  }
+  stream << end_time;
+  for (auto value : values) { stream << ',' << value; }
+  stream << '\n';
+}
+
+shm_coupling_adapter::shm_coupling_adapter(const std::string &channel, const std::vector<std::string> &boundaries,
+  const std::vector<std::string> &exchange, std::chrono::milliseconds timeout)
+  : _timeout(timeout)
+{
+  for (auto &quantity : boundaries) {
+    auto subscription = parse_quantity(quantity);
+    if (subscription.pipe_vector) {
+      throw std::invalid_argument("The shm adapter can not set all elements of " + quantity);
+    }
+    _boundaries.push_back({ subscription.component, subscription.property, 0.0 });
+  }
+  for (auto &quantity : exchange) {
+    if (parse_quantity(quantity).pipe_vector) {
+      throw std::invalid_argument("The shm adapter can not exchange all elements of " + quantity);
+    }
+  }
+  // the driver owns the channel, rings left behind by a crashed run are replaced
+  if (!boundaries.empty()) {
+    _boundary_ring = std::make_unique<shm_ring>(
+      channel + "_boundary", frame_layout(boundaries), 64, shm_open_mode::create);
+  }
+  if (!exchange.empty()) {
+    _exchange_ring = std::make_unique<shm_ring>(
+      channel + "_exchange", frame_layout(exchange), 64, shm_open_mode::create);
+  }
+  _frame.resize(boundaries.size());
+}
+
+std::vector<boundary_value> shm_coupling_adapter::get_boundary_values(double start_time, double)
+{
+  if (!_boundary_ring) { return {}; }
+  double time = 0.0;
+  _boundary_ring->pop(time, _frame, _timeout);
+  if (time != start_time) {
+    spdlog::warn("Boundary frame for time {} received for the range starting at {}", time, start_time);
+  }
+  auto values = _boundaries;
+  for (size_t i = 0; i < values.size(); i++) { values[i].value = _frame[i]; }
+  return values;
+}
+
+void shm_coupling_adapter::put_exchange_values(double end_time, const std::vector<std::string> &,
+  const std::vector<double> &values)
+{
+  if (_exchange_ring) { _exchange_ring->push(end_time, values, _timeout); }
+}
+
+std::unique_ptr<coupling_adapter> make_coupling_adapter(const coupling_config &config)
+{
+  if (config.adapter == "none") { return std::make_unique<null_coupling_adapter>(); }
+  if (config.adapter == "file") {
+    return std::make_unique<file_coupling_adapter>(config.boundary_file, config.exchange_file);
+  }
+  if (config.adapter == "shm") {
+    auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::duration<double>(config.channel_timeout));
+    return std::make_unique<shm_coupling_adapter>(config.channel, config.boundaries, config.exchange, timeout);
+  }
+  throw std::invalid_argument("Unknown adapter " + config.adapter + ", use none, file or shm");
+}
+
+coupling_driver::coupling_driver(coupling_config config, std::unique_ptr<coupling_adapter> adapter)
+  : _config(std::move(config)), _adapter(std::move(adapter))
+{
+  if (_config.model.empty()) { throw std::invalid_argument("No model given"); }
+  if (_config.ranges.empty()) { throw std::invalid_argument("No time ranges given"); }
+  for (size_t i = 1; i < _config.ranges.size(); i++) {
+    if (_config.ranges[i] <= _config.ranges[i - 1]) {
+      throw std::invalid_argument("Time ranges must end at increasing times");
+    }
+  }
+}
+
+void coupling_driver::run()
+{
+  // outputs and exchanged quantities are both subscriptions of the session, the exchanged ones after the outputs
+  std::vector<wanda_session_subscription> subscriptions;
+  for (auto &quantity : _config.outputs) { subscriptions.push_back(parse_quantity(quantity)); }
+  for (auto &quantity : _config.exchange) { subscriptions.push_back(parse_quantity(quantity)); }
+  std::filesystem::create_directories(_config.output_directory);
+
+  auto start = clock::now();
+  const std::filesystem::path case_file(_config.model);
+  if (!std::filesystem::exists(case_file)) { throw std::invalid_argument("Case does not exist: " + _config.model); }
+  const auto directory = case_file.parent_path() / (case_file.stem().string() + "_coupling");
+  copy_case(case_file, directory);
+  // declared before the model, so the copy is removed after the model is closed, also after an error
+  struct working_copy {
+    std::filesystem::path directory;
+    ~working_copy()
+    {
+      std::error_code error;
+      std::filesystem::remove_all(directory, error);
+    }
+  } copy{ directory };
+  wanda_model model((directory / case_file.filename()).string(), _config.wanda_bin);
+  {
+    wanda_time_range_session session(model, subscriptions, parse_mode(_config.mode));
+    _open_time = clock::now() - start;
+    spdlog::info("Opened {} in {:.3f} s, {}", _config.model, _open_time.count(),
+      session.uses_engine() ? "using the Wanda engine" : "using the case files");
+
+    _timings.clear();
+    for (size_t index = 0; index < _config.ranges.size(); index++) {
+      const double end_time = _config.ranges[index];
+      wanda_trace_span range_span("coupling range", "mgwso");
+      range_timing timing;
+      timing.end_time = end_time;
+
+      auto phase = clock::now();
+      for (auto &boundary : _adapter->get_boundary_values(session.get_current_time(), end_time)) {
+        session.set_value(boundary.item, boundary.property, boundary.value);
+      }
+      timing.boundary = clock::now() - phase;
+
+      phase = clock::now();
+      auto window = session.advance_to(end_time);
+      timing.advance = clock::now() - phase;
+
+      phase = clock::now();
+      if (!_config.exchange.empty()) {
+        auto names = get_column_names(_config.exchange, window, _config.outputs.size());
+        std::vector<double> values;
+        for (size_t i = _config.outputs.size(); i < subscriptions.size(); i++) {
+          auto &series = window.values[i];
+          auto width = static_cast<size_t>(window.widths[i]);
+          if (series.size() >= width) { values.insert(values.end(), series.end() - width, series.end()); }
+        }
+        if (values.size() != names.size()) {
+          throw std::runtime_error("No exchange values computed for the range ending at " + std::to_string(end_time));
+        }
+        _adapter->put_exchange_values(end_time, names, values);
+      }
+      timing.exchange = clock::now() - phase;
+
+      phase = clock::now();
+      if (!_config.outputs.empty()) {
+        write_range(index, window, get_column_names(_config.outputs, window, 0));
+      }
+      timing.output = clock::now() - phase;
+
+      spdlog::info("Range {} until {}: {} steps in {:.3f} s (boundary {:.3f}, advance {:.3f}, exchange {:.3f}, "
+                   "output {:.3f})",
+        index + 1,
+        end_time,
+        window.times.size(),
+        timing.total().count(),
+        timing.boundary.count(),
+        timing.advance.count(),
+        timing.exchange.count(),
+        timing.output.count());
+      _timings.push_back(timing);
+      if (!_config.metrics_file.empty()) { wanda_metrics::write_prometheus(_config.metrics_file); }
+    }
+  }
+  model.close();
+  write_timings((std::filesystem::path(_config.output_directory) / "timings.csv").string());
+
+  range_timing sum;
+  for (auto &timing : _timings) {
+    sum.boundary += timing.boundary;
+    sum.advance += timing.advance;
+    sum.exchange += timing.exchange;
+    sum.output += timing.output;
+  }
+  spdlog::info("{} ranges in {:.3f} s: open {:.3f}, boundary {:.3f}, advance {:.3f}, exchange {:.3f}, output {:.3f}",
+    _timings.size(),
+    _open_time.count() + sum.total().count(),
+    _open_time.count(),
+    sum.boundary.count(),
+    sum.advance.count(),
+    sum.exchange.count(),
+    sum.output.count());
+  if (!_config.metrics_file.empty()) { wanda_metrics::write_prometheus(_config.metrics_file); }
+}
+
+void coupling_driver::write_range(size_t index, const wanda_time_window &window,
+  const std::vector<std::string> &names) const
+{
+  auto file = std::filesystem::path(_config.output_directory) / ("range_" + std::to_string(index + 1) + ".csv");
+  std::ofstream stream(file);
+  if (!stream) { throw std::runtime_error("Could not open " + file.string()); }
+  stream << "time";
+  for (auto &name : names) { stream << ",\"" << name << '"'; }
+  stream << '\n';
+  for (size_t step = 0; step < window.times.size(); step++) {
+    stream << window.times[step];
+    for (size_t i = 0; i < _config.outputs.size(); i++) {
+      auto width = static_cast<size_t>(window.widths[i]);
+      for (size_t element = 0; element < width; element++) { stream << ',' << window.values[i][step * width + element]; }
+    }
+    stream << '\n';
+  }
+}
+
+void coupling_driver::write_timings(const std::string &file) const
+{
+  std::ofstream stream(file);
+  if (!stream) { throw std::runtime_error("Could not open " + file); }
+  stream << "range,end_time,boundary,advance,exchange,output,total\n";
+  stream << "open,,,,,," << _open_time.count() << '\n';
+  for (size_t i = 0; i < _timings.size(); i++) {
+    auto &timing = _timings[i];
+    stream << i + 1 << ',' << timing.end_time << ',' << timing.boundary.count() << ',' << timing.advance.count() << ','
+           << timing.exchange.count() << ',' << timing.output.count() << ',' << timing.total().count() << '\n';
+  }
+}
+
+}// namespace mgwso
@@ -0,0 +1,162 @@
+#ifndef MGWSO_COUPLING_DRIVER_HPP
+#define MGWSO_COUPLING_DRIVER_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wanda_time_range_session.h>
+
+#include "shm_channel.hpp"
+
+namespace mgwso {
+
+// Settings of a coupled run, read from the configuration file
+struct coupling_config {
+  std::string model;
+  std::string wanda_bin;
+  // automatic, engine or files, see wanda_session_mode
+  std::string mode = "automatic";
+  // end times of the consecutive time ranges
+  std::vector<double> ranges;
+  std::string output_directory = ".";
+  // quantities written per range as "ITEM/Property", "ITEM/Property[]" for all pipe elements
+  std::vector<std::string> outputs;
+  // quantities passed to the groundwater model at the end of every range
+  std::vector<std::string> exchange;
+  // none, file or shm
+  std::string adapter = "none";
+  std::string boundary_file;
+  std::string exchange_file;
+  // shm adapter: name of the channel and the quantities the groundwater model sets before every range
+  std::string channel = "mgwso";
+  std::vector<std::string> boundaries;
+  // shm adapter: seconds to wait for the groundwater model
+  double channel_timeout = 600.0;
+  // Prometheus text file with the metrics of the Wanda API, rewritten after every range
+  std::string metrics_file;
+  // OpenDA server: quantities of the state vector of every pipe and node, see wanda_state_vector_spec
+  // the engine can't set pipe quantities, so only a state without them can be set
+  std::vector<std::string> state_pipe_quantities;
+  std::vector<std::string> state_node_quantities{ "Head" };
+};
+
+// Value of an input of the WANDA model, set before a time range is computed
+struct boundary_value {
+  std::string item;
+  std::string property;
+  double value = 0.0;
+};
+
+// Connection to the groundwater model
+class coupling_adapter {
+public:
+  virtual ~coupling_adapter() = default;
+  // returns the boundary values for the range from start_time to end_time
+  virtual std::vector<boundary_value> get_boundary_values(double start_time, double end_time) = 0;
+  // receives the exchanged quantities at the end of a range, in the order of coupling_config::exchange
+  virtual void put_exchange_values(double end_time, const std::vector<std::string> &names,
+                                   const std::vector<double> &values) = 0;
+};
+
+// Adapter without groundwater model, the WANDA model runs stand alone
+class null_coupling_adapter : public coupling_adapter {
+public:
+  std::vector<boundary_value> get_boundary_values(double, double) override { return {}; }
+  void put_exchange_values(double, const std::vector<std::string> &, const std::vector<double> &) override {}
+};
+
+// Adapter which reads the boundary values from a file and writes the exchanged values to a file
+/*
+The boundary file is a comma separated table with a header "time,ITEM/Property,..."
+and one row per time. A range uses the last row at or before its start time.
+Every range appends one row with its end time and the exchanged values to the
+exchange file.
+*/
+class file_coupling_adapter : public coupling_adapter {
+public:
+  file_coupling_adapter(const std::string &boundary_file, std::string exchange_file);
+  std::vector<boundary_value> get_boundary_values(double start_time, double end_time) override;
+  void put_exchange_values(double end_time, const std::vector<std::string> &names,
+                           const std::vector<double> &values) override;
+
+private:
+  std::vector<boundary_value> _columns;
+  std::vector<double> _times;
+  std::vector<std::vector<double>> _rows;
+  std::string _exchange_file;
+  bool _header_written = false;
+};
+
+// Adapter which exchanges frames with the groundwater model over shared memory
+/*
+The channel consists of two rings, see shm_ring: "<channel>_boundary" carries
+a frame with the boundary values from the groundwater model before every range,
+"<channel>_exchange" carries a frame with the exchanged values back at the end
+of every range. The frame layouts are the boundary and exchange quantities of
+the configuration, the groundwater side must declare the same lists. Only
+scalar quantities can be exchanged.
+*/
+class shm_coupling_adapter : public coupling_adapter {
+public:
+  shm_coupling_adapter(const std::string &channel, const std::vector<std::string> &boundaries,
+    const std::vector<std::string> &exchange, std::chrono::milliseconds timeout);
+  std::vector<boundary_value> get_boundary_values(double start_time, double end_time) override;
+  void put_exchange_values(double end_time, const std::vector<std::string> &names,
+                           const std::vector<double> &values) override;
+
+private:
+  std::vector<boundary_value> _boundaries;
+  std::vector<double> _frame;
+  std::chrono::milliseconds _timeout;
+  std::unique_ptr<shm_ring> _boundary_ring;
+  std::unique_ptr<shm_ring> _exchange_ring;
+};
+
+std::unique_ptr<coupling_adapter> make_coupling_adapter(const coupling_config &config);
+// splits "ITEM/Property" or "ITEM/Property[]" into a subscription
+wanda_session_subscription parse_quantity(const std::string &quantity);
+wanda_session_mode parse_mode(const std::string &mode);
+// copies the files of the case, which all share the name of the wdi file, into an empty directory
+void copy_case(const std::filesystem::path &case_file, const std::filesystem::path &directory);
+
+// Wall clock time of the phases of one time range
+struct range_timing {
+  double end_time = 0.0;
+  std::chrono::duration<double> boundary{ 0.0 };
+  std::chrono::duration<double> advance{ 0.0 };
+  std::chrono::duration<double> exchange{ 0.0 };
+  std::chrono::duration<double> output{ 0.0 };
+  std::chrono::duration<double> total() const { return boundary + advance + exchange + output; }
+};
+
+// Opens the WANDA model once and advances it over the configured time ranges
+/*
+The model runs on a copy of the case in <case>_coupling next to the case,
+which is removed afterwards. In files mode every range rewrites the start and
+end time of the case and the boundary values change its input, the case of
+the user is left as it is.
+*/
+class coupling_driver {
+public:
+  coupling_driver(coupling_config config, std::unique_ptr<coupling_adapter> adapter);
+  void run();
+  // time to open the model and start the session
+  std::chrono::duration<double> get_open_time() const { return _open_time; }
+  const std::vector<range_timing> &get_timings() const { return _timings; }
+  void write_timings(const std::string &file) const;
+
+private:
+  coupling_config _config;
+  std::unique_ptr<coupling_adapter> _adapter;
+  std::chrono::duration<double> _open_time{ 0.0 };
+  std::vector<range_timing> _timings;
+
+  void write_range(size_t index, const wanda_time_window &window, const std::vector<std::string> &names) const;
+};
+
+}// namespace mgwso
+
+#endif
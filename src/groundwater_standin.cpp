@@ -0,0 +1,81 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <fmt/ranges.h>
+#include <spdlog/spdlog.h>
+
+#include "shm_channel.hpp"
+
+#include <internal_use_only/config.hpp>
+
+// Local stand-in for the groundwater model. It attaches to the shared memory
+// channel of the shm adapter, sends constant boundary values before every range
+// and reports the exchanged values and the time it waited for WANDA.
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app{ fmt::format("Groundwater stand-in, {} version {}", mgwso::cmake::project_name,
+      mgwso::cmake::project_version) };
+    std::string channel = "mgwso";
+    app.add_option("--channel", channel, "Shared memory channel, as given to mgwso");
+    std::vector<std::string> boundaries;
+    app.add_option("--boundaries", boundaries, "Quantities set in WANDA, as given to mgwso");
+    std::vector<double> values;
+    app.add_option("--values", values, "Value sent for every boundary quantity");
+    std::vector<std::string> exchange;
+    app.add_option("--exchange", exchange, "Quantities received from WANDA, as given to mgwso");
+    double start_time = 0.0;
+    app.add_option("--start", start_time, "Start time of the first range");
+    std::vector<double> ranges;
+    app.add_option("--ranges", ranges, "End times of the ranges, as given to mgwso")->required();
+    double timeout = 600.0;
+    app.add_option("--timeout", timeout, "Seconds to wait for WANDA");
+    bool clean = false;
+    app.add_flag("--clean", clean, "Remove the channel left behind by an earlier run first, when started before mgwso");
+    CLI11_PARSE(app, argc, argv);
+
+    if (values.size() != boundaries.size()) {
+      throw std::invalid_argument("Give a value for every boundary quantity");
+    }
+    if (clean) {
+      mgwso::shm_ring::remove(channel + "_boundary");
+      mgwso::shm_ring::remove(channel + "_exchange");
+    }
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(timeout));
+    // mgwso creates the channel, the stand-in waits for it
+    std::unique_ptr<mgwso::shm_ring> boundary_ring;
+    std::unique_ptr<mgwso::shm_ring> exchange_ring;
+    if (!boundaries.empty()) {
+      boundary_ring = std::make_unique<mgwso::shm_ring>(
+        channel + "_boundary", mgwso::frame_layout(boundaries), 64, mgwso::shm_open_mode::attach, wait);
+    }
+    if (!exchange.empty()) {
+      exchange_ring = std::make_unique<mgwso::shm_ring>(
+        channel + "_exchange", mgwso::frame_layout(exchange), 64, mgwso::shm_open_mode::attach, wait);
+    }
+
+    std::vector<double> received(exchange.size());
+    double time = start_time;
+    for (auto end_time : ranges) {
+      auto start = std::chrono::steady_clock::now();
+      if (boundary_ring) { boundary_ring->push(time, values, wait); }
+      if (exchange_ring) {
+        double frame_time = 0.0;
+        exchange_ring->pop(frame_time, received, wait);
+        if (frame_time != end_time) { spdlog::warn("Exchange frame for time {} expected at {}", frame_time, end_time); }
+      }
+      std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+      spdlog::info("t = {}: {} after {:.6f} s", end_time, fmt::join(received, ", "), waited.count());
+      time = end_time;
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in the groundwater stand-in: {}", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
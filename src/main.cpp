@@ -1,11 +1,12 @@
-
-#include<optional>
 #include<string>
 
 #include <CLI/CLI.hpp>
 #include <spdlog/spdlog.h>
-#include <wandamodel.h>
+#include <wanda_metrics.h>
+#include <wanda_trace.h>
 
+#include "coupling_driver.hpp"
+#include "openda_server.hpp"
 
 // This file will be generated automatically when cur_you run the CMake
 // configuration step. It creates a namespace called `mgwso`. You can modify
@@ -19,10 +20,31 @@ int main(int argc, const char **argv)
   try {
     CLI::App app{ fmt::format("{} version {}", mgwso::cmake::project_name, mgwso::cmake::project_version) };
 
-    std::optional<std::string> config_path;
-    app.add_option("-f,--file", config_path, "Configuration file path");
-    std::optional<std::string> model_path;
-    app.add_option("-m,--model", model_path, "model file path");
+    // every option can also be given in the configuration file, e.g. ranges = [60.0, 120.0]
+    app.set_config("-f,--file", "", "Configuration file path (TOML or INI)");
+    mgwso::coupling_config config;
+    app.add_option("-m,--model", config.model, "model file path");
+    app.add_option("-b,--wanda_bin", config.wanda_bin, "Wanda bin directory");
+    app.add_option("--mode", config.mode, "automatic, engine or files");
+    app.add_option("--ranges", config.ranges, "End times of the consecutive time ranges");
+    app.add_option("-o,--output_directory", config.output_directory, "Directory for the output per range");
+    app.add_option("--outputs", config.outputs, "Quantities written per range, ITEM/Property or ITEM/Property[]");
+    app.add_option("--exchange", config.exchange, "Quantities passed to the groundwater model");
+    app.add_option("--adapter", config.adapter, "Groundwater adapter: none, file or shm");
+    app.add_option("--boundary_file", config.boundary_file, "Boundary values for the file adapter");
+    app.add_option("--exchange_file", config.exchange_file, "Exchanged values written by the file adapter");
+    app.add_option("--channel", config.channel, "Shared memory channel of the shm adapter");
+    app.add_option("--boundaries", config.boundaries, "Quantities set by the groundwater model through the shm adapter");
+    app.add_option("--channel_timeout", config.channel_timeout, "Seconds the shm adapter waits for the groundwater model");
+    bool server = false;
+    app.add_flag("--server", server, "Serve the model to OpenDA instead of running the time ranges");
+    unsigned short port = 52525;
+    app.add_option("-p,--port", port, "Local port of the OpenDA server");
+    app.add_option("--state_pipes", config.state_pipe_quantities, "Pipe quantities in the OpenDA state, can't be set");
+    app.add_option("--state_nodes", config.state_node_quantities, "Node quantities in the OpenDA state");
+    std::string trace_file;
+    app.add_option("--trace", trace_file, "Write a Chrome trace of the run to this file, for chrome://tracing or Perfetto");
+    app.add_option("--metrics", config.metrics_file, "Write the metrics of the Wanda API to this Prometheus text file");
     bool show_version = false;
     app.add_flag("--version", show_version, "Show version information");
 
@@ -32,26 +54,39 @@ int main(int argc, const char **argv)
       fmt::print("{}\n", mgwso::cmake::project_version);
       return EXIT_SUCCESS;
     }
+    if (!trace_file.empty()) { wanda_trace::enable(); }
+    if (!config.metrics_file.empty()) { wanda_metrics::enable(); }
+    // the trace is also written when the run fails, that is when it is needed most
+    struct trace_writer {
+      const std::string &file;
+      ~trace_writer()
+      {
+        if (file.empty()) { return; }
+        try {
+          wanda_trace::write_chrome_trace(file);
+          spdlog::info("Trace written to {}, {} spans dropped", file, wanda_trace::get_dropped_events());
+        } catch (const std::exception &e) {
+          spdlog::error("Cannot write the trace: {}", e.what());
+        }
+      }
+    } write_trace{ trace_file };
     spdlog::info("Mooi-Goo Wanda Seawat OpenDA");
-    spdlog::info("Configuration file: {}", config_path.value_or("empty"));
-    spdlog::info("Model file: {}", model_path.value_or("not provided"));
-  } 
-  catch (const std::exception &e) {
-    spdlog::error("Unhandled exception in main: {}", e.what());
-  }
+    spdlog::info("Model file: {}", config.model.empty() ? "not provided" : config.model);
 
-  
-  try {
-    auto model = wanda_model("test.wdi", "c:\\Program Files (x86)\\Deltares\\Wanda 4.7\\Bin\\");
-    for(const auto& item: model.get_all_pipes()){
-      spdlog::info("Pipe: {}", item->get_complete_name_spec());
+    if (server) {
+      // the model is loaded once and reused by all instances OpenDA creates
+      mgwso::wanda_openda_model model(config);
+      mgwso::openda_server openda(model, port);
+      openda.run();
+      return EXIT_SUCCESS;
     }
-    model.close();
-  } 
+    mgwso::coupling_driver driver(config, mgwso::make_coupling_adapter(config));
+    driver.run();
+  }
   catch (const std::exception &e) {
     spdlog::error("Unhandled exception in main: {}", e.what());
+    return EXIT_FAILURE;
   }
 
-  
   return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
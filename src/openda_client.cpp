@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <fmt/ranges.h>
+#include <spdlog/spdlog.h>
+
+#include "openda_protocol.hpp"
+
+#include <internal_use_only/config.hpp>
+
+// Local test client for the OpenDA server of mgwso. It runs the requests
+// OpenDA makes for one instance and reports the latency per request type.
+namespace {
+using mgwso::openda::opcode;
+
+class latency_log {
+public:
+  void add(opcode code, std::chrono::duration<double> time)
+  {
+    auto &entry = _entries[code];
+    entry.count++;
+    entry.total += time.count();
+    entry.max = std::max(entry.max, time.count());
+  }
+  void report() const
+  {
+    static const std::map<opcode, std::string> names{ { opcode::create_instance, "create_instance" },
+      { opcode::get_time_horizon, "get_time_horizon" },
+      { opcode::compute_until, "compute_until" },
+      { opcode::resolve_item, "resolve_item" },
+      { opcode::get_values, "get_values" },
+      { opcode::set_values, "set_values" },
+      { opcode::get_state, "get_state" },
+      { opcode::set_state, "set_state" },
+      { opcode::destroy_instance, "destroy_instance" } };
+    for (auto &[code, entry] : _entries) {
+      spdlog::info("{:<17} {:>6} requests, mean {:.6f} s, max {:.6f} s",
+        names.at(code),
+        entry.count,
+        entry.total / entry.count,
+        entry.max);
+    }
+  }
+
+private:
+  struct entry {
+    int count = 0;
+    double total = 0.0;
+    double max = 0.0;
+  };
+  std::map<opcode, entry> _entries;
+};
+
+class client {
+public:
+  explicit client(unsigned short port) : _server(mgwso::openda::connection::connect(port)) {}
+
+  // sends the request in _request and returns a reader on the reply
+  mgwso::openda::payload_reader call(opcode code)
+  {
+    auto start = std::chrono::steady_clock::now();
+    mgwso::openda::call(_server, code, _request, _reply);
+    _latency.add(code, std::chrono::steady_clock::now() - start);
+    return mgwso::openda::payload_reader(_reply.payload);
+  }
+  mgwso::openda::payload_writer request() { return mgwso::openda::payload_writer(_request); }
+  const latency_log &get_latency() const { return _latency; }
+
+private:
+  mgwso::openda::connection _server;
+  std::vector<std::byte> _request;
+  mgwso::openda::message _reply;
+  latency_log _latency;
+};
+}// namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app{ fmt::format("OpenDA test client, {} version {}", mgwso::cmake::project_name,
+      mgwso::cmake::project_version) };
+    unsigned short port = 52525;
+    app.add_option("-p,--port", port, "Port of the mgwso server");
+    std::vector<std::string> items;
+    app.add_option("--items", items, "Exchange items, ITEM/Property or ITEM/Property[]");
+    std::vector<double> ranges;
+    app.add_option("--ranges", ranges, "End times to compute until")->required();
+    bool state = false;
+    app.add_flag("--state", state, "Get and set the state after every range like an ensemble filter, needs the engine");
+    bool shutdown = false;
+    app.add_flag("--shutdown", shutdown, "Stop the server at the end");
+    CLI11_PARSE(app, argc, argv);
+
+    client server(port);
+    auto instance = server.call(opcode::create_instance).read<std::uint32_t>();
+
+    server.request().write(instance);
+    auto horizon = server.call(opcode::get_time_horizon);
+    auto start_time = horizon.read<double>();
+    auto end_time = horizon.read<double>();
+    spdlog::info("Instance {} from {} to {}", instance, start_time, end_time);
+
+    std::vector<std::uint32_t> handles;
+    for (auto &item : items) {
+      auto request = server.request();
+      request.write(instance);
+      request.write(item);
+      auto reply = server.call(opcode::resolve_item);
+      handles.push_back(reply.read<std::uint32_t>());
+      spdlog::info("{} resolved to item {} with {} values", item, handles.back(), reply.read<std::uint32_t>());
+    }
+
+    std::vector<double> state_vector;
+    for (auto until : ranges) {
+      auto request = server.request();
+      request.write(instance);
+      request.write(until);
+      auto current = server.call(opcode::compute_until).read<double>();
+      for (size_t i = 0; i < handles.size(); i++) {
+        auto values_request = server.request();
+        values_request.write(instance);
+        values_request.write(handles[i]);
+        auto reply = server.call(opcode::get_values);
+        auto values = reply.read_remaining_doubles();
+        spdlog::info("t = {}: {} = {}", current, items[i], fmt::join(values, ", "));
+      }
+      if (state) {
+        server.request().write(instance);
+        auto reply = server.call(opcode::get_state);
+        auto values = reply.read_remaining_doubles();
+        state_vector.assign(values.begin(), values.end());
+        auto state_request = server.request();
+        state_request.write(instance);
+        state_request.write(std::span<const double>(state_vector));
+        server.call(opcode::set_state);
+      }
+    }
+
+    server.request().write(instance);
+    server.call(opcode::destroy_instance);
+    server.get_latency().report();
+    if (shutdown) {
+      server.request();
+      server.call(opcode::shutdown);
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in the OpenDA test client: {}", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+#include "openda_protocol.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace mgwso::openda {
+
+namespace {
+#ifdef _WIN32
+  using native_socket = SOCKET;
+  // length argument of send and recv, which winsock takes as int
+  int io_size(std::size_t size) { return static_cast<int>(size); }
+  void close_socket(std::intptr_t socket) { closesocket(static_cast<native_socket>(socket)); }
+
+  // winsock must be started once per process
+  void start_sockets()
+  {
+    static const int started = [] {
+      WSADATA data;
+      if (WSAStartup(MAKEWORD(2, 2), &data) != 0) { throw std::runtime_error("Could not start winsock"); }
+      return 0;
+    }();
+    (void)started;
+  }
+#else
+  using native_socket = int;
+  std::size_t io_size(std::size_t size) { return size; }
+  void close_socket(std::intptr_t socket) { ::close(static_cast<native_socket>(socket)); }
+  void start_sockets() {}
+#endif
+
+  native_socket to_native(std::intptr_t socket) { return static_cast<native_socket>(socket); }
+
+  sockaddr_in local_address(unsigned short port)
+  {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+  }
+
+  // requests are small and answered at once, without this every reply waits for the acknowledgement
+  void disable_delay(native_socket socket)
+  {
+    int flag = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&flag), sizeof(flag));
+  }
+
+  // a send to a closed connection must fail with an error instead of raising SIGPIPE, which ends the process
+#ifdef MSG_NOSIGNAL
+  constexpr int send_flags = MSG_NOSIGNAL;
+#else
+  constexpr int send_flags = 0;
+#endif
+  void disable_sigpipe([[maybe_unused]] native_socket socket)
+  {
+#ifdef SO_NOSIGPIPE
+    // macOS has no MSG_NOSIGNAL
+    int flag = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &flag, sizeof(flag));
+#endif
+  }
+}// namespace
+
+connection::connection(connection &&other) noexcept : _socket(std::exchange(other._socket, invalid_socket)) {}
+
+connection &connection::operator=(connection &&other) noexcept
+{
+  if (this != &other) {
+    if (is_open()) { close_socket(_socket); }
+    _socket = std::exchange(other._socket, invalid_socket);
+  }
+  return *this;
+}
+
+connection::~connection()
+{
+  if (is_open()) { close_socket(_socket); }
+}
+
+connection connection::connect(unsigned short port)
+{
+  start_sockets();
+  auto socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  connection result(static_cast<std::intptr_t>(socket));
+  if (!result.is_open()) { throw std::runtime_error("Could not create a socket"); }
+  auto address = local_address(port);
+  if (::connect(socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+    throw std::runtime_error("Could not connect to port " + std::to_string(port));
+  }
+  disable_delay(socket);
+  disable_sigpipe(socket);
+  return result;
+}
+
+void connection::send(std::uint32_t code, std::span<const std::byte> payload)
+{
+  std::array<std::uint32_t, 2> header{ code, static_cast<std::uint32_t>(payload.size()) };
+  auto write_all = [this](const std::byte *data, std::size_t size) {
+    while (size > 0) {
+      auto sent = ::send(to_native(_socket), reinterpret_cast<const char *>(data), io_size(size), send_flags);
+      if (sent <= 0) { throw connection_lost("Connection lost while sending"); }
+      data += sent;
+      size -= static_cast<std::size_t>(sent);
+    }
+  };
+  write_all(reinterpret_cast<const std::byte *>(header.data()), sizeof(header));
+  write_all(payload.data(), payload.size());
+}
+
+bool connection::read_exact(std::byte *data, std::size_t size)
+{
+  while (size > 0) {
+    auto received = ::recv(to_native(_socket), reinterpret_cast<char *>(data), io_size(size), 0);
+    if (received <= 0) { return false; }
+    data += received;
+    size -= static_cast<std::size_t>(received);
+  }
+  return true;
+}
+
+bool connection::receive(message &received)
+{
+  std::array<std::uint32_t, 2> header{};
+  if (!read_exact(reinterpret_cast<std::byte *>(header.data()), sizeof(header))) { return false; }
+  received.code = header[0];
+  if (header[1] > _max_payload_size) {
+    // the size comes from the other side, the payload is skipped so the next message can still be read
+    std::array<std::byte, 4096> skipped{};
+    for (std::size_t left = header[1]; left > 0;) {
+      auto size = std::min(left, skipped.size());
+      if (!read_exact(skipped.data(), size)) { throw connection_lost("Connection lost while receiving"); }
+      left -= size;
+    }
+    throw std::length_error("Message of " + std::to_string(header[1]) + " bytes is larger than the limit of "
+                            + std::to_string(_max_payload_size) + " bytes");
+  }
+  // the buffer keeps its capacity, so repeated messages of the same size do not allocate
+  received.payload.resize(header[1]);
+  if (!read_exact(received.payload.data(), received.payload.size())) {
+    throw connection_lost("Connection lost while receiving");
+  }
+  return true;
+}
+
+listener::listener(unsigned short port)
+{
+  start_sockets();
+  auto socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  _socket = static_cast<std::intptr_t>(socket);
+  if (_socket == connection::invalid_socket) { throw std::runtime_error("Could not create a socket"); }
+  int reuse = 1;
+  setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+  auto address = local_address(port);
+  if (::bind(socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(socket, 1) != 0) {
+    close_socket(_socket);
+    throw std::runtime_error("Could not listen on port " + std::to_string(port));
+  }
+}
+
+listener::~listener() { close_socket(_socket); }
+
+connection listener::accept()
+{
+  auto socket = ::accept(to_native(_socket), nullptr, nullptr);
+  connection result(static_cast<std::intptr_t>(socket));
+  if (!result.is_open()) { throw std::runtime_error("Could not accept a connection"); }
+  disable_delay(socket);
+  disable_sigpipe(socket);
+  return result;
+}
+
+void call(connection &server, opcode code, std::span<const std::byte> request, message &reply)
+{
+  server.send(static_cast<std::uint32_t>(code), request);
+  if (!server.receive(reply)) { throw std::runtime_error("Server closed the connection"); }
+  if (reply.code != static_cast<std::uint32_t>(status::ok)) {
+    throw std::runtime_error(std::string(reinterpret_cast<const char *>(reply.payload.data()), reply.payload.size()));
+  }
+}
+
+}// namespace mgwso::openda
@@ -0,0 +1,178 @@
+#ifndef MGWSO_OPENDA_PROTOCOL_HPP
+#define MGWSO_OPENDA_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Binary protocol between OpenDA (or the test client) and the mgwso server.
+//
+// Every message is a header of two uint32 values, a code and the size of the
+// payload in bytes, followed by the payload. The code of a request is the
+// opcode, the code of a reply is the status. When the status is not ok the
+// payload is the error message. Values are written in the byte order of the
+// machine, client and server run on the same machine.
+namespace mgwso::openda {
+
+// largest payload accepted from the other side, larger messages are skipped and refused
+constexpr std::size_t max_payload_size = std::size_t{ 256 } << 20U;
+
+enum class opcode : std::uint32_t {
+  // -> uint32 instance
+  create_instance = 1,
+  // uint32 instance ->
+  destroy_instance = 2,
+  // uint32 instance -> double start, double end, double current
+  get_time_horizon = 3,
+  // uint32 instance, double end time -> double current time
+  compute_until = 4,
+  // uint32 instance, string "ITEM/Property" or "ITEM/Property[]" -> uint32 item, uint32 number of values
+  resolve_item = 5,
+  // uint32 instance, uint32 item -> double values
+  get_values = 6,
+  // uint32 instance, uint32 item, double values ->
+  set_values = 7,
+  // uint32 instance -> double values of the state vector, see wanda_state_vector_layout
+  get_state = 8,
+  // uint32 instance, double values of the state vector ->
+  set_state = 9,
+  // -> , the server stops after the reply
+  shutdown = 10
+};
+
+enum class status : std::uint32_t { ok = 0, error = 1 };
+
+struct message {
+  std::uint32_t code = 0;
+  std::vector<std::byte> payload;
+};
+
+// Builds the payload of a message
+class payload_writer {
+public:
+  explicit payload_writer(std::vector<std::byte> &buffer) : _buffer(buffer) { _buffer.clear(); }
+  template<typename T> void write(T value)
+  {
+    auto offset = _buffer.size();
+    _buffer.resize(offset + sizeof(T));
+    std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+  }
+  void write(const std::string &text)
+  {
+    write(static_cast<std::uint32_t>(text.size()));
+    auto offset = _buffer.size();
+    _buffer.resize(offset + text.size());
+    std::memcpy(_buffer.data() + offset, text.data(), text.size());
+  }
+  void write(std::span<const double> values)
+  {
+    auto offset = _buffer.size();
+    _buffer.resize(offset + values.size_bytes());
+    std::memcpy(_buffer.data() + offset, values.data(), values.size_bytes());
+  }
+
+private:
+  std::vector<std::byte> &_buffer;
+};
+
+// Reads the payload of a message
+class payload_reader {
+public:
+  explicit payload_reader(std::span<const std::byte> payload) : _payload(payload) {}
+  template<typename T> T read()
+  {
+    T value;
+    std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+    return value;
+  }
+  std::string read_string()
+  {
+    auto size = read<std::uint32_t>();
+    auto bytes = take(size);
+    return { reinterpret_cast<const char *>(bytes.data()), bytes.size() };
+  }
+  // returns the rest of the payload as doubles, valid until the next call
+  std::span<const double> read_remaining_doubles()
+  {
+    if ((_payload.size() - _position) % sizeof(double) != 0) {
+      throw std::runtime_error("Payload does not end with whole double values");
+    }
+    auto bytes = take(_payload.size() - _position);
+    _values.resize(bytes.size() / sizeof(double));
+    std::memcpy(_values.data(), bytes.data(), bytes.size());
+    return _values;
+  }
+
+private:
+  std::span<const std::byte> _payload;
+  std::size_t _position = 0;
+  std::vector<double> _values;
+
+  std::span<const std::byte> take(std::size_t size)
+  {
+    if (_position + size > _payload.size()) { throw std::runtime_error("Payload of the message is too short"); }
+    auto bytes = _payload.subspan(_position, size);
+    _position += size;
+    return bytes;
+  }
+};
+
+// thrown when a message can't be sent or received completely, the connection is unusable after it
+class connection_lost : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+// Connected socket on the local machine
+class connection {
+public:
+  connection() = default;
+  explicit connection(std::intptr_t socket) : _socket(socket) {}
+  connection(const connection &) = delete;
+  connection &operator=(const connection &) = delete;
+  connection(connection &&other) noexcept;
+  connection &operator=(connection &&other) noexcept;
+  ~connection();
+
+  // connects to a server on the local machine
+  static connection connect(unsigned short port);
+  // throws connection_lost when the other side closed the connection
+  void send(std::uint32_t code, std::span<const std::byte> payload);
+  // receives the next message in place, returns false when the other side closed the connection
+  // throws std::length_error after skipping a payload larger than the maximum size and
+  // connection_lost when the connection closes in the middle of a message
+  bool receive(message &received);
+  bool is_open() const { return _socket != invalid_socket; }
+  void set_max_payload_size(std::size_t size) { _max_payload_size = size; }
+
+  static constexpr std::intptr_t invalid_socket = -1;
+
+private:
+  std::intptr_t _socket = invalid_socket;
+  std::size_t _max_payload_size = max_payload_size;
+  bool read_exact(std::byte *data, std::size_t size);
+};
+
+// Listening socket on the local machine
+class listener {
+public:
+  explicit listener(unsigned short port);
+  listener(const listener &) = delete;
+  listener &operator=(const listener &) = delete;
+  ~listener();
+  connection accept();
+
+private:
+  std::intptr_t _socket = connection::invalid_socket;
+};
+
+// sends a request and waits for the reply, throws the error message of a failed request
+void call(connection &server, opcode code, std::span<const std::byte> request, message &reply);
+
+}// namespace mgwso::openda
+
+#endif
@@ -0,0 +1,292 @@
+#include "openda_server.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+#include <wanda_time_range_session.h>
+#include <wandamodel.h>
+
+namespace mgwso {
+
+wanda_openda_model::wanda_openda_model(const coupling_config &config)
+  : _case_file(config.model), _wanda_bin(config.wanda_bin), _mode(config.mode)
+{
+  parse_mode(_mode);
+  _state_spec.pipe_quantities = config.state_pipe_quantities;
+  _state_spec.node_quantities = config.state_node_quantities;
+  if (!std::filesystem::exists(_case_file)) { throw std::invalid_argument("Case does not exist: " + _case_file); }
+}
+
+wanda_openda_model::~wanda_openda_model()
+{
+  for (auto &instance : _instances) { close_instance(instance.second); }
+}
+
+std::uint32_t wanda_openda_model::create_instance()
+{
+  for (auto &instance : _instances) {
+    if (instance.second.session->uses_engine()) {
+      throw std::runtime_error("The Wanda engine runs one instance at a time, use files mode for more instances");
+    }
+  }
+  const std::filesystem::path case_file(_case_file);
+  const auto id = _next_instance++;
+  instance_data data;
+  data.directory = case_file.parent_path() / (case_file.stem().string() + "_openda")
+                   / ("instance_" + std::to_string(id));
+  try {
+    copy_case(case_file, data.directory);
+    data.model = std::make_unique<wanda_model>((data.directory / case_file.filename()).string(), _wanda_bin);
+    data.session = std::make_unique<wanda_time_range_session>(*data.model, std::vector<wanda_session_subscription>{},
+      parse_mode(_mode));
+    if (data.session->uses_engine() && !_instances.empty()) {
+      throw std::runtime_error("The Wanda engine runs one instance at a time, use files mode for more instances");
+    }
+  } catch (...) {
+    close_instance(data);
+    throw;
+  }
+  _instances.emplace(id, std::move(data));
+  return id;
+}
+
+void wanda_openda_model::close_instance(instance_data &data)
+{
+  data.state.reset();
+  data.session.reset();
+  if (data.model) {
+    data.model->close();
+    data.model.reset();
+  }
+  std::error_code error;
+  std::filesystem::remove_all(data.directory, error);
+}
+
+void wanda_openda_model::destroy_instance(std::uint32_t instance)
+{
+  auto found = _instances.find(instance);
+  if (found == _instances.end()) { throw std::runtime_error("Unknown instance"); }
+  close_instance(found->second);
+  _instances.erase(found);
+}
+
+wanda_openda_model::instance_data &wanda_openda_model::get_instance(std::uint32_t instance)
+{
+  auto found = _instances.find(instance);
+  if (found == _instances.end()) { throw std::runtime_error("Unknown instance"); }
+  return found->second;
+}
+
+wanda_time_range_session &wanda_openda_model::get_session(std::uint32_t instance) const
+{
+  auto found = _instances.find(instance);
+  if (found == _instances.end()) { throw std::runtime_error("Unknown instance"); }
+  return *found->second.session;
+}
+
+std::array<double, 3> wanda_openda_model::get_time_horizon(std::uint32_t instance)
+{
+  auto &session = get_session(instance);
+  return { session.get_start_time(), session.get_end_time(), session.get_current_time() };
+}
+
+double wanda_openda_model::compute_until(std::uint32_t instance, double end_time)
+{
+  auto &session = get_session(instance);
+  // only the exchange items are read, so the window of the session is not used
+  session.advance_to(end_time);
+  return session.get_current_time();
+}
+
+std::size_t wanda_openda_model::resolve_item(std::uint32_t instance, const std::string &quantity)
+{
+  return get_session(instance).resolve_item(parse_quantity(quantity));
+}
+
+std::size_t wanda_openda_model::get_item_size(std::uint32_t instance, std::size_t item) const
+{
+  return get_session(instance).get_item_size(item);
+}
+
+void wanda_openda_model::get_values(std::uint32_t instance, std::size_t item, std::span<double> values)
+{
+  get_session(instance).get_item_values(item, values);
+}
+
+void wanda_openda_model::set_values(std::uint32_t instance, std::size_t item, std::span<const double> values)
+{
+  get_session(instance).set_item_values(item, values);
+}
+
+wanda_state_vector_layout &wanda_openda_model::get_state_layout(instance_data &data)
+{
+  if (!data.state) {
+    data.state = std::make_unique<wanda_state_vector_layout>(*data.model, _state_spec);
+    if (auto *engine = data.session->get_engine(); engine != nullptr) { data.state->bind_engine(*engine); }
+  }
+  return *data.state;
+}
+
+std::size_t wanda_openda_model::get_state_size(std::uint32_t instance)
+{
+  return get_state_layout(get_instance(instance)).size();
+}
+
+void wanda_openda_model::get_state(std::uint32_t instance, std::span<double> state)
+{
+  auto &data = get_instance(instance);
+  auto &layout = get_state_layout(data);
+  if (data.session->uses_engine()) {
+    layout.gather_engine(state);
+    return;
+  }
+  // every window reloads the output, so the series are bound again
+  layout.bind_output(*data.model);
+  if (layout.get_number_of_time_steps() == 0) { throw std::runtime_error("No output computed yet for the state"); }
+  layout.gather_output(layout.get_number_of_time_steps() - 1, state);
+}
+
+void wanda_openda_model::set_state(std::uint32_t instance, std::span<const double> state)
+{
+  auto &data = get_instance(instance);
+  if (!data.session->uses_engine()) {
+    throw std::runtime_error("The state can only be set with the engine, the case files hold no solver state");
+  }
+  get_state_layout(data).scatter_engine(state);
+}
+
+openda_server::openda_server(openda_model &model, unsigned short port) : _model(model), _port(port) {}
+
+void openda_server::run()
+{
+  openda::listener socket(_port);
+  spdlog::info("OpenDA server listening on port {}", _port);
+  _stop = false;
+  while (!_stop) {
+    auto client = socket.accept();
+    spdlog::info("OpenDA client connected");
+    try {
+      serve(client);
+    } catch (const openda::connection_lost &e) {
+      // a client which goes away in the middle of a message is treated like one which disconnects
+      spdlog::warn("OpenDA client lost: {}", e.what());
+    }
+    spdlog::info("OpenDA client disconnected");
+    // a new client starts with new instances
+    destroy_instances();
+  }
+}
+
+void openda_server::serve(openda::connection &client)
+{
+  while (!_stop) {
+    auto start = std::chrono::steady_clock::now();
+    auto result = openda::status::ok;
+    try {
+      if (!client.receive(_request)) { return; }
+      const auto code = static_cast<openda::opcode>(_request.code);
+      openda::payload_reader request(_request.payload);
+      openda::payload_writer reply(_reply);
+      handle(code, request, reply);
+    } catch (const openda::connection_lost &) {
+      throw;
+    } catch (const std::exception &e) {
+      // the payload of an error is the message, its size is given by the header
+      const std::string error = e.what();
+      _reply.resize(error.size());
+      std::memcpy(_reply.data(), error.data(), error.size());
+      result = openda::status::error;
+    }
+    client.send(static_cast<std::uint32_t>(result), _reply);
+    spdlog::debug("OpenDA request {} handled in {:.6f} s",
+      _request.code,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+}
+
+void openda_server::destroy_instances()
+{
+  for (auto &instance : _instances) { _model.destroy_instance(instance.first); }
+  _instances.clear();
+}
+
+std::pair<std::uint32_t, std::vector<std::size_t> &> openda_server::read_instance(openda::payload_reader &request)
+{
+  auto id = request.read<std::uint32_t>();
+  auto found = _instances.find(id);
+  if (found == _instances.end()) { throw std::runtime_error("Unknown instance"); }
+  return { id, found->second };
+}
+
+void openda_server::handle(openda::opcode code, openda::payload_reader &request, openda::payload_writer &reply)
+{
+  switch (code) {
+  case openda::opcode::create_instance: {
+    auto id = _model.create_instance();
+    _instances[id].clear();
+    reply.write(id);
+    break;
+  }
+  case openda::opcode::destroy_instance: {
+    auto [id, items] = read_instance(request);
+    _model.destroy_instance(id);
+    _instances.erase(id);
+    break;
+  }
+  case openda::opcode::get_time_horizon: {
+    auto [id, items] = read_instance(request);
+    auto horizon = _model.get_time_horizon(id);
+    reply.write(std::span<const double>(horizon));
+    break;
+  }
+  case openda::opcode::compute_until: {
+    auto [id, items] = read_instance(request);
+    reply.write(_model.compute_until(id, request.read<double>()));
+    break;
+  }
+  case openda::opcode::resolve_item: {
+    auto [id, items] = read_instance(request);
+    auto item = _model.resolve_item(id, request.read_string());
+    items.push_back(item);
+    reply.write(static_cast<std::uint32_t>(items.size() - 1));
+    reply.write(static_cast<std::uint32_t>(_model.get_item_size(id, item)));
+    break;
+  }
+  case openda::opcode::get_values: {
+    auto [id, items] = read_instance(request);
+    auto item = items.at(request.read<std::uint32_t>());
+    _values.resize(_model.get_item_size(id, item));
+    _model.get_values(id, item, _values);
+    reply.write(std::span<const double>(_values));
+    break;
+  }
+  case openda::opcode::set_values: {
+    auto [id, items] = read_instance(request);
+    auto item = items.at(request.read<std::uint32_t>());
+    _model.set_values(id, item, request.read_remaining_doubles());
+    break;
+  }
+  case openda::opcode::get_state: {
+    auto id = read_instance(request).first;
+    _values.resize(_model.get_state_size(id));
+    _model.get_state(id, _values);
+    reply.write(std::span<const double>(_values));
+    break;
+  }
+  case openda::opcode::set_state: {
+    auto id = read_instance(request).first;
+    _model.set_state(id, request.read_remaining_doubles());
+    break;
+  }
+  case openda::opcode::shutdown:
+    _stop = true;
+    break;
+  default:
+    throw std::invalid_argument("Unknown request " + std::to_string(static_cast<std::uint32_t>(code)));
+  }
+}
+
+}// namespace mgwso
@@ -0,0 +1,128 @@
+#ifndef MGWSO_OPENDA_SERVER_HPP
+#define MGWSO_OPENDA_SERVER_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <wanda_state_vector.h>
+
+#include "coupling_driver.hpp"
+#include "openda_protocol.hpp"
+
+class wanda_model;
+class wanda_time_range_session;
+
+namespace mgwso {
+
+// Model behind the OpenDA server, with independent instances like the members of an ensemble
+class openda_model {
+public:
+  virtual ~openda_model() = default;
+  // returns the id of the new instance
+  virtual std::uint32_t create_instance() = 0;
+  virtual void destroy_instance(std::uint32_t instance) = 0;
+  // start, end and current time
+  virtual std::array<double, 3> get_time_horizon(std::uint32_t instance) = 0;
+  // returns the time of the last computed step
+  virtual double compute_until(std::uint32_t instance, double end_time) = 0;
+  // resolves "ITEM/Property" or "ITEM/Property[]" once, returns the index of the exchange item
+  virtual std::size_t resolve_item(std::uint32_t instance, const std::string &quantity) = 0;
+  virtual std::size_t get_item_size(std::uint32_t instance, std::size_t item) const = 0;
+  virtual void get_values(std::uint32_t instance, std::size_t item, std::span<double> values) = 0;
+  virtual void set_values(std::uint32_t instance, std::size_t item, std::span<const double> values) = 0;
+  // number of values of the state vector of the instance
+  virtual std::size_t get_state_size(std::uint32_t instance) = 0;
+  virtual void get_state(std::uint32_t instance, std::span<double> state) = 0;
+  virtual void set_state(std::uint32_t instance, std::span<const double> state) = 0;
+};
+
+// WANDA case of which every instance runs a wanda_time_range_session on its own copy
+/*
+The files of the case are copied for every instance into a directory next to
+the case, so every instance starts from the case as it is on disk and values
+set in one instance don't change another. The Wanda engine runs one model at a
+time, so in engine mode only one instance can exist; ensembles use files mode.
+
+The state of an instance is laid out by a wanda_state_vector_layout of the
+state quantities of the configuration. In engine mode the state is exchanged
+with the engine; in files mode it is read from the last computed output step
+and can't be set, the case files hold no solver state.
+*/
+class wanda_openda_model : public openda_model {
+public:
+  explicit wanda_openda_model(const coupling_config &config);
+  ~wanda_openda_model() override;
+  std::uint32_t create_instance() override;
+  void destroy_instance(std::uint32_t instance) override;
+  std::array<double, 3> get_time_horizon(std::uint32_t instance) override;
+  double compute_until(std::uint32_t instance, double end_time) override;
+  std::size_t resolve_item(std::uint32_t instance, const std::string &quantity) override;
+  std::size_t get_item_size(std::uint32_t instance, std::size_t item) const override;
+  void get_values(std::uint32_t instance, std::size_t item, std::span<double> values) override;
+  void set_values(std::uint32_t instance, std::size_t item, std::span<const double> values) override;
+  std::size_t get_state_size(std::uint32_t instance) override;
+  void get_state(std::uint32_t instance, std::span<double> state) override;
+  void set_state(std::uint32_t instance, std::span<const double> state) override;
+
+private:
+  struct instance_data {
+    std::filesystem::path directory;
+    std::unique_ptr<wanda_model> model;
+    std::unique_ptr<wanda_time_range_session> session;
+    // built on the first state request
+    std::unique_ptr<wanda_state_vector_layout> state;
+  };
+  std::string _case_file;
+  std::string _wanda_bin;
+  std::string _mode;
+  wanda_state_vector_spec _state_spec;
+  std::uint32_t _next_instance = 1;
+  std::map<std::uint32_t, instance_data> _instances;
+  instance_data &get_instance(std::uint32_t instance);
+  wanda_time_range_session &get_session(std::uint32_t instance) const;
+  wanda_state_vector_layout &get_state_layout(instance_data &data);
+  void close_instance(instance_data &data);
+};
+
+// Serves the binary protocol of openda_protocol.hpp on a local port
+/*
+Requests are handled one at a time on one connection. The request and reply
+buffers are reused, so repeated get_values and get_state requests don't
+allocate. The instances of a client are destroyed when it disconnects or a
+send or receive fails, after which the server accepts the next client.
+*/
+class openda_server {
+public:
+  openda_server(openda_model &model, unsigned short port);
+  // serves connections until a shutdown request
+  void run();
+
+private:
+  openda_model &_model;
+  unsigned short _port;
+  bool _stop = false;
+  // resolved exchange items per instance
+  std::map<std::uint32_t, std::vector<std::size_t>> _instances;
+  openda::message _request;
+  std::vector<std::byte> _reply;
+  std::vector<double> _values;
+
+  // handles the requests of one client until it disconnects, throws openda::connection_lost
+  void serve(openda::connection &client);
+  // handles the request and fills the reply payload
+  void handle(openda::opcode code, openda::payload_reader &request, openda::payload_writer &reply);
+  // reads the instance of the request and returns its id and items
+  std::pair<std::uint32_t, std::vector<std::size_t> &> read_instance(openda::payload_reader &request);
+  void destroy_instances();
+};
+
+}// namespace mgwso
+
+#endif
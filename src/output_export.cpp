@@ -0,0 +1,203 @@
+#include "output_export.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/util/compression.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+namespace mgwso {
+
+namespace {
+  // Arrow reports errors as a status, the exporter throws like the rest of mgwso
+  void check(const arrow::Status &status)
+  {
+    if (!status.ok()) { throw std::runtime_error("Arrow: " + status.ToString()); }
+  }
+
+  template<typename T> T check(arrow::Result<T> result)
+  {
+    check(result.status());
+    return std::move(result).ValueOrDie();
+  }
+
+  // distinct values in the order of their first use, with the index of every value
+  struct dictionary {
+    std::vector<std::string> values;
+    std::vector<int32_t> indices;
+
+    void add(const std::string &value)
+    {
+      auto found = std::find(values.begin(), values.end(), value);
+      indices.push_back(static_cast<int32_t>(found - values.begin()));
+      if (found == values.end()) { values.push_back(value); }
+    }
+
+    std::shared_ptr<arrow::Array> make_array() const
+    {
+      arrow::StringBuilder builder;
+      check(builder.AppendValues(values));
+      return check(builder.Finish());
+    }
+  };
+
+  std::shared_ptr<arrow::Array> make_repeated_index(int32_t index, size_t rows)
+  {
+    arrow::Int32Builder builder;
+    check(builder.Reserve(static_cast<int64_t>(rows)));
+    for (size_t row = 0; row < rows; row++) { builder.UnsafeAppend(index); }
+    return check(builder.Finish());
+  }
+
+  class batch_writer {
+  public:
+    virtual ~batch_writer() = default;
+    virtual void write(const arrow::RecordBatch &batch) = 0;
+    virtual void close() = 0;
+  };
+
+  class parquet_batch_writer final : public batch_writer {
+  public:
+    parquet_batch_writer(const std::shared_ptr<arrow::Schema> &schema,
+      std::shared_ptr<arrow::io::OutputStream> sink,
+      arrow::Compression::type compression)
+    {
+      auto properties = parquet::WriterProperties::Builder().compression(compression)->build();
+      // keeps the dictionary types of item, quantity and unit when the file is read back
+      auto arrow_properties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+      _writer = check(parquet::arrow::FileWriter::Open(
+        *schema, arrow::default_memory_pool(), std::move(sink), properties, arrow_properties));
+    }
+
+    void write(const arrow::RecordBatch &batch) override
+    {
+      check(_writer->NewBufferedRowGroup());
+      check(_writer->WriteRecordBatch(batch));
+    }
+
+    void close() override { check(_writer->Close()); }
+
+  private:
+    std::unique_ptr<parquet::arrow::FileWriter> _writer;
+  };
+
+  class ipc_batch_writer final : public batch_writer {
+  public:
+    ipc_batch_writer(const std::shared_ptr<arrow::Schema> &schema,
+      std::shared_ptr<arrow::io::OutputStream> sink,
+      arrow::Compression::type compression)
+    {
+      auto options = arrow::ipc::IpcWriteOptions::Defaults();
+      if (compression != arrow::Compression::UNCOMPRESSED) {
+        options.codec = check(arrow::util::Codec::Create(compression));
+      }
+      _writer = check(arrow::ipc::MakeFileWriter(std::move(sink), schema, options));
+    }
+
+    void write(const arrow::RecordBatch &batch) override { check(_writer->WriteRecordBatch(batch)); }
+
+    void close() override { check(_writer->Close()); }
+
+  private:
+    std::shared_ptr<arrow::ipc::RecordBatchWriter> _writer;
+  };
+}// namespace
+
+export_format parse_export_format(const std::string &format)
+{
+  if (format == "parquet") { return export_format::parquet; }
+  if (format == "arrow") { return export_format::arrow; }
+  throw std::invalid_argument("Unknown export format " + format + ", use parquet or arrow");
+}
+
+export_summary export_output(const wanda_output_reader &reader,
+  const std::string &file,
+  export_format format,
+  size_t max_rows,
+  const std::string &compression)
+{
+  auto &columns = reader.get_columns();
+  auto &times = reader.get_times();
+  dictionary items;
+  dictionary quantities;
+  dictionary units;
+  for (auto &column : columns) {
+    items.add(column.item);
+    quantities.add(column.quantity);
+    units.add(column.unit);
+  }
+  // the dictionaries are the same in every batch, so Arrow files store them once
+  auto dictionary_type = arrow::dictionary(arrow::int32(), arrow::utf8());
+  auto item_dictionary = items.make_array();
+  auto quantity_dictionary = quantities.make_array();
+  auto unit_dictionary = units.make_array();
+  auto schema = arrow::schema({ arrow::field("time", arrow::float64(), false),
+    arrow::field("item", dictionary_type, false),
+    arrow::field("quantity", dictionary_type, false),
+    arrow::field("unit", dictionary_type, false),
+    arrow::field("element", arrow::int32(), false),
+    arrow::field("value", arrow::float32(), false) });
+
+  auto codec = check(arrow::util::Codec::GetCompressionType(compression));
+  auto sink = check(arrow::io::FileOutputStream::Open(file));
+  std::unique_ptr<batch_writer> writer;
+  if (format == export_format::parquet) {
+    writer = std::make_unique<parquet_batch_writer>(schema, sink, codec);
+  } else {
+    writer = std::make_unique<ipc_batch_writer>(schema, sink, codec);
+  }
+
+  export_summary summary;
+  std::vector<float> values;
+  for (size_t index = 0; index < columns.size(); index++) {
+    auto &column = columns[index];
+    auto width = static_cast<size_t>(column.number_of_values);
+    auto block = reader.get_steps_per_block(index, max_rows);
+    for (int first = 0; first < reader.get_number_of_steps(); first += block) {
+      auto steps = std::min(block, reader.get_number_of_steps() - first);
+      reader.read(index, first, steps, values);
+      auto rows = values.size();
+
+      arrow::DoubleBuilder time_builder;
+      arrow::Int32Builder element_builder;
+      check(time_builder.Reserve(static_cast<int64_t>(rows)));
+      check(element_builder.Reserve(static_cast<int64_t>(rows)));
+      for (int step = first; step < first + steps; step++) {
+        for (size_t element = 0; element < width; element++) {
+          time_builder.UnsafeAppend(times[static_cast<size_t>(step)]);
+          element_builder.UnsafeAppend(static_cast<int32_t>(element));
+        }
+      }
+      auto make_dictionary_column = [&](const dictionary &source, const std::shared_ptr<arrow::Array> &array) {
+        return check(
+          arrow::DictionaryArray::FromArrays(dictionary_type, make_repeated_index(source.indices[index], rows), array));
+      };
+      // the values are handed to Arrow without copying, the next block reads into a new vector
+      auto value_array = std::make_shared<arrow::FloatArray>(
+        static_cast<int64_t>(rows), arrow::Buffer::FromVector(std::move(values)));
+      values = {};
+      auto batch = arrow::RecordBatch::Make(schema,
+        static_cast<int64_t>(rows),
+        { check(time_builder.Finish()),
+          make_dictionary_column(items, item_dictionary),
+          make_dictionary_column(quantities, quantity_dictionary),
+          make_dictionary_column(units, unit_dictionary),
+          check(element_builder.Finish()),
+          value_array });
+      writer->write(*batch);
+      summary.rows += rows;
+      summary.batches++;
+    }
+  }
+  writer->close();
+  check(sink->Close());
+  return summary;
+}
+
+}// namespace mgwso
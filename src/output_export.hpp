@@ -0,0 +1,37 @@
+#ifndef MGWSO_OUTPUT_EXPORT_HPP
+#define MGWSO_OUTPUT_EXPORT_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <wanda_output_reader.h>
+
+namespace mgwso {
+
+enum class export_format { parquet, arrow };
+
+// parquet or arrow, for Arrow IPC files
+export_format parse_export_format(const std::string &format);
+
+struct export_summary {
+  size_t rows = 0;
+  size_t batches = 0;
+};
+
+// Writes the columns of the reader as one long table
+/*
+The table has the columns time, item, quantity, unit, element and value, with
+item, quantity and unit dictionary encoded. Every record batch holds a block
+of steps of one column of the reader with at most max_rows rows, so the memory
+needed does not grow with the size of the output. In Parquet files every batch
+is a row group, which lets readers skip the quantities they do not query.
+*/
+export_summary export_output(const wanda_output_reader &reader,
+  const std::string &file,
+  export_format format,
+  size_t max_rows = size_t{ 1 } << 20U,
+  const std::string &compression = "uncompressed");
+
+}// namespace mgwso
+
+#endif
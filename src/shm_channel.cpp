@@ -0,0 +1,302 @@
+#include "shm_channel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mgwso {
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  constexpr std::uint32_t ready_marker = 0x4d475753;// "MGWS"
+  constexpr std::uint32_t ring_version = 1;
+  constexpr std::size_t cache_line = 64;
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the ring needs lock-free 64 bit atomics");
+  static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the ring needs lock-free 32 bit atomics");
+
+  // a frame is the time followed by the values, every frame starts on its own cache line
+  std::size_t get_slot_size(std::size_t values_per_frame)
+  {
+    auto size = (values_per_frame + 1) * sizeof(double);
+    return (size + cache_line - 1) / cache_line * cache_line;
+  }
+
+  // spins for short waits, the other side usually answers within microseconds, and backs off
+  // to sleeping while it computes a whole range
+  template<typename Ready> bool wait_until(Ready ready, std::chrono::milliseconds timeout)
+  {
+    const auto deadline = clock::now() + timeout;
+    for (unsigned attempt = 0;; attempt++) {
+      if (ready()) { return true; }
+      if (attempt < 1024) { continue; }
+      if (clock::now() > deadline) { return false; }
+      if (attempt < 4096) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+#ifdef _WIN32
+  std::string get_native_name(const std::string &name) { return "Local\\" + name; }
+#else
+  std::string get_native_name(const std::string &name) { return "/" + name; }
+  std::runtime_error system_error(const std::string &message)
+  {
+    return std::runtime_error(message + ": " + std::strerror(errno));
+  }
+#endif
+}// namespace
+
+struct shm_ring::header {
+  // set to ready_marker by the creator once the rest of the header is initialized
+  std::atomic<std::uint32_t> state;
+  std::uint32_t version;
+  std::uint64_t layout_hash;
+  std::uint64_t values_per_frame;
+  std::uint64_t capacity;
+  // written by the producer only
+  alignas(cache_line) std::atomic<std::uint64_t> head;
+  // written by the consumer only
+  alignas(cache_line) std::atomic<std::uint64_t> tail;
+};
+
+frame_layout::frame_layout(std::vector<std::string> quantities) : _quantities(std::move(quantities))
+{
+  // FNV-1a over the names, separated by a byte which is not part of any name
+  _hash = 14695981039346656037ULL;
+  for (auto &quantity : _quantities) {
+    for (auto character : quantity) {
+      _hash ^= static_cast<unsigned char>(character);
+      _hash *= 1099511628211ULL;
+    }
+    _hash ^= 0xff;
+    _hash *= 1099511628211ULL;
+  }
+}
+
+shm_ring::shm_ring(const std::string &name,
+  const frame_layout &layout,
+  std::uint32_t capacity,
+  shm_open_mode mode,
+  std::chrono::milliseconds attach_timeout)
+  : _name(name), _values_per_frame(layout.size())
+{
+  if (capacity == 0) { throw std::invalid_argument("Shared memory ring " + name + " needs room for a frame"); }
+  const auto slots_offset = (sizeof(header) + cache_line - 1) / cache_line * cache_line;
+  _mapping_size = slots_offset + get_slot_size(_values_per_frame) * capacity;
+  const auto native_name = get_native_name(name);
+
+#ifdef _WIN32
+  HANDLE mapping = nullptr;
+  if (mode == shm_open_mode::attach) {
+    wait_until(
+      [&] {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, native_name.c_str());
+        return mapping != nullptr;
+      },
+      attach_timeout);
+    if (mapping == nullptr) { throw std::runtime_error("Shared memory ring " + name + " was not created in time"); }
+  } else {
+    auto size = static_cast<std::uint64_t>(_mapping_size);
+    mapping = CreateFileMappingA(INVALID_HANDLE_VALUE,
+      nullptr,
+      PAGE_READWRITE,
+      static_cast<DWORD>(size >> 32),
+      static_cast<DWORD>(size & 0xffffffff),
+      native_name.c_str());
+    if (mapping == nullptr) { throw std::runtime_error("Could not open shared memory " + name); }
+    _owner = GetLastError() != ERROR_ALREADY_EXISTS;
+    // a file mapping is removed with its last handle, so an existing one is in use
+    if (!_owner && mode == shm_open_mode::create) {
+      CloseHandle(mapping);
+      throw std::runtime_error("Shared memory ring " + name + " is in use by another run");
+    }
+  }
+  _handle = reinterpret_cast<std::intptr_t>(mapping);
+  _mapping = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, _mapping_size);
+  if (_mapping == nullptr) {
+    CloseHandle(mapping);
+    throw std::runtime_error("Could not map shared memory " + name + ", was it created with another layout?");
+  }
+#else
+  int descriptor = -1;
+  if (mode == shm_open_mode::create) { shm_unlink(native_name.c_str()); }
+  if (mode != shm_open_mode::attach) {
+    descriptor = shm_open(native_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (descriptor < 0 && (errno != EEXIST || mode == shm_open_mode::create)) {
+      throw system_error("Could not create shared memory " + name);
+    }
+  }
+  if (descriptor >= 0) {
+    _owner = true;
+    if (ftruncate(descriptor, static_cast<off_t>(_mapping_size)) != 0) {
+      auto error = system_error("Could not size shared memory " + name);
+      ::close(descriptor);
+      shm_unlink(native_name.c_str());
+      throw error;
+    }
+  } else {
+    wait_until(
+      [&] {
+        descriptor = shm_open(native_name.c_str(), O_RDWR, 0600);
+        return descriptor >= 0 || errno != ENOENT;
+      },
+      attach_timeout);
+    if (descriptor < 0) {
+      if (errno == ENOENT) { throw std::runtime_error("Shared memory ring " + name + " was not created in time"); }
+      throw system_error("Could not open shared memory " + name);
+    }
+    // the creator sizes the segment right after creating it
+    struct stat status {};
+    auto sized = wait_until(
+      [&] { return fstat(descriptor, &status) == 0 && static_cast<std::size_t>(status.st_size) >= _mapping_size; },
+      std::chrono::milliseconds(1000));
+    if (!sized) {
+      ::close(descriptor);
+      throw std::runtime_error("Shared memory " + name + " is smaller than the layout needs");
+    }
+  }
+  _handle = descriptor;
+  _mapping = mmap(nullptr, _mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  if (_mapping == MAP_FAILED) {
+    auto error = system_error("Could not map shared memory " + name);
+    ::close(descriptor);
+    if (_owner) { shm_unlink(native_name.c_str()); }
+    throw error;
+  }
+#endif
+
+  _header = static_cast<header *>(_mapping);
+  _slots = static_cast<std::byte *>(_mapping) + slots_offset;
+  if (_owner) {
+    // a new mapping is zero filled, so the state is not ready until it is stored below
+    _header->version = ring_version;
+    _header->layout_hash = layout.get_hash();
+    _header->values_per_frame = _values_per_frame;
+    _header->capacity = capacity;
+    _header->head.store(0, std::memory_order_relaxed);
+    _header->tail.store(0, std::memory_order_relaxed);
+    _header->state.store(ready_marker, std::memory_order_release);
+  } else {
+    auto ready = wait_until([this] { return _header->state.load(std::memory_order_acquire) == ready_marker; },
+      std::chrono::milliseconds(1000));
+    std::string mismatch;
+    if (!ready) {
+      mismatch = "is not initialized";
+    } else if (_header->version != ring_version) {
+      mismatch = "has another version";
+    } else if (_header->layout_hash != layout.get_hash() || _header->values_per_frame != _values_per_frame) {
+      mismatch = "has another frame layout";
+    } else if (_header->capacity != capacity) {
+      mismatch = "has another capacity";
+    }
+    if (!mismatch.empty()) {
+      unmap();
+      throw std::runtime_error("Shared memory ring " + name + " " + mismatch);
+    }
+  }
+  _capacity = capacity;
+  _cached_head = _header->head.load(std::memory_order_acquire);
+  _cached_tail = _header->tail.load(std::memory_order_acquire);
+}
+
+shm_ring::~shm_ring() { unmap(); }
+
+void shm_ring::unmap()
+{
+  if (_mapping == nullptr) { return; }
+#ifdef _WIN32
+  UnmapViewOfFile(_mapping);
+  CloseHandle(reinterpret_cast<HANDLE>(_handle));
+#else
+  munmap(_mapping, _mapping_size);
+  ::close(static_cast<int>(_handle));
+  // the other side keeps its mapping, only the name is removed
+  if (_owner) { shm_unlink(get_native_name(_name).c_str()); }
+#endif
+  _mapping = nullptr;
+}
+
+void shm_ring::remove(const std::string &name)
+{
+#ifndef _WIN32
+  shm_unlink(get_native_name(name).c_str());
+#else
+  // a file mapping is removed with its last handle
+  (void)name;
+#endif
+}
+
+double *shm_ring::get_slot(std::uint64_t index) const
+{
+  return reinterpret_cast<double *>(_slots + (index % _capacity) * get_slot_size(_values_per_frame));
+}
+
+bool shm_ring::try_push(double time, std::span<const double> values)
+{
+  if (values.size() != _values_per_frame) {
+    throw std::invalid_argument("Frame for " + _name + " has " + std::to_string(values.size()) + " values, the layout "
+                                + std::to_string(_values_per_frame));
+  }
+  const auto head = _header->head.load(std::memory_order_relaxed);
+  // the tail is only read again when the ring looks full
+  if (head - _cached_tail >= _capacity) {
+    _cached_tail = _header->tail.load(std::memory_order_acquire);
+    if (head - _cached_tail >= _capacity) { return false; }
+  }
+  auto *slot = get_slot(head);
+  slot[0] = time;
+  std::copy(values.begin(), values.end(), slot + 1);
+  _header->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void shm_ring::push(double time, std::span<const double> values, std::chrono::milliseconds timeout)
+{
+  if (!wait_until([&] { return try_push(time, values); }, timeout)) {
+    throw std::runtime_error("Shared memory ring " + _name + " stayed full, is the consumer running?");
+  }
+}
+
+bool shm_ring::try_pop(double &time, std::span<double> values)
+{
+  if (values.size() != _values_per_frame) {
+    throw std::invalid_argument("Frame for " + _name + " has " + std::to_string(values.size()) + " values, the layout "
+                                + std::to_string(_values_per_frame));
+  }
+  const auto tail = _header->tail.load(std::memory_order_relaxed);
+  if (tail == _cached_head) {
+    _cached_head = _header->head.load(std::memory_order_acquire);
+    if (tail == _cached_head) { return false; }
+  }
+  const auto *slot = get_slot(tail);
+  time = slot[0];
+  std::copy(slot + 1, slot + 1 + _values_per_frame, values.begin());
+  _header->tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+void shm_ring::pop(double &time, std::span<double> values, std::chrono::milliseconds timeout)
+{
+  if (!wait_until([&] { return try_pop(time, values); }, timeout)) {
+    throw std::runtime_error("Shared memory ring " + _name + " stayed empty, is the producer running?");
+  }
+}
+
+}// namespace mgwso
@@ -0,0 +1,100 @@
+#ifndef MGWSO_SHM_CHANNEL_HPP
+#define MGWSO_SHM_CHANNEL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mgwso {
+
+// Values in every frame of a ring, declared as "ITEM/Property" names
+/*
+Both sides of a ring declare the layout from the same list of quantities. The
+hash of the names is stored in the ring, so a side with another layout can
+not attach.
+*/
+class frame_layout {
+public:
+  explicit frame_layout(std::vector<std::string> quantities);
+  const std::vector<std::string> &get_quantities() const { return _quantities; }
+  std::size_t size() const { return _quantities.size(); }
+  std::uint64_t get_hash() const { return _hash; }
+
+private:
+  std::vector<std::string> _quantities;
+  std::uint64_t _hash = 0;
+};
+
+// How a side opens a ring
+enum class shm_open_mode {
+  // creates the ring when it does not exist, otherwise attaches
+  open,
+  // removes a ring left behind by an earlier run and creates a new one
+  create,
+  // waits until the other side has created the ring
+  attach
+};
+
+// Lock-free single producer, single consumer ring of timestamped frames in shared memory
+/*
+The ring lives in a named shared memory segment, POSIX shared memory or a
+Windows file mapping, so a producer and a consumer in different processes can
+exchange frames without file I/O. One side creates and initializes the ring,
+the other side attaches, see shm_open_mode. The producer only writes the head
+and the consumer only writes the tail, each on its own cache line.
+*/
+class shm_ring {
+public:
+  // opens the ring with the given name, a created ring has room for capacity frames
+  // attach_timeout is how long an attaching side waits for the ring to be created
+  shm_ring(const std::string &name,
+    const frame_layout &layout,
+    std::uint32_t capacity = 64,
+    shm_open_mode mode = shm_open_mode::open,
+    std::chrono::milliseconds attach_timeout = std::chrono::milliseconds(1000));
+  shm_ring(const shm_ring &) = delete;
+  shm_ring &operator=(const shm_ring &) = delete;
+  ~shm_ring();
+
+  // removes a ring left behind by an earlier run
+  static void remove(const std::string &name);
+
+  // producer: adds a frame, returns false when the ring is full
+  bool try_push(double time, std::span<const double> values);
+  // producer: adds a frame, waits while the ring is full, throws after the timeout
+  void push(double time, std::span<const double> values, std::chrono::milliseconds timeout);
+  // consumer: takes the oldest frame, returns false when the ring is empty
+  bool try_pop(double &time, std::span<double> values);
+  // consumer: takes the oldest frame, waits while the ring is empty, throws after the timeout
+  void pop(double &time, std::span<double> values, std::chrono::milliseconds timeout);
+
+  std::size_t get_frame_size() const { return _values_per_frame; }
+  bool is_owner() const { return _owner; }
+
+  struct header;
+
+private:
+  std::string _name;
+  bool _owner = false;
+  std::size_t _values_per_frame = 0;
+  std::uint64_t _capacity = 0;
+  // last head seen by the consumer and last tail seen by the producer, to keep off the other side's cache line
+  std::uint64_t _cached_head = 0;
+  std::uint64_t _cached_tail = 0;
+  std::size_t _mapping_size = 0;
+  void *_mapping = nullptr;
+  std::intptr_t _handle = -1;
+  header *_header = nullptr;
+  std::byte *_slots = nullptr;
+
+  double *get_slot(std::uint64_t index) const;
+  void unmap();
+};
+
+}// namespace mgwso
+
+#endif
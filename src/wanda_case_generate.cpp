@@ -0,0 +1,58 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+#include <wanda_case_generator.h>
+#include <wandamodel.h>
+
+#include <internal_use_only/config.hpp>
+
+// Generates a synthetic case of a given size from a template case, for scale
+// tests of mgwso and the Wanda API. With --output_only the output of an existing
+// case is replaced by synthetic output, which needs no Wanda license.
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app{ fmt::format("wanda_case_generate, {} version {}", mgwso::cmake::project_name,
+                              mgwso::cmake::project_version) };
+
+    wanda_case_generator_spec spec;
+    app.add_option("-t,--template", spec.template_case, "Case to copy the pipe and control component from");
+    app.add_option("-o,--output", spec.output_case, "Wdi file of the synthetic case")->required();
+    app.add_option("-b,--bin", spec.wanda_bin, "Wanda bin directory")->required();
+    app.add_option("--pipes", spec.pipes, "Number of pipes");
+    app.add_option("--controls", spec.control_components, "Number of control components");
+    app.add_option("--steps", spec.time_steps, "Number of output time steps, 0 for no output");
+    app.add_option("--time_step", spec.time_step, "Time between the output time steps");
+    app.add_option("--seed", spec.seed, "Seed of the pseudo-random input and output");
+    bool output_only = false;
+    app.add_flag("--output_only", output_only, "Only write synthetic output for the existing case");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (spec.wanda_bin.back() != '\\') {
+      spec.wanda_bin.append("\\");
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (output_only) {
+      // the model must not have the old output open
+      std::filesystem::remove(std::filesystem::path(spec.output_case).replace_extension(".wdo"));
+      wanda_model model(spec.output_case, spec.wanda_bin);
+      wanda_write_synthetic_output(model, spec.time_steps, spec.time_step, spec.seed);
+      model.close();
+    } else {
+      if (spec.template_case.empty()) { throw std::invalid_argument("Give the template case"); }
+      wanda_generate_case(spec);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    spdlog::info("{} written in {:.1f} s", spec.output_case, elapsed.count());
+  }
+  catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in wanda_case_generate: {}", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
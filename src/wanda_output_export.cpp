@@ -0,0 +1,76 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+#include <wanda_output_reader.h>
+#include <wandamodel.h>
+
+#include <internal_use_only/config.hpp>
+
+#include "output_export.hpp"
+
+// Exports output quantities of a WANDA case to a Parquet or Arrow file, one long
+// table with a row per time step and element. The output is streamed from the
+// wdo file in blocks, so results of any size export in bounded memory.
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app{ fmt::format("wanda_output_export, {} version {}", mgwso::cmake::project_name,
+                              mgwso::cmake::project_version) };
+
+    std::string model_file;
+    app.add_option("-m,--model", model_file, "Wdi file of the case")->required();
+    std::string wanda_bin;
+    app.add_option("-b,--bin", wanda_bin, "Wanda bin directory")->required();
+    std::string output_file;
+    app.add_option("-o,--output", output_file, "Parquet or Arrow file to write")->required();
+    std::vector<std::string> outputs;
+    app.add_option("--outputs", outputs, "Quantities to export as ITEM/Property, all elements of pipes")->required();
+    std::string format;
+    app.add_option("--format", format, "parquet or arrow, by default from the extension of the output file");
+    size_t max_rows = size_t{ 1 } << 20U;
+    app.add_option("--rows", max_rows, "Maximum number of rows per record batch");
+    std::string compression = "uncompressed";
+    app.add_option("--compression", compression, "Codec of the file, e.g. uncompressed, snappy, zstd or lz4");
+    bool si_units = false;
+    app.add_flag("--si", si_units, "Export SI values instead of the units of the case");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (wanda_bin.back() != '\\') {
+      wanda_bin.append("\\");
+    }
+    if (format.empty()) {
+      auto extension = std::filesystem::path(output_file).extension();
+      format = extension == ".arrow" || extension == ".feather" ? "arrow" : "parquet";
+    }
+    auto start = std::chrono::steady_clock::now();
+    wanda_model model(model_file, wanda_bin);
+    if (si_units) { model.switch_to_unit_SI(); }
+    wanda_output_reader reader(model);
+    for (auto &quantity : outputs) {
+      auto separator = quantity.find('/');
+      if (separator == std::string::npos || separator == 0 || separator + 1 == quantity.size()) {
+        throw std::invalid_argument("Quantity " + quantity + " is not of the form ITEM/Property");
+      }
+      auto property = quantity.substr(separator + 1);
+      // the mgwso notation for all pipe elements is accepted, they are always exported
+      if (property.ends_with("[]")) { property.resize(property.size() - 2); }
+      reader.add(quantity.substr(0, separator), property);
+    }
+    auto summary = mgwso::export_output(reader, output_file, mgwso::parse_export_format(format), max_rows, compression);
+    model.close();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    spdlog::info("{} rows in {} batches written to {} in {:.1f} s", summary.rows, summary.batches, output_file,
+      elapsed.count());
+  }
+  catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in wanda_output_export: {}", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
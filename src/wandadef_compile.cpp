@@ -0,0 +1,42 @@
+#include <string>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+#include <wandadef.h>
+
+#include <internal_use_only/config.hpp>
+
+// Reads all definitions from WandaDef.dat once and writes them as a snapshot
+// which wanda_def maps instead of reading WandaDef.dat.
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app{ fmt::format("wandadef_compile, {} version {}", mgwso::cmake::project_name,
+                              mgwso::cmake::project_version) };
+
+    std::string wanda_bin;
+    app.add_option("-b,--bin", wanda_bin, "Wanda bin directory containing WandaDef.dat")->required();
+    std::string output;
+    app.add_option("-o,--output", output, "Snapshot file, default is WandaDef.snapshot in the bin directory");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (wanda_bin.back() != '\\') {
+      wanda_bin.append("\\");
+    }
+    if (output.empty()) {
+      output = wanda_bin + wanda_def_snapshot::file_name;
+    }
+
+    wanda_def definition(wanda_bin, true);
+    definition.load_all_definitions();
+    definition.save_snapshot(output);
+    spdlog::info("Definition snapshot of Wanda {} written to {}", definition.get_wanda_version(), output);
+  }
+  catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in wandadef_compile: {}", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,16 @@
+// Stand-in for steady.exe and unsteady.exe in the solver launcher tests.
+// The first argument selects the behaviour.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv)
+{
+  const std::string mode = argc > 1 ? argv[1] : "ok";
+  std::cout << "stub solver " << mode << std::endl;
+  std::cerr << "stub solver error output" << std::endl;
+  if (mode == "sleep") { std::this_thread::sleep_for(std::chrono::seconds(30)); }
+  if (mode == "fail") { return 3; }
+  return 0;
+}
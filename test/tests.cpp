@@ -1,4 +1,20 @@
+#include <atomic>
+#include <cmath>
 #include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <openda_protocol.hpp>
+#include <shm_channel.hpp>
+#include <sstream>
+#include <thread>
+#include <wanda_batch_runner.h>
+#include <wanda_grid_mapping.h>
+#include <wanda_metrics.h>
+#include <wanda_native_hcs.h>
+#include <wanda_solver_process.h>
+#include <wanda_state_vector.h>
+#include <wanda_time_range_session.h>
+#include <wanda_trace.h>
 
 // #include <mgwso/test.hpp>
 
@@ -6,4 +22,551 @@
 TEST_CASE("Example testcase", "[mgwso]")
 {
   REQUIRE((1+1) == 2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Solver process runs and captures its output", "[solver]")
+{
+  auto job = wanda_solver_job::launch(STUB_SOLVER_PATH, { "ok" });
+  const auto &result = job->wait();
+  REQUIRE(result.succeeded());
+  REQUIRE(result.output == "stub solver ok\n");
+  REQUIRE(result.error == "stub solver error output\n");
+
+  auto failing = wanda_solver_job::launch(STUB_SOLVER_PATH, { "fail" });
+  REQUIRE(failing->wait().exit_code == 3);
+}
+
+TEST_CASE("Solver process can time out and be cancelled", "[solver]")
+{
+  wanda_solver_options options;
+  options.timeout = std::chrono::milliseconds(200);
+  bool callback_called = false;
+  options.on_finished = [&](const wanda_solver_result &) { callback_called = true; };
+  auto timed = wanda_solver_job::launch(STUB_SOLVER_PATH, { "sleep" }, options);
+  REQUIRE(timed->wait().timed_out);
+  REQUIRE(callback_called);
+
+  auto cancelled = wanda_solver_job::launch(STUB_SOLVER_PATH, { "sleep" });
+  REQUIRE_FALSE(cancelled->wait_for(std::chrono::milliseconds(100)));
+  cancelled->cancel();
+  REQUIRE(cancelled->wait().cancelled);
+}
+
+TEST_CASE("Solver process quotes arguments for the Windows command line", "[solver]")
+{
+  auto job = wanda_solver_job::launch(STUB_SOLVER_PATH, { "ok", R"(C:\case dir\)", R"(say "hi"\)", "" });
+  REQUIRE(job->get_command_line() == std::string("\"") + STUB_SOLVER_PATH + R"(" "ok" "C:\case dir\\" "say \"hi\"\\" "")");
+  REQUIRE(job->wait().succeeded());
+}
+
+TEST_CASE("Solver job may release its last handle in the completion callback", "[solver]")
+{
+  std::shared_ptr<wanda_solver_job> job;
+  std::promise<void> launched;
+  wanda_solver_options options;
+  options.on_finished = [&, ready = launched.get_future().share()](const wanda_solver_result &) {
+    ready.wait();
+    job.reset();
+  };
+  job = wanda_solver_job::launch(STUB_SOLVER_PATH, { "ok" }, options);
+  auto future = job->get_future();
+  launched.set_value();
+  REQUIRE(future.get().succeeded());
+}
+
+namespace {
+// base case of the batch tests, the stub solver does not read it
+std::filesystem::path make_batch_directory(const std::string &name)
+{
+  auto directory = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::ofstream(directory / "case.wdi") << "stub case";
+  return directory;
+}
+
+void run_stub(wanda_batch_runner &runner, const std::string &mode)
+{
+  auto solver = wanda_solver_job::launch(STUB_SOLVER_PATH, { mode });
+  runner.wait_for(solver);
+  if (!solver->wait().succeeded()) { throw std::runtime_error("stub solver " + mode + " failed"); }
+}
+}// namespace
+
+TEST_CASE("Batch runner retries failing jobs and keeps the other jobs going", "[batch]")
+{
+  auto directory = make_batch_directory("mgwso_batch_retries");
+  wanda_batch_runner *self = nullptr;
+  wanda_batch_runner runner((directory / "case.wdi").string(),
+    (directory / "jobs").string(),
+    [&](const wanda_batch_job &job,
+      const std::string &case_file,
+      const wanda_batch_options &,
+      wanda_batch_result &result) {
+      if (!std::filesystem::exists(case_file)) { throw std::runtime_error("no copy of the case"); }
+      // not derived from std::exception, the worker must still catch it
+      if (job.name == "thrown") { throw 42; }// NOLINT(hicpp-exception-baseclass)
+      run_stub(*self, job.name == "broken" || (job.name == "flaky" && result.attempts == 1) ? "fail" : "ok");
+    });
+  self = &runner;
+  runner.add_job({ "flaky", {} });
+  runner.add_job({ "broken", {} });
+  runner.add_job({ "thrown", {} });
+  runner.add_job({ "fine", {} });
+  REQUIRE_THROWS(runner.add_job({ "../outside", {} }));
+  REQUIRE_THROWS(runner.add_job({ "..", {} }));
+  REQUIRE_THROWS(runner.add_job({ (directory / "absolute").string(), {} }));
+
+  wanda_batch_options options;
+  options.num_workers = 2;
+  options.max_retries = 1;
+  auto results = runner.run(options);
+  REQUIRE(results.size() == 4);
+  REQUIRE(results[0].succeeded);
+  REQUIRE(results[0].attempts == 2);
+  REQUIRE_FALSE(results[1].succeeded);
+  REQUIRE(results[1].attempts == 2);
+  REQUIRE(results[1].error == "stub solver fail failed");
+  REQUIRE_FALSE(results[2].succeeded);
+  REQUIRE(results[2].error == "Unknown error");
+  REQUIRE(results[3].succeeded);
+  REQUIRE(results[3].attempts == 1);
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Batch runner runs at most num_workers jobs at a time", "[batch]")
+{
+  auto directory = make_batch_directory("mgwso_batch_workers");
+  std::atomic<int> running = 0;
+  std::atomic<int> most_running = 0;
+  wanda_batch_runner *self = nullptr;
+  wanda_batch_runner runner((directory / "case.wdi").string(),
+    (directory / "jobs").string(),
+    [&](const wanda_batch_job &, const std::string &, const wanda_batch_options &, wanda_batch_result &) {
+      int now = ++running;
+      int most = most_running;
+      while (now > most && !most_running.compare_exchange_weak(most, now)) {}
+      run_stub(*self, "ok");
+      running--;
+    });
+  self = &runner;
+  for (int job = 0; job < 8; job++) { runner.add_job({ "job" + std::to_string(job), {} }); }
+  wanda_batch_options options;
+  options.num_workers = 3;
+  for (auto &result : runner.run(options)) { REQUIRE(result.succeeded); }
+  REQUIRE(most_running >= 1);
+  REQUIRE(most_running <= 3);
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Batch runner writes the result table as CSV", "[batch]")
+{
+  auto directory = make_batch_directory("mgwso_batch_csv");
+  wanda_batch_runner runner((directory / "case.wdi").string(),
+    (directory / "jobs").string(),
+    [](const wanda_batch_job &job, const std::string &, const wanda_batch_options &, wanda_batch_result &result) {
+      if (job.name == "bad") { throw std::runtime_error("no \"output\""); }
+      result.values = { 1.5f, 2.0f };
+    });
+  runner.add_job({ "good", {} });
+  runner.add_job({ "bad", {} });
+  runner.add_output({ "PIPE P1", "Pressure", wanda_batch_statistic::maximum, 2 });
+  runner.add_output({ "H-NODE A", "Head", wanda_batch_statistic::final_value, 0 });
+  auto results = runner.run();
+  auto file = directory / "summary.csv";
+  runner.write_csv(results, file.string());
+
+  std::ifstream stream(file);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(stream, line);) { lines.push_back(line); }
+  REQUIRE(lines.size() == 3);
+  REQUIRE(lines[0] == R"(job,succeeded,attempts,wall_time,"PIPE P1/Pressure[2] max","H-NODE A/Head final",error)");
+  REQUIRE(lines[1].starts_with(R"("good",1,1,)"));
+  REQUIRE(lines[1].ends_with(R"(,1.5,2,"")"));
+  REQUIRE(lines[2].starts_with(R"("bad",0,1,)"));
+  REQUIRE(lines[2].ends_with(R"(,,,"no ""output""")"));
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Native HCS computes the length of pipe profiles", "[hcs]")
+{
+  std::vector<float> distance = { 0.0f, 3.0f, 3.0f };
+  std::vector<float> height = { 0.0f, 4.0f, 6.0f };
+  REQUIRE(wanda_native_hcs::profile_length(distance, height) == 7.0f);
+
+  std::vector<float> x = { 1.0f, 3.0f };
+  std::vector<float> y = { 1.0f, 4.0f };
+  std::vector<float> z = { 1.0f, 7.0f };
+  REQUIRE(wanda_native_hcs::profile_length(x, y, z) == 7.0f);
+
+  // the first row of a difference table is the start point
+  std::vector<float> x_diff = { 10.0f, 2.0f };
+  std::vector<float> y_diff = { 10.0f, 3.0f };
+  std::vector<float> z_diff = { 10.0f, 6.0f };
+  REQUIRE(wanda_native_hcs::profile_length_from_differences(x_diff, y_diff, z_diff) == 7.0f);
+}
+
+TEST_CASE("Native HCS computes the number of pipe elements", "[hcs]")
+{
+  std::vector<float> length = { 1000.0f, 1240.0f, 10.0f, 0.0f, 100.0f };
+  std::vector<float> wave_speed = { 1000.0f, 1000.0f, 1000.0f, 1000.0f, -1.0f };
+  std::vector<float> count(length.size());
+  wanda_native_hcs::compute_pipe_element_count(length, wave_speed, 0.1f, count);
+  REQUIRE(count[0] == 10.0f);
+  REQUIRE(count[1] == 12.0f);
+  REQUIRE(count[2] == 1.0f);
+  REQUIRE(count[3] == wanda_native_hcs::not_computed);
+  REQUIRE(count[4] == wanda_native_hcs::not_computed);
+
+  // many pipes in one call
+  std::vector<float> many_length(100000, 500.0f);
+  std::vector<float> many_wave_speed(100000, 1250.0f);
+  std::vector<float> many_count(100000);
+  wanda_native_hcs::compute_pipe_element_count(many_length, many_wave_speed, 0.01f, many_count);
+  REQUIRE(many_count.front() == 40.0f);
+  REQUIRE(many_count.back() == 40.0f);
+}
+
+TEST_CASE("Native HCS matches the reference results of Component64.dll", "[hcs]")
+{
+  std::ifstream file(HCS_REFERENCE_PATH);
+  REQUIRE(file.is_open());
+  auto split = [](const std::string &text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    for (std::string part; std::getline(stream, part, separator);) { parts.push_back(part); }
+    // a trailing empty field is not returned by getline
+    if (!text.empty() && text.back() == separator) { parts.emplace_back(); }
+    return parts;
+  };
+  int pipes = 0;
+  int compared = 0;
+  std::string line;
+  std::getline(file, line);
+  while (line.starts_with('#')) { std::getline(file, line); }
+  REQUIRE(line == "geometry,profile,wave_speed,time_step,dll_length,dll_element_count");
+  while (std::getline(file, line)) {
+    if (line.empty()) { continue; }
+    auto fields = split(line, ',');
+    REQUIRE(fields.size() == 6);
+    std::vector<std::vector<float>> columns(fields[0] == "l-h" ? 2 : 3);
+    float length = 0.0f;
+    if (fields[0] == "Length") {
+      length = std::stof(fields[1]);
+    } else {
+      for (auto &row : split(fields[1], ';')) {
+        auto values = split(row, ' ');
+        REQUIRE(values.size() == columns.size());
+        for (size_t column = 0; column < columns.size(); column++) {
+          columns[column].push_back(std::stof(values[column]));
+        }
+      }
+      if (fields[0] == "l-h") {
+        length = wanda_native_hcs::profile_length(columns[0], columns[1]);
+      } else if (fields[0] == "xyz") {
+        length = wanda_native_hcs::profile_length(columns[0], columns[1], columns[2]);
+      } else {
+        REQUIRE(fields[0] == "xyz dif");
+        length = wanda_native_hcs::profile_length_from_differences(columns[0], columns[1], columns[2]);
+      }
+    }
+    std::vector<float> lengths{ length };
+    std::vector<float> wave_speeds{ std::stof(fields[2]) };
+    std::vector<float> count(1);
+    wanda_native_hcs::compute_pipe_element_count(lengths, wave_speeds, std::stof(fields[3]), count);
+    REQUIRE(count[0] != wanda_native_hcs::not_computed);
+    pipes++;
+    if (fields[4].empty() || fields[5].empty()) { continue; }
+    // the dll computes in single precision as well, but it may sum the segments in another order
+    REQUIRE(std::abs(length - std::stof(fields[4])) <= 1e-5f * std::stof(fields[4]));
+    REQUIRE(count[0] == std::stof(fields[5]));
+    compared++;
+  }
+  REQUIRE(pipes > 0);
+  if (compared == 0) { WARN("No results of Component64.dll in " HCS_REFERENCE_PATH ", nothing is compared"); }
+}
+
+TEST_CASE("OpenDA protocol messages round-trip over a local connection", "[openda]")
+{
+  using namespace mgwso::openda;
+  std::vector<std::byte> buffer;
+  payload_writer writer(buffer);
+  writer.write(std::uint32_t{ 7 });
+  writer.write(2.5);
+  writer.write(std::string("PIPE P1/Head[]"));
+  const std::vector<double> values{ 1.0, -2.0, 3.5 };
+  writer.write(std::span<const double>(values));
+
+  payload_reader reader(buffer);
+  REQUIRE(reader.read<std::uint32_t>() == 7);
+  REQUIRE(reader.read<double>() == 2.5);
+  REQUIRE(reader.read_string() == "PIPE P1/Head[]");
+  auto remaining = reader.read_remaining_doubles();
+  REQUIRE(std::vector<double>(remaining.begin(), remaining.end()) == values);
+  REQUIRE_THROWS(reader.read<double>());
+
+  // the server echoes the requests and refuses messages above its size limit without losing the connection
+  constexpr unsigned short port = 52611;
+  listener socket(port);
+  std::thread server([&socket] {
+    auto client = socket.accept();
+    client.set_max_payload_size(64);
+    message request;
+    while (true) {
+      try {
+        if (!client.receive(request)) { break; }
+      } catch (const std::length_error &) {
+        const std::string error = "too large";
+        client.send(static_cast<std::uint32_t>(status::error), std::as_bytes(std::span(error)));
+        continue;
+      }
+      client.send(static_cast<std::uint32_t>(status::ok), request.payload);
+    }
+  });
+  auto openda = connection::connect(port);
+  message reply;
+  call(openda, opcode::get_values, buffer, reply);
+  REQUIRE(reply.payload == buffer);
+  const std::vector<std::byte> large(100);
+  REQUIRE_THROWS(call(openda, opcode::set_state, large, reply));
+  call(openda, opcode::get_state, buffer, reply);
+  REQUIRE(reply.payload == buffer);
+  openda = {};
+  server.join();
+
+  // sending to a closed connection throws instead of raising SIGPIPE
+  std::thread closing([&socket] { auto client = socket.accept(); });
+  auto closed = connection::connect(port);
+  closing.join();
+  const std::vector<std::byte> block(4096);
+  auto send_until_lost = [&closed, &block] {
+    for (int i = 0; i < 1000; i++) { closed.send(static_cast<std::uint32_t>(status::ok), block); }
+  };
+  REQUIRE_THROWS_AS(send_until_lost(), connection_lost);
+}
+
+TEST_CASE("Shared memory ring passes frames in order", "[shm]")
+{
+  mgwso::shm_ring::remove("mgwso_test_ring");
+  mgwso::frame_layout layout({ "PIPE P1/Discharge 2", "NODE A/Head" });
+  mgwso::shm_ring producer("mgwso_test_ring", layout, 4);
+  REQUIRE(producer.is_owner());
+  // the consumer attaches to the same ring, as another process would
+  mgwso::shm_ring consumer("mgwso_test_ring", layout, 4);
+  REQUIRE_FALSE(consumer.is_owner());
+  REQUIRE_THROWS(mgwso::shm_ring("mgwso_test_ring", mgwso::frame_layout({ "NODE A/Head" }), 4));
+
+  double time = 0.0;
+  std::vector<double> values(2);
+  REQUIRE_FALSE(consumer.try_pop(time, values));
+  for (int i = 0; i < 4; i++) { REQUIRE(producer.try_push(i, std::vector<double>{ i * 1.0, i * 2.0 })); }
+  REQUIRE_FALSE(producer.try_push(4.0, values));
+
+  // more frames than fit in the ring, while the consumer takes them
+  constexpr int frames = 10000;
+  std::thread writer([&] {
+    for (int i = 4; i < frames; i++) {
+      producer.push(i, std::vector<double>{ i * 1.0, i * 2.0 }, std::chrono::milliseconds(5000));
+    }
+  });
+  bool in_order = true;
+  for (int i = 0; i < frames; i++) {
+    consumer.pop(time, values, std::chrono::milliseconds(5000));
+    in_order = in_order && time == i && values[0] == i * 1.0 && values[1] == i * 2.0;
+  }
+  writer.join();
+  REQUIRE(in_order);
+  REQUIRE_FALSE(consumer.try_pop(time, values));
+}
+
+TEST_CASE("Shared memory ring is created by one side and attached by the other", "[shm]")
+{
+  mgwso::shm_ring::remove("mgwso_test_owned");
+  mgwso::frame_layout layout({ "NODE A/Head" });
+  REQUIRE_THROWS(mgwso::shm_ring("mgwso_test_owned", layout, 4, mgwso::shm_open_mode::attach,
+    std::chrono::milliseconds(10)));
+#ifndef _WIN32
+  // a ring of a crashed run with another layout is replaced by the creating side
+  mgwso::shm_ring stale("mgwso_test_owned", mgwso::frame_layout({ "NODE B/Head" }), 4);
+#endif
+  mgwso::shm_ring creator("mgwso_test_owned", layout, 4, mgwso::shm_open_mode::create);
+  REQUIRE(creator.is_owner());
+  mgwso::shm_ring attached("mgwso_test_owned", layout, 4, mgwso::shm_open_mode::attach);
+  REQUIRE_FALSE(attached.is_owner());
+  REQUIRE(creator.try_push(1.0, std::vector<double>{ 2.0 }));
+  double time = 0.0;
+  std::vector<double> values(1);
+  REQUIRE(attached.try_pop(time, values));
+  REQUIRE(values[0] == 2.0);
+}
+
+TEST_CASE("Grid mapping passes pipe values to the cells and back", "[mapping]")
+{
+  // one row of four cells, a pipe of four elements along the middle
+  wanda_grid grid{ 0.0, 0.0, 10.0, 10.0, 4, 1 };
+  std::vector<wanda_pipe_path> paths{ { "PIPE P1", { 0.0, 40.0 }, { 5.0, 5.0 }, {}, 4 } };
+  wanda_grid_mapping average(grid, paths);
+  REQUIRE(average.get_number_of_points() == 5);
+
+  std::vector<double> cells = { 1.0, 2.0, 3.0, 4.0 };
+  std::vector<double> points(5);
+  average.from_grid(cells, points);
+  REQUIRE(points == std::vector<double>{ 1.0, 1.5, 2.5, 3.5, 4.0 });
+
+  points = { 0.0, 1.0, 2.0, 3.0, 4.0 };
+  average.to_grid(points, cells);
+  REQUIRE(cells == std::vector<double>{ 0.5, 1.5, 2.5, 3.5 });
+
+  // a leakage of 1 per point is divided over the cells, the total is kept
+  wanda_grid_mapping conserve(grid, paths, wanda_grid_transfer::conserve);
+  points.assign(5, 1.0);
+  conserve.to_grid(points, cells);
+  REQUIRE(cells == std::vector<double>{ 1.5, 1.0, 1.0, 1.5 });
+
+  // cells not crossed by a pipe are left untouched
+  wanda_grid wide{ 0.0, 0.0, 10.0, 10.0, 4, 2 };
+  wanda_grid_mapping partial(wide, paths);
+  REQUIRE(partial.get_to_grid_matrix().row_index.size() == 4);
+  std::vector<double> wide_cells(8, -1.0);
+  partial.to_grid(points, wide_cells);
+  REQUIRE(wide_cells[4] == -1.0);
+}
+
+TEST_CASE("Values are averaged and interpolated in time", "[mapping]")
+{
+  wanda_time_averager averager(1);
+  averager.add_series(std::vector<double>{ 0.0, 1.0, 3.0 }, std::vector<double>{ 0.0, 2.0, 2.0 });
+  std::vector<double> average(1);
+  averager.get_average(average);
+  REQUIRE(average[0] * 3.0 == 5.0);
+  averager.restart();
+  REQUIRE(averager.get_start_time() == 3.0);
+
+  std::vector<double> result(1);
+  wanda_interpolate_in_time(0.0, std::vector<double>{ 1.0 }, 4.0, std::vector<double>{ 3.0 }, 1.0, result);
+  REQUIRE(result[0] == 1.5);
+  wanda_interpolate_in_time(0.0, std::vector<double>{ 1.0 }, 4.0, std::vector<double>{ 3.0 }, 5.0, result);
+  REQUIRE(result[0] == 3.0);
+}
+
+TEST_CASE("State vector layout assigns offsets and gathers the output", "[state]")
+{
+  // a pipe of three elements followed by a node and a valve
+  wanda_state_vector_layout layout({ { "PIPE P1", "Pressure", 0, 4, true },
+    { "H-node N1", "Head", 0, 1, false },
+    { "VALVE V1", "Position", 0, 1, false } });
+  REQUIRE(layout.size() == 6);
+  REQUIRE(layout.get_entry("H-node N1", "Head").offset == 4);
+  REQUIRE(layout.get_entry("VALVE V1", "Position").offset == 5);
+  REQUIRE_THROWS_AS(layout.get_entry("VALVE V1", "Head"), std::invalid_argument);
+  REQUIRE(layout.has_pipe_quantities());
+
+  std::vector<double> state(6);
+  REQUIRE_THROWS_AS(layout.gather_output(0, state), std::runtime_error);
+  // three time steps per value, value i at step t is 10 * i + t
+  std::vector<std::vector<float>> output(6);
+  std::vector<std::span<const float>> series;
+  for (size_t i = 0; i < output.size(); i++) {
+    for (int step = 0; step < 3; step++) { output[i].push_back(static_cast<float>(10 * i) + static_cast<float>(step)); }
+    series.emplace_back(output[i]);
+  }
+  layout.bind_output(series);
+  REQUIRE(layout.get_number_of_time_steps() == 3);
+  layout.gather_output(2, state);
+  REQUIRE(state == std::vector<double>{ 2.0, 12.0, 22.0, 32.0, 42.0, 52.0 });
+  REQUIRE_THROWS_AS(layout.gather_output(3, state), std::out_of_range);
+  std::vector<double> short_state(5);
+  REQUIRE_THROWS_AS(layout.gather_output(0, short_state), std::invalid_argument);
+  series.pop_back();
+  REQUIRE_THROWS_AS(layout.bind_output(series), std::invalid_argument);
+
+  // pipe quantities can't be set in the engine, scatter_engine only accepts scalar layouts
+  wanda_state_vector_layout scalars({ { "H-node N1", "Head", 0, 1, false } });
+  REQUIRE_FALSE(scalars.has_pipe_quantities());
+  REQUIRE(scalars.get_entries()[0].offset == 0);
+}
+
+TEST_CASE("Time windows hold the steps after the previous window up to their end", "[session]")
+{
+  // the first window starts at the start of the simulation, its output holds the start step
+  std::vector<float> first_run{ 0.0F, 0.1F, 0.2F, 0.3F };
+  auto steps = get_window_steps(first_run, 0.0, 0.3);
+  REQUIRE(steps.first == 1);
+  REQUIRE(steps.last == 4);
+
+  // the next run restarts at the end of the previous window, which is not repeated
+  std::vector<float> second_run{ 0.3F, 0.4F, 0.5F, 0.6F, 0.7F };
+  steps = get_window_steps(second_run, static_cast<double>(first_run.back()), 0.6);
+  REQUIRE(steps.first == 1);
+  REQUIRE(steps.last == 4);
+
+  // a window shorter than a time step holds no steps
+  steps = get_window_steps(second_run, 0.3, 0.35);
+  REQUIRE(steps.first == steps.last);
+  steps = get_window_steps({}, 0.0, 1.0);
+  REQUIRE(steps.last == 0);
+}
+
+TEST_CASE("Trace spans are recorded per thread and exported as Chrome trace", "[trace]")
+{
+  wanda_trace::clear();
+  { WANDA_TRACE_SCOPE("not recorded"); }
+  REQUIRE(wanda_trace::get_number_of_events() == 0);
+
+  wanda_trace::enable(2);
+  {
+    WANDA_TRACE_SCOPE("outer");
+    wanda_trace::count_nefis(100);
+    { WANDA_TRACE_SCOPE("inner"); }
+  }
+  std::thread([] {
+    WANDA_TRACE_SCOPE("worker");
+  }).join();
+  { WANDA_TRACE_SCOPE("dropped"); }
+  auto job = wanda_solver_job::launch(STUB_SOLVER_PATH, { "ok" });
+  job->wait();
+  wanda_trace::disable();
+
+  REQUIRE(wanda_trace::get_number_of_events() == 4);
+  REQUIRE(wanda_trace::get_dropped_events() == 1);
+  std::ostringstream json;
+  wanda_trace::write_chrome_trace(json);
+  auto trace = json.str();
+  REQUIRE(trace.find("\"name\":\"outer\",\"cat\":\"wanda_api\",\"ph\":\"X\"") != std::string::npos);
+  REQUIRE(trace.find("\"nefis_calls\":1,\"nefis_bytes\":100") != std::string::npos);
+  REQUIRE(trace.find("\"name\":\"worker\"") != std::string::npos);
+  REQUIRE(trace.find("\"name\":\"solver process\",\"cat\":\"solver\"") != std::string::npos);
+  REQUIRE(trace.find("dropped\"") == std::string::npos);
+  wanda_trace::clear();
+}
+
+TEST_CASE("Metrics count and time while enabled and export Prometheus text", "[metrics]")
+{
+  wanda_metrics::reset();
+  auto &calls = wanda_metrics::counter("test_calls_total", "group=\"OUTP_H\"");
+  auto &latency = wanda_metrics::histogram("test_call_seconds");
+  { wanda_metric_timer timer(latency); }
+  REQUIRE(latency.get_count() == 0);
+
+  wanda_metrics::enable();
+  calls.add(3);
+  latency.observe(std::chrono::microseconds(3));
+  latency.observe(std::chrono::seconds(1000));
+  auto job = wanda_solver_job::launch(STUB_SOLVER_PATH, { "fail" });
+  job->wait();
+  wanda_metrics::disable();
+
+  REQUIRE(wanda_metrics::get_counter("test_calls_total", "group=\"OUTP_H\"") == 3);
+  REQUIRE(wanda_metrics::get_counter("test_calls_total") == 0);
+  REQUIRE(wanda_metrics::histogram("wanda_solver_seconds", "result=\"failed\"").get_count() == 1);
+  std::ostringstream text;
+  wanda_metrics::write_prometheus(text);
+  auto prometheus = text.str();
+  REQUIRE(prometheus.find("# TYPE test_calls_total counter\ntest_calls_total{group=\"OUTP_H\"} 3\n") != std::string::npos);
+  REQUIRE(prometheus.find("test_call_seconds_bucket{le=\"2.5e-06\"} 0\n") != std::string::npos);
+  REQUIRE(prometheus.find("test_call_seconds_bucket{le=\"5e-06\"} 1\n") != std::string::npos);
+  REQUIRE(prometheus.find("test_call_seconds_bucket{le=\"500\"} 1\n") != std::string::npos);
+  REQUIRE(prometheus.find("test_call_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+  REQUIRE(prometheus.find("test_call_seconds_count 2\n") != std::string::npos);
+  wanda_metrics::reset();
+}